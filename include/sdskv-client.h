@@ -15,6 +15,15 @@ typedef struct sdskv_client* sdskv_client_t;
 typedef struct sdskv_provider_handle *sdskv_provider_handle_t;
 #define SDSKV_PROVIDER_HANDLE_NULL ((sdskv_provider_handle_t)NULL)
 
+typedef struct sdskv_cursor *sdskv_cursor_t;
+#define SDSKV_CURSOR_NULL ((sdskv_cursor_t)NULL)
+
+typedef struct sdskv_request *sdskv_request_t;
+#define SDSKV_REQUEST_NULL ((sdskv_request_t)NULL)
+
+typedef struct sdskv_batcher *sdskv_batcher_t;
+#define SDSKV_BATCHER_NULL ((sdskv_batcher_t)NULL)
+
 
 /**
  * @brief Global variable recording the last error encountered by REMI.
@@ -95,6 +104,72 @@ int sdskv_provider_handle_ref_incr(
  */
 int sdskv_provider_handle_release(sdskv_provider_handle_t handle);
 
+/**
+ * @brief Sets the largest payload (in bytes) that an operation sends
+ * inline with its RPC rather than through a bulk transfer. This applies
+ * to sdskv_put, sdskv_get, sdskv_put_multi, sdskv_get_multi,
+ * sdskv_erase_multi and to the values returned inline by
+ * sdskv_get_alloc and sdskv_get_packed_alloc. By default the threshold
+ * is derived from the eager message sizes of the Mercury transport the
+ * client's Margo instance uses. Passing 0 restores this default.
+ * Values returned by sdskv_get_multi are sent inline only up to this
+ * default, since the server rejects larger inline responses.
+ *
+ * @param[in] client SDSKV client
+ * @param[in] size eager size in bytes (0 for the default)
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_client_set_eager_size(sdskv_client_t client, hg_size_t size);
+
+/**
+ * @brief Gets the eager size currently used by the client
+ * (see sdskv_client_set_eager_size).
+ *
+ * @param[in] client SDSKV client
+ * @param[out] size eager size in bytes
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_client_get_eager_size(sdskv_client_t client, hg_size_t* size);
+
+/**
+ * @brief Enables caching of the bulk registrations of user buffers
+ * sent or received by sdskv_put, sdskv_get and sdskv_list_keys_packed
+ * (and their variants). Applications that reuse the same buffers for
+ * large values can enable this cache to avoid registering them with
+ * Mercury on every call. Registrations are looked up by buffer address,
+ * size and access mode, and the least recently used one is evicted
+ * when the cache is full. The cache is disabled (max_entries = 0) by
+ * default.
+ *
+ * Important: a cached registration stays attached to the memory it
+ * was created for. Before freeing or unmapping a buffer that may be in
+ * the cache, the application must call sdskv_client_bulk_cache_invalidate
+ * on it.
+ *
+ * @param[in] client SDSKV client
+ * @param[in] max_entries maximum number of cached registrations (0 to disable)
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_client_set_bulk_cache_size(sdskv_client_t client, size_t max_entries);
+
+/**
+ * @brief Removes from the bulk cache the registrations of any buffer
+ * overlapping [buffer, buffer+size). If buffer is NULL, all the
+ * registrations are removed. Operations still in flight keep using
+ * their registration until they complete.
+ *
+ * @param[in] client SDSKV client
+ * @param[in] buffer start of the memory region (or NULL)
+ * @param[in] size size of the memory region
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_client_bulk_cache_invalidate(sdskv_client_t client,
+        const void* buffer, hg_size_t size);
+
 /**
  * @brief Opens a database. This effectively contacts the provider
  * pointed to by the provider handle and request the database id
@@ -228,6 +303,90 @@ int sdskv_proxy_put_packed(sdskv_provider_handle_t provider,
         sdskv_database_id_t db_id, const char* origin_addr,
         size_t num, hg_bulk_t packed_data, hg_size_t packed_data_size);
 
+/**
+ * @brief Callback invoked by a batcher once a batch of puts has
+ * completed, with the number of puts in the batch and the result
+ * of the put_packed operation (SDSKV_SUCCESS or error code).
+ * Calls are made one at a time, in the order of the batches, by a
+ * thread leaving sdskv_batcher_put or sdskv_batcher_flush (or by the
+ * background ULT) after it has released the batcher's lock. The
+ * callback may therefore call sdskv_batcher_put and sdskv_batcher_flush
+ * on the same batcher, but not sdskv_batcher_destroy.
+ */
+typedef void (*sdskv_batch_callback_t)(void* uargs, size_t num, int ret);
+
+/**
+ * @brief Creates a batcher, which coalesces individual puts into
+ * put_packed operations on a given database. The puts are copied into
+ * staging buffers, and sent as a batch through a buffer registered
+ * once for all the batches when one of the following happens:
+ *   - max_count puts have been staged (if max_count is not 0);
+ *   - the next put would make the packed batch larger than max_bytes;
+ *   - flush_interval_ms milliseconds have passed since the last batch
+ *     (if flush_interval_ms > 0; a background ULT checks periodically);
+ *   - sdskv_batcher_flush or sdskv_batcher_destroy is called.
+ * Batches are applied in the order of the puts: a batch is only sent
+ * once the previous one has completed, while new puts can be staged.
+ * A put that does not fit in an empty batch is sent by itself.
+ *
+ * @param[in] provider provider handle managing the database
+ * @param[in] db_id targeted database id
+ * @param[in] max_count maximum number of puts in a batch (0 for no limit)
+ * @param[in] max_bytes maximum size of a batch in put_packed layout
+ * @param[in] flush_interval_ms maximum time a put is kept before it is sent
+ * @param[in] callback function called when a batch completes (may be NULL)
+ * @param[in] uargs argument passed to the callback
+ * @param[out] batcher resulting batcher
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_batcher_create(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id,
+        size_t max_count, hg_size_t max_bytes,
+        double flush_interval_ms,
+        sdskv_batch_callback_t callback, void* uargs,
+        sdskv_batcher_t* batcher);
+
+/**
+ * @brief Adds a put to a batcher. The key and value are copied, so
+ * their buffers can be reused as soon as this function returns. The
+ * put may only take effect when its batch is sent; errors are reported
+ * by the callback and by sdskv_batcher_flush.
+ *
+ * @param[in] batcher batcher
+ * @param[in] key key
+ * @param[in] ksize size of the key
+ * @param[in] value value
+ * @param[in] vsize size of the value
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_batcher_put(sdskv_batcher_t batcher,
+        const void *key, hg_size_t ksize,
+        const void *value, hg_size_t vsize);
+
+/**
+ * @brief Sends the staged puts and waits for all the batches to
+ * complete. Their callbacks have been called when it returns, unless
+ * it is called while another thread (or the calling callback itself)
+ * is calling the callback, in which case that thread calls them.
+ *
+ * @param[in] batcher batcher
+ *
+ * @return SDSKV_SUCCESS if all the batches completed since the
+ * previous call succeeded, otherwise the first error encountered.
+ */
+int sdskv_batcher_flush(sdskv_batcher_t batcher);
+
+/**
+ * @brief Flushes a batcher and destroys it.
+ *
+ * @param[in] batcher batcher
+ *
+ * @return the result of the final flush.
+ */
+int sdskv_batcher_destroy(sdskv_batcher_t batcher);
+
 /**
  * @brief Gets the value associated with a given key.
  * vsize needs to be set to the current size of the allocated
@@ -305,6 +464,50 @@ int sdskv_get_packed(sdskv_provider_handle_t provider,
         size_t* num, const void* packed_keys, const hg_size_t* ksizes,
         hg_size_t vbufsize, void* packed_values, hg_size_t *vsizes);
 
+/**
+ * @brief Gets the value associated with a given key without requiring
+ * its size to be known in advance. The value is returned in a buffer
+ * allocated by this function, which the caller must free with free()
+ * (*value may be NULL if the value is empty). Small values are sent
+ * in the response itself; larger ones are exposed by the provider and
+ * pulled by the client, so this call always takes a single RPC.
+ *
+ * @param[in] provider provider handle
+ * @param[in] db_id database id of the target database
+ * @param[in] key key to lookup
+ * @param[in] ksize size of the key
+ * @param[out] value pointer set to the newly allocated value
+ * @param[out] vsize size of the value
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_get_alloc(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id,
+        const void *key, hg_size_t ksize,
+        void **value, hg_size_t* vsize);
+
+/**
+ * @brief Gets multiple values, whose sizes do not need to be known
+ * in advance, into a single packed buffer allocated by this function
+ * (the caller must free it with free()). The size of the value of a
+ * key that does not exist is set to (hg_size_t)(-1) and the value
+ * takes no room in the packed buffer.
+ *
+ * @param[in] provider provider handle
+ * @param[in] db_id database id
+ * @param[in] num number of values to retrieve
+ * @param[in] packed_keys buffer of packed keys to retrieve
+ * @param[in] ksizes size of the keys
+ * @param[out] packed_values pointer set to the newly allocated packed values
+ * @param[out] vsizes sizes of the values (array of num elements)
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_get_packed_alloc(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id,
+        size_t num, const void* packed_keys, const hg_size_t* ksizes,
+        void** packed_values, hg_size_t *vsizes);
+
 /**
  * @brief Gets the length of a value associated with a given key.
  *
@@ -554,6 +757,400 @@ int sdskv_list_keyvals_with_prefix(
         hg_size_t* vsizes,
         hg_size_t* max_items);
 
+/**
+ * @brief Lists the keys k such that lower_bound <= k < upper_bound,
+ * in the order defined by the database's comparison function.
+ * An empty lower_bound starts from the first key, and an empty
+ * upper_bound lists up to the last key. At most *max_keys keys
+ * are returned; buffers are handled as in sdskv_list_keys.
+ * The range is not supported by the unordered (hash) backend.
+ *
+ * @param[in] provider provider handle
+ * @param[in] db_id database id
+ * @param[in] lower_bound lower bound (included)
+ * @param[in] lower_bound_size size of the lower bound
+ * @param[in] upper_bound upper bound (excluded)
+ * @param[in] upper_bound_size size of the upper bound
+ * @param[out] keys array of buffers to hold returned keys
+ * @param[inout] ksizes array of key sizes
+ * @param[inout] max_keys max keys requested
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_list_keys_range(
+        sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id,
+        const void *lower_bound,
+        hg_size_t lower_bound_size,
+        const void *upper_bound,
+        hg_size_t upper_bound_size,
+        void **keys,
+        hg_size_t* ksizes,
+        hg_size_t* max_keys);
+
+/**
+ * @brief Same as sdskv_list_keys_range but returns also the values.
+ *
+ * @param[in] provider provider handle
+ * @param[in] db_id database id
+ * @param[in] lower_bound lower bound (included)
+ * @param[in] lower_bound_size size of the lower bound
+ * @param[in] upper_bound upper bound (excluded)
+ * @param[in] upper_bound_size size of the upper bound
+ * @param[out] keys array of buffers to hold returned keys
+ * @param[inout] ksizes array of key sizes
+ * @param[inout] values array of buffers to hold returned values
+ * @param[inout] vsizes array of value sizes
+ * @param[inout] max_items max items requested
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_list_keyvals_range(
+        sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id,
+        const void *lower_bound,
+        hg_size_t lower_bound_size,
+        const void *upper_bound,
+        hg_size_t upper_bound_size,
+        void **keys,
+        hg_size_t* ksizes,
+        void **values,
+        hg_size_t* vsizes,
+        hg_size_t* max_items);
+
+/**
+ * @brief Lists keys like sdskv_list_keys_with_prefix, but the provider
+ * packs them into a single buffer and sends it with one bulk transfer,
+ * instead of one transfer per key. The buffer is filled as follows:
+ * [key sizes (n hg_size_t)][keys]. The provider packs as many keys
+ * as fit in the buffer (at most *max_keys), so *max_keys may be smaller
+ * than requested even if the end of the database was not reached.
+ * On return, keys[i] points to the i-th key in packed_data and ksizes[i]
+ * is its size (keys and ksizes may be NULL).
+ *
+ * If not even the first key fits, the function returns SDSKV_ERR_SIZE
+ * and *packed_data_size is set to the size needed to hold it.
+ *
+ * @param[in] provider provider handle
+ * @param[in] db_id database id
+ * @param[in] start_key starting key (excluded, may be NULL)
+ * @param[in] start_ksize size of the starting key
+ * @param[in] prefix prefix of the keys to list (may be NULL)
+ * @param[in] prefix_size size of the prefix
+ * @param[out] packed_data buffer receiving the packed keys
+ * @param[inout] packed_data_size size of the buffer, set to the size used
+ * @param[out] keys array of max_keys pointers to the keys in packed_data
+ * @param[out] ksizes array of max_keys key sizes
+ * @param[inout] max_keys max keys requested, set to the number of keys returned
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_list_keys_packed(
+        sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id,
+        const void *start_key,
+        hg_size_t start_ksize,
+        const void *prefix,
+        hg_size_t prefix_size,
+        void *packed_data,
+        hg_size_t* packed_data_size,
+        const void **keys,
+        hg_size_t* ksizes,
+        hg_size_t* max_keys);
+
+/**
+ * @brief Same as sdskv_list_keys_packed but returns also the values.
+ * The buffer is filled as follows:
+ * [key sizes (n hg_size_t)][value sizes (n hg_size_t)][keys][values].
+ *
+ * @param[in] provider provider handle
+ * @param[in] db_id database id
+ * @param[in] start_key starting key (excluded, may be NULL)
+ * @param[in] start_ksize size of the starting key
+ * @param[in] prefix prefix of the keys to list (may be NULL)
+ * @param[in] prefix_size size of the prefix
+ * @param[out] packed_data buffer receiving the packed keys and values
+ * @param[inout] packed_data_size size of the buffer, set to the size used
+ * @param[out] keys array of max_items pointers to the keys in packed_data
+ * @param[out] ksizes array of max_items key sizes
+ * @param[out] values array of max_items pointers to the values in packed_data
+ * @param[out] vsizes array of max_items value sizes
+ * @param[inout] max_items max items requested, set to the number of items returned
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_list_keyvals_packed(
+        sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id,
+        const void *start_key,
+        hg_size_t start_ksize,
+        const void *prefix,
+        hg_size_t prefix_size,
+        void *packed_data,
+        hg_size_t* packed_data_size,
+        const void **keys,
+        hg_size_t* ksizes,
+        const void **values,
+        hg_size_t* vsizes,
+        hg_size_t* max_items);
+
+/**
+ * @brief Lists as many keys as fit in a buffer of *packed_data_size
+ * bytes, without a limit on their number, so the caller only has to
+ * choose a byte budget and does not need to know the sizes of the keys
+ * in advance. The keys are those that sdskv_list_keys_with_prefix would
+ * return, packed as in sdskv_list_keys_packed. On return, *num_keys is
+ * the number of keys in the buffer, and sdskv_unpack_keys can be used to
+ * locate them. Fewer keys than fit in the budget are returned only when
+ * the end of the listing was reached.
+ *
+ * If not even the first key fits, the function returns SDSKV_ERR_SIZE
+ * and *packed_data_size is set to the size needed to hold it.
+ *
+ * @param[in] provider provider handle
+ * @param[in] db_id database id
+ * @param[in] start_key starting key (excluded, may be NULL)
+ * @param[in] start_ksize size of the starting key
+ * @param[in] prefix prefix of the keys to list (may be NULL)
+ * @param[in] prefix_size size of the prefix
+ * @param[out] packed_data buffer receiving the packed keys
+ * @param[inout] packed_data_size size of the buffer, set to the size used
+ * @param[out] num_keys number of keys returned
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_list_keys_budget(
+        sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id,
+        const void *start_key,
+        hg_size_t start_ksize,
+        const void *prefix,
+        hg_size_t prefix_size,
+        void *packed_data,
+        hg_size_t* packed_data_size,
+        hg_size_t* num_keys);
+
+/**
+ * @brief Same as sdskv_list_keys_budget but returns also the values,
+ * packed as in sdskv_list_keyvals_packed (use sdskv_unpack_keyvals
+ * to locate them).
+ *
+ * @param[in] provider provider handle
+ * @param[in] db_id database id
+ * @param[in] start_key starting key (excluded, may be NULL)
+ * @param[in] start_ksize size of the starting key
+ * @param[in] prefix prefix of the keys to list (may be NULL)
+ * @param[in] prefix_size size of the prefix
+ * @param[out] packed_data buffer receiving the packed keys and values
+ * @param[inout] packed_data_size size of the buffer, set to the size used
+ * @param[out] num_items number of key/value pairs returned
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_list_keyvals_budget(
+        sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id,
+        const void *start_key,
+        hg_size_t start_ksize,
+        const void *prefix,
+        hg_size_t prefix_size,
+        void *packed_data,
+        hg_size_t* packed_data_size,
+        hg_size_t* num_items);
+
+/**
+ * @brief Fills tables pointing to the keys of a buffer filled by
+ * sdskv_list_keys_packed or sdskv_list_keys_budget.
+ *
+ * @param[in] packed_data packed keys
+ * @param[in] num_keys number of keys in the buffer
+ * @param[out] keys array of num_keys pointers to the keys (may be NULL)
+ * @param[out] ksizes array of num_keys key sizes (may be NULL)
+ */
+void sdskv_unpack_keys(
+        const void *packed_data,
+        hg_size_t num_keys,
+        const void **keys,
+        hg_size_t* ksizes);
+
+/**
+ * @brief Fills tables pointing to the keys and values of a buffer
+ * filled by sdskv_list_keyvals_packed or sdskv_list_keyvals_budget.
+ *
+ * @param[in] packed_data packed keys and values
+ * @param[in] num_items number of key/value pairs in the buffer
+ * @param[out] keys array of num_items pointers to the keys (may be NULL)
+ * @param[out] ksizes array of num_items key sizes (may be NULL)
+ * @param[out] values array of num_items pointers to the values (may be NULL)
+ * @param[out] vsizes array of num_items value sizes (may be NULL)
+ */
+void sdskv_unpack_keyvals(
+        const void *packed_data,
+        hg_size_t num_items,
+        const void **keys,
+        hg_size_t* ksizes,
+        const void **values,
+        hg_size_t* vsizes);
+
+/**
+ * @brief Opens a cursor on a database. The provider keeps the underlying
+ * iterator open between calls to sdskv_cursor_next, so a scan does not
+ * have to look up its starting point for every page, and it fetches the
+ * next page while the current one is being sent. The cursor lists the
+ * same entries as sdskv_list_keyvals_with_prefix (keys strictly after
+ * start_key and starting with prefix). If the cursor is not used for
+ * more than lease_ms milliseconds, the provider closes it and further
+ * calls to sdskv_cursor_next fail with SDSKV_ERR_UNKNOWN_CURSOR.
+ * The cursor must be closed with sdskv_cursor_close.
+ *
+ * @param[in] provider provider handle
+ * @param[in] db_id database id
+ * @param[in] start_key starting key (excluded, may be NULL)
+ * @param[in] start_ksize size of the starting key
+ * @param[in] prefix prefix of the keys to list (may be NULL)
+ * @param[in] prefix_size size of the prefix
+ * @param[in] lease_ms lease in milliseconds (0 for the provider's default)
+ * @param[out] cursor resulting cursor
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_cursor_open(
+        sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id,
+        const void *start_key,
+        hg_size_t start_ksize,
+        const void *prefix,
+        hg_size_t prefix_size,
+        uint32_t lease_ms,
+        sdskv_cursor_t* cursor);
+
+/**
+ * @brief Gets the next entries of a cursor. The buffers are handled
+ * as in sdskv_list_keyvals. After a successful call, *max_items is set
+ * to the number of entries returned; fewer entries than requested means
+ * that the end of the scan has been reached. If the call fails with
+ * SDSKV_ERR_SIZE, ksizes and vsizes hold the required sizes and the
+ * same entries are returned by the next call.
+ *
+ * @param[in] cursor cursor
+ * @param[out] keys array of buffers to hold returned keys
+ * @param[inout] ksizes array of key sizes
+ * @param[out] values array of buffers to hold returned values
+ * @param[inout] vsizes array of value sizes
+ * @param[inout] max_items max items requested
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_cursor_next(
+        sdskv_cursor_t cursor,
+        void **keys,
+        hg_size_t* ksizes,
+        void **values,
+        hg_size_t* vsizes,
+        hg_size_t* max_items);
+
+/**
+ * @brief Closes a cursor and releases its resources on the provider.
+ * The cursor handle is freed even if the provider could not be reached.
+ *
+ * @param[in] cursor cursor
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_cursor_close(sdskv_cursor_t cursor);
+
+/**
+ * @brief The following functions are non-blocking versions of
+ * sdskv_put, sdskv_put_multi, sdskv_get, sdskv_get_multi,
+ * sdskv_exists, sdskv_length and sdskv_erase. They take the
+ * same arguments and return as soon as the RPC has been sent,
+ * setting *req to a request that must be completed with
+ * sdskv_wait or sdskv_wait_any. The outputs (values, sizes,
+ * flags) are only written at completion, and the buffers passed
+ * to the function (keys, values, sizes) must remain valid until
+ * then. Contrary to their blocking counterparts, sdskv_get_async
+ * and sdskv_get_multi_async do not accept NULL values.
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ * if the operation could not be started (in which case no request
+ * is created).
+ */
+int sdskv_put_async(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id,
+        const void *key, hg_size_t ksize,
+        const void *value, hg_size_t vsize,
+        sdskv_request_t* req);
+
+int sdskv_put_multi_async(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id,
+        size_t num, const void* const* keys, const hg_size_t* ksizes,
+        const void* const* values, const hg_size_t *vsizes,
+        sdskv_request_t* req);
+
+int sdskv_get_async(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id,
+        const void *key, hg_size_t ksize,
+        void *value, hg_size_t* vsize,
+        sdskv_request_t* req);
+
+int sdskv_get_multi_async(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id,
+        size_t num, const void* const* keys, const hg_size_t* ksizes,
+        void** values, hg_size_t *vsizes,
+        sdskv_request_t* req);
+
+int sdskv_exists_async(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id, const void *key,
+        hg_size_t ksize, int* flag,
+        sdskv_request_t* req);
+
+int sdskv_length_async(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id, const void *key,
+        hg_size_t ksize, hg_size_t* vsize,
+        sdskv_request_t* req);
+
+int sdskv_erase_async(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id, const void *key,
+        hg_size_t ksize,
+        sdskv_request_t* req);
+
+/**
+ * @brief Waits for a request to complete and frees it.
+ *
+ * @param[in] req request
+ *
+ * @return the result of the operation (SDSKV_SUCCESS or error code
+ * defined in sdskv-common.h).
+ */
+int sdskv_wait(sdskv_request_t req);
+
+/**
+ * @brief Checks whether a request has completed, without blocking.
+ * The request must still be completed with sdskv_wait, which will
+ * then return immediately if *flag was set to 1.
+ *
+ * @param[in] req request
+ * @param[out] flag set to 1 if the request has completed, 0 otherwise
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_test(sdskv_request_t req, int* flag);
+
+/**
+ * @brief Waits for any of the given requests to complete. The
+ * completed request is freed and its entry in the array is set
+ * to SDSKV_REQUEST_NULL. Entries that are SDSKV_REQUEST_NULL
+ * are ignored; if all of them are, *index is set to count.
+ *
+ * @param[in] count number of requests
+ * @param[inout] reqs array of requests
+ * @param[out] index index of the request that completed
+ *
+ * @return the result of the completed operation (SDSKV_SUCCESS
+ * or error code defined in sdskv-common.h).
+ */
+int sdskv_wait_any(size_t count, sdskv_request_t* reqs, size_t* index);
+
 /**
  * @brief Migrates a set of keys/values from a source provider/database
  * to a target provider/database.
@@ -5,6 +5,10 @@
 #include <stdexcept>
 #include <vector>
 #include <string>
+#include <cstring>
+#include <cstdlib>
+#include <memory>
+#include <functional>
 #include <sdskv-client.h>
 #include <sdskv-common.hpp>
 
@@ -61,6 +65,203 @@ inline void object_resize(std::string& s, size_t new_size) {
 
 class provider_handle;
 class database;
+class cursor;
+class write_batch;
+
+/**
+ * @brief The packed_keyvals class holds the result of list_keys_packed
+ * or list_keyvals_packed: a single buffer received from the provider,
+ * and tables giving the location of each key (and value) in it.
+ * Iterating over a packed_keyvals object yields entry objects.
+ */
+class packed_keyvals {
+
+    friend class client;
+
+    std::vector<char>        m_buffer;
+    std::vector<const void*> m_keys;
+    std::vector<hg_size_t>   m_ksizes;
+    std::vector<const void*> m_values;
+    std::vector<hg_size_t>   m_vsizes;
+
+    public:
+
+    packed_keyvals() = default;
+
+    /* the tables point into m_buffer, hence the object can only be moved */
+    packed_keyvals(const packed_keyvals&) = delete;
+    packed_keyvals& operator=(const packed_keyvals&) = delete;
+    packed_keyvals(packed_keyvals&&) = default;
+    packed_keyvals& operator=(packed_keyvals&&) = default;
+
+    /**
+     * @brief Key/value pair pointing into the packed buffer.
+     * value is null if the values were not requested.
+     */
+    struct entry {
+        const char* key;
+        hg_size_t   ksize;
+        const char* value;
+        hg_size_t   vsize;
+
+        template<typename K = std::string>
+        K key_as() const {
+            K k; object_resize(k, ksize);
+            std::memcpy(object_data(k), key, ksize);
+            return k;
+        }
+
+        template<typename V = std::string>
+        V value_as() const {
+            V v; object_resize(v, vsize);
+            std::memcpy(object_data(v), value, vsize);
+            return v;
+        }
+    };
+
+    class const_iterator {
+
+        const packed_keyvals* m_pk;
+        size_t                m_index;
+
+        public:
+
+        const_iterator(const packed_keyvals* pk, size_t index)
+        : m_pk(pk), m_index(index) {}
+
+        entry operator*() const { return (*m_pk)[m_index]; }
+        const_iterator& operator++() { m_index += 1; return *this; }
+        bool operator==(const const_iterator& other) const { return m_index == other.m_index; }
+        bool operator!=(const const_iterator& other) const { return m_index != other.m_index; }
+    };
+
+    size_t size() const { return m_keys.size(); }
+
+    bool empty() const { return m_keys.empty(); }
+
+    entry operator[](size_t i) const {
+        if(m_values.empty())
+            return entry{ (const char*)m_keys[i], m_ksizes[i], nullptr, 0 };
+        return entry{ (const char*)m_keys[i], m_ksizes[i],
+                      (const char*)m_values[i], m_vsizes[i] };
+    }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+
+    const_iterator end() const { return const_iterator(this, size()); }
+};
+
+/**
+ * @brief The async_request class is the C++ equivalent of a C
+ * sdskv_request_t, returned by the *_async methods of client. Like a
+ * std::future<void>, wait() blocks until the operation has completed
+ * and throws an exception if it failed, after which the outputs of the
+ * operation are available. The buffers passed to the operation must
+ * remain valid until then. Destroying a pending request waits for it
+ * and ignores its result.
+ */
+class async_request {
+
+    friend class client;
+
+    sdskv_request_t              m_req = SDSKV_REQUEST_NULL;
+    std::unique_ptr<hg_size_t[]> m_sizes; // sizes written at completion
+    std::unique_ptr<int[]>       m_flags; // flags written at completion
+    std::function<void()>        m_on_completion;
+
+    void complete(int ret) {
+        _CHECK_RET(ret);
+        if(m_on_completion) m_on_completion();
+    }
+
+    void release() {
+        if(m_req != SDSKV_REQUEST_NULL) sdskv_wait(m_req);
+        m_req = SDSKV_REQUEST_NULL;
+    }
+
+    public:
+
+    async_request() = default;
+
+    async_request(const async_request&) = delete;
+    async_request& operator=(const async_request&) = delete;
+
+    async_request(async_request&& other)
+    : m_req(other.m_req)
+    , m_sizes(std::move(other.m_sizes))
+    , m_flags(std::move(other.m_flags))
+    , m_on_completion(std::move(other.m_on_completion)) {
+        other.m_req = SDSKV_REQUEST_NULL;
+    }
+
+    async_request& operator=(async_request&& other) {
+        if(this == &other) return *this;
+        release();
+        m_req           = other.m_req;
+        m_sizes         = std::move(other.m_sizes);
+        m_flags         = std::move(other.m_flags);
+        m_on_completion = std::move(other.m_on_completion);
+        other.m_req     = SDSKV_REQUEST_NULL;
+        return *this;
+    }
+
+    ~async_request() {
+        release();
+    }
+
+    /**
+     * @brief Returns true if the request has not been waited on yet.
+     */
+    bool valid() const {
+        return m_req != SDSKV_REQUEST_NULL;
+    }
+
+    /**
+     * @brief Returns true if the operation has completed, without blocking.
+     * wait() must still be called to get its result.
+     */
+    bool test() const {
+        int flag = 0;
+        int ret = sdskv_test(m_req, &flag);
+        _CHECK_RET(ret);
+        return flag;
+    }
+
+    /**
+     * @brief Waits for the operation to complete. Throws an exception
+     * if the operation failed.
+     */
+    void wait() {
+        int ret = sdskv_wait(m_req);
+        m_req = SDSKV_REQUEST_NULL;
+        complete(ret);
+    }
+
+    /**
+     * @brief Waits for any of the given requests to complete (requests
+     * that are not valid are ignored). Throws an exception if the
+     * operation that completed failed.
+     *
+     * @param reqs Requests.
+     *
+     * @return the index of the request that completed, or reqs.size()
+     * if none of the requests was valid.
+     */
+    static size_t wait_any(std::vector<async_request>& reqs) {
+        std::vector<sdskv_request_t> r(reqs.size());
+        for(size_t i=0; i < reqs.size(); i++)
+            r[i] = reqs[i].m_req;
+        size_t index = reqs.size();
+        int ret = sdskv_wait_any(r.size(), r.data(), &index);
+        if(index >= reqs.size()) {
+            _CHECK_RET(ret);
+            return reqs.size();
+        }
+        reqs[index].m_req = SDSKV_REQUEST_NULL;
+        reqs[index].complete(ret);
+        return index;
+    }
+};
 
 /**
  * @brief The sdskv::client class is the C++ equivalent of a C sdskv_client_t.
@@ -165,6 +366,51 @@ class client {
         return m_client != SDSKV_CLIENT_NULL;
     }
 
+    /**
+     * @brief Sets the largest payload sent inline with an RPC rather
+     * than through a bulk transfer (see sdskv_client_set_eager_size).
+     *
+     * @param size Eager size in bytes (0 to use the transport's default).
+     */
+    void set_eager_size(hg_size_t size) const {
+        int ret = sdskv_client_set_eager_size(m_client, size);
+        _CHECK_RET(ret);
+    }
+
+    /**
+     * @brief Returns the eager size currently used by the client.
+     */
+    hg_size_t eager_size() const {
+        hg_size_t size = 0;
+        int ret = sdskv_client_get_eager_size(m_client, &size);
+        _CHECK_RET(ret);
+        return size;
+    }
+
+    /**
+     * @brief Enables caching of the bulk registrations of user buffers
+     * (see sdskv_client_set_bulk_cache_size). Buffers that may be cached
+     * must be passed to invalidate_bulk_cache before being freed.
+     *
+     * @param max_entries Maximum number of cached registrations (0 to disable).
+     */
+    void set_bulk_cache_size(size_t max_entries) const {
+        int ret = sdskv_client_set_bulk_cache_size(m_client, max_entries);
+        _CHECK_RET(ret);
+    }
+
+    /**
+     * @brief Removes the cached registrations of the buffers overlapping
+     * the given memory region, or all of them if buffer is nullptr.
+     *
+     * @param buffer Start of the memory region.
+     * @param size Size of the memory region.
+     */
+    void invalidate_bulk_cache(const void* buffer = nullptr, hg_size_t size = 0) const {
+        int ret = sdskv_client_bulk_cache_invalidate(m_client, buffer, size);
+        _CHECK_RET(ret);
+    }
+
     /**
      * @brief Open a database held by a given provider.
      *
@@ -592,8 +838,13 @@ class client {
              const K& key, V& value) const {
         hg_size_t s = value.size();
         if(s == 0) {
-            s = length(db, key);
+            // size unknown: let the provider size the value in one RPC
+            void* data = nullptr;
+            get_alloc(db, object_data(key), object_size(key), &data, &s);
+            std::unique_ptr<void, void(*)(void*)> guard(data, free);
             object_resize(value, s);
+            if(s) std::memcpy(object_data(value), data, s);
+            return true;
         }
         try {
             get(db, object_data(key), object_size(key), object_data(value), &s);
@@ -629,6 +880,40 @@ class client {
         return value;
     }
 
+    //////////////////////////
+    // GET_ALLOC methods
+    //////////////////////////
+
+    /**
+     * @brief Equivalent to sdskv_get_alloc. The value must be freed
+     * by the caller using free().
+     *
+     * @param db Database instance.
+     * @param key Key.
+     * @param ksize Size of the key.
+     * @param value Set to the newly allocated value.
+     * @param vsize Set to the size of the value.
+     */
+    bool get_alloc(const database& db,
+             const void* key, hg_size_t ksize,
+             void** value, hg_size_t* vsize) const;
+
+    /**
+     * @brief Equivalent to sdskv_get_packed_alloc. The packed values
+     * must be freed by the caller using free().
+     *
+     * @param db Database instance.
+     * @param count Number of keys.
+     * @param packed_keys Packed keys.
+     * @param ksizes Array of key sizes.
+     * @param packed_values Set to the newly allocated packed values.
+     * @param vsizes Array receiving the sizes of the values
+     * ((hg_size_t)(-1) for missing keys).
+     */
+    bool get_packed_alloc(const database& db,
+             hg_size_t count, const void* packed_keys, const hg_size_t* ksizes,
+             void** packed_values, hg_size_t* vsizes) const;
+
     //////////////////////////
     // GET_MULTI methods
     //////////////////////////
@@ -756,13 +1041,27 @@ class client {
             const database& db,
             const std::vector<K>& keys) {
         hg_size_t num = keys.size();
-        std::vector<hg_size_t> vsizes(num);
-        length_multi(db, keys, vsizes);
         std::vector<V> values(num);
+        if(num == 0) return values;
+        std::vector<hg_size_t> ksizes(num);
+        std::vector<hg_size_t> vsizes(num);
+        std::vector<char> packed_keys;
+        for(unsigned i=0; i < num; i++) {
+            ksizes[i] = object_size(keys[i]);
+            const char* k = (const char*)object_data(keys[i]);
+            packed_keys.insert(packed_keys.end(), k, k+ksizes[i]);
+        }
+        void* packed_values = nullptr;
+        get_packed_alloc(db, num, packed_keys.data(), ksizes.data(), &packed_values, vsizes.data());
+        std::unique_ptr<void, void(*)(void*)> guard(packed_values, free);
+        const char* v = (const char*)packed_values;
         for(unsigned i=0 ; i < num; i++) {
+            // values of missing keys are left empty
+            if(vsizes[i] == (hg_size_t)(-1)) continue;
             object_resize(values[i], vsizes[i]);
+            if(vsizes[i]) std::memcpy(object_data(values[i]), v, vsizes[i]);
+            v += vsizes[i];
         }
-        get_multi(db, keys, values);
         return values;
     }
 
@@ -1117,96 +1416,336 @@ class client {
     }
 
     //////////////////////////
-    // MIGRATE_KEYS methods
+    // LIST_*_RANGE methods
     //////////////////////////
-    
-    /**
-     * @brief Migrates a given set of keys from a source to a destination database.
-     *
-     * @param source_db Source database.
-     * @param dest_db Destination database.
-     * @param num_items Number of items
-     * @param keys Array of keys.
-     * @param key_sizes Array of key sizes.
-     * @param flag SDSKV_KEEP_ORIGINAL or SDSKV_REMOVE_ORIGINAL.
-     */
-    void migrate(const database& source_db, const database& dest_db,
-            hg_size_t num_items, const void* const* keys, const hg_size_t* key_sizes,
-            int flag = SDSKV_KEEP_ORIGINAL) const;
 
     /**
-     * @brief Migrates a given set of keys from a source to a destination database.
+     * @brief Equivalent to sdskv_list_keys_range.
      *
-     * @param source_db Source database.
-     * @param dest_db Destination database.
-     * @param keys Array of keys.
-     * @param ksizes Array of key sizes.
-     * @param flag SDSKV_KEEP_ORIGINAL or SDSKV_REMOVE_ORIGINAL.
+     * @param db Database instance.
+     * @param lower_bound Lower bound (included).
+     * @param lower_bound_size Lower bound size.
+     * @param upper_bound Upper bound (excluded, empty for no bound).
+     * @param upper_bound_size Upper bound size.
+     * @param keys Resulting key buffers.
+     * @param ksizes Resulting key buffer sizes.
+     * @param max_keys Max number of keys.
      */
-    inline void migrate(const database& source_db, const database& dest_db,
-            const std::vector<const void*> keys, 
-            const std::vector<hg_size_t> ksizes,
-            int flag = SDSKV_KEEP_ORIGINAL) const {
-        if(keys.size() != ksizes.size()) {
-            throw std::length_error("Provided vectors should have the same size");
-        }
-        migrate(source_db, dest_db, keys.size(), keys.data(), ksizes.data(), flag);
-    }
+    void list_keys_range(const database& db,
+            const void *lower_bound, hg_size_t lower_bound_size,
+            const void *upper_bound, hg_size_t upper_bound_size,
+            void** keys, hg_size_t* ksizes, hg_size_t* max_keys) const;
 
     /**
-     * @brief Migrate a set of keys from a source to a destination database.
+     * @brief List the keys in [lower_bound, upper_bound).
+     * At most keys.size() keys are returned.
      *
      * @tparam K Key type.
-     * @param source_db Source database.
-     * @param dest_db Destination database.
-     * @param keys Vector of keys.
-     * @param flag SDSKV_KEEP_ORIGINAL or SDSKV_REMOVE_ORIGINAL.
+     * @param db Database instance.
+     * @param lower_bound Lower bound (included).
+     * @param upper_bound Upper bound (excluded).
+     * @param keys Resulting keys.
      */
     template<typename K>
-    inline void migrate(const database& source_db, const database& dest_db,
-            const std::vector<K> keys, int flag = SDSKV_KEEP_ORIGINAL) const {
+    inline void list_keys_range(const database& db,
+                const K& lower_bound,
+                const K& upper_bound,
+                std::vector<K>& keys) const {
+        hg_size_t max_keys = keys.size();
+        if(max_keys == 0) return;
+        std::vector<void*> kdata; kdata.reserve(keys.size());
         std::vector<hg_size_t> ksizes; ksizes.reserve(keys.size());
-        std::vector<const void*> kdata; kdata.reserve(keys.size());
-        for(const auto& k : keys) {
-            ksizes.push_back(object_size(k));
+        for(auto& k : keys) {
             kdata.push_back(object_data(k));
+            ksizes.push_back(object_size(k));
         }
-        migrate(source_db, dest_db,
-                kdata, ksizes, flag);
+        try {
+            list_keys_range(db, object_data(lower_bound), object_size(lower_bound),
+                object_data(upper_bound), object_size(upper_bound),
+                kdata.data(), ksizes.data(), &max_keys);
+        } catch(exception& e) {
+            if(e.error() == SDSKV_ERR_SIZE && object_size(keys[0]) == 0) {
+                for(unsigned i=0; i < max_keys; i++) {
+                    object_resize(keys[i], ksizes[i]);
+                    kdata[i] = object_data(keys[i]);
+                }
+                list_keys_range(db, object_data(lower_bound), object_size(lower_bound),
+                        object_data(upper_bound), object_size(upper_bound),
+                        kdata.data(), ksizes.data(), &max_keys);
+            } else {
+                throw;
+            }
+        }
+        for(unsigned i=0; i < max_keys; i++) {
+            object_resize(keys[i], ksizes[i]);
+        }
+        keys.resize(max_keys);
     }
 
     /**
-     * @brief Migrate a range of keys.
-     *
-     * @param source_db Source database.
-     * @param dest_db Destination database.
-     * @param key_range[2] Key range ] lb; ub [
-     * @param key_sizes[2] Key sizes
-     * @param flag SDSKV_KEEP_ORIGINAL or SDSKV_REMOVE_ORIGINAL.
+     * @brief Same as list_keys_range but also returns the values.
      */
-    void migrate(const database& source_db, const database& dest_db,
-            const void* key_range[2], const hg_size_t key_sizes[2],
-            int flag = SDSKV_KEEP_ORIGINAL) const;
+    void list_keyvals_range(const database& db,
+            const void *lower_bound, hg_size_t lower_bound_size,
+            const void *upper_bound, hg_size_t upper_bound_size,
+            void** keys, hg_size_t* ksizes,
+            void** values, hg_size_t* vsizes,
+            hg_size_t* max_items) const;
 
     /**
-     * @brief Migrate a range of keys.
-     *
-     * @tparam K Key type.
-     * @param source_db Source database.
-     * @param dest_db Destination database.
-     * @param key_range Key range ] lb; ub [.
-     * @param flag SDSKV_KEEP_ORIGINAL or SDSKV_REMOVE_ORIGINAL.
+     * @brief Same as list_keys_range but also returns the values.
      */
-    template<typename K>
-    inline void migrate(const database& source_db, const database& dest_db,
-                 const std::pair<K,K>& key_range,
-                 int flag = SDSKV_KEEP_ORIGINAL) const {
-        const void* key_range_arr[2] = { object_data(key_range.first), object_data(key_range.second) };
-        const hg_size_t key_sizes_arr[2] = { object_size(key_range.first), object_size(key_range.second) };
-        migrate(source_db, dest_db, key_range_arr, key_sizes_arr, flag);
+    template<typename K, typename V>
+    inline void list_keyvals_range(const database& db,
+                const K& lower_bound,
+                const K& upper_bound,
+                std::vector<K>& keys,
+                std::vector<V>& values) const {
+
+        hg_size_t max_keys = std::min(keys.size(), values.size());
+        if(max_keys == 0) return;
+        std::vector<void*> kdata; kdata.reserve(keys.size());
+        std::vector<hg_size_t> ksizes; ksizes.reserve(keys.size());
+        std::vector<void*> vdata; vdata.reserve(values.size());
+        std::vector<hg_size_t> vsizes; vsizes.reserve(values.size());
+        for(auto& k : keys) {
+            kdata.push_back(object_data(k));
+            ksizes.push_back(object_size(k));
+        }
+        for(auto& v : values) {
+            vdata.push_back(object_data(v));
+            vsizes.push_back(object_size(v));
+        }
+        try {
+            list_keyvals_range(db, object_data(lower_bound), object_size(lower_bound),
+                object_data(upper_bound), object_size(upper_bound),
+                kdata.data(), ksizes.data(),
+                vdata.data(), vsizes.data(), &max_keys);
+        } catch(exception& e) {
+            if(e.error() == SDSKV_ERR_SIZE) {
+                for(unsigned i=0; i < max_keys; i++) {
+                    object_resize(keys[i], ksizes[i]);
+                    kdata[i] = object_data(keys[i]);
+                    object_resize(values[i], vsizes[i]);
+                    vdata[i] = object_data(values[i]);
+                }
+                list_keyvals_range(db, object_data(lower_bound), object_size(lower_bound),
+                        object_data(upper_bound), object_size(upper_bound),
+                        kdata.data(), ksizes.data(),
+                        vdata.data(), vsizes.data(), &max_keys);
+            } else {
+                throw;
+            }
+        }
+        for(unsigned i=0; i < max_keys; i++) {
+            object_resize(keys[i], ksizes[i]);
+            object_resize(values[i], vsizes[i]);
+        }
+        keys.resize(max_keys);
+        values.resize(max_keys);
     }
 
-    /**
+    //////////////////////////
+    // LIST_*_PACKED methods
+    //////////////////////////
+
+    /**
+     * @brief Equivalent to sdskv_list_keys_packed.
+     *
+     * @param db Database instance.
+     * @param start_key Starting key (excluded from results).
+     * @param start_ksize Starting key size.
+     * @param prefix Prefix.
+     * @param prefix_size Prefix size.
+     * @param packed_data Buffer receiving the packed keys.
+     * @param packed_data_size Size of the buffer (set to the size used).
+     * @param keys Resulting pointers to the keys.
+     * @param ksizes Resulting key sizes.
+     * @param max_keys Max number of keys.
+     */
+    void list_keys_packed(const database& db,
+            const void *start_key, hg_size_t start_ksize,
+            const void *prefix, hg_size_t prefix_size,
+            void* packed_data, hg_size_t* packed_data_size,
+            const void** keys, hg_size_t* ksizes, hg_size_t* max_keys) const;
+
+    /**
+     * @brief Equivalent to sdskv_list_keyvals_packed.
+     */
+    void list_keyvals_packed(const database& db,
+            const void *start_key, hg_size_t start_ksize,
+            const void *prefix, hg_size_t prefix_size,
+            void* packed_data, hg_size_t* packed_data_size,
+            const void** keys, hg_size_t* ksizes,
+            const void** values, hg_size_t* vsizes,
+            hg_size_t* max_items) const;
+
+    /**
+     * @brief Lists at most max_keys keys following start_key (excluded)
+     * and starting with prefix, received in a single buffer of at most
+     * buffer_size bytes (0 for max_keys means no limit other than
+     * buffer_size). If the first key does not fit, the buffer is
+     * enlarged to hold it.
+     *
+     * @tparam K Key type.
+     * @param db Database instance.
+     * @param start_key Start key.
+     * @param prefix Prefix.
+     * @param max_keys Max number of keys.
+     * @param buffer_size Size of the buffer.
+     *
+     * @return the packed keys.
+     */
+    template<typename K>
+    inline packed_keyvals list_keys_packed(const database& db,
+                const K& start_key, const K& prefix,
+                hg_size_t max_keys, hg_size_t buffer_size) const {
+        return list_packed(db, object_data(start_key), object_size(start_key),
+                object_data(prefix), object_size(prefix), false, max_keys, buffer_size);
+    }
+
+    /**
+     * @brief Same as list_keys_packed but also returns the values.
+     */
+    template<typename K>
+    inline packed_keyvals list_keyvals_packed(const database& db,
+                const K& start_key, const K& prefix,
+                hg_size_t max_items, hg_size_t buffer_size) const {
+        return list_packed(db, object_data(start_key), object_size(start_key),
+                object_data(prefix), object_size(prefix), true, max_items, buffer_size);
+    }
+
+    /**
+     * @brief Lists as many keys following start_key (excluded) and
+     * starting with prefix as fit in buffer_size bytes (see
+     * sdskv_list_keys_budget). If the first key does not fit, the
+     * buffer is enlarged to hold it.
+     *
+     * @tparam K Key type.
+     * @param db Database instance.
+     * @param start_key Start key.
+     * @param prefix Prefix.
+     * @param buffer_size Byte budget.
+     *
+     * @return the packed keys.
+     */
+    template<typename K>
+    inline packed_keyvals list_keys_budget(const database& db,
+                const K& start_key, const K& prefix, hg_size_t buffer_size) const {
+        return list_packed(db, object_data(start_key), object_size(start_key),
+                object_data(prefix), object_size(prefix), false, 0, buffer_size);
+    }
+
+    /**
+     * @brief Same as list_keys_budget but also returns the values.
+     */
+    template<typename K>
+    inline packed_keyvals list_keyvals_budget(const database& db,
+                const K& start_key, const K& prefix, hg_size_t buffer_size) const {
+        return list_packed(db, object_data(start_key), object_size(start_key),
+                object_data(prefix), object_size(prefix), true, 0, buffer_size);
+    }
+
+    private:
+
+    packed_keyvals list_packed(const database& db,
+            const void* start_key, hg_size_t start_ksize,
+            const void* prefix, hg_size_t prefix_size,
+            bool with_values, hg_size_t max_items, hg_size_t buffer_size) const;
+
+    public:
+
+    //////////////////////////
+    // MIGRATE_KEYS methods
+    //////////////////////////
+    
+    /**
+     * @brief Migrates a given set of keys from a source to a destination database.
+     *
+     * @param source_db Source database.
+     * @param dest_db Destination database.
+     * @param num_items Number of items
+     * @param keys Array of keys.
+     * @param key_sizes Array of key sizes.
+     * @param flag SDSKV_KEEP_ORIGINAL or SDSKV_REMOVE_ORIGINAL.
+     */
+    void migrate(const database& source_db, const database& dest_db,
+            hg_size_t num_items, const void* const* keys, const hg_size_t* key_sizes,
+            int flag = SDSKV_KEEP_ORIGINAL) const;
+
+    /**
+     * @brief Migrates a given set of keys from a source to a destination database.
+     *
+     * @param source_db Source database.
+     * @param dest_db Destination database.
+     * @param keys Array of keys.
+     * @param ksizes Array of key sizes.
+     * @param flag SDSKV_KEEP_ORIGINAL or SDSKV_REMOVE_ORIGINAL.
+     */
+    inline void migrate(const database& source_db, const database& dest_db,
+            const std::vector<const void*> keys, 
+            const std::vector<hg_size_t> ksizes,
+            int flag = SDSKV_KEEP_ORIGINAL) const {
+        if(keys.size() != ksizes.size()) {
+            throw std::length_error("Provided vectors should have the same size");
+        }
+        migrate(source_db, dest_db, keys.size(), keys.data(), ksizes.data(), flag);
+    }
+
+    /**
+     * @brief Migrate a set of keys from a source to a destination database.
+     *
+     * @tparam K Key type.
+     * @param source_db Source database.
+     * @param dest_db Destination database.
+     * @param keys Vector of keys.
+     * @param flag SDSKV_KEEP_ORIGINAL or SDSKV_REMOVE_ORIGINAL.
+     */
+    template<typename K>
+    inline void migrate(const database& source_db, const database& dest_db,
+            const std::vector<K> keys, int flag = SDSKV_KEEP_ORIGINAL) const {
+        std::vector<hg_size_t> ksizes; ksizes.reserve(keys.size());
+        std::vector<const void*> kdata; kdata.reserve(keys.size());
+        for(const auto& k : keys) {
+            ksizes.push_back(object_size(k));
+            kdata.push_back(object_data(k));
+        }
+        migrate(source_db, dest_db,
+                kdata, ksizes, flag);
+    }
+
+    /**
+     * @brief Migrate a range of keys.
+     *
+     * @param source_db Source database.
+     * @param dest_db Destination database.
+     * @param key_range[2] Key range ] lb; ub [
+     * @param key_sizes[2] Key sizes
+     * @param flag SDSKV_KEEP_ORIGINAL or SDSKV_REMOVE_ORIGINAL.
+     */
+    void migrate(const database& source_db, const database& dest_db,
+            const void* key_range[2], const hg_size_t key_sizes[2],
+            int flag = SDSKV_KEEP_ORIGINAL) const;
+
+    /**
+     * @brief Migrate a range of keys.
+     *
+     * @tparam K Key type.
+     * @param source_db Source database.
+     * @param dest_db Destination database.
+     * @param key_range Key range ] lb; ub [.
+     * @param flag SDSKV_KEEP_ORIGINAL or SDSKV_REMOVE_ORIGINAL.
+     */
+    template<typename K>
+    inline void migrate(const database& source_db, const database& dest_db,
+                 const std::pair<K,K>& key_range,
+                 int flag = SDSKV_KEEP_ORIGINAL) const {
+        const void* key_range_arr[2] = { object_data(key_range.first), object_data(key_range.second) };
+        const hg_size_t key_sizes_arr[2] = { object_size(key_range.first), object_size(key_range.second) };
+        migrate(source_db, dest_db, key_range_arr, key_sizes_arr, flag);
+    }
+
+    /**
      * @brief Migrate keys with a prefix.
      *
      * @param source_db Source database.
@@ -1262,6 +1801,209 @@ class client {
             const std::string& dest_root,
             int flag = SDSKV_KEEP_ORIGINAL) const;
 
+    //////////////////////////
+    // ASYNC methods
+    //////////////////////////
+
+    /**
+     * @brief Equivalent to sdskv_put_async.
+     *
+     * @param db Database instance.
+     * @param key Key.
+     * @param ksize Size of the key in bytes.
+     * @param value Value.
+     * @param vsize Size of the value in bytes.
+     *
+     * @return a request to wait on.
+     */
+    async_request put_async(const database& db,
+             const void *key, hg_size_t ksize,
+             const void *value, hg_size_t vsize) const;
+
+    /**
+     * @brief Templated version of put_async, meant to work with
+     * std::vector<X> and std::string. The key and value must remain
+     * valid until the request has completed.
+     *
+     * @tparam K Key type.
+     * @tparam V Value type.
+     * @param db Database instance.
+     * @param key Key.
+     * @param value Value.
+     *
+     * @return a request to wait on.
+     */
+    template<typename K, typename V>
+    inline async_request put_async(const database& db,
+             const K& key, const V& value) const {
+        return put_async(db, object_data(key), object_size(key), object_data(value), object_size(value));
+    }
+
+    /**
+     * @brief Equivalent to sdskv_put_multi_async.
+     *
+     * @param db Database instance.
+     * @param count Number of key/val pairs.
+     * @param keys Array of keys.
+     * @param ksizes Array of key sizes.
+     * @param values Array of values.
+     * @param vsizes Array of value sizes.
+     *
+     * @return a request to wait on.
+     */
+    async_request put_multi_async(const database& db,
+             hg_size_t count, const void* const* keys, const hg_size_t* ksizes,
+             const void* const* values, const hg_size_t *vsizes) const;
+
+    /**
+     * @brief Equivalent to sdskv_get_async.
+     *
+     * @param db Database instance.
+     * @param key Key.
+     * @param ksize Size of the key.
+     * @param value Buffer allocated for the value.
+     * @param vsize Size of the value buffer (in), size of the value (out).
+     *
+     * @return a request to wait on.
+     */
+    async_request get_async(const database& db,
+             const void* key, hg_size_t ksize,
+             void* value, hg_size_t* vsize) const;
+
+    /**
+     * @brief Templated version of get_async, meant to be used with
+     * std::vector<X> and std::string. value must already be large
+     * enough to hold the value, and is resized to the actual size
+     * of the value when the request completes.
+     *
+     * @tparam K Key type.
+     * @tparam V Value type.
+     * @param db Database instance.
+     * @param key Key.
+     * @param value Value.
+     *
+     * @return a request to wait on.
+     */
+    template<typename K, typename V>
+    inline async_request get_async(const database& db,
+             const K& key, V& value) const {
+        std::unique_ptr<hg_size_t[]> vsize(new hg_size_t[1]);
+        vsize[0] = object_size(value);
+        async_request req = get_async(db, object_data(key), object_size(key),
+                object_data(value), vsize.get());
+        hg_size_t* s = vsize.get();
+        req.m_sizes = std::move(vsize);
+        req.m_on_completion = [&value, s]() { object_resize(value, *s); };
+        return req;
+    }
+
+    /**
+     * @brief Equivalent to sdskv_get_multi_async.
+     *
+     * @param db Database instance.
+     * @param count Number of key/val pairs.
+     * @param keys Array of keys.
+     * @param ksizes Array of key sizes.
+     * @param values Array of value buffers.
+     * @param vsizes Array of sizes of value buffers.
+     *
+     * @return a request to wait on.
+     */
+    async_request get_multi_async(const database& db,
+             hg_size_t count, const void* const* keys, const hg_size_t* ksizes,
+             void** values, hg_size_t *vsizes) const;
+
+    /**
+     * @brief Equivalent to sdskv_exists_async.
+     *
+     * @param db Database instance.
+     * @param key Key.
+     * @param ksize Size of the key.
+     * @param flag Set to 1 if the key exists, 0 otherwise.
+     *
+     * @return a request to wait on.
+     */
+    async_request exists_async(const database& db,
+             const void* key, hg_size_t ksize, int* flag) const;
+
+    /**
+     * @brief Templated version of exists_async.
+     *
+     * @tparam K Key type.
+     * @param db Database instance.
+     * @param key Key.
+     * @param flag Set to whether the key exists when the request completes.
+     *
+     * @return a request to wait on.
+     */
+    template<typename K>
+    inline async_request exists_async(const database& db,
+             const K& key, bool& flag) const {
+        std::unique_ptr<int[]> f(new int[1]);
+        f[0] = 0;
+        async_request req = exists_async(db, object_data(key), object_size(key), f.get());
+        int* p = f.get();
+        req.m_flags = std::move(f);
+        req.m_on_completion = [&flag, p]() { flag = *p; };
+        return req;
+    }
+
+    /**
+     * @brief Equivalent to sdskv_length_async.
+     *
+     * @param db Database instance.
+     * @param key Key.
+     * @param ksize Size of the key.
+     * @param vsize Set to the size of the value.
+     *
+     * @return a request to wait on.
+     */
+    async_request length_async(const database& db,
+             const void* key, hg_size_t ksize, hg_size_t* vsize) const;
+
+    /**
+     * @brief Templated version of length_async.
+     *
+     * @tparam K Key type.
+     * @param db Database instance.
+     * @param key Key.
+     * @param vsize Set to the size of the value when the request completes.
+     *
+     * @return a request to wait on.
+     */
+    template<typename K>
+    inline async_request length_async(const database& db,
+             const K& key, hg_size_t& vsize) const {
+        return length_async(db, object_data(key), object_size(key), &vsize);
+    }
+
+    /**
+     * @brief Equivalent to sdskv_erase_async.
+     *
+     * @param db Database instance.
+     * @param key Key.
+     * @param ksize Size of the key.
+     *
+     * @return a request to wait on.
+     */
+    async_request erase_async(const database& db,
+             const void* key, hg_size_t ksize) const;
+
+    /**
+     * @brief Templated version of erase_async.
+     *
+     * @tparam K Key type.
+     * @param db Database instance.
+     * @param key Key.
+     *
+     * @return a request to wait on.
+     */
+    template<typename K>
+    inline async_request erase_async(const database& db,
+             const K& key) const {
+        return erase_async(db, object_data(key), object_size(key));
+    }
+
     //////////////////////////
     // SHUTDOWN method
     //////////////////////////
@@ -1393,6 +2135,7 @@ class database {
     
     friend class client;
     friend class provider_handle;
+    friend class write_batch;
 
     provider_handle     m_ph;
     sdskv_database_id_t m_db_id;
@@ -1446,6 +2189,13 @@ class database {
         return m_db_id;
     }
 
+    /**
+     * @brief Returns the provider handle used to access the database.
+     */
+    const provider_handle& handle() const {
+        return m_ph;
+    }
+
     /**
      * @brief @see client::put.
      */
@@ -1471,51 +2221,123 @@ class database {
     }
 
     /**
-     * @brief @see client::length.
+     * @brief @see client::length.
+     */
+    template<typename ... T>
+    decltype(auto) length(T&& ... args) const {
+        return m_ph.m_client->length(*this, std::forward<T>(args)...);
+    }
+
+    /**
+     * @brief @see client::length_multi.
+     */
+    template<typename ... T>
+    decltype(auto) length_multi(T&& ... args) const {
+        return m_ph.m_client->length_multi(*this, std::forward<T>(args)...);
+    }
+
+    /**
+     * @brief @see client::length_packed.
+     */
+    template<typename ... T>
+    decltype(auto) length_packed(T&& ... args) const {
+        return m_ph.m_client->length_packed(*this, std::forward<T>(args)...);
+    }
+
+    /**
+     * @brief @see client::get.
+     */
+    template<typename ... T>
+    decltype(auto) get(T&& ... args) const {
+        return m_ph.m_client->get(*this, std::forward<T>(args)...);
+    }
+
+    /**
+     * @brief @see client::get_alloc.
+     */
+    template<typename ... T>
+    decltype(auto) get_alloc(T&& ... args) const {
+        return m_ph.m_client->get_alloc(*this, std::forward<T>(args)...);
+    }
+
+    /**
+     * @brief @see client::get_packed_alloc.
+     */
+    template<typename ... T>
+    decltype(auto) get_packed_alloc(T&& ... args) const {
+        return m_ph.m_client->get_packed_alloc(*this, std::forward<T>(args)...);
+    }
+
+    /**
+     * @brief @see client::get_multi.
+     */
+    template<typename ... T>
+    decltype(auto) get_multi(T&& ... args) const {
+        return m_ph.m_client->get_multi(*this, std::forward<T>(args)...);
+    }
+    
+    /**
+     * @brief @see client::get_packed.
+     */
+    template<typename ... T>
+    decltype(auto) get_packed(T&& ... args) const {
+        return m_ph.m_client->get_packed(*this, std::forward<T>(args)...);
+    }
+
+    /**
+     * @brief @see client::put_async.
+     */
+    template<typename ... T>
+    decltype(auto) put_async(T&& ... args) const {
+        return m_ph.m_client->put_async(*this, std::forward<T>(args)...);
+    }
+
+    /**
+     * @brief @see client::put_multi_async.
      */
     template<typename ... T>
-    decltype(auto) length(T&& ... args) const {
-        return m_ph.m_client->length(*this, std::forward<T>(args)...);
+    decltype(auto) put_multi_async(T&& ... args) const {
+        return m_ph.m_client->put_multi_async(*this, std::forward<T>(args)...);
     }
 
     /**
-     * @brief @see client::length_multi.
+     * @brief @see client::get_async.
      */
     template<typename ... T>
-    decltype(auto) length_multi(T&& ... args) const {
-        return m_ph.m_client->length_multi(*this, std::forward<T>(args)...);
+    decltype(auto) get_async(T&& ... args) const {
+        return m_ph.m_client->get_async(*this, std::forward<T>(args)...);
     }
 
     /**
-     * @brief @see client::length_packed.
+     * @brief @see client::get_multi_async.
      */
     template<typename ... T>
-    decltype(auto) length_packed(T&& ... args) const {
-        return m_ph.m_client->length_packed(*this, std::forward<T>(args)...);
+    decltype(auto) get_multi_async(T&& ... args) const {
+        return m_ph.m_client->get_multi_async(*this, std::forward<T>(args)...);
     }
 
     /**
-     * @brief @see client::get.
+     * @brief @see client::exists_async.
      */
     template<typename ... T>
-    decltype(auto) get(T&& ... args) const {
-        return m_ph.m_client->get(*this, std::forward<T>(args)...);
+    decltype(auto) exists_async(T&& ... args) const {
+        return m_ph.m_client->exists_async(*this, std::forward<T>(args)...);
     }
 
     /**
-     * @brief @see client::get_multi.
+     * @brief @see client::length_async.
      */
     template<typename ... T>
-    decltype(auto) get_multi(T&& ... args) const {
-        return m_ph.m_client->get_multi(*this, std::forward<T>(args)...);
+    decltype(auto) length_async(T&& ... args) const {
+        return m_ph.m_client->length_async(*this, std::forward<T>(args)...);
     }
-    
+
     /**
-     * @brief @see client::get_packed.
+     * @brief @see client::erase_async.
      */
     template<typename ... T>
-    decltype(auto) get_packed(T&& ... args) const {
-        return m_ph.m_client->get_packed(*this, std::forward<T>(args)...);
+    decltype(auto) erase_async(T&& ... args) const {
+        return m_ph.m_client->erase_async(*this, std::forward<T>(args)...);
     }
 
 
@@ -1567,6 +2389,67 @@ class database {
         return m_ph.m_client->list_keyvals(*this, std::forward<T>(args)...);
     }
 
+    /**
+     * @brief @see client::list_keys_range.
+     */
+    template<typename ... T>
+    decltype(auto) list_keys_range(T&& ... args) const {
+        return m_ph.m_client->list_keys_range(*this, std::forward<T>(args)...);
+    }
+
+    /**
+     * @brief @see client::list_keyvals_range.
+     */
+    template<typename ... T>
+    decltype(auto) list_keyvals_range(T&& ... args) const {
+        return m_ph.m_client->list_keyvals_range(*this, std::forward<T>(args)...);
+    }
+
+    /**
+     * @brief @see client::list_keys_packed.
+     */
+    template<typename ... T>
+    decltype(auto) list_keys_packed(T&& ... args) const {
+        return m_ph.m_client->list_keys_packed(*this, std::forward<T>(args)...);
+    }
+
+    /**
+     * @brief @see client::list_keyvals_packed.
+     */
+    template<typename ... T>
+    decltype(auto) list_keyvals_packed(T&& ... args) const {
+        return m_ph.m_client->list_keyvals_packed(*this, std::forward<T>(args)...);
+    }
+
+    /**
+     * @brief @see client::list_keys_budget.
+     */
+    template<typename ... T>
+    decltype(auto) list_keys_budget(T&& ... args) const {
+        return m_ph.m_client->list_keys_budget(*this, std::forward<T>(args)...);
+    }
+
+    /**
+     * @brief @see client::list_keyvals_budget.
+     */
+    template<typename ... T>
+    decltype(auto) list_keyvals_budget(T&& ... args) const {
+        return m_ph.m_client->list_keyvals_budget(*this, std::forward<T>(args)...);
+    }
+
+    /**
+     * @brief Equivalent to sdskv_cursor_open.
+     *
+     * @param start_key Start key (excluded from results).
+     * @param start_ksize Start key size.
+     * @param prefix Prefix.
+     * @param prefix_size Prefix size.
+     * @param lease_ms Lease in milliseconds (0 for the provider's default).
+     */
+    cursor open_cursor(const void* start_key = nullptr, hg_size_t start_ksize = 0,
+            const void* prefix = nullptr, hg_size_t prefix_size = 0,
+            uint32_t lease_ms = 0) const;
+
     /**
      * @brief @see client::migrate.
      */
@@ -1585,6 +2468,258 @@ class database {
 
 };
 
+/**
+ * @brief The cursor class wraps a sdskv_cursor_t C handle. The cursor
+ * is closed when the object is destroyed.
+ */
+class cursor {
+
+    friend class database;
+
+    sdskv_cursor_t m_cursor = SDSKV_CURSOR_NULL;
+
+    cursor(sdskv_cursor_t c)
+    : m_cursor(c) {}
+
+    public:
+
+    cursor() = default;
+
+    cursor(const cursor&) = delete;
+    cursor& operator=(const cursor&) = delete;
+
+    cursor(cursor&& other)
+    : m_cursor(other.m_cursor) {
+        other.m_cursor = SDSKV_CURSOR_NULL;
+    }
+
+    cursor& operator=(cursor&& other) {
+        if(this == &other) return *this;
+        close();
+        m_cursor = other.m_cursor;
+        other.m_cursor = SDSKV_CURSOR_NULL;
+        return *this;
+    }
+
+    ~cursor() {
+        if(m_cursor != SDSKV_CURSOR_NULL)
+            sdskv_cursor_close(m_cursor);
+    }
+
+    /**
+     * @brief Closes the cursor on the provider.
+     */
+    void close() {
+        if(m_cursor == SDSKV_CURSOR_NULL) return;
+        int ret = sdskv_cursor_close(m_cursor);
+        m_cursor = SDSKV_CURSOR_NULL;
+        _CHECK_RET(ret);
+    }
+
+    /**
+     * @brief Equivalent to sdskv_cursor_next.
+     */
+    void next(void** keys, hg_size_t* ksizes,
+              void** values, hg_size_t* vsizes,
+              hg_size_t* max_items) {
+        int ret = sdskv_cursor_next(m_cursor, keys, ksizes, values, vsizes, max_items);
+        _CHECK_RET(ret);
+    }
+
+    /**
+     * @brief Gets the next entries of the cursor, at most
+     * min(keys.size(), values.size()). Buffers that are too small
+     * are resized. Returns false once the end of the scan is reached.
+     *
+     * @tparam K Key type.
+     * @tparam V Value type.
+     * @param keys Resulting keys.
+     * @param values Resulting values.
+     */
+    template<typename K, typename V>
+    bool next(std::vector<K>& keys, std::vector<V>& values) {
+        hg_size_t max_items = std::min(keys.size(), values.size());
+        hg_size_t requested = max_items;
+        if(max_items == 0) return true;
+        std::vector<void*> kdata(max_items), vdata(max_items);
+        std::vector<hg_size_t> ksizes(max_items), vsizes(max_items);
+        for(unsigned i=0; i < max_items; i++) {
+            kdata[i]  = object_data(keys[i]);
+            ksizes[i] = object_size(keys[i]);
+            vdata[i]  = object_data(values[i]);
+            vsizes[i] = object_size(values[i]);
+        }
+        try {
+            next(kdata.data(), ksizes.data(), vdata.data(), vsizes.data(), &max_items);
+        } catch(exception& e) {
+            if(e.error() != SDSKV_ERR_SIZE) throw;
+            /* the provider kept the entries, get them again with larger buffers */
+            for(unsigned i=0; i < max_items; i++) {
+                object_resize(keys[i], ksizes[i]);
+                kdata[i] = object_data(keys[i]);
+                object_resize(values[i], vsizes[i]);
+                vdata[i] = object_data(values[i]);
+            }
+            max_items = requested;
+            next(kdata.data(), ksizes.data(), vdata.data(), vsizes.data(), &max_items);
+        }
+        for(unsigned i=0; i < max_items; i++) {
+            object_resize(keys[i], ksizes[i]);
+            object_resize(values[i], vsizes[i]);
+        }
+        keys.resize(max_items);
+        values.resize(max_items);
+        return max_items == requested;
+    }
+
+    /**
+     * @brief Cast operator to sdskv_cursor_t.
+     */
+    operator sdskv_cursor_t() const {
+        return m_cursor;
+    }
+};
+
+/**
+ * @brief The write_batch class wraps a C sdskv_batcher_t: individual
+ * puts are coalesced into put_packed operations on a database. See
+ * sdskv_batcher_create for when batches are sent.
+ */
+class write_batch {
+
+    public:
+
+    /**
+     * @brief Type of the function called when a batch completes,
+     * with the number of puts in the batch and the result (SDSKV_SUCCESS
+     * or error code) of the batch.
+     */
+    typedef std::function<void(size_t, int)> callback_type;
+
+    private:
+
+    sdskv_batcher_t                m_batcher = SDSKV_BATCHER_NULL;
+    std::unique_ptr<callback_type> m_callback;
+
+    static void invoke_callback(void* uargs, size_t num, int ret) {
+        (*static_cast<callback_type*>(uargs))(num, ret);
+    }
+
+    public:
+
+    write_batch() = default;
+
+    /**
+     * @brief Creates a write_batch for the given database.
+     *
+     * @param db Database instance.
+     * @param max_count Maximum number of puts in a batch (0 for no limit).
+     * @param max_bytes Maximum size of a batch in put_packed layout.
+     * @param flush_interval_ms Maximum time a put is kept before it is sent (0 for no limit).
+     * @param on_batch Function called when a batch completes.
+     */
+    write_batch(const database& db, size_t max_count, hg_size_t max_bytes,
+                double flush_interval_ms = 0, callback_type on_batch = callback_type());
+
+    write_batch(const write_batch&) = delete;
+    write_batch& operator=(const write_batch&) = delete;
+
+    write_batch(write_batch&& other)
+    : m_batcher(other.m_batcher)
+    , m_callback(std::move(other.m_callback)) {
+        other.m_batcher = SDSKV_BATCHER_NULL;
+    }
+
+    write_batch& operator=(write_batch&& other) {
+        if(this == &other) return *this;
+        if(m_batcher != SDSKV_BATCHER_NULL)
+            sdskv_batcher_destroy(m_batcher);
+        m_batcher  = other.m_batcher;
+        m_callback = std::move(other.m_callback);
+        other.m_batcher = SDSKV_BATCHER_NULL;
+        return *this;
+    }
+
+    /**
+     * @brief Flushes the remaining puts (ignoring errors) and
+     * destroys the batcher.
+     */
+    ~write_batch() {
+        if(m_batcher != SDSKV_BATCHER_NULL)
+            sdskv_batcher_destroy(m_batcher);
+    }
+
+    /**
+     * @brief Equivalent to sdskv_batcher_put.
+     *
+     * @param key Key.
+     * @param ksize Size of the key in bytes.
+     * @param value Value.
+     * @param vsize Size of the value in bytes.
+     */
+    void put(const void *key, hg_size_t ksize,
+             const void *value, hg_size_t vsize) {
+        int ret = sdskv_batcher_put(m_batcher, key, ksize, value, vsize);
+        _CHECK_RET(ret);
+    }
+
+    /**
+     * @brief Templated put, meant to work with std::vector<X>
+     * and std::string, X being a standard layout type.
+     *
+     * @tparam K Key type.
+     * @tparam V Value type.
+     * @param key Key.
+     * @param value Value.
+     */
+    template<typename K, typename V>
+    inline void put(const K& key, const V& value) {
+        put(object_data(key), object_size(key), object_data(value), object_size(value));
+    }
+
+    /**
+     * @brief Equivalent to sdskv_batcher_flush. Throws an exception
+     * if one of the batches completed since the last flush failed.
+     */
+    void flush() {
+        int ret = sdskv_batcher_flush(m_batcher);
+        _CHECK_RET(ret);
+    }
+
+    /**
+     * @brief Flushes the remaining puts and destroys the batcher.
+     * Throws an exception if the final flush failed.
+     */
+    void close() {
+        if(m_batcher == SDSKV_BATCHER_NULL) return;
+        int ret = sdskv_batcher_destroy(m_batcher);
+        m_batcher = SDSKV_BATCHER_NULL;
+        _CHECK_RET(ret);
+    }
+};
+
+inline write_batch::write_batch(const database& db, size_t max_count, hg_size_t max_bytes,
+        double flush_interval_ms, callback_type on_batch) {
+    sdskv_batch_callback_t cb = nullptr;
+    if(on_batch) {
+        m_callback.reset(new callback_type(std::move(on_batch)));
+        cb = &write_batch::invoke_callback;
+    }
+    int ret = sdskv_batcher_create(db.m_ph, db.m_db_id,
+            max_count, max_bytes, flush_interval_ms,
+            cb, m_callback.get(), &m_batcher);
+    _CHECK_RET(ret);
+}
+
+inline cursor database::open_cursor(const void* start_key, hg_size_t start_ksize,
+        const void* prefix, hg_size_t prefix_size, uint32_t lease_ms) const {
+    sdskv_cursor_t c;
+    int ret = sdskv_cursor_open(m_ph.m_ph, m_db_id, start_key, start_ksize,
+            prefix, prefix_size, lease_ms, &c);
+    _CHECK_RET(ret);
+    return cursor(c);
+}
+
 inline database client::open(const provider_handle& ph, const std::string& db_name) const {
     sdskv_database_id_t db_id;
     int ret = sdskv_open(ph.m_ph, db_name.c_str(), &db_id);
@@ -1643,6 +2778,73 @@ inline void client::put_packed(const database& db, const std::string& origin_add
      _CHECK_RET(ret);
 }
 
+inline async_request client::put_async(const database& db,
+        const void *key, hg_size_t ksize,
+        const void *value, hg_size_t vsize) const {
+    async_request req;
+    int ret = sdskv_put_async(db.m_ph.m_ph, db.m_db_id,
+            key, ksize, value, vsize, &req.m_req);
+    _CHECK_RET(ret);
+    return req;
+}
+
+inline async_request client::put_multi_async(const database& db,
+        hg_size_t count, const void* const* keys, const hg_size_t* ksizes,
+        const void* const* values, const hg_size_t *vsizes) const {
+    async_request req;
+    int ret = sdskv_put_multi_async(db.m_ph.m_ph, db.m_db_id,
+            count, keys, ksizes, values, vsizes, &req.m_req);
+    _CHECK_RET(ret);
+    return req;
+}
+
+inline async_request client::get_async(const database& db,
+        const void* key, hg_size_t ksize,
+        void* value, hg_size_t* vsize) const {
+    async_request req;
+    int ret = sdskv_get_async(db.m_ph.m_ph, db.m_db_id,
+            key, ksize, value, vsize, &req.m_req);
+    _CHECK_RET(ret);
+    return req;
+}
+
+inline async_request client::get_multi_async(const database& db,
+        hg_size_t count, const void* const* keys, const hg_size_t* ksizes,
+        void** values, hg_size_t *vsizes) const {
+    async_request req;
+    int ret = sdskv_get_multi_async(db.m_ph.m_ph, db.m_db_id,
+            count, keys, ksizes, values, vsizes, &req.m_req);
+    _CHECK_RET(ret);
+    return req;
+}
+
+inline async_request client::exists_async(const database& db,
+        const void* key, hg_size_t ksize, int* flag) const {
+    async_request req;
+    int ret = sdskv_exists_async(db.m_ph.m_ph, db.m_db_id,
+            key, ksize, flag, &req.m_req);
+    _CHECK_RET(ret);
+    return req;
+}
+
+inline async_request client::length_async(const database& db,
+        const void* key, hg_size_t ksize, hg_size_t* vsize) const {
+    async_request req;
+    int ret = sdskv_length_async(db.m_ph.m_ph, db.m_db_id,
+            key, ksize, vsize, &req.m_req);
+    _CHECK_RET(ret);
+    return req;
+}
+
+inline async_request client::erase_async(const database& db,
+        const void* key, hg_size_t ksize) const {
+    async_request req;
+    int ret = sdskv_erase_async(db.m_ph.m_ph, db.m_db_id,
+            key, ksize, &req.m_req);
+    _CHECK_RET(ret);
+    return req;
+}
+
 inline hg_size_t client::length(const database& db,
         const void* key, hg_size_t ksize) const {
     hg_size_t vsize;
@@ -1697,6 +2899,24 @@ inline bool client::get(const database& db,
     return true;
 }
 
+inline bool client::get_alloc(const database& db,
+        const void* key, hg_size_t ksize,
+        void** value, hg_size_t* vsize) const {
+    int ret = sdskv_get_alloc(db.m_ph.m_ph, db.m_db_id,
+            key, ksize, value, vsize);
+    _CHECK_RET(ret);
+    return true;
+}
+
+inline bool client::get_packed_alloc(const database& db,
+        hg_size_t count, const void* packed_keys, const hg_size_t* ksizes,
+        void** packed_values, hg_size_t* vsizes) const {
+    int ret = sdskv_get_packed_alloc(db.m_ph.m_ph, db.m_db_id,
+            count, packed_keys, ksizes, packed_values, vsizes);
+    _CHECK_RET(ret);
+    return true;
+}
+
 inline bool client::get_multi(const database& db,
         hg_size_t count, const void* const* keys, const hg_size_t* ksizes,
         void** values, hg_size_t *vsizes) const {
@@ -1755,6 +2975,110 @@ inline void client::list_keyvals(const database& db,
     _CHECK_RET(ret);
 }
 
+inline void client::list_keys_range(const database& db,
+        const void *lower_bound, hg_size_t lower_bound_size,
+        const void *upper_bound, hg_size_t upper_bound_size,
+        void** keys, hg_size_t* ksizes, hg_size_t* max_keys) const {
+    int ret = sdskv_list_keys_range(db.m_ph.m_ph, db.m_db_id,
+            lower_bound, lower_bound_size, upper_bound, upper_bound_size,
+            keys, ksizes, max_keys);
+    _CHECK_RET(ret);
+}
+
+inline void client::list_keyvals_range(const database& db,
+        const void *lower_bound, hg_size_t lower_bound_size,
+        const void *upper_bound, hg_size_t upper_bound_size,
+        void** keys, hg_size_t* ksizes,
+        void** values, hg_size_t* vsizes,
+        hg_size_t* max_items) const {
+    int ret = sdskv_list_keyvals_range(db.m_ph.m_ph, db.m_db_id,
+            lower_bound, lower_bound_size, upper_bound, upper_bound_size,
+            keys, ksizes,
+            values, vsizes,
+            max_items);
+    _CHECK_RET(ret);
+}
+
+inline void client::list_keys_packed(const database& db,
+        const void *start_key, hg_size_t start_ksize,
+        const void *prefix, hg_size_t prefix_size,
+        void* packed_data, hg_size_t* packed_data_size,
+        const void** keys, hg_size_t* ksizes, hg_size_t* max_keys) const {
+    int ret = sdskv_list_keys_packed(db.m_ph.m_ph, db.m_db_id,
+            start_key, start_ksize, prefix, prefix_size,
+            packed_data, packed_data_size,
+            keys, ksizes, max_keys);
+    _CHECK_RET(ret);
+}
+
+inline void client::list_keyvals_packed(const database& db,
+        const void *start_key, hg_size_t start_ksize,
+        const void *prefix, hg_size_t prefix_size,
+        void* packed_data, hg_size_t* packed_data_size,
+        const void** keys, hg_size_t* ksizes,
+        const void** values, hg_size_t* vsizes,
+        hg_size_t* max_items) const {
+    int ret = sdskv_list_keyvals_packed(db.m_ph.m_ph, db.m_db_id,
+            start_key, start_ksize, prefix, prefix_size,
+            packed_data, packed_data_size,
+            keys, ksizes,
+            values, vsizes,
+            max_items);
+    _CHECK_RET(ret);
+}
+
+inline packed_keyvals client::list_packed(const database& db,
+        const void* start_key, hg_size_t start_ksize,
+        const void* prefix, hg_size_t prefix_size,
+        bool with_values, hg_size_t max_items, hg_size_t buffer_size) const {
+    packed_keyvals result;
+    result.m_buffer.resize(buffer_size);
+    hg_size_t count, size;
+    auto list = [&]() {
+        count = max_items;
+        size  = result.m_buffer.size();
+        if(max_items == 0 && with_values)
+            return sdskv_list_keyvals_budget(db.m_ph.m_ph, db.m_db_id,
+                start_key, start_ksize, prefix, prefix_size,
+                result.m_buffer.data(), &size, &count);
+        else if(max_items == 0)
+            return sdskv_list_keys_budget(db.m_ph.m_ph, db.m_db_id,
+                start_key, start_ksize, prefix, prefix_size,
+                result.m_buffer.data(), &size, &count);
+        else if(with_values)
+            return sdskv_list_keyvals_packed(db.m_ph.m_ph, db.m_db_id,
+                start_key, start_ksize, prefix, prefix_size,
+                result.m_buffer.data(), &size,
+                nullptr, nullptr, nullptr, nullptr, &count);
+        else
+            return sdskv_list_keys_packed(db.m_ph.m_ph, db.m_db_id,
+                start_key, start_ksize, prefix, prefix_size,
+                result.m_buffer.data(), &size,
+                nullptr, nullptr, &count);
+    };
+    int ret = list();
+    if(ret == SDSKV_ERR_SIZE) {
+        /* size is the buffer size needed for the first entry */
+        result.m_buffer.resize(size);
+        ret = list();
+    }
+    _CHECK_RET(ret);
+    result.m_buffer.resize(size);
+    result.m_keys.resize(count);
+    result.m_ksizes.resize(count);
+    if(with_values) {
+        result.m_values.resize(count);
+        result.m_vsizes.resize(count);
+        sdskv_unpack_keyvals(result.m_buffer.data(), count,
+                result.m_keys.data(), result.m_ksizes.data(),
+                result.m_values.data(), result.m_vsizes.data());
+    } else {
+        sdskv_unpack_keys(result.m_buffer.data(), count,
+                result.m_keys.data(), result.m_ksizes.data());
+    }
+    return result;
+}
+
 inline void client::migrate(const database& source_db, const database& dest_db,
         hg_size_t num_items, const void* const* keys, const hg_size_t* key_sizes,
         int flag) const {
@@ -13,12 +13,21 @@ typedef enum sdskv_db_type_t
     KVDB_BWTREE,    /* Datastore implementation using a BwTree   */
     KVDB_LEVELDB,   /* Datastore implementation using LevelDB    */
     KVDB_BERKELEYDB,/* Datastore implementation using BerkeleyDB */
-    KVDB_FORWARDDB  /* Datastore implementation forwarding to secondary DB */
+    KVDB_FORWARDDB, /* Datastore implementation forwarding to secondary DB */
+    KVDB_SHARDED_MAP,/* Datastore implementation using lock-striped std::maps */
+    KVDB_HASH       /* Datastore implementation using an unordered hash table */
 } sdskv_db_type_t;
 
 typedef uint64_t sdskv_database_id_t;
 #define SDSKV_DATABASE_ID_INVALID 0
 
+typedef struct sdskv_memory_usage_t {
+    uint64_t num_items;     /* number of key/value pairs stored */
+    uint64_t data_bytes;    /* combined size of the keys and values */
+    uint64_t storage_bytes; /* memory reserved to hold the keys and values */
+    uint64_t index_bytes;   /* estimated memory used by the index structure */
+} sdskv_memory_usage_t;
+
 #define SDSKV_KEEP_ORIGINAL    0 /* for migration operations, keep original */
 #define SDSKV_REMOVE_ORIGINAL  1 /* for migration operations, remove the origin after migrating */
 
@@ -45,6 +54,7 @@ typedef uint64_t sdskv_database_id_t;
     X(SDSKV_ERR_COMP_FUNC,   "Invalid comparison function")       \
     X(SDSKV_ERR_REMI,        "REMI error")                        \
     X(SDSKV_ERR_KEYEXISTS,   "Key exists")                        \
+    X(SDSKV_ERR_UNKNOWN_CURSOR, "Invalid or expired cursor")      \
     X(SDSKV_ERR_MAX,         "End of range for valid error codes")
 
 #define X(__err__, __msg__) __err__,
@@ -34,9 +34,30 @@ typedef struct sdskv_config_t {
     sdskv_db_type_t  db_type;         // type of database
     const char*      db_comp_fn_name; // name of registered comparison function (can be NULL)
     int              db_no_overwrite; // prevents overwritting data if set to 1
+    const char*      db_options;      // engine-specific "key=value,..." options (can be NULL)
 } sdskv_config_t;
 
-#define SDSKV_CONFIG_DEFAULT { "", "", KVDB_MAP, SDSKV_COMPARE_DEFAULT, 0 }
+#define SDSKV_CONFIG_DEFAULT { "", "", KVDB_MAP, SDSKV_COMPARE_DEFAULT, 0, NULL }
+
+/* Classes of operations that a database can run in its own pool */
+typedef enum sdskv_op_class_t {
+    SDSKV_OP_CLASS_READ = 0, // get, length, exists
+    SDSKV_OP_CLASS_WRITE,    // put, erase
+    SDSKV_OP_CLASS_SCAN,     // list_keys, list_keyvals, cursors
+    SDSKV_OP_CLASS_MIGRATION,// migrate_keys, migrate_database, etc.
+    SDSKV_OP_CLASS_ALL       // all of the above
+} sdskv_op_class_t;
+
+typedef struct sdskv_group_commit_stats_t {
+    uint64_t num_writes;  /* puts and erases committed since group commit was first enabled */
+    uint64_t num_batches; /* engine batches that committed them */
+} sdskv_group_commit_stats_t;
+
+typedef struct sdskv_read_coalescing_stats_t {
+    uint64_t num_gets;    /* gets issued since read coalescing was first enabled */
+    uint64_t num_lookups; /* engine lookups that these gets required */
+    uint64_t num_merged;  /* gets served by the lookup of a concurrent get */
+} sdskv_read_coalescing_stats_t;
 
 typedef void (*sdskv_pre_migration_callback_fn)(sdskv_provider_t, const sdskv_config_t*, void*);
 typedef void (*sdskv_post_migration_callback_fn)(sdskv_provider_t, const sdskv_config_t*, sdskv_database_id_t, void*);
@@ -102,6 +123,115 @@ int sdskv_provider_attach_database(
         const sdskv_config_t* config,
         sdskv_database_id_t* sb_id);
 
+/**
+ * Makes the provider run the operations of a given class on a database
+ * in the given pool, instead of the pool in which the provider's RPCs run.
+ * The RPC handler decodes the request, then runs the database operation
+ * in this pool and waits for it, so that slow operations on this database
+ * do not hold the provider's execution streams. Passing SDSKV_ABT_POOL_DEFAULT
+ * makes the operations run in the provider's pool again.
+ *
+ * @param provider provider
+ * @param db_id id of the database
+ * @param op_class class of operations, or SDSKV_OP_CLASS_ALL
+ * @param pool Argobots pool
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_provider_set_database_pool(
+        sdskv_provider_t provider,
+        sdskv_database_id_t db_id,
+        sdskv_op_class_t op_class,
+        ABT_pool pool);
+
+/**
+ * Enables or disables group commit on a database. When enabled, the
+ * puts and erases issued concurrently on the database (by the put,
+ * bulk_put and erase RPCs) are queued, and the first of them commits the
+ * queued ones with a single engine batch (e.g. one LevelDB WriteBatch)
+ * before handing each RPC its own result. The first mutation waits up to
+ * max_delay_us microseconds for others to join the batch; with 0 it only
+ * batches the mutations queued while the previous batch was being
+ * committed. The multi and packed operations are already applied as one
+ * engine batch and do not go through the queue.
+ *
+ * @param provider provider
+ * @param db_id id of the database
+ * @param enable 1 to enable group commit, 0 to disable it
+ * @param max_delay_us maximum batching delay in microseconds
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_provider_set_group_commit(
+        sdskv_provider_t provider,
+        sdskv_database_id_t db_id,
+        int enable,
+        unsigned max_delay_us);
+
+/**
+ * Retrieves the counters of the group commit of a database.
+ *
+ * @param[in] provider provider
+ * @param[in] db_id id of the database
+ * @param[out] stats resulting counters
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_provider_get_group_commit_stats(
+        sdskv_provider_t provider,
+        sdskv_database_id_t db_id,
+        sdskv_group_commit_stats_t* stats);
+
+/**
+ * Enables or disables read coalescing on a database. When enabled, the
+ * gets (issued by the get RPC) of a key for which a lookup is in progress
+ * wait for that lookup and share its result instead of doing their own,
+ * provided that no write completed on the database since it started.
+ *
+ * @param provider provider
+ * @param db_id id of the database
+ * @param enable 1 to enable read coalescing, 0 to disable it
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_provider_set_read_coalescing(
+        sdskv_provider_t provider,
+        sdskv_database_id_t db_id,
+        int enable);
+
+/**
+ * Retrieves the counters of the read coalescing of a database.
+ *
+ * @param[in] provider provider
+ * @param[in] db_id id of the database
+ * @param[out] stats resulting counters
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_provider_get_read_coalescing_stats(
+        sdskv_provider_t provider,
+        sdskv_database_id_t db_id,
+        sdskv_read_coalescing_stats_t* stats);
+
+/**
+ * Makes the provider run the operations on its LevelDB and BerkeleyDB
+ * databases in the given pool, typically served by execution streams
+ * dedicated to I/O, so that calls blocking on the disk do not stall the
+ * execution streams running the RPC handlers and the in-memory databases.
+ * This applies to the databases already attached and to the ones attached
+ * later, except for the classes of operations for which a pool was set
+ * with sdskv_provider_set_database_pool. Passing SDSKV_ABT_POOL_DEFAULT
+ * makes these operations run in the provider's pool again.
+ *
+ * @param provider provider
+ * @param pool Argobots pool
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ */
+int sdskv_provider_set_io_pool(
+        sdskv_provider_t provider,
+        ABT_pool pool);
+
 /**
  * Makes the provider stop managing a database and deletes the
  * database. This will effectively destroy the database if it is
@@ -153,6 +283,22 @@ int sdskv_provider_list_databases(
         sdskv_provider_t provider,
         sdskv_database_id_t* databases);
 
+/**
+ * @brief Reports the memory used by an in-memory database to
+ * store its keys and values.
+ *
+ * @param[in] provider provider.
+ * @param[in] database_id Database id.
+ * @param[out] usage Resulting memory usage.
+ *
+ * @return SDSKV_SUCCESS or error code defined in sdskv-common.h
+ * (SDSKV_OP_NOT_IMPL if the database's backend does not support it)
+ */
+int sdskv_provider_get_database_memory_usage(
+        sdskv_provider_t provider,
+        sdskv_database_id_t database_id,
+        sdskv_memory_usage_t* usage);
+
 /**
  * @brief Computes the database size.
  *
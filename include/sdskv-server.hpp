@@ -119,6 +119,81 @@ class provider {
     }
 #endif
 
+    /**
+     * @brief Run the operations of a given class on a database in
+     * a specific pool.
+     *
+     * @param db_id Database id.
+     * @param op_class Class of operations, or SDSKV_OP_CLASS_ALL.
+     * @param pool Argobots pool (SDSKV_ABT_POOL_DEFAULT for the provider's pool).
+     */
+    void set_database_pool(sdskv_database_id_t db_id, sdskv_op_class_t op_class, ABT_pool pool) {
+        int ret = sdskv_provider_set_database_pool(m_provider, db_id, op_class, pool);
+        _CHECK_RET(ret);
+    }
+
+    /**
+     * @brief Enable or disable group commit of the puts and erases on a database.
+     *
+     * @param db_id Database id.
+     * @param enable Whether to enable group commit.
+     * @param max_delay_us Maximum batching delay in microseconds.
+     */
+    void set_group_commit(sdskv_database_id_t db_id, bool enable, unsigned max_delay_us = 0) {
+        int ret = sdskv_provider_set_group_commit(m_provider, db_id, enable, max_delay_us);
+        _CHECK_RET(ret);
+    }
+
+    /**
+     * @brief Get the group commit counters of a database.
+     *
+     * @param db_id Database id.
+     *
+     * @return Group commit counters.
+     */
+    sdskv_group_commit_stats_t get_group_commit_stats(sdskv_database_id_t db_id) const {
+        sdskv_group_commit_stats_t stats;
+        int ret = sdskv_provider_get_group_commit_stats(m_provider, db_id, &stats);
+        _CHECK_RET(ret);
+        return stats;
+    }
+
+    /**
+     * @brief Enable or disable the coalescing of concurrent gets of the same key.
+     *
+     * @param db_id Database id.
+     * @param enable Whether to enable read coalescing.
+     */
+    void set_read_coalescing(sdskv_database_id_t db_id, bool enable) {
+        int ret = sdskv_provider_set_read_coalescing(m_provider, db_id, enable);
+        _CHECK_RET(ret);
+    }
+
+    /**
+     * @brief Get the read coalescing counters of a database.
+     *
+     * @param db_id Database id.
+     *
+     * @return Read coalescing counters.
+     */
+    sdskv_read_coalescing_stats_t get_read_coalescing_stats(sdskv_database_id_t db_id) const {
+        sdskv_read_coalescing_stats_t stats;
+        int ret = sdskv_provider_get_read_coalescing_stats(m_provider, db_id, &stats);
+        _CHECK_RET(ret);
+        return stats;
+    }
+
+    /**
+     * @brief Run the operations on the LevelDB and BerkeleyDB databases
+     * in a pool dedicated to I/O.
+     *
+     * @param pool Argobots pool (SDSKV_ABT_POOL_DEFAULT for the provider's pool).
+     */
+    void set_io_pool(ABT_pool pool) {
+        int ret = sdskv_provider_set_io_pool(m_provider, pool);
+        _CHECK_RET(ret);
+    }
+
     /**
      * @brief Remove a database (this will not remove the underlying files).
      *
@@ -153,6 +228,24 @@ class provider {
         _CHECK_RET(ret);
     }
 
+    /**
+     * @brief Get the memory used by an in-memory database to store
+     * its keys and values.
+     *
+     * @param db_id Database id.
+     *
+     * @return Memory usage of the specified database.
+     */
+    sdskv_memory_usage_t get_database_memory_usage(sdskv_database_id_t db_id) const {
+        sdskv_memory_usage_t usage;
+        int ret = sdskv_provider_get_database_memory_usage(
+                    m_provider,
+                    db_id,
+                    &usage);
+        _CHECK_RET(ret);
+        return usage;
+    }
+
     /**
      * @brief Compute the size of a database (combined sizes of all files
      * that make up the database). Requires REMI support.
@@ -4,6 +4,7 @@
 #define bulk_h
 
 #include <stddef.h>
+#include <stdint.h>
 #include "kv-config.h"
 //#include <boost/functional/hash.hpp>
 #include <vector>
@@ -13,12 +14,21 @@
 // typedef is for convenience
 typedef std::vector<char> ds_bulk_t;
 
+// 64-bit FNV-1a hash of a byte range, usable on keys that
+// are not stored in a ds_bulk_t (does not allocate).
+inline uint64_t ds_bulk_hash_bytes(const void* data, size_t size) {
+  const unsigned char* p = (const unsigned char*)data;
+  uint64_t hash = 14695981039346656037ULL;
+  for(size_t i = 0; i < size; i++) {
+    hash ^= p[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
 struct ds_bulk_hash {
   size_t operator()(const ds_bulk_t &v) const {
-    size_t hash = 0;
-    hash = std::hash<std::string>() ( std::string( v.begin(), v.end() ) );
-        //boost::hash_range(hash, v.begin(), v.end());
-    return hash;
+    return ds_bulk_hash_bytes(v.data(), v.size());
   }
 };
 
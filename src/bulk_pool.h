@@ -0,0 +1,172 @@
+// Copyright (c) 2017, Los Alamos National Security, LLC.
+// All rights reserved.
+#ifndef bulk_pool_h
+#define bulk_pool_h
+
+#include <vector>
+#include <cstdlib>
+#include <margo.h>
+
+/**
+ * BulkBufferPool keeps memory registered for bulk transfers so that RPC
+ * handlers do not allocate and register a new buffer for each request.
+ * Buffers are grouped in power-of-2 size classes between min_size and
+ * max_size, and each class keeps up to max_cached idle buffers. A request
+ * larger than max_size gets a buffer that is allocated and registered on
+ * demand, and released along with its handle.
+ *
+ * Buffers are registered with HG_BULK_READWRITE, so the same buffer can
+ * receive data from a client and send data back to it. Their content is
+ * not initialized.
+ */
+class BulkBufferPool {
+
+    struct entry {
+        char*     data;
+        hg_size_t size;
+        hg_bulk_t bulk;
+        int       size_class; // -1 if not pooled
+    };
+
+    public:
+
+        /**
+         * Buffer borrowed from the pool, given back when destroyed.
+         */
+        class buffer {
+
+            friend class BulkBufferPool;
+
+            BulkBufferPool* _pool = nullptr;
+            entry           _entry = { nullptr, 0, HG_BULK_NULL, -1 };
+
+            public:
+
+            buffer() = default;
+
+            buffer(const buffer&) = delete;
+            buffer& operator=(const buffer&) = delete;
+
+            buffer(buffer&& other)
+            : _pool(other._pool), _entry(other._entry) {
+                other._pool = nullptr;
+            }
+
+            buffer& operator=(buffer&& other) {
+                if(this == &other) return *this;
+                release();
+                _pool  = other._pool;
+                _entry = other._entry;
+                other._pool = nullptr;
+                return *this;
+            }
+
+            ~buffer() {
+                release();
+            }
+
+            char* data() const { return _entry.data; }
+
+            hg_bulk_t bulk() const { return _entry.bulk; }
+
+            /* capacity of the buffer, at least the size requested */
+            hg_size_t size() const { return _entry.size; }
+
+            void release() {
+                if(_pool) _pool->put_back(_entry);
+                _pool = nullptr;
+            }
+        };
+
+        static const hg_size_t default_min_size   = 4096;
+        static const hg_size_t default_max_size   = 4*1024*1024;
+        static const size_t    default_max_cached = 8;
+
+        BulkBufferPool(margo_instance_id mid,
+                hg_size_t min_size = default_min_size,
+                hg_size_t max_size = default_max_size,
+                size_t max_cached = default_max_cached)
+        : _mid(mid), _min_size(min_size), _max_cached(max_cached) {
+            ABT_mutex_create(&_mutex);
+            for(hg_size_t s = min_size; s <= max_size; s *= 2)
+                _classes.emplace_back();
+        }
+
+        BulkBufferPool(const BulkBufferPool&) = delete;
+        BulkBufferPool& operator=(const BulkBufferPool&) = delete;
+
+        ~BulkBufferPool() {
+            for(auto& c : _classes)
+                for(auto& e : c) destroy(e);
+            ABT_mutex_free(&_mutex);
+        }
+
+        /**
+         * Gets a registered buffer of at least size bytes.
+         */
+        hg_return_t get(hg_size_t size, buffer& b) {
+            b.release();
+            int c = size_class(size);
+            if(c >= 0) {
+                ABT_mutex_lock(_mutex);
+                if(!_classes[c].empty()) {
+                    b._entry = _classes[c].back();
+                    _classes[c].pop_back();
+                    ABT_mutex_unlock(_mutex);
+                    b._pool = this;
+                    return HG_SUCCESS;
+                }
+                ABT_mutex_unlock(_mutex);
+                size = _min_size << c;
+            }
+            entry e = { nullptr, size, HG_BULK_NULL, c };
+            e.data = (char*)std::malloc(size > 0 ? size : 1);
+            if(!e.data) return HG_NOMEM;
+            void* ptr = e.data;
+            hg_return_t hret = margo_bulk_create(_mid, 1, &ptr, &e.size,
+                    HG_BULK_READWRITE, &e.bulk);
+            if(hret != HG_SUCCESS) {
+                std::free(e.data);
+                return hret;
+            }
+            b._entry = e;
+            b._pool  = this;
+            return HG_SUCCESS;
+        }
+
+    private:
+
+        int size_class(hg_size_t size) const {
+            int c = 0;
+            for(hg_size_t s = _min_size; c < (int)_classes.size(); s *= 2, c++)
+                if(size <= s) return c;
+            return -1;
+        }
+
+        void put_back(const entry& e) {
+            if(e.size_class >= 0) {
+                ABT_mutex_lock(_mutex);
+                auto& c = _classes[e.size_class];
+                if(c.size() < _max_cached) {
+                    c.push_back(e);
+                    ABT_mutex_unlock(_mutex);
+                    return;
+                }
+                ABT_mutex_unlock(_mutex);
+            }
+            destroy(e);
+        }
+
+        static void destroy(const entry& e) {
+            margo_bulk_free(e.bulk);
+            std::free(e.data);
+        }
+
+        margo_instance_id               _mid;
+        hg_size_t                       _min_size;
+        size_t                          _max_cached;
+        ABT_mutex                       _mutex;
+        std::vector<std::vector<entry>> _classes;
+};
+
+#endif
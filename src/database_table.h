@@ -0,0 +1,444 @@
+// Copyright (c) 2017, Los Alamos National Security, LLC.
+// All rights reserved.
+#ifndef database_table_h
+#define database_table_h
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <margo.h>
+#include "sdskv-common.h"
+#include "sdskv-server.h"
+#include "datastore/datastore.h"
+#include "write_combiner.h"
+#include "read_coalescer.h"
+
+/**
+ * DatabaseTable maps the database ids of a provider to their datastore.
+ * A database id encodes the index of a slot in the table and the generation
+ * of that slot, so find() is a direct lookup that takes no lock. Slots are
+ * allocated by chunks that are never moved nor freed before the table,
+ * hence readers never access reclaimed memory.
+ *
+ * find() returns a reference that keeps the database alive. Each slot counts
+ * its references in a few counters placed on distinct cache lines, and a
+ * reference uses the counter of the execution stream that created it, so
+ * that execution streams accessing the same database do not share a cache
+ * line. Removing a database is done in two steps: detach() makes find() fail
+ * for its id, then release() waits until the references taken before it
+ * are gone, after which the caller may destroy the database.
+ *
+ * Each slot also holds the pools in which the classes of operations on
+ * its database should run (ABT_POOL_NULL for the provider's pool). The
+ * operations on a database inserted as blocking run in the table's I/O
+ * pool unless a pool was set for their class.
+ *
+ * A slot may also hold the WriteCombiner that commits the concurrent puts
+ * and erases on its database in batches, destroyed along with the slot's
+ * database by release(), and likewise the ReadCoalescer that makes the
+ * concurrent gets of a key share one lookup.
+ *
+ * insert(), detach(), release() and set_pool() are serialized by a mutex.
+ */
+class DatabaseTable {
+
+    static const unsigned num_counters = 16;
+    static const size_t   chunk_size   = 16;
+    static const size_t   max_chunks   = 4096;
+
+    struct counter {
+        std::atomic<int64_t> value;
+        char pad[64 - sizeof(std::atomic<int64_t>)];
+    };
+
+    struct slot {
+        std::atomic<AbstractDataStore*> db;
+        std::atomic<uint32_t>           generation;
+        std::atomic<ABT_pool>           pools[SDSKV_OP_CLASS_ALL];
+        const std::atomic<ABT_pool>*    io_pool; // null if the database does not block
+        std::atomic<WriteCombiner*>     combiner;
+        std::atomic<bool>               group_commit;
+        std::atomic<ReadCoalescer*>     coalescer;
+        std::atomic<bool>               coalesce_reads;
+        counter                         in_flight[num_counters];
+        slot() : db(nullptr), generation(1), io_pool(nullptr), combiner(nullptr), group_commit(false),
+                 coalescer(nullptr), coalesce_reads(false) {
+            for(auto& p : pools) p.store(ABT_POOL_NULL);
+            for(auto& c : in_flight) c.value.store(0);
+        }
+    };
+
+    public:
+
+        /**
+         * Reference to a database, released when destroyed.
+         */
+        class reference {
+
+            friend class DatabaseTable;
+
+            slot*              _slot = nullptr;
+            unsigned           _counter = 0;
+            AbstractDataStore* _db = nullptr;
+
+            reference(slot* s, unsigned c, AbstractDataStore* db)
+            : _slot(s), _counter(c), _db(db) {}
+
+            public:
+
+            reference() = default;
+
+            reference(const reference&) = delete;
+            reference& operator=(const reference&) = delete;
+
+            reference(reference&& other)
+            : _slot(other._slot), _counter(other._counter), _db(other._db) {
+                other._slot = nullptr;
+                other._db   = nullptr;
+            }
+
+            reference& operator=(reference&& other) {
+                if(this == &other) return *this;
+                reset();
+                _slot    = other._slot;
+                _counter = other._counter;
+                _db      = other._db;
+                other._slot = nullptr;
+                other._db   = nullptr;
+                return *this;
+            }
+
+            ~reference() {
+                reset();
+            }
+
+            AbstractDataStore* get() const { return _db; }
+
+            AbstractDataStore* operator->() const { return _db; }
+
+            explicit operator bool() const { return _db != nullptr; }
+
+            /* pool in which operations of the given class should run */
+            ABT_pool pool(sdskv_op_class_t op_class) const {
+                if(!_slot) return ABT_POOL_NULL;
+                ABT_pool p = _slot->pools[op_class].load(std::memory_order_acquire);
+                if(p == ABT_POOL_NULL && _slot->io_pool)
+                    p = _slot->io_pool->load(std::memory_order_acquire);
+                return p;
+            }
+
+            /* combiner for the puts and erases, null if group commit is disabled */
+            WriteCombiner* combiner() const {
+                if(!_slot || !_slot->group_commit.load(std::memory_order_acquire))
+                    return nullptr;
+                return _slot->combiner.load(std::memory_order_acquire);
+            }
+
+            /* coalescer for the gets, null if read coalescing is disabled */
+            ReadCoalescer* read_coalescer() const {
+                if(!_slot || !_slot->coalesce_reads.load(std::memory_order_acquire))
+                    return nullptr;
+                return _slot->coalescer.load(std::memory_order_acquire);
+            }
+
+            /* to be called after a write completes on the database */
+            void written() const {
+                if(!_slot) return;
+                ReadCoalescer* c = _slot->coalescer.load(std::memory_order_acquire);
+                if(c) c->invalidate();
+            }
+
+            void reset() {
+                if(_slot)
+                    _slot->in_flight[_counter].value.fetch_sub(1, std::memory_order_release);
+                _slot = nullptr;
+                _db   = nullptr;
+            }
+        };
+
+        DatabaseTable() : _io_pool(ABT_POOL_NULL) {
+            ABT_mutex_create(&_mutex);
+            for(auto& c : _chunks) c.store(nullptr);
+        }
+
+        DatabaseTable(const DatabaseTable&) = delete;
+        DatabaseTable& operator=(const DatabaseTable&) = delete;
+
+        ~DatabaseTable() {
+            for(size_t i = 0; i < _num_slots; i++) {
+                delete chunk_slot(i).combiner.load();
+                delete chunk_slot(i).coalescer.load();
+            }
+            for(auto& c : _chunks)
+                delete[] c.load();
+            ABT_mutex_free(&_mutex);
+        }
+
+        /**
+         * Returns a reference to the database with the given id,
+         * or an empty reference if there is no such database.
+         */
+        reference find(sdskv_database_id_t id) const {
+            slot* s = slot_for(id);
+            if(!s) return reference();
+            unsigned c = counter_index();
+            // the increment must be ordered before the load of db, and the
+            // store of db in detach() before the loads of the counters in release()
+            s->in_flight[c].value.fetch_add(1, std::memory_order_seq_cst);
+            AbstractDataStore* db = s->db.load(std::memory_order_seq_cst);
+            if(!db || s->generation.load(std::memory_order_acquire) != generation_of(id)) {
+                s->in_flight[c].value.fetch_sub(1, std::memory_order_release);
+                return reference();
+            }
+            return reference(s, c, db);
+        }
+
+        /**
+         * Adds a database to the table and returns its id,
+         * or SDSKV_DATABASE_ID_INVALID if the table is full.
+         * The operations on a blocking database default to the I/O pool.
+         */
+        sdskv_database_id_t insert(AbstractDataStore* db, bool blocking = false) {
+            ABT_mutex_lock(_mutex);
+            size_t index;
+            if(!_free_slots.empty()) {
+                index = _free_slots.back();
+                _free_slots.pop_back();
+            } else {
+                index = _num_slots;
+                size_t chunk = index / chunk_size;
+                if(chunk >= max_chunks) {
+                    ABT_mutex_unlock(_mutex);
+                    return SDSKV_DATABASE_ID_INVALID;
+                }
+                if(index % chunk_size == 0)
+                    _chunks[chunk].store(new slot[chunk_size], std::memory_order_release);
+                _num_slots += 1;
+            }
+            slot& s = chunk_slot(index);
+            for(auto& p : s.pools) p.store(ABT_POOL_NULL, std::memory_order_relaxed);
+            s.io_pool = blocking ? &_io_pool : nullptr;
+            sdskv_database_id_t id = make_id(index, s.generation.load());
+            s.db.store(db, std::memory_order_seq_cst);
+            _ids.push_back(id);
+            ABT_mutex_unlock(_mutex);
+            return id;
+        }
+
+        /**
+         * Makes find() fail for the given id and returns the database,
+         * or nullptr if the id is unknown. release() must then be called
+         * before the database is destroyed.
+         */
+        AbstractDataStore* detach(sdskv_database_id_t id) {
+            ABT_mutex_lock(_mutex);
+            slot* s = slot_for(id);
+            AbstractDataStore* db = nullptr;
+            if(s && s->generation.load() == generation_of(id))
+                db = s->db.exchange(nullptr, std::memory_order_seq_cst);
+            if(db) {
+                for(auto it = _ids.begin(); it != _ids.end(); it++) {
+                    if(*it == id) { _ids.erase(it); break; }
+                }
+            }
+            ABT_mutex_unlock(_mutex);
+            return db;
+        }
+
+        /**
+         * Waits until the references to the detached database with the given
+         * id are released, then makes its slot available for a new database.
+         */
+        void release(sdskv_database_id_t id) {
+            slot* s = slot_for(id);
+            if(!s) return;
+            while(references(*s) != 0)
+                ABT_thread_yield();
+            ABT_mutex_lock(_mutex);
+            s->group_commit.store(false, std::memory_order_relaxed);
+            delete s->combiner.exchange(nullptr);
+            s->coalesce_reads.store(false, std::memory_order_relaxed);
+            delete s->coalescer.exchange(nullptr);
+            // bumping the generation invalidates the id, the slot can be reused
+            s->generation.fetch_add(1, std::memory_order_release);
+            _free_slots.push_back(index_of(id));
+            ABT_mutex_unlock(_mutex);
+        }
+
+        /**
+         * Sets the pool in which operations of the given class (or of all
+         * the classes) on a database should run. Returns false if the id
+         * is unknown.
+         */
+        bool set_pool(sdskv_database_id_t id, sdskv_op_class_t op_class, ABT_pool pool) {
+            ABT_mutex_lock(_mutex);
+            slot* s = slot_for(id);
+            bool found = s && s->db.load() && s->generation.load() == generation_of(id);
+            if(found) {
+                for(int c = 0; c < SDSKV_OP_CLASS_ALL; c++) {
+                    if(op_class == SDSKV_OP_CLASS_ALL || op_class == c)
+                        s->pools[c].store(pool, std::memory_order_release);
+                }
+            }
+            ABT_mutex_unlock(_mutex);
+            return found;
+        }
+
+        /**
+         * Enables or disables group commit for the puts and erases on a
+         * database, a leader waiting up to max_delay seconds for more
+         * mutations to batch. Returns false if the id is unknown.
+         */
+        bool set_group_commit(sdskv_database_id_t id, bool enable, double max_delay) {
+            ABT_mutex_lock(_mutex);
+            slot* s = slot_for(id);
+            bool found = s && s->db.load() && s->generation.load() == generation_of(id);
+            if(found) {
+                WriteCombiner* c = s->combiner.load();
+                if(c) {
+                    c->set_max_delay(max_delay);
+                } else if(enable) {
+                    // kept until release() even if disabled, since
+                    // ULTs may still be using it
+                    c = new WriteCombiner(max_delay);
+                    s->combiner.store(c, std::memory_order_release);
+                }
+                s->group_commit.store(enable, std::memory_order_release);
+            }
+            ABT_mutex_unlock(_mutex);
+            return found;
+        }
+
+        /**
+         * Fills stats with the counters of the write combiner of a database
+         * (zeros if group commit was never enabled). Returns false if the
+         * id is unknown.
+         */
+        bool group_commit_stats(sdskv_database_id_t id, sdskv_group_commit_stats_t* stats) const {
+            ABT_mutex_lock(_mutex);
+            slot* s = slot_for(id);
+            bool found = s && s->db.load() && s->generation.load() == generation_of(id);
+            if(found) {
+                WriteCombiner* c = s->combiner.load();
+                stats->num_writes  = c ? c->num_writes()  : 0;
+                stats->num_batches = c ? c->num_batches() : 0;
+            }
+            ABT_mutex_unlock(_mutex);
+            return found;
+        }
+
+        /**
+         * Enables or disables the coalescing of the concurrent gets of the
+         * same key on a database. Returns false if the id is unknown.
+         */
+        bool set_read_coalescing(sdskv_database_id_t id, bool enable) {
+            ABT_mutex_lock(_mutex);
+            slot* s = slot_for(id);
+            bool found = s && s->db.load() && s->generation.load() == generation_of(id);
+            if(found) {
+                if(enable && !s->coalescer.load()) {
+                    // kept until release(), like the write combiner
+                    s->coalescer.store(new ReadCoalescer(), std::memory_order_release);
+                }
+                s->coalesce_reads.store(enable, std::memory_order_release);
+            }
+            ABT_mutex_unlock(_mutex);
+            return found;
+        }
+
+        /**
+         * Fills stats with the counters of the read coalescer of a database
+         * (zeros if read coalescing was never enabled). Returns false if the
+         * id is unknown.
+         */
+        bool read_coalescing_stats(sdskv_database_id_t id, sdskv_read_coalescing_stats_t* stats) const {
+            ABT_mutex_lock(_mutex);
+            slot* s = slot_for(id);
+            bool found = s && s->db.load() && s->generation.load() == generation_of(id);
+            if(found) {
+                ReadCoalescer* c = s->coalescer.load();
+                stats->num_gets    = c ? c->num_gets()    : 0;
+                stats->num_lookups = c ? c->num_lookups() : 0;
+                stats->num_merged  = c ? c->num_merged()  : 0;
+            }
+            ABT_mutex_unlock(_mutex);
+            return found;
+        }
+
+        /**
+         * Sets the pool in which the operations on the blocking databases
+         * run when no pool was set for their class (ABT_POOL_NULL to run
+         * them in the provider's pool).
+         */
+        void set_io_pool(ABT_pool pool) {
+            _io_pool.store(pool, std::memory_order_release);
+        }
+
+        /**
+         * Returns the ids of the databases in the table.
+         */
+        std::vector<sdskv_database_id_t> ids() const {
+            ABT_mutex_lock(_mutex);
+            std::vector<sdskv_database_id_t> result(_ids);
+            ABT_mutex_unlock(_mutex);
+            return result;
+        }
+
+        size_t size() const {
+            ABT_mutex_lock(_mutex);
+            size_t n = _ids.size();
+            ABT_mutex_unlock(_mutex);
+            return n;
+        }
+
+    private:
+
+        // the low 32 bits hold the slot index plus one, so that no id is 0
+        static sdskv_database_id_t make_id(size_t index, uint32_t generation) {
+            return ((sdskv_database_id_t)generation << 32) | (sdskv_database_id_t)(index + 1);
+        }
+
+        static uint32_t generation_of(sdskv_database_id_t id) {
+            return (uint32_t)(id >> 32);
+        }
+
+        static size_t index_of(sdskv_database_id_t id) {
+            return (size_t)(id & 0xffffffff) - 1;
+        }
+
+        static unsigned counter_index() {
+            int rank = 0;
+            ABT_xstream_self_rank(&rank);
+            return (unsigned)rank % num_counters;
+        }
+
+        static int64_t references(const slot& s) {
+            int64_t n = 0;
+            for(auto& c : s.in_flight)
+                n += c.value.load(std::memory_order_seq_cst);
+            return n;
+        }
+
+        slot& chunk_slot(size_t index) const {
+            return _chunks[index / chunk_size].load(std::memory_order_acquire)[index % chunk_size];
+        }
+
+        slot* slot_for(sdskv_database_id_t id) const {
+            if((id & 0xffffffff) == 0) return nullptr;
+            size_t index = index_of(id);
+            size_t chunk = index / chunk_size;
+            if(chunk >= max_chunks) return nullptr;
+            slot* c = _chunks[chunk].load(std::memory_order_acquire);
+            if(!c) return nullptr;
+            return &c[index % chunk_size];
+        }
+
+        mutable ABT_mutex                 _mutex;
+        std::atomic<slot*>                _chunks[max_chunks];
+        std::atomic<ABT_pool>             _io_pool;
+        size_t                            _num_slots = 0;
+        std::vector<size_t>               _free_slots;
+        std::vector<sdskv_database_id_t>  _ids;
+};
+
+#endif
@@ -13,98 +13,130 @@ using namespace std::chrono;
 BerkeleyDBDataStore::BerkeleyDBDataStore() :
   AbstractDataStore(false, false) {
   _dbm = NULL;
-  _dbenv = NULL;
   _in_memory = false;
 };
 
 BerkeleyDBDataStore::BerkeleyDBDataStore(bool eraseOnGet, bool debug) :
   AbstractDataStore(eraseOnGet, debug) {
   _dbm = NULL;
-  _dbenv = NULL;
   _in_memory = false;
 };
   
 BerkeleyDBDataStore::~BerkeleyDBDataStore() {
 //  delete _dbm;
+  // the database must be closed before its environment,
+  // which _dbenv releases if no other database uses it
   delete _wrapper;
-  delete _dbenv;
 };
 
-bool BerkeleyDBDataStore::openDatabase(const std::string& db_name, const std::string& db_path) {
-  int status = 0;
-
-  _name = db_name;
-  _path = db_path;
-  std::string fullpath = db_path;
-  if(fullpath[fullpath.size()-1] != '/') {
-    fullpath += "/";
-  }
-  fullpath += db_name;
-
-  if(!fullpath.empty()) {
-    mkdirs(fullpath.c_str());
+/* Supported options:
+ * - cache_size (size): size of the environment's cache (1G by default);
+ * - shared_env (bool): use an environment shared by all the databases of
+ *   the provider located in the same path (the first database to open it
+ *   sets its cache size and transactional mode);
+ * - transactional (bool): if 0, the environment is created without the
+ *   logging and transaction subsystems (faster, but not recoverable).
+ */
+bool BerkeleyDBDataStore::set_option(const std::string& key, const std::string& value) {
+  if (key == "cache_size") {
+    size_t v = 0;
+    if (!parse_size(value, v) || v == 0) return false;
+    _cache_size = v;
+  } else if (key == "shared_env") {
+    if (!parse_bool(value, _shared_env)) return false;
+  } else if (key == "transactional") {
+    if (!parse_bool(value, _transactional)) return false;
+  } else {
+    return false;
   }
+  return true;
+}
 
-  // initialize the environment
-  uint32_t flags = 0;
-  if (_in_memory) {
-    // not sure if we want all of these for in_memory
-    flags =
+DbEnv* BerkeleyDBDataStore::createEnv(const std::string& home) const {
+  uint32_t flags =
       DB_CREATE      | // Create the environment if it does not exist
       DB_PRIVATE     |
-      DB_RECOVER     | // Run normal recovery.
       DB_INIT_LOCK   | // Initialize the locking subsystem
-      DB_INIT_LOG    | // Initialize the logging subsystem
-      DB_INIT_TXN    | // Initialize the transactional subsystem. This
       DB_THREAD      | // Cause the environment to be free-threaded
-      DB_AUTO_COMMIT |
       DB_INIT_MPOOL;   // Initialize the memory pool (in-memory cache)
-  }
-  else {
-    flags =
-      DB_CREATE      | // Create the environment if it does not exist
-      DB_PRIVATE     |
+  if (_transactional) {
+    flags |=
       DB_RECOVER     | // Run normal recovery.
-      DB_INIT_LOCK   | // Initialize the locking subsystem
       DB_INIT_LOG    | // Initialize the logging subsystem
-      DB_INIT_TXN    | // Initialize the transactional subsystem. This
-      DB_THREAD      | // Cause the environment to be free-threaded
-      DB_AUTO_COMMIT |
-      DB_INIT_MPOOL;   // Initialize the memory pool (in-memory cache)
+      DB_INIT_TXN;     // Initialize the transactional subsystem
   }
 
+  int status = 0;
+  DbEnv* env = nullptr;
   try {
     // create and open the environment
-    uint32_t flag = DB_CXX_NO_EXCEPTIONS;
-    int scratch_size = 1; // 1GB cache
-    _dbenv = new DbEnv(flag);
-    _dbenv->set_error_stream(&std::cerr);
-    _dbenv->set_cachesize(scratch_size, 0, 0);
+    env = new DbEnv(DB_CXX_NO_EXCEPTIONS);
+    env->set_error_stream(&std::cerr);
+    env->set_cachesize(uint32_t(_cache_size >> 30), uint32_t(_cache_size & ((1 << 30) - 1)), 0);
     if (_in_memory) {
-      _dbenv->log_set_config(DB_LOG_IN_MEMORY, 1);
-      _dbenv->set_lg_bsize(scratch_size * 1024 * 1024 * 1024); // in GB
-      _dbenv->open(NULL, flags, 0);
+      if (_transactional) {
+        env->log_set_config(DB_LOG_IN_MEMORY, 1);
+        env->set_lg_bsize(1024 * 1024 * 1024); // 1GB
+      }
+      status = env->open(NULL, flags, 0);
     }
     else {
-      _dbenv->set_lk_detect(DB_LOCK_MINWRITE);
-      _dbenv->open(fullpath.c_str(), flags, 0644);
+      env->set_lk_detect(DB_LOCK_MINWRITE);
+      status = env->open(home.c_str(), flags, 0644);
+    }
+    if (status == 0 && _transactional) {
+      env->set_flags(DB_TXN_WRITE_NOSYNC,1);
+      env->set_flags(DB_TXN_NOSYNC,1);
     }
-    _dbenv->set_flags(DB_TXN_WRITE_NOSYNC,1);
-    _dbenv->set_flags(DB_TXN_NOSYNC,1);
   }
   catch (DbException &e) {
     std::cerr << "BerkeleyDBDataStore::createDatabase: BerkeleyDB error on environment open = " 
 	      << e.what() << std::endl;
     status = 1; // failure
   }
+  if (status != 0) {
+    delete env;
+    return nullptr;
+  }
+  return env;
+}
+
+bool BerkeleyDBDataStore::openDatabase(const std::string& db_name, const std::string& db_path) {
+  int status = 0;
+
+  _name = db_name;
+  _path = db_path;
+  std::string fullpath = db_path;
+  if(fullpath[fullpath.size()-1] != '/') {
+    fullpath += "/";
+  }
+  fullpath += db_name;
+
+  if(!fullpath.empty()) {
+    mkdirs(fullpath.c_str());
+  }
+
+  // initialize the environment; a shared environment lives in db_path
+  // so the database file, relative to it, is still in fullpath
+  std::string db_file = db_name;
+  if (_shared_env && _resources) {
+    std::string home = _in_memory ? std::string() : db_path;
+    _dbenv = _resources->get_or_create<DbEnv>("bdb:env:" + home,
+        [this, &home]() { return createEnv(home); });
+    if (!_in_memory) db_file = db_name + "/" + db_name;
+  } else {
+    _dbenv.reset(createEnv(fullpath));
+  }
+  if (!_dbenv) status = 1;
   
   if (status == 0) {
-    _wrapper = new DbWrapper(_dbenv, DB_CXX_NO_EXCEPTIONS);
+    _wrapper = new DbWrapper(_dbenv.get(), DB_CXX_NO_EXCEPTIONS);
     _dbm = &(_wrapper->_db);
 
     _dbm->set_bt_compare(&(BerkeleyDBDataStore::compkeys));
   
-    uint32_t flags = DB_CREATE | DB_AUTO_COMMIT | DB_THREAD; // Allow database creation
+    uint32_t flags = DB_CREATE | DB_THREAD; // Allow database creation
+    if (_transactional) flags |= DB_AUTO_COMMIT;
     if (_in_memory) {
       status = _dbm->open(NULL, // txn pointer
 			  NULL, // NULL for in-memory DB
@@ -119,7 +151,7 @@ bool BerkeleyDBDataStore::openDatabase(const std::string& db_name, const std::st
     }
     else {
       status = _dbm->open(NULL, // txn pointer
-			  db_name.c_str(), // file name
+			  db_file.c_str(), // file name
 			  NULL, // logical DB name
 			  DB_BTREE, // DB type (e.g. BTREE, HASH)
 			  flags,
@@ -199,6 +231,37 @@ int BerkeleyDBDataStore::put_multi(hg_size_t num_items,
     return SDSKV_SUCCESS;
 }
 
+/* Consecutive puts are written with a single DB_MULTIPLE put, unless in
+ * no-overwrite mode where such a put fails as a whole if one key exists.
+ * Erases, which must report whether the key existed, are applied one by one. */
+void BerkeleyDBDataStore::write_batch(hg_size_t num_ops, const write_op* ops, int* results) {
+    if(_no_overwrite) {
+        AbstractDataStore::write_batch(num_ops, ops, results);
+        return;
+    }
+    std::vector<const void*> keys, values;
+    std::vector<hg_size_t> ksizes, vsizes;
+    hg_size_t i = 0;
+    while(i < num_ops) {
+        if(ops[i].erase) {
+            results[i] = erase(ops[i].key, ops[i].ksize) ? SDSKV_SUCCESS : SDSKV_ERR_ERASE;
+            i += 1;
+            continue;
+        }
+        hg_size_t first = i;
+        keys.clear(); ksizes.clear(); values.clear(); vsizes.clear();
+        for(; i < num_ops && !ops[i].erase; i++) {
+            keys.push_back(ops[i].key);
+            ksizes.push_back(ops[i].ksize);
+            values.push_back(ops[i].value);
+            vsizes.push_back(ops[i].vsize);
+        }
+        int ret = put_multi(i - first, keys.data(), ksizes.data(), values.data(), vsizes.data());
+        for(hg_size_t j = first; j < i; j++)
+            results[j] = ret;
+    }
+}
+
 bool BerkeleyDBDataStore::exists(const void* key, hg_size_t size) const {
     Dbt db_key((void*)key, size);
     db_key.set_flags(DB_DBT_USERMEM);
@@ -206,8 +269,26 @@ bool BerkeleyDBDataStore::exists(const void* key, hg_size_t size) const {
     return status != DB_NOTFOUND;
 }
 
+bool BerkeleyDBDataStore::length(const void* key, hg_size_t ksize, hg_size_t* vsize) {
+    Dbt db_key((void*)key, uint32_t(ksize));
+    db_key.set_flags(DB_DBT_USERMEM);
+    /* a zero-length user buffer makes BerkeleyDB report the size of
+     * the value (DB_BUFFER_SMALL) without copying any of it */
+    Dbt db_data;
+    db_data.set_flags(DB_DBT_USERMEM);
+    db_data.set_ulen(0);
+    int status = _dbm->get(NULL, &db_key, &db_data, 0);
+    if(status != 0 && status != DB_BUFFER_SMALL) return false;
+    *vsize = db_data.get_size();
+    return true;
+}
+
 bool BerkeleyDBDataStore::erase(const ds_bulk_t &key) {
-    Dbt db_key((void*)key.data(), key.size());
+    return erase(key.data(), key.size());
+}
+
+bool BerkeleyDBDataStore::erase(const void* key, hg_size_t ksize) {
+    Dbt db_key((void*)key, ksize);
     int status = _dbm->del(NULL, &db_key, 0);
     return status == 0;
 }
@@ -219,13 +300,17 @@ void BerkeleyDBDataStore::sync() {
 // In the case where Duplicates::ALLOW, this will return the first
 // value found using key.
 bool BerkeleyDBDataStore::get(const ds_bulk_t &key, ds_bulk_t &data) {
+  return get(key.data(), key.size(), data);
+}
+
+bool BerkeleyDBDataStore::get(const void* key, hg_size_t ksize, ds_bulk_t &data) {
   int status = 0;
   bool success = false;
 
   data.clear();
 
-  Dbt db_key((void*)&(key[0]), uint32_t(key.size()));
-  db_key.set_ulen(uint32_t(key.size()));
+  Dbt db_key((void*)key, uint32_t(ksize));
+  db_key.set_ulen(uint32_t(ksize));
   Dbt db_data;
   db_key.set_flags(DB_DBT_USERMEM);
   db_data.set_flags(DB_DBT_MALLOC);
@@ -377,19 +462,52 @@ std::vector<std::pair<ds_bulk_t,ds_bulk_t>> BerkeleyDBDataStore::vlist_keyvals(
     return result;
 }
 
+/* Calls visitor(key, data) on the entries in [lower_bound, upper_bound)
+ * until max_items entries have been visited (0 means no limit). */
+template<typename F>
+void BerkeleyDBDataStore::range_scan(const ds_bulk_t &lower_bound, const ds_bulk_t &upper_bound,
+        hg_size_t max_items, F&& visitor) const {
+    Dbc * cursorp;
+    Dbt key, data;
+    Dbt upper((void*)upper_bound.data(), upper_bound.size());
+    int ret;
+    _dbm->cursor(NULL, &cursorp, 0);
+
+    if (lower_bound.size()) {
+        key.set_size(lower_bound.size());
+        key.set_data((void *)lower_bound.data());
+        ret = cursorp->get(&key, &data, DB_SET_RANGE);
+    } else {
+        ret = cursorp->get(&key, &data, DB_FIRST);
+    }
+    hg_size_t count = 0;
+    while (ret == 0 && (max_items == 0 || count < max_items)) {
+        if (upper_bound.size() && compkeys(_dbm, &key, &upper, NULL) >= 0)
+            break;
+        visitor(key, data);
+        count += 1;
+        ret = cursorp->get(&key, &data, DB_NEXT);
+    }
+    cursorp->close();
+}
+
 std::vector<ds_bulk_t> BerkeleyDBDataStore::vlist_key_range(
         const ds_bulk_t &lower_bound, const ds_bulk_t &upper_bound, hg_size_t max_keys) const {
     std::vector<ds_bulk_t> result;
-    // TODO implement this function
-    throw SDSKV_OP_NOT_IMPL;
+    range_scan(lower_bound, upper_bound, max_keys, [&result](const Dbt& key, const Dbt& data) {
+        result.emplace_back((char*)key.get_data(), ((char*)key.get_data())+key.get_size());
+    });
     return result;
 }
 
 std::vector<std::pair<ds_bulk_t,ds_bulk_t>> BerkeleyDBDataStore::vlist_keyval_range(
         const ds_bulk_t &lower_bound, const ds_bulk_t &upper_bound, hg_size_t max_keys) const {
     std::vector<std::pair<ds_bulk_t,ds_bulk_t>> result;
-    // TODO implement this function
-    throw SDSKV_OP_NOT_IMPL;
+    range_scan(lower_bound, upper_bound, max_keys, [&result](const Dbt& key, const Dbt& data) {
+        result.emplace_back(
+            ds_bulk_t((char*)key.get_data(), ((char*)key.get_data())+key.get_size()),
+            ds_bulk_t((char*)data.get_data(), ((char*)data.get_data())+data.get_size()));
+    });
     return result;
 }
 
@@ -424,6 +542,9 @@ remi_fileset_t BerkeleyDBDataStore::create_and_populate_fileset() const {
     if(_no_overwrite) {
         remi_fileset_register_metadata(fileset, "no_overwrite", "");
     }
+    if(!_options.empty()) {
+        remi_fileset_register_metadata(fileset, "database_options", _options.c_str());
+    }
     return fileset;
 }
 #endif
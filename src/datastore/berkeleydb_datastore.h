@@ -7,6 +7,7 @@
 #include "datastore/datastore.h"
 #include <db_cxx.h>
 #include <dbstl_map.h>
+#include <memory>
 #include "sdskv-common.h"
 
 // may want to implement some caching for persistent stores like BerkeleyDB
@@ -35,10 +36,15 @@ class BerkeleyDBDataStore : public AbstractDataStore {
                                const hg_size_t* ksizes,
                                const void* const* values,
                                const hg_size_t* vsizes) override;
+        virtual void write_batch(hg_size_t num_ops, const write_op* ops,
+                               int* results) override;
         virtual bool get(const ds_bulk_t &key, ds_bulk_t &data) override;
         virtual bool get(const ds_bulk_t &key, std::vector<ds_bulk_t> &data) override;
+        virtual bool get(const void* key, hg_size_t ksize, ds_bulk_t &data) override;
+        virtual bool length(const void* key, hg_size_t ksize, hg_size_t* vsize) override;
         virtual bool exists(const void* key, hg_size_t ksize) const override;
         virtual bool erase(const ds_bulk_t &key) override;
+        virtual bool erase(const void* key, hg_size_t ksize) override;
         virtual void set_in_memory(bool enable) override; // enable/disable in-memory mode
         virtual void set_comparison_function(const std::string& name, comparator_fn less) override;
         virtual void set_no_overwrite() override {
@@ -49,6 +55,7 @@ class BerkeleyDBDataStore : public AbstractDataStore {
         virtual remi_fileset_t create_and_populate_fileset() const override;
 #endif
     protected:
+        virtual bool set_option(const std::string& key, const std::string& value) override;
         virtual std::vector<ds_bulk_t> vlist_keys(
                 const ds_bulk_t &start, hg_size_t count, const ds_bulk_t &prefix) const override;
         virtual std::vector<std::pair<ds_bulk_t,ds_bulk_t>> vlist_keyvals(
@@ -57,9 +64,17 @@ class BerkeleyDBDataStore : public AbstractDataStore {
                 const ds_bulk_t &lower_bound, const ds_bulk_t &upper_bound, hg_size_t max_keys) const override;
         virtual std::vector<std::pair<ds_bulk_t,ds_bulk_t>> vlist_keyval_range(
                 const ds_bulk_t &lower_bound, const ds_bulk_t& upper_bound, hg_size_t max_keys) const override;
-        DbEnv *_dbenv = nullptr;
+        std::shared_ptr<DbEnv> _dbenv;
         Db *_dbm = nullptr;
         DbWrapper* _wrapper = nullptr;
+        size_t _cache_size = 1 << 30; // 1GB
+        bool _shared_env = false;
+        bool _transactional = true;
+    private:
+        DbEnv* createEnv(const std::string& home) const;
+        template<typename F>
+        void range_scan(const ds_bulk_t &lower_bound, const ds_bulk_t &upper_bound,
+                hg_size_t max_items, F&& visitor) const;
 };
 
 #endif // bdb_datastore_h
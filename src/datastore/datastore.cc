@@ -4,6 +4,7 @@
 #include "kv-config.h"
 #include <chrono>
 #include <iostream>
+#include <cstdlib>
 
 using namespace std::chrono;
 
@@ -22,3 +23,85 @@ AbstractDataStore::AbstractDataStore(bool eraseOnGet, bool debug) {
 AbstractDataStore::~AbstractDataStore()
 {};
 
+namespace {
+
+class ListingCursor : public AbstractDataStore::Cursor {
+
+  public:
+
+    ListingCursor(const AbstractDataStore* store, const ds_bulk_t& start_key, const ds_bulk_t& prefix)
+      : _store(store), _last_key(start_key), _prefix(prefix) {}
+
+    virtual hg_size_t next(hg_size_t max_items,
+                           std::vector<std::pair<ds_bulk_t,ds_bulk_t>>& result) override {
+      if(_done || max_items == 0) return 0;
+      auto batch = _store->list_keyvals(_last_key, max_items, _prefix);
+      if(batch.size() < max_items) _done = true;
+      if(!batch.empty()) _last_key = batch.back().first;
+      for(auto& p : batch) result.push_back(std::move(p));
+      return batch.size();
+    }
+
+  private:
+
+    const AbstractDataStore* _store;
+    ds_bulk_t _last_key;
+    ds_bulk_t _prefix;
+    bool _done = false;
+};
+
+}
+
+std::unique_ptr<AbstractDataStore::Cursor> AbstractDataStore::open_cursor(
+    const ds_bulk_t& start_key, const ds_bulk_t& prefix) const {
+  return std::unique_ptr<Cursor>(new ListingCursor(this, start_key, prefix));
+}
+
+
+bool AbstractDataStore::set_options(const std::string& options, DataStoreResources* resources) {
+  _resources = resources;
+  size_t pos = 0;
+  while(pos < options.size()) {
+    size_t end = options.find(',', pos);
+    if(end == std::string::npos) end = options.size();
+    std::string option = options.substr(pos, end-pos);
+    pos = end + 1;
+    if(option.empty()) continue;
+    size_t eq = option.find('=');
+    std::string key = option.substr(0, eq);
+    std::string value = eq == std::string::npos ? std::string() : option.substr(eq+1);
+    if(!set_option(key, value)) {
+      std::cerr << "AbstractDataStore::set_options: invalid option \"" << option << "\"" << std::endl;
+      return false;
+    }
+  }
+  _options = options;
+  return true;
+}
+
+bool AbstractDataStore::parse_size(const std::string& value, size_t& size) {
+  if(value.empty()) return false;
+  char* end = nullptr;
+  unsigned long long v = strtoull(value.c_str(), &end, 10);
+  if(end == value.c_str()) return false;
+  unsigned shift = 0;
+  switch(*end) {
+    case 'K': case 'k': shift = 10; end++; break;
+    case 'M': case 'm': shift = 20; end++; break;
+    case 'G': case 'g': shift = 30; end++; break;
+  }
+  if(*end != '\0') return false;
+  size = (size_t)(v << shift);
+  return true;
+}
+
+bool AbstractDataStore::parse_bool(const std::string& value, bool& flag) {
+  if(value == "1" || value == "on" || value == "true") {
+    flag = true;
+  } else if(value == "0" || value == "off" || value == "false") {
+    flag = false;
+  } else {
+    return false;
+  }
+  return true;
+}
@@ -6,21 +6,46 @@
 #include "kv-config.h"
 #include "bulk.h"
 #include <margo.h>
+#include "sdskv-common.h"
+#include "datastore/datastore_resources.h"
 #ifdef USE_REMI
 #include "remi/remi-common.h"
 #endif
 
 #include <vector>
+#include <memory>
 
 class AbstractDataStore {
     public:
 
         typedef int (*comparator_fn)(const void*, hg_size_t, const void*, hg_size_t);
 
+        /**
+         * A Cursor walks the entries of a datastore in key order. Each call
+         * to next() resumes where the previous one stopped, so a paginated
+         * scan does not need to look up its start key for every page.
+         * A cursor must be destroyed before the datastore it was opened on,
+         * and must not be used by multiple ULTs concurrently.
+         */
+        class Cursor {
+            public:
+                virtual ~Cursor() = default;
+                // Appends up to max_items entries to result and returns the number
+                // of entries appended. Returning fewer than max_items entries
+                // means that the end of the scan has been reached.
+                virtual hg_size_t next(hg_size_t max_items,
+                        std::vector<std::pair<ds_bulk_t,ds_bulk_t>>& result) = 0;
+        };
+
         AbstractDataStore();
         AbstractDataStore(bool eraseOnGet, bool debug);
         virtual ~AbstractDataStore();
         virtual bool openDatabase(const std::string& db_name, const std::string& path)=0;
+        // Applies engine-specific options given as comma-separated key=value
+        // pairs (e.g. "block_cache_size=256M,bloom_bits_per_key=10").
+        // Must be called before openDatabase. Returns false if an option is
+        // not supported by the engine or has an invalid value.
+        bool set_options(const std::string& options, DataStoreResources* resources=nullptr);
         virtual int put(const void* kdata, hg_size_t ksize, const void* vdata, hg_size_t vsize)=0;
         virtual int put(const ds_bulk_t &key, const ds_bulk_t &data) {
             return put(key.data(), key.size(), data.data(), data.size());
@@ -60,15 +85,78 @@ class AbstractDataStore {
         }
         virtual bool get(const ds_bulk_t &key, ds_bulk_t &data)=0;
         virtual bool get(const ds_bulk_t &key, std::vector<ds_bulk_t> &data)=0;
+        virtual bool get(const void* key, hg_size_t ksize, ds_bulk_t &data) {
+            return get(ds_bulk_t((const char*)key, ((const char*)key)+ksize), data);
+        }
+        virtual bool length(const void* key, hg_size_t ksize, hg_size_t* vsize) {
+            ds_bulk_t data;
+            if(!get(key, ksize, data)) return false;
+            *vsize = data.size();
+            return true;
+        }
         virtual bool exists(const void* key, hg_size_t ksize) const = 0;
         virtual bool exists(const ds_bulk_t &key) const {
             return exists(key.data(), key.size());
         }
+        // Sets bit (i%8) of flags[i/8] if the i-th of the packed keys exists.
+        // Bits of keys that do not exist are left untouched.
+        virtual void exists_multi(hg_size_t num_items,
+                                  const char* keys,
+                                  const hg_size_t* ksizes,
+                                  uint8_t* flags) const
+        {
+            size_t keys_offset = 0;
+            for(hg_size_t i=0; i < num_items; i++) {
+                if(exists(keys+keys_offset, ksizes[i]))
+                    flags[i/8] |= (1 << (i%8));
+                keys_offset += ksizes[i];
+            }
+        }
         virtual bool erase(const ds_bulk_t &key) = 0;
+        virtual bool erase(const void* key, hg_size_t ksize) {
+            return erase(ds_bulk_t((const char*)key, ((const char*)key)+ksize));
+        }
+        // Erases the keys that exist; missing keys are not an error.
+        // Returns SDSKV_ERR_ERASE if the engine failed to apply the erasures.
+        virtual int erase_multi(hg_size_t num_items,
+                                const char* keys,
+                                const hg_size_t* ksizes)
+        {
+            size_t keys_offset = 0;
+            for(hg_size_t i=0; i < num_items; i++) {
+                erase(keys+keys_offset, ksizes[i]);
+                keys_offset += ksizes[i];
+            }
+            return SDSKV_SUCCESS;
+        }
+        // Mutation applied by write_batch (value and vsize are ignored for an erase).
+        struct write_op {
+            bool        erase;
+            const void* key;
+            hg_size_t   ksize;
+            const void* value;
+            hg_size_t   vsize;
+        };
+        // Applies the mutations in order and sets results[i] to the result of
+        // ops[i], i.e. the value put() returns, or SDSKV_SUCCESS/SDSKV_ERR_ERASE
+        // depending on what erase() returns. Engines that can commit several
+        // mutations at once (e.g. with a single log append) should override it.
+        virtual void write_batch(hg_size_t num_ops, const write_op* ops, int* results)
+        {
+            for(hg_size_t i=0; i < num_ops; i++) {
+                if(ops[i].erase)
+                    results[i] = erase(ops[i].key, ops[i].ksize) ? SDSKV_SUCCESS : SDSKV_ERR_ERASE;
+                else
+                    results[i] = put(ops[i].key, ops[i].ksize, ops[i].value, ops[i].vsize);
+            }
+        }
         virtual void set_in_memory(bool enable)=0; // enable/disable in-memory mode (where supported)
         virtual void set_comparison_function(const std::string& name, comparator_fn less)=0;
         virtual void set_no_overwrite()=0;
         virtual void sync() = 0;
+        virtual int get_memory_usage(sdskv_memory_usage_t* usage) const { // where supported
+            return SDSKV_OP_NOT_IMPL;
+        }
 
 #ifdef USE_REMI
         virtual remi_fileset_t create_and_populate_fileset() const = 0;
@@ -86,6 +174,10 @@ class AbstractDataStore {
             return _comp_fun_name;
         }
 
+        const std::string& get_options() const {
+            return _options;
+        }
+
         std::vector<ds_bulk_t> list_keys(
                 const ds_bulk_t &start_key, hg_size_t count, const ds_bulk_t& prefix=ds_bulk_t()) const {
             return vlist_keys(start_key, count, prefix);
@@ -96,6 +188,8 @@ class AbstractDataStore {
             return vlist_keyvals(start_key, count, prefix);
         }
 
+        // Lists the keys in [lower_bound, upper_bound), up to max_keys keys
+        // (0 means no limit). An empty upper_bound means no upper bound.
         std::vector<ds_bulk_t> list_key_range(
                 const ds_bulk_t &lower_bound, const ds_bulk_t &upper_bound, hg_size_t max_keys=0) const {
             return vlist_key_range(lower_bound, upper_bound, max_keys);
@@ -106,6 +200,13 @@ class AbstractDataStore {
             return vlist_keyval_range(lower_bound, upper_bound, max_keys);
         }
 
+        // Opens a cursor over the entries strictly after start_key (or from the
+        // first entry if start_key is empty) whose key starts with prefix.
+        // The default cursor calls list_keyvals from the last key it returned;
+        // engines whose iterators can be kept open should override this.
+        virtual std::unique_ptr<Cursor> open_cursor(
+                const ds_bulk_t& start_key, const ds_bulk_t& prefix) const;
+
     protected:
         std::string _path;
         std::string _name;
@@ -114,6 +215,18 @@ class AbstractDataStore {
         bool _eraseOnGet;
         bool _debug;
         bool _in_memory;
+        std::string _options;
+        DataStoreResources* _resources = nullptr;
+
+        // Applies a single option, called by set_options. Returns
+        // false if the option is not supported.
+        virtual bool set_option(const std::string& key, const std::string& value) {
+            return false;
+        }
+        // Parses an unsigned integer with an optional K, M or G suffix.
+        static bool parse_size(const std::string& value, size_t& size);
+        // Parses "1", "0", "on", "off", "true" or "false".
+        static bool parse_bool(const std::string& value, bool& flag);
 
         virtual std::vector<ds_bulk_t> vlist_keys(
                 const ds_bulk_t &start_key, hg_size_t count, const ds_bulk_t& prefix) const = 0;
@@ -10,6 +10,8 @@
 #include "datastore.h"
 
 #include "map_datastore.h"
+#include "sharded_map_datastore.h"
+#include "hash_datastore.h"
 #include "null_datastore.h"
 
 #ifdef USE_BWTREE
@@ -27,9 +29,34 @@
 class datastore_factory {
 
     static AbstractDataStore* open_map_datastore(
-            const std::string& name, const std::string& path) {
+            const std::string& name, const std::string& path,
+            const std::string& options, DataStoreResources* resources) {
         auto db = new MapDataStore();
-        if(db->openDatabase(name, path)) {
+        if(db->set_options(options, resources) && db->openDatabase(name, path)) {
+            return db;
+        } else {
+            delete db;
+            return nullptr;
+        }
+    }
+
+    static AbstractDataStore* open_sharded_map_datastore(
+            const std::string& name, const std::string& path,
+            const std::string& options, DataStoreResources* resources) {
+        auto db = new ShardedMapDataStore();
+        if(db->set_options(options, resources) && db->openDatabase(name, path)) {
+            return db;
+        } else {
+            delete db;
+            return nullptr;
+        }
+    }
+
+    static AbstractDataStore* open_hash_datastore(
+            const std::string& name, const std::string& path,
+            const std::string& options, DataStoreResources* resources) {
+        auto db = new HashDataStore();
+        if(db->set_options(options, resources) && db->openDatabase(name, path)) {
             return db;
         } else {
             delete db;
@@ -38,9 +65,10 @@ class datastore_factory {
     }
 
     static AbstractDataStore* open_null_datastore(
-            const std::string& name, const std::string& path) {
+            const std::string& name, const std::string& path,
+            const std::string& options, DataStoreResources* resources) {
         auto db = new NullDataStore();
-        if(db->openDatabase(name, path)) {
+        if(db->set_options(options, resources) && db->openDatabase(name, path)) {
             return db;
         } else {
             delete db;
@@ -49,10 +77,11 @@ class datastore_factory {
     }
 
     static AbstractDataStore* open_bwtree_datastore(
-            const std::string& name, const std::string& path) {
+            const std::string& name, const std::string& path,
+            const std::string& options, DataStoreResources* resources) {
 #ifdef USE_BWTREE
         auto db = new BwTreeDataStore();
-        if(db->openDatabase(name, path)) {
+        if(db->set_options(options, resources) && db->openDatabase(name, path)) {
             return db;
         } else {
             delete db;
@@ -64,10 +93,11 @@ class datastore_factory {
     }
 
     static AbstractDataStore* open_berkeleydb_datastore(
-            const std::string& name, const std::string& path) {
+            const std::string& name, const std::string& path,
+            const std::string& options, DataStoreResources* resources) {
 #ifdef USE_BDB
         auto db = new BerkeleyDBDataStore();
-        if(db->openDatabase(name, path)) {
+        if(db->set_options(options, resources) && db->openDatabase(name, path)) {
             return db;
         } else {
             delete db;
@@ -79,10 +109,11 @@ class datastore_factory {
     }
 
     static AbstractDataStore* open_leveldb_datastore(
-            const std::string& name, const std::string& path) {
+            const std::string& name, const std::string& path,
+            const std::string& options, DataStoreResources* resources) {
 #ifdef USE_LEVELDB
         auto db = new LevelDBDataStore();
-        if(db->openDatabase(name, path)) {
+        if(db->set_options(options, resources) && db->openDatabase(name, path)) {
             return db;
         } else {
             delete db;
@@ -99,25 +130,33 @@ class datastore_factory {
     static AbstractDataStore* open_datastore(
             sdskv_db_type_t type,
             const std::string& name,
-            const std::string& path)
+            const std::string& path,
+            const std::string& options="",
+            DataStoreResources* resources=nullptr)
 #else
     static AbstractDataStore* open_datastore(
             kv_db_type_t type, 
             const std::string& name="db",
-            const std::string& path="db")
+            const std::string& path="db",
+            const std::string& options="",
+            DataStoreResources* resources=nullptr)
 #endif
     {
         switch(type) {
             case KVDB_NULL:
-                return open_null_datastore(name, path);
+                return open_null_datastore(name, path, options, resources);
             case KVDB_MAP:
-                return open_map_datastore(name, path);
+                return open_map_datastore(name, path, options, resources);
+            case KVDB_SHARDED_MAP:
+                return open_sharded_map_datastore(name, path, options, resources);
+            case KVDB_HASH:
+                return open_hash_datastore(name, path, options, resources);
             case KVDB_BWTREE:
-                return open_bwtree_datastore(name, path);
+                return open_bwtree_datastore(name, path, options, resources);
             case KVDB_LEVELDB:
-                return open_leveldb_datastore(name, path);
+                return open_leveldb_datastore(name, path, options, resources);
             case KVDB_BERKELEYDB:
-                return open_berkeleydb_datastore(name, path);
+                return open_berkeleydb_datastore(name, path, options, resources);
         }
         return nullptr;
     };
@@ -0,0 +1,59 @@
+// Copyright (c) 2017, Los Alamos National Security, LLC.
+// All rights reserved.
+#ifndef datastore_resources_h
+#define datastore_resources_h
+
+#include <map>
+#include <memory>
+#include <string>
+#include <margo.h>
+
+/**
+ * DataStoreResources holds objects that the datastores attached to the
+ * same provider may share, such as a LevelDB block cache. Each resource
+ * is stored under a name chosen by the engine that creates it. Datastores
+ * keep a shared_ptr to the resources they use, so a resource remains
+ * valid as long as the provider or any of these datastores exists.
+ */
+class DataStoreResources {
+
+    public:
+
+        DataStoreResources() {
+            ABT_mutex_create(&_mutex);
+        }
+
+        DataStoreResources(const DataStoreResources&) = delete;
+        DataStoreResources& operator=(const DataStoreResources&) = delete;
+
+        ~DataStoreResources() {
+            ABT_mutex_free(&_mutex);
+        }
+
+        /**
+         * Returns the resource registered under the given name, creating
+         * it with create() (which must return a new T*) if it does not exist.
+         * The returned pointer is null if create() returned null.
+         */
+        template<typename T, typename F>
+        std::shared_ptr<T> get_or_create(const std::string& name, F&& create) {
+            ABT_mutex_lock(_mutex);
+            auto it = _resources.find(name);
+            if(it != _resources.end()) {
+                auto r = std::static_pointer_cast<T>(it->second);
+                ABT_mutex_unlock(_mutex);
+                return r;
+            }
+            std::shared_ptr<T> r(create());
+            if(r) _resources[name] = r;
+            ABT_mutex_unlock(_mutex);
+            return r;
+        }
+
+    private:
+
+        ABT_mutex _mutex;
+        std::map<std::string, std::shared_ptr<void>> _resources;
+};
+
+#endif
@@ -0,0 +1,374 @@
+// Copyright (c) 2017, Los Alamos National Security, LLC.
+// All rights reserved.
+#ifndef hash_datastore_h
+#define hash_datastore_h
+
+#include <memory>
+#include <vector>
+#include <cstring>
+#include <iostream>
+#include "kv-config.h"
+#include "bulk.h"
+#include "datastore/datastore.h"
+#include "datastore/slab_arena.h"
+
+/**
+ * HashDataStore is an unordered in-memory datastore meant for databases
+ * that are only accessed through point operations (put, get, exists, erase).
+ * Entries are spread over a number of bucket groups, each of which is an
+ * open-addressing hash table with linear probing, protected by its own
+ * ABT_rwlock and grown independently of the others.
+ *
+ * A slot holds the hash and the sizes of its entry inline, next to a
+ * reference to the key and value, which are stored one after the other
+ * in the slab arena of the group. Probing thus compares hashes and key
+ * sizes without leaving the slot array, and only touches the arena to
+ * compare the key bytes of a likely match.
+ *
+ * Keys are compared byte-wise; the comparison function, if any, is
+ * ignored. Listing operations are not supported.
+ */
+class HashDataStore : public AbstractDataStore {
+
+    private:
+
+        struct slot {
+            uint64_t         _hash  = 0; // 0 if the slot is unused
+            SlabArena::ref_t _ref   = 0; // key followed by the value
+            uint32_t         _ksize = 0;
+            uint32_t         _vsize = 0;
+            bool used() const { return _hash != 0; }
+        };
+
+        struct bucket_group {
+            ABT_rwlock        _lock;
+            std::vector<slot> _slots; // size is always a power of 2
+            size_t            _count = 0;
+            size_t            _data_bytes = 0;
+            SlabArena         _arena;
+            bucket_group()
+                : _slots(initial_group_capacity) {
+                ABT_rwlock_create(&_lock);
+            }
+            ~bucket_group() {
+                clear();
+                ABT_rwlock_free(&_lock);
+            }
+            const char* key_data(const slot& s) const {
+                return _arena.data(s._ref, s._ksize + s._vsize);
+            }
+            const char* value_data(const slot& s) const {
+                return key_data(s) + s._ksize;
+            }
+            void clear() {
+                for(auto& s : _slots)
+                    if(s.used()) _arena.deallocate(s._ref, s._ksize + s._vsize);
+                _slots.clear();
+                _slots.resize(initial_group_capacity);
+                _count = 0;
+                _data_bytes = 0;
+                _arena.clear();
+            }
+        };
+
+        static const size_t initial_group_capacity = 16;
+
+    public:
+
+        static const unsigned default_num_groups = 64;
+
+        HashDataStore(unsigned num_groups = default_num_groups)
+            : AbstractDataStore() {
+            init_groups(num_groups);
+        }
+
+        HashDataStore(bool eraseOnGet, bool debug, unsigned num_groups = default_num_groups)
+            : AbstractDataStore(eraseOnGet, debug) {
+            init_groups(num_groups);
+        }
+
+        ~HashDataStore() = default;
+
+        virtual bool openDatabase(const std::string& db_name, const std::string& path) override {
+            _name = db_name;
+            _path = path;
+            for(auto& g : _groups) {
+                ABT_rwlock_wrlock(g->_lock);
+                g->clear();
+                ABT_rwlock_unlock(g->_lock);
+            }
+            return true;
+        }
+
+        virtual void sync() override {}
+
+        virtual int put(const void* key, hg_size_t ksize, const void* value, hg_size_t vsize) override {
+            if(ksize > UINT32_MAX || vsize > UINT32_MAX)
+                return SDSKV_ERR_SIZE;
+            uint64_t h = hash(key, ksize);
+            auto& g = group_for(h);
+            ABT_rwlock_wrlock(g._lock);
+            int ret = unlocked_put(g, h, (const char*)key, ksize, (const char*)value, vsize);
+            ABT_rwlock_unlock(g._lock);
+            return ret;
+        }
+
+        virtual bool get(const ds_bulk_t &key, ds_bulk_t &data) override {
+            return get(key.data(), key.size(), data);
+        }
+
+        virtual bool get(const void* key, hg_size_t ksize, ds_bulk_t &data) override {
+            uint64_t h = hash(key, ksize);
+            auto& g = group_for(h);
+            ABT_rwlock_rdlock(g._lock);
+            size_t i = find(g, h, key, ksize);
+            if(i == npos) {
+                ABT_rwlock_unlock(g._lock);
+                return false;
+            }
+            const slot& sl = g._slots[i];
+            const char* v = g.value_data(sl);
+            data.assign(v, v + sl._vsize);
+            ABT_rwlock_unlock(g._lock);
+            return true;
+        }
+
+        virtual bool get(const ds_bulk_t &key, std::vector<ds_bulk_t>& values) override {
+            values.clear();
+            values.resize(1);
+            return get(key.data(), key.size(), values[0]);
+        }
+
+        virtual bool length(const void* key, hg_size_t ksize, hg_size_t* vsize) override {
+            uint64_t h = hash(key, ksize);
+            auto& g = group_for(h);
+            ABT_rwlock_rdlock(g._lock);
+            size_t i = find(g, h, key, ksize);
+            if(i != npos) *vsize = g._slots[i]._vsize;
+            ABT_rwlock_unlock(g._lock);
+            return i != npos;
+        }
+
+        virtual bool exists(const ds_bulk_t& key) const override {
+            return exists(key.data(), key.size());
+        }
+
+        virtual bool exists(const void* key, hg_size_t ksize) const override {
+            uint64_t h = hash(key, ksize);
+            auto& g = group_for(h);
+            ABT_rwlock_rdlock(g._lock);
+            bool e = find(g, h, key, ksize) != npos;
+            ABT_rwlock_unlock(g._lock);
+            return e;
+        }
+
+        virtual bool erase(const ds_bulk_t &key) override {
+            return erase(key.data(), key.size());
+        }
+
+        virtual bool erase(const void* key, hg_size_t ksize) override {
+            uint64_t h = hash(key, ksize);
+            auto& g = group_for(h);
+            ABT_rwlock_wrlock(g._lock);
+            size_t i = find(g, h, key, ksize);
+            if(i == npos) {
+                ABT_rwlock_unlock(g._lock);
+                return false;
+            }
+            slot& s = g._slots[i];
+            g._arena.deallocate(s._ref, s._ksize + s._vsize);
+            g._data_bytes -= s._ksize + s._vsize;
+            g._count -= 1;
+            erase_slot(g, i);
+            ABT_rwlock_unlock(g._lock);
+            return true;
+        }
+
+        virtual void set_in_memory(bool enable) override {
+            _in_memory = enable;
+        }
+
+        virtual void set_comparison_function(const std::string& name, comparator_fn less) override {
+           _comp_fun_name = name;
+        }
+
+        virtual void set_no_overwrite() override {
+            _no_overwrite = true;
+        }
+
+        virtual int get_memory_usage(sdskv_memory_usage_t* usage) const override {
+            *usage = sdskv_memory_usage_t();
+            for(auto& g : _groups) {
+                ABT_rwlock_rdlock(g->_lock);
+                usage->num_items     += g->_count;
+                usage->data_bytes    += g->_data_bytes;
+                usage->storage_bytes += g->_arena.allocated_bytes();
+                usage->index_bytes   += g->_slots.size() * sizeof(slot);
+                ABT_rwlock_unlock(g->_lock);
+            }
+            return SDSKV_SUCCESS;
+        }
+
+#ifdef USE_REMI
+        virtual remi_fileset_t create_and_populate_fileset() const override {
+            return REMI_FILESET_NULL;
+        }
+#endif
+
+    protected:
+
+        virtual std::vector<ds_bulk_t> vlist_keys(
+                const ds_bulk_t &start_key, hg_size_t count, const ds_bulk_t &prefix) const override {
+            throw (int)SDSKV_OP_NOT_IMPL;
+        }
+
+        virtual std::vector<std::pair<ds_bulk_t,ds_bulk_t>> vlist_keyvals(
+                const ds_bulk_t &start_key, hg_size_t count, const ds_bulk_t &prefix) const override {
+            throw (int)SDSKV_OP_NOT_IMPL;
+        }
+
+        virtual std::vector<ds_bulk_t> vlist_key_range(
+                const ds_bulk_t &lower_bound, const ds_bulk_t &upper_bound, hg_size_t max_keys) const override {
+            throw (int)SDSKV_OP_NOT_IMPL;
+        }
+
+        virtual std::vector<std::pair<ds_bulk_t,ds_bulk_t>> vlist_keyval_range(
+                const ds_bulk_t &lower_bound, const ds_bulk_t& upper_bound, hg_size_t max_keys) const override {
+            throw (int)SDSKV_OP_NOT_IMPL;
+        }
+
+    private:
+
+        static const size_t npos = (size_t)-1;
+
+        void init_groups(unsigned num_groups) {
+            if(num_groups == 0) num_groups = 1;
+            _groups.reserve(num_groups);
+            for(unsigned i = 0; i < num_groups; i++)
+                _groups.emplace_back(new bucket_group());
+        }
+
+        static uint64_t hash(const void* key, size_t ksize) {
+            // FNV-1a followed by a final avalanche so that
+            // both the low and the high bits are usable
+            uint64_t h = ds_bulk_hash_bytes(key, ksize);
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdULL;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ULL;
+            h ^= h >> 33;
+            return h ? h : 1; // 0 marks unused slots
+        }
+
+        // the high bits select the group, the low bits the slot within the group
+        bucket_group& group_for(uint64_t h) const {
+            return *_groups[(h >> 32) % _groups.size()];
+        }
+
+        static size_t find(const bucket_group& g, uint64_t h, const void* key, size_t ksize) {
+            size_t mask = g._slots.size() - 1;
+            for(size_t i = h & mask; ; i = (i+1) & mask) {
+                const slot& s = g._slots[i];
+                if(!s.used()) return npos;
+                if(s._hash == h && s._ksize == ksize
+                && (ksize == 0 || std::memcmp(g.key_data(s), key, ksize) == 0))
+                    return i;
+            }
+        }
+
+        // must be called with the group's lock held for writing
+        int unlocked_put(bucket_group& g, uint64_t h, const char* key, hg_size_t ksize,
+                         const char* value, hg_size_t vsize) {
+            size_t i = find(g, h, key, ksize);
+            if(i != npos) {
+                if(_no_overwrite)
+                    return SDSKV_ERR_KEYEXISTS;
+                slot& s = g._slots[i];
+                size_t old_size = s._ksize + s._vsize;
+                size_t new_size = ksize + vsize;
+                if(!g._arena.same_class(old_size, new_size)) {
+                    SlabArena::ref_t ref;
+                    try {
+                        ref = g._arena.allocate(new_size);
+                    } catch(const std::bad_alloc&) {
+                        return SDSKV_ERR_ALLOCATION;
+                    }
+                    if(ksize) std::memcpy(g._arena.data(ref, new_size), key, ksize);
+                    g._arena.deallocate(s._ref, old_size);
+                    s._ref = ref;
+                }
+                s._vsize = vsize;
+                if(vsize) std::memcpy(g._arena.data(s._ref, new_size) + ksize, value, vsize);
+                g._data_bytes += new_size;
+                g._data_bytes -= old_size;
+                return SDSKV_SUCCESS;
+            }
+            SlabArena::ref_t ref;
+            try {
+                ref = g._arena.allocate(ksize + vsize);
+            } catch(const std::bad_alloc&) {
+                return SDSKV_ERR_ALLOCATION;
+            }
+            slot* sp;
+            try {
+                sp = &insert_slot(g, h);
+            } catch(const std::bad_alloc&) {
+                g._arena.deallocate(ref, ksize + vsize);
+                return SDSKV_ERR_ALLOCATION;
+            }
+            slot& s = *sp;
+            s._ksize = ksize;
+            s._vsize = vsize;
+            s._ref   = ref;
+            char* data = g._arena.data(s._ref, ksize + vsize);
+            if(ksize) std::memcpy(data, key, ksize);
+            if(vsize) std::memcpy(data + ksize, value, vsize);
+            s._hash = h;
+            g._count += 1;
+            g._data_bytes += ksize + vsize;
+            return SDSKV_SUCCESS;
+        }
+
+        // Returns an unused slot for a key with hash h, growing the
+        // group if needed so that it stays at most 3/4 full. The slot
+        // is marked used once its hash is set.
+        static slot& insert_slot(bucket_group& g, uint64_t h) {
+            if(4*(g._count+1) > 3*g._slots.size()) {
+                std::vector<slot> old(2*g._slots.size());
+                old.swap(g._slots);
+                size_t mask = g._slots.size() - 1;
+                for(auto& s : old) {
+                    if(!s.used()) continue;
+                    size_t i = s._hash & mask;
+                    while(g._slots[i].used()) i = (i+1) & mask;
+                    g._slots[i] = s;
+                }
+            }
+            size_t mask = g._slots.size() - 1;
+            size_t i = h & mask;
+            while(g._slots[i].used()) i = (i+1) & mask;
+            return g._slots[i];
+        }
+
+        // Backward-shift deletion: entries following the erased slot in
+        // the same probe sequence are moved up so that no tombstone is needed.
+        static void erase_slot(bucket_group& g, size_t i) {
+            size_t mask = g._slots.size() - 1;
+            size_t j = i;
+            while(true) {
+                j = (j+1) & mask;
+                if(!g._slots[j].used()) break;
+                size_t home = g._slots[j]._hash & mask;
+                // skip entries whose home slot lies cyclically in (i, j]
+                if(i <= j ? (i < home && home <= j) : (i < home || home <= j))
+                    continue;
+                g._slots[i] = g._slots[j];
+                i = j;
+            }
+            g._slots[i] = slot();
+        }
+
+        std::vector<std::unique_ptr<bucket_group>> _groups;
+};
+
+#endif
@@ -3,6 +3,9 @@
 #include "leveldb_datastore.h"
 #include "fs_util.h"
 #include "kv-config.h"
+#include <leveldb/write_batch.h>
+#include <unordered_set>
+#include <algorithm>
 #include <cstring>
 #include <chrono>
 #include <iostream>
@@ -13,11 +16,13 @@ using namespace std::chrono;
 LevelDBDataStore::LevelDBDataStore() :
   AbstractDataStore(false, false), _less(nullptr), _keycmp(this) {
   _dbm = NULL;
+  ABT_mutex_create(&_size_cache_mutex);
 };
 
 LevelDBDataStore::LevelDBDataStore(bool eraseOnGet, bool debug) :
   AbstractDataStore(eraseOnGet, debug), _less(nullptr), _keycmp(this) {
   _dbm = NULL;
+  ABT_mutex_create(&_size_cache_mutex);
 };
   
 std::string LevelDBDataStore::toString(const ds_bulk_t &bulk_val) {
@@ -37,6 +42,7 @@ ds_bulk_t LevelDBDataStore::fromString(const std::string &str_val) {
 
 LevelDBDataStore::~LevelDBDataStore() {
   delete _dbm;
+  ABT_mutex_free(&_size_cache_mutex);
   //leveldb::Env::Shutdown(); // Riak version only
 };
 
@@ -48,12 +54,24 @@ bool LevelDBDataStore::openDatabase(const std::string& db_name, const std::strin
     _name = db_name;
     _path = db_path;
 
-  leveldb::Options options;
+  leveldb::Options options = _db_options;
   leveldb::Status status;
   
   if (!db_path.empty()) {
     mkdirs(db_path.c_str());
   }
+  if (_shared_block_cache && _resources) {
+    size_t cache_size = _block_cache_size ? _block_cache_size : 8 << 20;
+    _block_cache = _resources->get_or_create<leveldb::Cache>("leveldb:block_cache",
+        [cache_size]() { return leveldb::NewLRUCache(cache_size); });
+  } else if (_block_cache_size) {
+    _block_cache.reset(leveldb::NewLRUCache(_block_cache_size));
+  }
+  options.block_cache = _block_cache.get();
+  if (_bloom_bits_per_key) {
+    _filter_policy.reset(leveldb::NewBloomFilterPolicy(_bloom_bits_per_key));
+    options.filter_policy = _filter_policy.get();
+  }
   options.comparator = &_keycmp;
   options.create_if_missing = true;
   std::string fullname = db_path;
@@ -69,6 +87,69 @@ bool LevelDBDataStore::openDatabase(const std::string& db_name, const std::strin
   return true;
 };
 
+/* Supported options:
+ * - block_cache_size (size): capacity of the LRU block cache;
+ * - shared_block_cache (bool): use a block cache shared by all the LevelDB
+ *   databases of the provider (its size is set by the first database to use it);
+ * - bloom_bits_per_key (int): enables a bloom filter policy;
+ * - write_buffer_size (size), max_open_files (int), block_size (size);
+ * - compression (bool): enables snappy compression (enabled by default);
+ * - size_cache (int): number of value sizes cached by length(), the least
+ *   recently used size being evicted when the cache is full.
+ */
+bool LevelDBDataStore::set_option(const std::string& key, const std::string& value) {
+  size_t v = 0;
+  bool flag = false;
+  if (key == "block_cache_size") {
+    if (!parse_size(value, v)) return false;
+    _block_cache_size = v;
+  } else if (key == "shared_block_cache") {
+    if (!parse_bool(value, flag)) return false;
+    _shared_block_cache = flag;
+  } else if (key == "bloom_bits_per_key") {
+    if (!parse_size(value, v)) return false;
+    _bloom_bits_per_key = v;
+  } else if (key == "write_buffer_size") {
+    if (!parse_size(value, v)) return false;
+    _db_options.write_buffer_size = v;
+  } else if (key == "max_open_files") {
+    if (!parse_size(value, v)) return false;
+    _db_options.max_open_files = (int)v;
+  } else if (key == "block_size") {
+    if (!parse_size(value, v)) return false;
+    _db_options.block_size = v;
+  } else if (key == "compression") {
+    if (!parse_bool(value, flag)) return false;
+    _db_options.compression = flag ? leveldb::kSnappyCompression : leveldb::kNoCompression;
+  } else if (key == "size_cache") {
+    if (!parse_size(value, v)) return false;
+    set_size_cache_capacity(v);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void LevelDBDataStore::set_size_cache_capacity(size_t capacity) {
+  ABT_mutex_lock(_size_cache_mutex);
+  _size_cache_capacity.store(capacity);
+  _size_cache.clear();
+  _size_lru.clear();
+  ABT_mutex_unlock(_size_cache_mutex);
+}
+
+void LevelDBDataStore::invalidate_size(const void* key, hg_size_t ksize) {
+  if(_size_cache_capacity.load() == 0) return;
+  ABT_mutex_lock(_size_cache_mutex);
+  auto c = _size_cache.find(std::string((const char*)key, ksize));
+  if(c != _size_cache.end()) {
+    _size_lru.erase(c->second);
+    _size_cache.erase(c);
+  }
+  _size_cache_epoch += 1;
+  ABT_mutex_unlock(_size_cache_mutex);
+}
+
 void LevelDBDataStore::set_comparison_function(const std::string& name, comparator_fn less) {
     _comp_fun_name = name;
    _less = less; 
@@ -79,39 +160,215 @@ int LevelDBDataStore::put(const void* key, hg_size_t ksize, const void* value, h
   bool success = false;
 
   if(_no_overwrite) {
-      if(exists(key, ksize)) return SDSKV_ERR_KEYEXISTS;
+      std::string scratch;
+      if(key_exists(leveldb::Slice((const char*)key, ksize), &scratch))
+          return SDSKV_ERR_KEYEXISTS;
   }
 
   status = _dbm->Put(leveldb::WriteOptions(), 
             leveldb::Slice((const char*)key, ksize),
             leveldb::Slice((const char*)value, vsize));
+  invalidate_size(key, ksize);
   if (status.ok()) return SDSKV_SUCCESS;
   return SDSKV_ERR_PUT;
 };
 
+/* All the items are written with a single WriteBatch, hence a single
+ * log append. In no-overwrite mode, items whose key already exists (or
+ * appears earlier in the batch) are skipped and SDSKV_ERR_KEYEXISTS is
+ * returned after the other items are written. */
+int LevelDBDataStore::put_multi(hg_size_t num_items,
+        const void* const* keys,
+        const hg_size_t* ksizes,
+        const void* const* values,
+        const hg_size_t* vsizes)
+{
+  leveldb::WriteBatch batch;
+  int ret = SDSKV_SUCCESS;
+
+  if(_no_overwrite) {
+    std::string scratch;
+    std::unordered_set<std::string> batched;
+    for(hg_size_t i = 0; i < num_items; i++) {
+      leveldb::Slice k((const char*)keys[i], ksizes[i]);
+      if(key_exists(k, &scratch) || !batched.insert(k.ToString()).second) {
+        ret = SDSKV_ERR_KEYEXISTS;
+        continue;
+      }
+      batch.Put(k, leveldb::Slice((const char*)values[i], vsizes[i]));
+    }
+  } else {
+    for(hg_size_t i = 0; i < num_items; i++) {
+      batch.Put(leveldb::Slice((const char*)keys[i], ksizes[i]),
+                leveldb::Slice((const char*)values[i], vsizes[i]));
+    }
+  }
+
+  leveldb::Status status = _dbm->Write(leveldb::WriteOptions(), &batch);
+  for(hg_size_t i = 0; i < num_items; i++)
+    invalidate_size(keys[i], ksizes[i]);
+  if (!status.ok()) return SDSKV_ERR_PUT;
+  return ret;
+}
+
+int LevelDBDataStore::put_packed(hg_size_t num_items,
+        const char* keys,
+        const hg_size_t* ksizes,
+        const char* values,
+        const hg_size_t* vsizes)
+{
+  std::vector<const void*> kptrs(num_items);
+  std::vector<const void*> vptrs(num_items);
+  for(hg_size_t i = 0; i < num_items; i++) {
+    kptrs[i] = keys;
+    vptrs[i] = values;
+    keys   += ksizes[i];
+    values += vsizes[i];
+  }
+  return put_multi(num_items, kptrs.data(), ksizes, vptrs.data(), vsizes);
+}
+
+int LevelDBDataStore::erase_multi(hg_size_t num_items, const char* keys, const hg_size_t* ksizes) {
+    leveldb::WriteBatch batch;
+    const char* k = keys;
+    for(hg_size_t i = 0; i < num_items; i++) {
+        batch.Delete(leveldb::Slice(k, ksizes[i]));
+        k += ksizes[i];
+    }
+    leveldb::Status status = _dbm->Write(leveldb::WriteOptions(), &batch);
+    if(!status.ok()) return SDSKV_ERR_ERASE;
+    for(hg_size_t i = 0; i < num_items; i++) {
+        invalidate_size(keys, ksizes[i]);
+        keys += ksizes[i];
+    }
+    return SDSKV_SUCCESS;
+}
+
+/* The mutations are committed with a single WriteBatch. In no-overwrite
+ * mode, a put is skipped with SDSKV_ERR_KEYEXISTS if its key exists in the
+ * database or is put by an earlier mutation of the batch that is not erased
+ * in between. As with erase(), an erase succeeds if the write does. */
+void LevelDBDataStore::write_batch(hg_size_t num_ops, const write_op* ops, int* results) {
+  leveldb::WriteBatch batch;
+  std::string scratch;
+  std::unordered_map<std::string, bool> batched; // key -> exists after the batch
+
+  for(hg_size_t i = 0; i < num_ops; i++) {
+    leveldb::Slice k((const char*)ops[i].key, ops[i].ksize);
+    results[i] = SDSKV_SUCCESS;
+    if(ops[i].erase) {
+      batch.Delete(k);
+      if(_no_overwrite) batched[k.ToString()] = false;
+      continue;
+    }
+    if(_no_overwrite) {
+      auto b = batched.find(k.ToString());
+      bool exists = b != batched.end() ? b->second : key_exists(k, &scratch);
+      if(exists) {
+        results[i] = SDSKV_ERR_KEYEXISTS;
+        continue;
+      }
+      batched[k.ToString()] = true;
+    }
+    batch.Put(k, leveldb::Slice((const char*)ops[i].value, ops[i].vsize));
+  }
+
+  leveldb::Status status = _dbm->Write(leveldb::WriteOptions(), &batch);
+  for(hg_size_t i = 0; i < num_ops; i++) {
+    invalidate_size(ops[i].key, ops[i].ksize);
+    if(!status.ok() && results[i] == SDSKV_SUCCESS)
+      results[i] = ops[i].erase ? SDSKV_ERR_ERASE : SDSKV_ERR_PUT;
+  }
+}
+
 bool LevelDBDataStore::erase(const ds_bulk_t &key) {
+    return erase(key.data(), key.size());
+}
+
+bool LevelDBDataStore::erase(const void* key, hg_size_t ksize) {
     leveldb::Status status;
-    status = _dbm->Delete(leveldb::WriteOptions(), toString(key));
+    status = _dbm->Delete(leveldb::WriteOptions(), leveldb::Slice((const char*)key, ksize));
+    invalidate_size(key, ksize);
     return status.ok();
 }
 
+/* Returns true if the key exists, leaving its value in *scratch. Point
+ * lookups go through DB::Get rather than an iterator because only Get
+ * consults the filter policy, so that a bloom filter (bloom_bits_per_key)
+ * answers most lookups of missing keys without reading a data block.
+ * Passing the same scratch string to successive calls reuses its buffer. */
+bool LevelDBDataStore::key_exists(const leveldb::Slice& key, std::string* scratch) const {
+    leveldb::ReadOptions options;
+    options.fill_cache = false;
+    return _dbm->Get(options, key, scratch).ok();
+}
+
 bool LevelDBDataStore::exists(const void* key, hg_size_t ksize) const {
-    leveldb::Status status;
+    std::string scratch;
+    return key_exists(leveldb::Slice((const char*)key, ksize), &scratch);
+}
+
+void LevelDBDataStore::exists_multi(hg_size_t num_items, const char* keys,
+        const hg_size_t* ksizes, uint8_t* flags) const {
+    std::string scratch;
+    for(hg_size_t i = 0; i < num_items; i++) {
+        if(key_exists(leveldb::Slice(keys, ksizes[i]), &scratch))
+            flags[i/8] |= (1 << (i%8));
+        keys += ksizes[i];
+    }
+}
+
+bool LevelDBDataStore::length(const void* key, hg_size_t ksize, hg_size_t* vsize) {
+    uint64_t epoch = 0;
+    bool use_cache = _size_cache_capacity.load() != 0;
+    if(use_cache) {
+        ABT_mutex_lock(_size_cache_mutex);
+        auto c = _size_cache.find(std::string((const char*)key, ksize));
+        if(c != _size_cache.end()) {
+            _size_lru.splice(_size_lru.begin(), _size_lru, c->second);
+            *vsize = c->second->second;
+            ABT_mutex_unlock(_size_cache_mutex);
+            return true;
+        }
+        epoch = _size_cache_epoch;
+        ABT_mutex_unlock(_size_cache_mutex);
+    }
     std::string value;
-    status = _dbm->Get(leveldb::ReadOptions(), leveldb::Slice((const char*)key, ksize), &value);
-    return status.ok();
+    bool found = key_exists(leveldb::Slice((const char*)key, ksize), &value);
+    if(found) *vsize = value.size();
+    if(found && use_cache) {
+        ABT_mutex_lock(_size_cache_mutex);
+        size_t capacity = _size_cache_capacity.load();
+        if(epoch == _size_cache_epoch && capacity != 0) {
+            std::string k((const char*)key, ksize);
+            if(_size_cache.count(k) == 0) {
+                if(_size_cache.size() >= capacity) {
+                    _size_cache.erase(_size_lru.back().first);
+                    _size_lru.pop_back();
+                }
+                _size_lru.emplace_front(k, *vsize);
+                _size_cache.emplace(std::move(k), _size_lru.begin());
+            }
+        }
+        ABT_mutex_unlock(_size_cache_mutex);
+    }
+    return found;
 }
 
 bool LevelDBDataStore::get(const ds_bulk_t &key, ds_bulk_t &data) {
+  return get(key.data(), key.size(), data);
+}
+
+bool LevelDBDataStore::get(const void* key, hg_size_t ksize, ds_bulk_t &data) {
   leveldb::Status status;
   bool success = false;
 
   //high_resolution_clock::time_point start = high_resolution_clock::now();
   data.clear();
   std::string value;
-  status = _dbm->Get(leveldb::ReadOptions(), toString(key), &value);
+  status = _dbm->Get(leveldb::ReadOptions(), leveldb::Slice((const char*)key, ksize), &value);
   if (status.ok()) {
-    data = fromString(value);
+    data.assign(value.begin(), value.end());
     success = true;
   }
   else if (!status.IsNotFound()) {
@@ -214,19 +471,99 @@ std::vector<std::pair<ds_bulk_t,ds_bulk_t>> LevelDBDataStore::vlist_keyvals(
     return result;
 }
 
+namespace {
+
+class LevelDBCursor : public AbstractDataStore::Cursor {
+
+    public:
+
+    LevelDBCursor(leveldb::Iterator* it, const ds_bulk_t& prefix)
+        : _it(it), _prefix(prefix) {}
+
+    ~LevelDBCursor() {
+        delete _it;
+    }
+
+    virtual hg_size_t next(hg_size_t max_items,
+            std::vector<std::pair<ds_bulk_t,ds_bulk_t>>& result) override {
+        hg_size_t n = 0;
+        for (; n < max_items && _it->Valid(); _it->Next()) {
+            leveldb::Slice k = _it->key();
+            /* same prefix test as vlist_keyvals: c > 0 means the key sorts
+             * before the keys with the prefix, c < 0 that it sorts after */
+            int c = std::memcmp(_prefix.data(), k.data(), std::min(_prefix.size(), k.size()));
+            if (c == 0 && k.size() < _prefix.size()) c = 1;
+            if (c > 0) continue;
+            if (c < 0) break;
+            leveldb::Slice v = _it->value();
+            result.emplace_back(ds_bulk_t(k.data(), k.data()+k.size()),
+                                ds_bulk_t(v.data(), v.data()+v.size()));
+            n += 1;
+        }
+        return n;
+    }
+
+    private:
+
+    leveldb::Iterator* _it;
+    ds_bulk_t _prefix;
+};
+
+}
+
+std::unique_ptr<AbstractDataStore::Cursor> LevelDBDataStore::open_cursor(
+        const ds_bulk_t& start_key, const ds_bulk_t& prefix) const {
+    leveldb::ReadOptions options;
+    /* a scan reads each block once, don't let it evict the hot blocks */
+    options.fill_cache = false;
+    leveldb::Iterator *it = _dbm->NewIterator(options);
+    if (start_key.size() > 0) {
+        it->Seek(leveldb::Slice(start_key.data(), start_key.size()));
+        /* start_key is excluded, as in vlist_keyvals */
+        if ( it->Valid() && (start_key.size() == it->key().size()) &&
+                (memcmp(it->key().data(), start_key.data(), start_key.size()) == 0))
+            it->Next();
+    } else {
+        it->SeekToFirst();
+    }
+    return std::unique_ptr<Cursor>(new LevelDBCursor(it, prefix));
+}
+
 std::vector<ds_bulk_t> LevelDBDataStore::vlist_key_range(
         const ds_bulk_t &lower_bound, const ds_bulk_t &upper_bound, hg_size_t max_keys) const {
     std::vector<ds_bulk_t> result;
-    // TODO implement this function
-    throw SDSKV_OP_NOT_IMPL;
+
+    leveldb::Iterator *it = _dbm->NewIterator(leveldb::ReadOptions());
+    leveldb::Slice upper_slice(upper_bound.data(), upper_bound.size());
+
+    /* lower_bound is included, upper_bound is excluded */
+    it->Seek(leveldb::Slice(lower_bound.data(), lower_bound.size()));
+    for (; it->Valid(); it->Next()) {
+        if (max_keys != 0 && result.size() == max_keys) break;
+        if (!upper_bound.empty() && _keycmp.Compare(it->key(), upper_slice) >= 0) break;
+        result.emplace_back(it->key().data(), it->key().data()+it->key().size());
+    }
+    delete it;
     return result;
 }
 
 std::vector<std::pair<ds_bulk_t,ds_bulk_t>> LevelDBDataStore::vlist_keyval_range(
         const ds_bulk_t &lower_bound, const ds_bulk_t &upper_bound, hg_size_t max_keys) const {
     std::vector<std::pair<ds_bulk_t,ds_bulk_t>> result;
-    // TODO implement this function
-    throw SDSKV_OP_NOT_IMPL;
+
+    leveldb::Iterator *it = _dbm->NewIterator(leveldb::ReadOptions());
+    leveldb::Slice upper_slice(upper_bound.data(), upper_bound.size());
+
+    /* lower_bound is included, upper_bound is excluded */
+    it->Seek(leveldb::Slice(lower_bound.data(), lower_bound.size()));
+    for (; it->Valid(); it->Next()) {
+        if (max_keys != 0 && result.size() == max_keys) break;
+        if (!upper_bound.empty() && _keycmp.Compare(it->key(), upper_slice) >= 0) break;
+        result.emplace_back(
+            ds_bulk_t(it->key().data(), it->key().data()+it->key().size()),
+            ds_bulk_t(it->value().data(), it->value().data()+it->value().size()));
+    }
+    delete it;
     return result;
 }
 
@@ -245,6 +582,9 @@ remi_fileset_t LevelDBDataStore::create_and_populate_fileset() const {
     if(_no_overwrite) {
         remi_fileset_register_metadata(fileset, "no_overwrite", "");
     }
+    if(!_options.empty()) {
+        remi_fileset_register_metadata(fileset, "database_options", _options.c_str());
+    }
     return fileset;
 }
 #endif
@@ -7,6 +7,12 @@
 #include <leveldb/db.h>
 #include <leveldb/comparator.h>
 #include <leveldb/env.h>
+#include <leveldb/cache.h>
+#include <leveldb/filter_policy.h>
+#include <unordered_map>
+#include <list>
+#include <atomic>
+#include <memory>
 #include "sdskv-common.h"
 #include "datastore/datastore.h"
 
@@ -43,20 +49,45 @@ class LevelDBDataStore : public AbstractDataStore {
         virtual ~LevelDBDataStore();
         virtual bool openDatabase(const std::string& db_name, const std::string& path) override;
         virtual int put(const void* key, hg_size_t ksize, const void* kdata, hg_size_t dsize) override;
+        virtual int put_multi(hg_size_t num_items,
+                               const void* const* keys,
+                               const hg_size_t* ksizes,
+                               const void* const* values,
+                               const hg_size_t* vsizes) override;
+        virtual int put_packed(hg_size_t num_items,
+                               const char* keys,
+                               const hg_size_t* ksizes,
+                               const char* values,
+                               const hg_size_t* vsizes) override;
         virtual bool get(const ds_bulk_t &key, ds_bulk_t &data) override;
         virtual bool get(const ds_bulk_t &key, std::vector<ds_bulk_t> &data) override;
+        virtual bool get(const void* key, hg_size_t ksize, ds_bulk_t &data) override;
+        virtual bool length(const void* key, hg_size_t ksize, hg_size_t* vsize) override;
         virtual bool exists(const void* key, hg_size_t ksize) const override;
+        virtual void exists_multi(hg_size_t num_items, const char* keys,
+                const hg_size_t* ksizes, uint8_t* flags) const override;
         virtual bool erase(const ds_bulk_t &key) override;
+        virtual bool erase(const void* key, hg_size_t ksize) override;
+        virtual int erase_multi(hg_size_t num_items, const char* keys,
+                const hg_size_t* ksizes) override;
+        virtual void write_batch(hg_size_t num_ops, const write_op* ops,
+                int* results) override;
         virtual void set_in_memory(bool enable) override; // not supported, a no-op
         virtual void set_comparison_function(const std::string& name, comparator_fn less) override;
         virtual void set_no_overwrite() override {
             _no_overwrite = true;
         }
         virtual void sync() override;
+        // Number of value sizes remembered by length() (0 disables the cache).
+        void set_size_cache_capacity(size_t capacity);
+        // The cursor keeps a LevelDB iterator (and hence a snapshot) open.
+        virtual std::unique_ptr<Cursor> open_cursor(
+                const ds_bulk_t& start_key, const ds_bulk_t& prefix) const override;
 #ifdef USE_REMI
         virtual remi_fileset_t create_and_populate_fileset() const override;
 #endif
     protected:
+        virtual bool set_option(const std::string& key, const std::string& value) override;
         virtual std::vector<ds_bulk_t> vlist_keys(
                 const ds_bulk_t &start, hg_size_t count, const ds_bulk_t &prefix) const override;
         virtual std::vector<std::pair<ds_bulk_t,ds_bulk_t>> vlist_keyvals(
@@ -70,8 +101,26 @@ class LevelDBDataStore : public AbstractDataStore {
         static std::string toString(const ds_bulk_t &key);
         static std::string toString(const char* bug, hg_size_t buf_size);
         static ds_bulk_t fromString(const std::string &keystr);
+        bool key_exists(const leveldb::Slice& key, std::string* scratch) const;
+        void invalidate_size(const void* key, hg_size_t ksize);
         AbstractDataStore::comparator_fn _less;
         LevelDBDataStoreComparator _keycmp;
+        // options set by set_option and used by openDatabase
+        leveldb::Options _db_options;
+        size_t _block_cache_size = 0; // 0 means LevelDB's default
+        bool _shared_block_cache = false;
+        size_t _bloom_bits_per_key = 0; // 0 means no filter
+        std::shared_ptr<leveldb::Cache> _block_cache;
+        std::unique_ptr<const leveldb::FilterPolicy> _filter_policy;
+        // LRU cache of value sizes, filled by length() and invalidated by
+        // writes; _size_cache_epoch is incremented by every invalidation so
+        // that length() does not cache a size read before a concurrent write
+        typedef std::list<std::pair<std::string, hg_size_t>> size_lru_t;
+        ABT_mutex _size_cache_mutex;
+        std::atomic<size_t> _size_cache_capacity = { 0 };
+        uint64_t _size_cache_epoch = 0;
+        size_lru_t _size_lru; // most recently used first
+        std::unordered_map<std::string, size_lru_t::iterator> _size_cache;
 };
 
 #endif // ldb_datastore_h
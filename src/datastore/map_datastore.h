@@ -3,30 +3,57 @@
 #ifndef map_datastore_h
 #define map_datastore_h
 
-#include <map>
+#include <set>
 #include <cstring>
+#include <algorithm>
 #include <iostream>
 #include "kv-config.h"
 #include "bulk.h"
 #include "datastore/datastore.h"
+#include "datastore/slab_arena.h"
 
 class MapDataStore : public AbstractDataStore {
 
     private:
 
+        // An entry stores its key immediately followed by its value
+        // in a single allocation from the slab arena.
+        struct entry {
+            uint32_t         ksize;
+            uint32_t         vsize;
+            SlabArena::ref_t ref;
+        };
+
+        // Key that has not been inserted, used for lookups.
+        struct key_view {
+            const char* data;
+            size_t      size;
+        };
+
         struct keycmp {
+            typedef void is_transparent;
             MapDataStore* _store;
             keycmp(MapDataStore* store)
                 : _store(store) {}
-            bool operator()(const ds_bulk_t& a, const ds_bulk_t& b) const {
+            bool less(const char* a, size_t asize, const char* b, size_t bsize) const {
                 if(_store->_less)
-                    return _store->_less((const void*)a.data(),
-                            a.size(), (const void*)b.data(), b.size()) < 0;
+                    return _store->_less((const void*)a, asize, (const void*)b, bsize) < 0;
                 else
-                    return std::less<ds_bulk_t>()(a,b);
+                    return std::lexicographical_compare(a, a+asize, b, b+bsize);
+            }
+            bool operator()(const entry& a, const entry& b) const {
+                return less(_store->key_data(a), a.ksize, _store->key_data(b), b.ksize);
+            }
+            bool operator()(const entry& a, const key_view& b) const {
+                return less(_store->key_data(a), a.ksize, b.data, b.size);
+            }
+            bool operator()(const key_view& a, const entry& b) const {
+                return less(a.data, a.size, _store->key_data(b), b.ksize);
             }
         };
 
+        typedef std::set<entry, keycmp> map_type;
+
     public:
 
         MapDataStore()
@@ -40,6 +67,7 @@ class MapDataStore : public AbstractDataStore {
         }
 
         ~MapDataStore() {
+            clear();
             ABT_rwlock_free(&_map_lock);
         }
 
@@ -47,57 +75,69 @@ class MapDataStore : public AbstractDataStore {
             _name = db_name;
             _path = path;
             ABT_rwlock_wrlock(_map_lock);
-            _map.clear();
+            clear();
             ABT_rwlock_unlock(_map_lock);
             return true;
         }
 
         virtual void sync() override {}
 
-        virtual int put(const ds_bulk_t &key, const ds_bulk_t &data) override {
+        virtual int put(const void* key, hg_size_t ksize, const void* value, hg_size_t vsize) override {
             ABT_rwlock_wrlock(_map_lock);
-            auto x = _map.count(key);
-            if(_no_overwrite && (x != 0)) {
-                ABT_rwlock_unlock(_map_lock);
-                return SDSKV_ERR_KEYEXISTS;
-            }
-            _map.insert(std::make_pair(key,data));
+            int ret = unlocked_put((const char*)key, ksize, (const char*)value, vsize);
             ABT_rwlock_unlock(_map_lock);
-            return SDSKV_SUCCESS;
+            return ret;
         }
 
-        virtual int put(ds_bulk_t &&key, ds_bulk_t &&data) override {
+        virtual int put_multi(hg_size_t num_items,
+                              const void* const* keys,
+                              const hg_size_t* ksizes,
+                              const void* const* values,
+                              const hg_size_t* vsizes) override
+        {
+            int ret = 0;
             ABT_rwlock_wrlock(_map_lock);
-            auto x = _map.count(key);
-            if(_no_overwrite && (x != 0)) {
-                ABT_rwlock_unlock(_map_lock);
-                return SDSKV_ERR_KEYEXISTS;
+            for(hg_size_t i=0; i < num_items; i++) {
+                int r = unlocked_put((const char*)keys[i], ksizes[i], (const char*)values[i], vsizes[i]);
+                ret = ret == 0 ? r : 0;
             }
-            _map.insert(std::make_pair(std::move(key),std::move(data)));
             ABT_rwlock_unlock(_map_lock);
-            return SDSKV_SUCCESS;
+            return ret;
         }
 
-        virtual int put(const void* key, hg_size_t ksize, const void* value, hg_size_t vsize) override {
-            if(vsize != 0) {
-                ds_bulk_t k((const char*)key, ((const char*)key)+ksize);
-                ds_bulk_t v((const char*)value, ((const char*)value)+vsize);
-                return put(std::move(k), std::move(v));
-            } else {
-                ds_bulk_t k((const char*)key, ((const char*)key)+ksize);
-                ds_bulk_t v;
-                return put(std::move(k), std::move(v));
+        virtual int put_packed(hg_size_t num_items,
+                               const char* keys,
+                               const hg_size_t* ksizes,
+                               const char* values,
+                               const hg_size_t* vsizes) override
+        {
+            int ret = 0;
+            size_t keys_offset = 0;
+            size_t vals_offset = 0;
+            ABT_rwlock_wrlock(_map_lock);
+            for(hg_size_t i=0; i < num_items; i++) {
+                int r = unlocked_put(keys+keys_offset, ksizes[i], values+vals_offset, vsizes[i]);
+                ret = ret == 0 ? r : 0;
+                keys_offset += ksizes[i];
+                vals_offset += vsizes[i];
             }
+            ABT_rwlock_unlock(_map_lock);
+            return ret;
         }
 
         virtual bool get(const ds_bulk_t &key, ds_bulk_t &data) override {
+            return get(key.data(), key.size(), data);
+        }
+
+        virtual bool get(const void* key, hg_size_t ksize, ds_bulk_t &data) override {
             ABT_rwlock_rdlock(_map_lock);
-            auto it = _map.find(key);
+            auto it = _map.find(key_view{(const char*)key, ksize});
             if(it == _map.end()) {
                 ABT_rwlock_unlock(_map_lock);
                 return false;
             }
-            data = it->second;
+            const char* v = value_data(*it);
+            data.assign(v, v + it->vsize);
             ABT_rwlock_unlock(_map_lock);
             return true;
         }
@@ -105,41 +145,96 @@ class MapDataStore : public AbstractDataStore {
         virtual bool get(const ds_bulk_t &key, std::vector<ds_bulk_t>& values) override {
             values.clear();
             values.resize(1);
-            return get(key, values[0]);
+            return get(key.data(), key.size(), values[0]);
         }
 
-        virtual bool exists(const ds_bulk_t& key) const override {
+        virtual bool length(const void* key, hg_size_t ksize, hg_size_t* vsize) override {
             ABT_rwlock_rdlock(_map_lock);
-            bool e = _map.count(key) > 0;
+            auto it = _map.find(key_view{(const char*)key, ksize});
+            bool b = it != _map.end();
+            if(b) *vsize = it->vsize;
             ABT_rwlock_unlock(_map_lock);
-            return e;
+            return b;
         }
 
         virtual bool exists(const void* key, hg_size_t ksize) const override {
-            return exists(ds_bulk_t((const char*)key, ((const char*)key)+ksize));
+            ABT_rwlock_rdlock(_map_lock);
+            bool e = _map.count(key_view{(const char*)key, ksize}) > 0;
+            ABT_rwlock_unlock(_map_lock);
+            return e;
+        }
+
+        virtual void exists_multi(hg_size_t num_items,
+                                  const char* keys,
+                                  const hg_size_t* ksizes,
+                                  uint8_t* flags) const override {
+            ABT_rwlock_rdlock(_map_lock);
+            for(hg_size_t i = 0; i < num_items; i++) {
+                if(_map.count(key_view{keys, ksizes[i]}) > 0)
+                    flags[i/8] |= (1 << (i%8));
+                keys += ksizes[i];
+            }
+            ABT_rwlock_unlock(_map_lock);
         }
 
         virtual bool erase(const ds_bulk_t &key) override {
+            return erase(key.data(), key.size());
+        }
+
+        virtual bool erase(const void* key, hg_size_t ksize) override {
             ABT_rwlock_wrlock(_map_lock);
-            bool b = _map.find(key) != _map.end();
-            _map.erase(key);
+            auto it = _map.find(key_view{(const char*)key, ksize});
+            bool b = it != _map.end();
+            if(b) {
+                _data_bytes -= it->ksize + it->vsize;
+                _arena.deallocate(it->ref, it->ksize + it->vsize);
+                _map.erase(it);
+            }
             ABT_rwlock_unlock(_map_lock);
             return b;
         }
 
+        virtual int erase_multi(hg_size_t num_items,
+                                const char* keys,
+                                const hg_size_t* ksizes) override {
+            ABT_rwlock_wrlock(_map_lock);
+            for(hg_size_t i = 0; i < num_items; i++) {
+                auto it = _map.find(key_view{keys, ksizes[i]});
+                if(it != _map.end()) {
+                    _data_bytes -= it->ksize + it->vsize;
+                    _arena.deallocate(it->ref, it->ksize + it->vsize);
+                    _map.erase(it);
+                }
+                keys += ksizes[i];
+            }
+            ABT_rwlock_unlock(_map_lock);
+            return SDSKV_SUCCESS;
+        }
+
         virtual void set_in_memory(bool enable) override {
             _in_memory = enable;
         }
 
         virtual void set_comparison_function(const std::string& name, comparator_fn less) override {
            _comp_fun_name = name;
-           _less = less; 
+           _less = less;
         }
 
         virtual void set_no_overwrite() override {
             _no_overwrite = true;
         }
 
+        virtual int get_memory_usage(sdskv_memory_usage_t* usage) const override {
+            ABT_rwlock_rdlock(_map_lock);
+            usage->num_items     = _map.size();
+            usage->data_bytes    = _data_bytes;
+            usage->storage_bytes = _arena.allocated_bytes();
+            // a red-black tree node holds 3 pointers and a color next to the entry
+            usage->index_bytes   = _map.size() * (sizeof(entry) + 4*sizeof(void*));
+            ABT_rwlock_unlock(_map_lock);
+            return SDSKV_SUCCESS;
+        }
+
 #ifdef USE_REMI
         virtual remi_fileset_t create_and_populate_fileset() const override {
             return REMI_FILESET_NULL;
@@ -154,16 +249,21 @@ class MapDataStore : public AbstractDataStore {
             std::vector<ds_bulk_t> result;
             decltype(_map.begin()) it;
             if(start_key.size() > 0) {
-                it = _map.upper_bound(start_key);
+                it = _map.upper_bound(key_view{start_key.data(), start_key.size()});
             } else {
                 it = _map.begin();
             }
             while(result.size() < count && it != _map.end()) {
-                const auto& p = *it;
-                if(prefix.size() > p.first.size()) continue;
-                int c = std::memcmp(prefix.data(), p.first.data(), prefix.size());
+                const char* k = key_data(*it);
+                if(prefix.size() > it->ksize) {
+                    if(std::memcmp(prefix.data(), k, it->ksize) < 0)
+                        break; // we have exceeded prefix
+                    it++;
+                    continue;
+                }
+                int c = std::memcmp(prefix.data(), k, prefix.size());
                 if(c == 0) {
-                    result.push_back(p.first);
+                    result.emplace_back(k, k + it->ksize);
                 } else if(c < 0) {
                     break; // we have exceeded prefix
                 }
@@ -179,16 +279,22 @@ class MapDataStore : public AbstractDataStore {
             std::vector<std::pair<ds_bulk_t,ds_bulk_t>> result;
             decltype(_map.begin()) it;
             if(start_key.size() > 0) {
-                it = _map.upper_bound(start_key);
+                it = _map.upper_bound(key_view{start_key.data(), start_key.size()});
             } else {
                 it = _map.begin();
             }
             while(result.size() < count && it != _map.end()) {
-                const auto& p = *it;
-                if(prefix.size() > p.first.size()) continue;
-                int c = std::memcmp(prefix.data(), p.first.data(), prefix.size());
+                const char* k = key_data(*it);
+                if(prefix.size() > it->ksize) {
+                    if(std::memcmp(prefix.data(), k, it->ksize) < 0)
+                        break; // we have exceeded prefix
+                    it++;
+                    continue;
+                }
+                int c = std::memcmp(prefix.data(), k, prefix.size());
                 if(c == 0) {
-                    result.push_back(p);
+                    const char* v = value_data(*it);
+                    result.emplace_back(ds_bulk_t(k, k + it->ksize), ds_bulk_t(v, v + it->vsize));
                 } else if(c < 0) {
                     break; // we have exceeded prefix
                 }
@@ -202,18 +308,13 @@ class MapDataStore : public AbstractDataStore {
                 const ds_bulk_t &lower_bound, const ds_bulk_t &upper_bound, hg_size_t max_keys) const override {
             ABT_rwlock_rdlock(_map_lock);
             std::vector<ds_bulk_t> result;
-            decltype(_map.begin()) it, ub;
-            // get the first element that goes immediately after lower_bound
-            it = _map.upper_bound(lower_bound);
-            if(it == _map.end()) {
-                return result;
-            }
-            // get the element that goes immediately before upper bound
-            ub = _map.lower_bound(upper_bound);
-            if(ub->first != upper_bound) ub++;
-
-            while(it != ub) {
-                result.push_back(it->second);
+            // get the first element that does not go before lower_bound
+            auto it = _map.lower_bound(key_view{lower_bound.data(), lower_bound.size()});
+            key_view ub{upper_bound.data(), upper_bound.size()};
+            auto less = _map.key_comp();
+            while(it != _map.end() && (upper_bound.empty() || less(*it, ub))) {
+                const char* k = key_data(*it);
+                result.emplace_back(k, k + it->ksize);
                 it++;
                 if(max_keys != 0 && result.size() == max_keys)
                     break;
@@ -226,18 +327,14 @@ class MapDataStore : public AbstractDataStore {
                 const ds_bulk_t &lower_bound, const ds_bulk_t& upper_bound, hg_size_t max_keys) const override {
             ABT_rwlock_rdlock(_map_lock);
             std::vector<std::pair<ds_bulk_t,ds_bulk_t>> result;
-            decltype(_map.begin()) it, ub;
-            // get the first element that goes immediately after lower_bound
-            it = _map.upper_bound(lower_bound);
-            if(it == _map.end()) {
-                return result;
-            }
-            // get the element that goes immediately before upper bound
-            ub = _map.lower_bound(upper_bound);
-            if(ub->first != upper_bound) ub++;
-
-            while(it != ub) {
-                result.emplace_back(it->first,it->second);
+            // get the first element that does not go before lower_bound
+            auto it = _map.lower_bound(key_view{lower_bound.data(), lower_bound.size()});
+            key_view ub{upper_bound.data(), upper_bound.size()};
+            auto less = _map.key_comp();
+            while(it != _map.end() && (upper_bound.empty() || less(*it, ub))) {
+                const char* k = key_data(*it);
+                const char* v = value_data(*it);
+                result.emplace_back(ds_bulk_t(k, k + it->ksize), ds_bulk_t(v, v + it->vsize));
                 it++;
                 if(max_keys != 0 && result.size() == max_keys)
                     break;
@@ -247,8 +344,58 @@ class MapDataStore : public AbstractDataStore {
         }
 
     private:
+
+        const char* key_data(const entry& e) const {
+            return _arena.data(e.ref, e.ksize + e.vsize);
+        }
+
+        const char* value_data(const entry& e) const {
+            return _arena.data(e.ref, e.ksize + e.vsize) + e.ksize;
+        }
+
+        // must be called with _map_lock held for writing
+        int unlocked_put(const char* key, hg_size_t ksize, const char* value, hg_size_t vsize) {
+            if(ksize > UINT32_MAX || vsize > UINT32_MAX)
+                return SDSKV_ERR_SIZE;
+            auto it = _map.find(key_view{key, ksize});
+            if(it != _map.end()) {
+                // like std::map::insert, keep the value already stored
+                return _no_overwrite ? SDSKV_ERR_KEYEXISTS : SDSKV_SUCCESS;
+            }
+            entry e;
+            e.ksize = ksize;
+            e.vsize = vsize;
+            try {
+                e.ref = _arena.allocate(ksize + vsize);
+            } catch(const std::bad_alloc&) {
+                return SDSKV_ERR_ALLOCATION;
+            }
+            char* data = _arena.data(e.ref, ksize + vsize);
+            if(ksize) std::memcpy(data, key, ksize);
+            if(vsize) std::memcpy(data + ksize, value, vsize);
+            try {
+                _map.insert(it, e);
+            } catch(const std::bad_alloc&) {
+                _arena.deallocate(e.ref, ksize + vsize);
+                return SDSKV_ERR_ALLOCATION;
+            }
+            _data_bytes += ksize + vsize;
+            return SDSKV_SUCCESS;
+        }
+
+        // must be called with _map_lock held for writing
+        void clear() {
+            for(auto& e : _map)
+                _arena.deallocate(e.ref, e.ksize + e.vsize);
+            _map.clear();
+            _arena.clear();
+            _data_bytes = 0;
+        }
+
         AbstractDataStore::comparator_fn _less;
-        std::map<ds_bulk_t, ds_bulk_t, keycmp> _map;
+        SlabArena _arena;
+        size_t _data_bytes = 0;
+        map_type _map;
         ABT_rwlock _map_lock;
 };
 
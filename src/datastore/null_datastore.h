@@ -49,6 +49,15 @@ class NullDataStore : public AbstractDataStore {
             return true;
         }
 
+        virtual bool get(const void* key, hg_size_t ksize, ds_bulk_t &data) override {
+            return true;
+        }
+
+        virtual bool length(const void* key, hg_size_t ksize, hg_size_t* vsize) override {
+            *vsize = 0;
+            return true;
+        }
+
         virtual bool exists(const ds_bulk_t& key) const override {
             return false;
         }
@@ -61,6 +70,10 @@ class NullDataStore : public AbstractDataStore {
             return false;
         }
 
+        virtual bool erase(const void* key, hg_size_t ksize) override {
+            return false;
+        }
+
         virtual void set_in_memory(bool enable) override {
         }
 
@@ -0,0 +1,355 @@
+// Copyright (c) 2017, Los Alamos National Security, LLC.
+// All rights reserved.
+#ifndef sharded_map_datastore_h
+#define sharded_map_datastore_h
+
+#include <map>
+#include <memory>
+#include <algorithm>
+#include <vector>
+#include <cstring>
+#include <iostream>
+#include "kv-config.h"
+#include "bulk.h"
+#include "datastore/datastore.h"
+
+/**
+ * ShardedMapDataStore is an ordered in-memory datastore that splits
+ * its key space across a number of std::map shards, each protected by
+ * its own ABT_rwlock. Point operations (put, get, exists, erase) only
+ * lock the shard that the key hashes to, so concurrent writers on
+ * different shards do not serialize. Listing operations lock all the
+ * shards for reading and merge them in key order.
+ *
+ * Keys are assigned to shards by hashing their bytes, hence a custom
+ * comparison function must consider two keys equal only if their
+ * bytes are equal.
+ *
+ * Supported options:
+ * - num_shards (int): number of shards (32 by default).
+ */
+class ShardedMapDataStore : public AbstractDataStore {
+
+    private:
+
+        // Key that has not been inserted, used for lookups.
+        struct key_view {
+            const char* data;
+            size_t      size;
+        };
+
+        struct keycmp {
+            typedef void is_transparent;
+            const ShardedMapDataStore* _store;
+            keycmp(const ShardedMapDataStore* store)
+                : _store(store) {}
+            bool less(const char* a, size_t asize, const char* b, size_t bsize) const {
+                if(_store->_less)
+                    return _store->_less((const void*)a, asize, (const void*)b, bsize) < 0;
+                else
+                    return std::lexicographical_compare(a, a+asize, b, b+bsize);
+            }
+            bool operator()(const ds_bulk_t& a, const ds_bulk_t& b) const {
+                return less(a.data(), a.size(), b.data(), b.size());
+            }
+            bool operator()(const ds_bulk_t& a, const key_view& b) const {
+                return less(a.data(), a.size(), b.data, b.size);
+            }
+            bool operator()(const key_view& a, const ds_bulk_t& b) const {
+                return less(a.data, a.size, b.data(), b.size());
+            }
+        };
+
+        typedef std::map<ds_bulk_t, ds_bulk_t, keycmp> map_type;
+
+        struct shard {
+            ABT_rwlock _lock;
+            map_type   _map;
+            shard(const ShardedMapDataStore* store)
+                : _map(keycmp(store)) {
+                ABT_rwlock_create(&_lock);
+            }
+            ~shard() {
+                ABT_rwlock_free(&_lock);
+            }
+        };
+
+    public:
+
+        static const unsigned default_num_shards = 32;
+
+        ShardedMapDataStore(unsigned num_shards = default_num_shards)
+            : AbstractDataStore(), _less(nullptr) {
+            init_shards(num_shards);
+        }
+
+        ShardedMapDataStore(bool eraseOnGet, bool debug, unsigned num_shards = default_num_shards)
+            : AbstractDataStore(eraseOnGet, debug), _less(nullptr) {
+            init_shards(num_shards);
+        }
+
+        ~ShardedMapDataStore() = default;
+
+        virtual bool openDatabase(const std::string& db_name, const std::string& path) override {
+            _name = db_name;
+            _path = path;
+            for(auto& s : _shards) {
+                ABT_rwlock_wrlock(s->_lock);
+                s->_map.clear();
+                ABT_rwlock_unlock(s->_lock);
+            }
+            return true;
+        }
+
+        virtual void sync() override {}
+
+        virtual int put(const ds_bulk_t &key, const ds_bulk_t &data) override {
+            auto& s = shard_for(key.data(), key.size());
+            ABT_rwlock_wrlock(s._lock);
+            auto it = s._map.find(key);
+            if(it != s._map.end()) {
+                // like MapDataStore (and std::map::insert), keep the value already stored
+                ABT_rwlock_unlock(s._lock);
+                return _no_overwrite ? SDSKV_ERR_KEYEXISTS : SDSKV_SUCCESS;
+            }
+            s._map.emplace(key, data);
+            ABT_rwlock_unlock(s._lock);
+            return SDSKV_SUCCESS;
+        }
+
+        virtual int put(ds_bulk_t &&key, ds_bulk_t &&data) override {
+            auto& s = shard_for(key.data(), key.size());
+            ABT_rwlock_wrlock(s._lock);
+            auto it = s._map.find(key);
+            if(it != s._map.end()) {
+                // like MapDataStore (and std::map::insert), keep the value already stored
+                ABT_rwlock_unlock(s._lock);
+                return _no_overwrite ? SDSKV_ERR_KEYEXISTS : SDSKV_SUCCESS;
+            }
+            s._map.emplace(std::move(key), std::move(data));
+            ABT_rwlock_unlock(s._lock);
+            return SDSKV_SUCCESS;
+        }
+
+        virtual int put(const void* key, hg_size_t ksize, const void* value, hg_size_t vsize) override {
+            ds_bulk_t k((const char*)key, ((const char*)key)+ksize);
+            ds_bulk_t v((const char*)value, ((const char*)value)+vsize);
+            return put(std::move(k), std::move(v));
+        }
+
+        virtual bool get(const ds_bulk_t &key, ds_bulk_t &data) override {
+            return get(key.data(), key.size(), data);
+        }
+
+        virtual bool get(const void* key, hg_size_t ksize, ds_bulk_t &data) override {
+            auto& s = shard_for((const char*)key, ksize);
+            ABT_rwlock_rdlock(s._lock);
+            auto it = s._map.find(key_view{(const char*)key, ksize});
+            if(it == s._map.end()) {
+                ABT_rwlock_unlock(s._lock);
+                return false;
+            }
+            data = it->second;
+            ABT_rwlock_unlock(s._lock);
+            return true;
+        }
+
+        virtual bool get(const ds_bulk_t &key, std::vector<ds_bulk_t>& values) override {
+            values.clear();
+            values.resize(1);
+            return get(key.data(), key.size(), values[0]);
+        }
+
+        virtual bool length(const void* key, hg_size_t ksize, hg_size_t* vsize) override {
+            auto& s = shard_for((const char*)key, ksize);
+            ABT_rwlock_rdlock(s._lock);
+            auto it = s._map.find(key_view{(const char*)key, ksize});
+            bool b = it != s._map.end();
+            if(b) *vsize = it->second.size();
+            ABT_rwlock_unlock(s._lock);
+            return b;
+        }
+
+        virtual bool exists(const void* key, hg_size_t ksize) const override {
+            auto& s = shard_for((const char*)key, ksize);
+            ABT_rwlock_rdlock(s._lock);
+            bool e = s._map.count(key_view{(const char*)key, ksize}) > 0;
+            ABT_rwlock_unlock(s._lock);
+            return e;
+        }
+
+        virtual bool erase(const ds_bulk_t &key) override {
+            return erase(key.data(), key.size());
+        }
+
+        virtual bool erase(const void* key, hg_size_t ksize) override {
+            auto& s = shard_for((const char*)key, ksize);
+            ABT_rwlock_wrlock(s._lock);
+            auto it = s._map.find(key_view{(const char*)key, ksize});
+            bool b = it != s._map.end();
+            if(b) s._map.erase(it);
+            ABT_rwlock_unlock(s._lock);
+            return b;
+        }
+
+        virtual void set_in_memory(bool enable) override {
+            _in_memory = enable;
+        }
+
+        virtual void set_comparison_function(const std::string& name, comparator_fn less) override {
+           _comp_fun_name = name;
+           _less = less;
+        }
+
+        virtual void set_no_overwrite() override {
+            _no_overwrite = true;
+        }
+
+#ifdef USE_REMI
+        virtual remi_fileset_t create_and_populate_fileset() const override {
+            return REMI_FILESET_NULL;
+        }
+#endif
+
+    protected:
+
+        virtual bool set_option(const std::string& key, const std::string& value) override {
+            if(key == "num_shards") {
+                size_t v = 0;
+                if(!parse_size(value, v) || v == 0) return false;
+                // options are applied before the database is opened,
+                // so the shards are still empty
+                _shards.clear();
+                init_shards(v);
+                return true;
+            }
+            return false;
+        }
+
+        virtual std::vector<ds_bulk_t> vlist_keys(
+                const ds_bulk_t &start_key, hg_size_t count, const ds_bulk_t &prefix) const override {
+            std::vector<ds_bulk_t> result;
+            merged_scan(start_key, false, [&](const map_type::value_type& p) {
+                if(result.size() >= count) return false;
+                int c = prefix_compare(prefix, p.first);
+                if(c == 0) result.push_back(p.first);
+                return c >= 0; // c < 0 means we have exceeded prefix
+            });
+            return result;
+        }
+
+        virtual std::vector<std::pair<ds_bulk_t,ds_bulk_t>> vlist_keyvals(
+                const ds_bulk_t &start_key, hg_size_t count, const ds_bulk_t &prefix) const override {
+            std::vector<std::pair<ds_bulk_t,ds_bulk_t>> result;
+            merged_scan(start_key, false, [&](const map_type::value_type& p) {
+                if(result.size() >= count) return false;
+                int c = prefix_compare(prefix, p.first);
+                if(c == 0) result.push_back(p);
+                return c >= 0; // c < 0 means we have exceeded prefix
+            });
+            return result;
+        }
+
+        virtual std::vector<ds_bulk_t> vlist_key_range(
+                const ds_bulk_t &lower_bound, const ds_bulk_t &upper_bound, hg_size_t max_keys) const override {
+            std::vector<ds_bulk_t> result;
+            keycmp less(this);
+            merged_scan(lower_bound, true, [&](const map_type::value_type& p) {
+                if(max_keys != 0 && result.size() == max_keys) return false;
+                if(!upper_bound.empty() && !less(p.first, upper_bound)) return false;
+                result.push_back(p.first);
+                return true;
+            });
+            return result;
+        }
+
+        virtual std::vector<std::pair<ds_bulk_t,ds_bulk_t>> vlist_keyval_range(
+                const ds_bulk_t &lower_bound, const ds_bulk_t& upper_bound, hg_size_t max_keys) const override {
+            std::vector<std::pair<ds_bulk_t,ds_bulk_t>> result;
+            keycmp less(this);
+            merged_scan(lower_bound, true, [&](const map_type::value_type& p) {
+                if(max_keys != 0 && result.size() == max_keys) return false;
+                if(!upper_bound.empty() && !less(p.first, upper_bound)) return false;
+                result.push_back(p);
+                return true;
+            });
+            return result;
+        }
+
+    private:
+
+        void init_shards(unsigned num_shards) {
+            if(num_shards == 0) num_shards = 1;
+            _shards.reserve(num_shards);
+            for(unsigned i = 0; i < num_shards; i++)
+                _shards.emplace_back(new shard(this));
+        }
+
+        shard& shard_for(const char* key, size_t ksize) const {
+            return *_shards[ds_bulk_hash_bytes(key, ksize) % _shards.size()];
+        }
+
+        // Returns 0 if key starts with prefix, a negative value if
+        // key sorts after all the keys starting with prefix, and a
+        // positive value otherwise.
+        static int prefix_compare(const ds_bulk_t& prefix, const ds_bulk_t& key) {
+            if(prefix.size() > key.size()) {
+                int c = std::memcmp(prefix.data(), key.data(), key.size());
+                return c == 0 ? 1 : c;
+            }
+            return std::memcmp(prefix.data(), key.data(), prefix.size());
+        }
+
+        /**
+         * Visits the entries of all the shards in key order, starting
+         * right after start_key (or at start_key if inclusive is true, or
+         * at the first key if start_key is empty), until the visitor returns
+         * false. All the shards are read-locked for the duration of the scan.
+         */
+        template<typename F>
+        void merged_scan(const ds_bulk_t& start_key, bool inclusive, F&& visitor) const {
+            typedef map_type::const_iterator iterator;
+            struct cursor {
+                iterator it;
+                iterator end;
+            };
+            keycmp less(this);
+            // heap ordered so that the cursor with the smallest key is at the front
+            auto cursor_greater = [&less](const cursor& a, const cursor& b) {
+                return less(b.it->first, a.it->first);
+            };
+            std::vector<cursor> heap;
+            heap.reserve(_shards.size());
+            for(auto& s : _shards) {
+                ABT_rwlock_rdlock(s->_lock);
+                iterator it;
+                if(start_key.size() > 0)
+                    it = inclusive ? s->_map.lower_bound(start_key) : s->_map.upper_bound(start_key);
+                else
+                    it = s->_map.begin();
+                if(it != s->_map.end())
+                    heap.push_back(cursor{it, s->_map.end()});
+            }
+            std::make_heap(heap.begin(), heap.end(), cursor_greater);
+            while(!heap.empty()) {
+                std::pop_heap(heap.begin(), heap.end(), cursor_greater);
+                cursor& c = heap.back();
+                if(!visitor(*(c.it)))
+                    break;
+                c.it++;
+                if(c.it == c.end) {
+                    heap.pop_back();
+                } else {
+                    std::push_heap(heap.begin(), heap.end(), cursor_greater);
+                }
+            }
+            for(auto& s : _shards) {
+                ABT_rwlock_unlock(s->_lock);
+            }
+        }
+
+        AbstractDataStore::comparator_fn   _less;
+        std::vector<std::unique_ptr<shard>> _shards;
+};
+
+#endif
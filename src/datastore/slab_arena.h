@@ -0,0 +1,167 @@
+// Copyright (c) 2017, Los Alamos National Security, LLC.
+// All rights reserved.
+#ifndef slab_arena_h
+#define slab_arena_h
+
+#include <algorithm>
+#include <new>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+
+/**
+ * SlabArena stores byte strings in size-classed slabs instead of giving
+ * each of them its own heap allocation. An object of a given size is
+ * placed in a chunk of the smallest size class that can hold it; chunks
+ * are carved out of large slabs, and freed chunks are chained in a
+ * per-class free list stored inside the chunks themselves.
+ *
+ * An allocation is identified by a 64-bit reference. The reference alone
+ * does not identify the size class, so the size passed to allocate()
+ * must be passed again to data() and deallocate(). Objects larger than
+ * the largest class are allocated individually with malloc.
+ *
+ * This class is not thread-safe; the caller is responsible for locking.
+ */
+class SlabArena {
+
+    public:
+
+        typedef uint64_t ref_t;
+
+        static const size_t slab_size = 1 << 16;
+        static const size_t max_chunk_size = 1 << 13;
+
+        SlabArena() {
+            // two classes per power of 2: 8, 12, 16, 24, 32, 48, ...
+            for(size_t s = 8; s <= max_chunk_size; s *= 2) {
+                _class_sizes.push_back(s);
+                if(s + s/2 <= max_chunk_size)
+                    _class_sizes.push_back(s + s/2);
+            }
+            _classes.resize(_class_sizes.size());
+        }
+
+        SlabArena(const SlabArena&) = delete;
+        SlabArena& operator=(const SlabArena&) = delete;
+
+        ~SlabArena() {
+            clear();
+        }
+
+        /**
+         * Allocates room for size bytes. Allocations of size 0
+         * do not use any memory and return 0. Throws std::bad_alloc
+         * if memory cannot be obtained from the system.
+         */
+        ref_t allocate(size_t size) {
+            if(size == 0) return 0;
+            if(size > max_chunk_size) {
+                void* p = std::malloc(size);
+                if(!p) throw std::bad_alloc();
+                _large_bytes += size;
+                return (ref_t)(uintptr_t)p;
+            }
+            auto c = size_class(size);
+            auto& sc = _classes[c];
+            if(sc.free_head != 0) {
+                ref_t ref = sc.free_head - 1;
+                std::memcpy(&sc.free_head, chunk(c, ref), sizeof(sc.free_head));
+                return ref;
+            }
+            size_t per_slab = slab_size / _class_sizes[c];
+            if(sc.num_chunks == sc.slabs.size() * per_slab) {
+                char* slab = (char*)std::malloc(slab_size);
+                if(!slab) throw std::bad_alloc();
+                try {
+                    sc.slabs.push_back(slab);
+                } catch(...) {
+                    std::free(slab);
+                    throw;
+                }
+            }
+            return sc.num_chunks++;
+        }
+
+        /**
+         * Releases an allocation previously returned by allocate(size).
+         */
+        void deallocate(ref_t ref, size_t size) {
+            if(size == 0) return;
+            if(size > max_chunk_size) {
+                _large_bytes -= size;
+                std::free((void*)(uintptr_t)ref);
+                return;
+            }
+            auto c = size_class(size);
+            auto& sc = _classes[c];
+            std::memcpy(chunk(c, ref), &sc.free_head, sizeof(sc.free_head));
+            sc.free_head = ref + 1;
+        }
+
+        /**
+         * Returns a pointer to the bytes of an allocation of the given size.
+         */
+        char* data(ref_t ref, size_t size) const {
+            if(size == 0) return nullptr;
+            if(size > max_chunk_size) return (char*)(uintptr_t)ref;
+            return chunk(size_class(size), ref);
+        }
+
+        /**
+         * Returns true if an allocation of old_size bytes can be reused
+         * in place to hold new_size bytes.
+         */
+        bool same_class(size_t old_size, size_t new_size) const {
+            if(old_size == 0 || new_size == 0) return old_size == new_size;
+            if(old_size > max_chunk_size || new_size > max_chunk_size) return false;
+            return size_class(old_size) == size_class(new_size);
+        }
+
+        /**
+         * Frees all the slabs. References obtained before become invalid,
+         * and objects larger than max_chunk_size are not released
+         * (the caller must deallocate them).
+         */
+        void clear() {
+            for(auto& sc : _classes) {
+                for(auto s : sc.slabs) std::free(s);
+                sc = size_class_t();
+            }
+        }
+
+        /**
+         * Returns the number of bytes obtained from the system.
+         */
+        size_t allocated_bytes() const {
+            size_t total = _large_bytes;
+            for(auto& sc : _classes)
+                total += sc.slabs.size() * slab_size;
+            return total;
+        }
+
+    private:
+
+        struct size_class_t {
+            std::vector<char*> slabs;
+            size_t             num_chunks = 0;
+            ref_t              free_head  = 0; // index of first free chunk + 1
+        };
+
+        unsigned size_class(size_t size) const {
+            return std::lower_bound(_class_sizes.begin(), _class_sizes.end(), size) - _class_sizes.begin();
+        }
+
+        char* chunk(unsigned c, ref_t ref) const {
+            size_t csize    = _class_sizes[c];
+            size_t per_slab = slab_size / csize;
+            return _classes[c].slabs[ref / per_slab] + (ref % per_slab)*csize;
+        }
+
+        std::vector<size_t>       _class_sizes;
+        std::vector<size_class_t> _classes;
+        size_t                    _large_bytes = 0;
+};
+
+#endif
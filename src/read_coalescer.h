@@ -0,0 +1,140 @@
+// Copyright (c) 2017, Los Alamos National Security, LLC.
+// All rights reserved.
+#ifndef read_coalescer_h
+#define read_coalescer_h
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <margo.h>
+#include "bulk.h"
+
+/**
+ * ReadCoalescer makes the concurrent gets of the same key on a database
+ * share a single engine lookup (single-flight). The first get of a key
+ * registers an in-flight lookup and performs it, the gets of that key
+ * arriving in the meantime wait for it and all of them are handed the
+ * same immutable result.
+ *
+ * A get joins an in-flight lookup only if no write completed since that
+ * lookup started, which invalidate() notes. Hence a get never returns a
+ * value older than the last write completed before it arrived.
+ */
+class ReadCoalescer {
+
+    public:
+
+        struct result {
+            bool      found = false;
+            ds_bulk_t value;
+        };
+
+        typedef std::shared_ptr<const result> result_ptr;
+
+    private:
+
+        struct flight {
+            uint64_t   epoch;
+            bool       done = false;
+            result_ptr res; // null if the lookup failed
+        };
+
+    public:
+
+        ReadCoalescer() {
+            ABT_mutex_create(&_mutex);
+            ABT_cond_create(&_cond);
+        }
+
+        ReadCoalescer(const ReadCoalescer&) = delete;
+        ReadCoalescer& operator=(const ReadCoalescer&) = delete;
+
+        ~ReadCoalescer() {
+            ABT_cond_free(&_cond);
+            ABT_mutex_free(&_mutex);
+        }
+
+        /**
+         * Returns the result of the lookup of the given key, calling
+         * lookup(result&) unless a lookup of the key is in flight.
+         * Exceptions thrown by lookup are rethrown.
+         */
+        template<typename F>
+        result_ptr get(const void* key, hg_size_t ksize, F&& lookup) {
+            _num_gets.fetch_add(1, std::memory_order_relaxed);
+            std::string k((const char*)key, ksize);
+            ABT_mutex_lock(_mutex);
+            auto it = _flights.find(k);
+            if(it != _flights.end() && it->second->epoch == _epoch.load()) {
+                std::shared_ptr<flight> f = it->second;
+                while(!f->done)
+                    ABT_cond_wait(_cond, _mutex);
+                result_ptr r = f->res;
+                ABT_mutex_unlock(_mutex);
+                if(r) {
+                    _num_merged.fetch_add(1, std::memory_order_relaxed);
+                    return r;
+                }
+                // the shared lookup failed, do our own
+                _num_lookups.fetch_add(1, std::memory_order_relaxed);
+                auto own = std::make_shared<result>();
+                lookup(*own);
+                return own;
+            }
+            // a flight started before the last write is replaced,
+            // its waiters keep it alive until it is done
+            auto f = std::make_shared<flight>();
+            f->epoch = _epoch.load();
+            _flights[k] = f;
+            ABT_mutex_unlock(_mutex);
+
+            _num_lookups.fetch_add(1, std::memory_order_relaxed);
+            auto r = std::make_shared<result>();
+            try {
+                lookup(*r);
+            } catch(...) {
+                complete(k, f, nullptr);
+                throw;
+            }
+            complete(k, f, r);
+            return r;
+        }
+
+        /**
+         * Notes that a write completed, so that the gets arriving
+         * from now on do not join the lookups in flight.
+         */
+        void invalidate() {
+            _epoch.fetch_add(1);
+        }
+
+        uint64_t num_gets() const { return _num_gets.load(std::memory_order_relaxed); }
+
+        uint64_t num_lookups() const { return _num_lookups.load(std::memory_order_relaxed); }
+
+        uint64_t num_merged() const { return _num_merged.load(std::memory_order_relaxed); }
+
+    private:
+
+        void complete(const std::string& k, const std::shared_ptr<flight>& f, result_ptr r) {
+            ABT_mutex_lock(_mutex);
+            f->res  = std::move(r);
+            f->done = true;
+            auto it = _flights.find(k);
+            if(it != _flights.end() && it->second == f)
+                _flights.erase(it);
+            ABT_cond_broadcast(_cond);
+            ABT_mutex_unlock(_mutex);
+        }
+
+        ABT_mutex                                                _mutex;
+        ABT_cond                                                 _cond;
+        std::unordered_map<std::string, std::shared_ptr<flight>> _flights;
+        std::atomic<uint64_t>                                    _epoch = { 0 };
+        std::atomic<uint64_t>                                    _num_gets = { 0 };
+        std::atomic<uint64_t>                                    _num_lookups = { 0 };
+        std::atomic<uint64_t>                                    _num_merged = { 0 };
+};
+
+#endif
@@ -30,7 +30,7 @@ struct options
 
 static void usage(int argc, char **argv)
 {
-    fprintf(stderr, "Usage: sdskv-aggr-service [OPTIONS] <listen_addr> <db name 1>[:map|:bwt|:bdb|:ldb] <db name 2>[:map|:bwt|:bdb|:ldb] ...\n");
+    fprintf(stderr, "Usage: sdskv-aggr-service [OPTIONS] <listen_addr> <db name 1>[:map|:smap|:hash|:bwt|:bdb|:ldb] <db name 2>[:map|:smap|:hash|:bwt|:bdb|:ldb] ...\n");
     fprintf(stderr, "       listen_addr is the Mercury address to listen on\n");
     fprintf(stderr, "       db name X are the names of the databases\n");
     fprintf(stderr, "       [-f filename] to write the server address to a file\n");
@@ -50,6 +50,10 @@ static sdskv_db_type_t parse_db_type(char* db_fullname) {
         return KVDB_NULL;
     } else if(strcmp(db_type, "map") == 0) {
         return KVDB_MAP;
+    } else if(strcmp(db_type, "smap") == 0) {
+        return KVDB_SHARDED_MAP;
+    } else if(strcmp(db_type, "hash") == 0) {
+        return KVDB_HASH;
     } else if(strcmp(db_type, "bwt") == 0) {
         return KVDB_BWTREE;
     } else if(strcmp(db_type, "bdb") == 0) {
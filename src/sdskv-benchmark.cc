@@ -7,6 +7,7 @@
 #include <map>
 #include <functional>
 #include <memory>
+#include <atomic>
 #include <mpi.h>
 #include <json/json.h>
 #include <sdskv-client.hpp>
@@ -320,6 +321,8 @@ class PutPackedBenchmark : public PutBenchmark {
 			//db.put_packed(m_kptrs, m_ksizes, m_vptrs, m_vsizes);
 			db.put_packed(packed_keys, m_ksizes, packed_vals, m_vsizes);
 			fprintf(stderr, "Batch size: %d and per-kv-size: %d\n", i, j*2);
+			packed_keys.clear();
+			packed_vals.clear();
 			//m_keys.resize(0);
 			//m_vals.resize(0);
 		}
@@ -773,10 +776,163 @@ class ListKeyValsBenchmark : public ListKeysBenchmark {
 };
 REGISTER_BENCHMARK("list-keyvals", ListKeyValsBenchmark);
 
+/**
+ * MixedScanGetBenchmark inherits from GetBenchmark and executes the same
+ * GET operations while a ULT keeps scanning another database (the one named
+ * by "scan-database") with large LIST KEYVALS operations. It reports the
+ * latency percentiles of the GET operations, which show how much the scans
+ * delay them (e.g. with or without "isolate-databases" on the server side).
+ */
+class MixedScanGetBenchmark : public GetBenchmark {
+
+    protected:
+
+    RemoteDatabase            m_scan_db;
+    uint64_t                  m_scan_num_entries;
+    size_t                    m_scan_key_size;
+    size_t                    m_scan_val_size;
+    size_t                    m_scan_batch_size;
+    std::vector<std::string>  m_scan_keys;
+    std::vector<double>       m_latencies;
+    std::atomic<bool>         m_stop_scans;
+    uint64_t                  m_num_scans;
+
+    static void scan_ult(void* arg) {
+        auto bench = static_cast<MixedScanGetBenchmark*>(arg);
+        auto& db = bench->m_scan_db;
+        size_t batch_size = bench->m_scan_batch_size;
+        std::vector<std::string> keys(batch_size, std::string(bench->m_scan_key_size, 0));
+        std::vector<std::string> vals(batch_size, std::string(bench->m_scan_val_size, 0));
+        std::vector<hg_size_t> ksizes(batch_size), vsizes(batch_size);
+        std::vector<void*> kptrs(batch_size), vptrs(batch_size);
+        std::string start_key = "";
+        while(!bench->m_stop_scans) {
+            hg_size_t count = batch_size;
+            for(unsigned i=0; i < batch_size; i++) {
+                ksizes[i] = keys[i].size();
+                kptrs[i]  = (void*)keys[i].data();
+                vsizes[i] = vals[i].size();
+                vptrs[i]  = (void*)vals[i].data();
+            }
+            try {
+                db.list_keyvals(start_key.data(), start_key.size(),
+                        (void**)kptrs.data(), (hg_size_t*)ksizes.data(),
+                        (void**)vptrs.data(), (hg_size_t*)vsizes.data(),
+                        &count);
+            } catch(const sdskv::exception& ex) {
+                std::cerr << "Scan failed: " << ex.what() << std::endl;
+                return;
+            }
+            // start over from the first key once the end is reached
+            if(count == batch_size)
+                start_key = std::string((const char*)kptrs[count-1], ksizes[count-1]);
+            else
+                start_key = "";
+            bench->m_num_scans += 1;
+        }
+    }
+
+    public:
+
+    template<typename ... T>
+    MixedScanGetBenchmark(Json::Value& config, T&& ... args)
+    : GetBenchmark(config, std::forward<T>(args)...)
+    , m_stop_scans(false)
+    , m_num_scans(0) {
+        m_scan_num_entries = config.get("scan-num-entries", 1024).asUInt64();
+        m_scan_key_size    = config.get("scan-key-size", 16).asUInt64();
+        m_scan_val_size    = config.get("scan-val-size", 4096).asUInt64();
+        m_scan_batch_size  = config.get("scan-batch-size", 256).asUInt();
+        if(m_scan_batch_size == 0 || m_scan_key_size == 0)
+            throw std::range_error("invalid scan-batch-size or scan-key-size");
+        auto& db = remoteDatabase();
+        if(config.isMember("scan-database")) {
+            std::string name = config["scan-database"].asString();
+            sdskv_database_id_t db_id;
+            int ret = sdskv_open(db.handle(), name.c_str(), &db_id);
+            if(ret != SDSKV_SUCCESS)
+                throw std::invalid_argument("could not open scan database "+name);
+            m_scan_db = RemoteDatabase(db.handle(), db_id);
+        } else {
+            m_scan_db = db;
+        }
+    }
+
+    virtual void setup() override {
+        GetBenchmark::setup();
+        // fill the scanned database (not part of the measure)
+        m_scan_keys.reserve(m_scan_num_entries);
+        std::string val = gen_random_string(m_scan_val_size);
+        for(unsigned i=0; i < m_scan_num_entries; i++) {
+            m_scan_keys.push_back(gen_random_string(m_scan_key_size));
+            m_scan_db.put(m_scan_keys[i], val);
+        }
+        m_latencies.resize(m_num_entries);
+        m_num_scans = 0;
+    }
+
+    virtual void execute() override {
+        // start scanning from a ULT that runs while the GETs wait for responses
+        ABT_xstream xstream;
+        ABT_pool pool;
+        ABT_xstream_self(&xstream);
+        ABT_xstream_get_main_pools(xstream, 1, &pool);
+        m_stop_scans = false;
+        ABT_thread scanner = ABT_THREAD_NULL;
+        ABT_thread_create(pool, scan_ult, this, ABT_THREAD_ATTR_NULL, &scanner);
+        // let the scans start before issuing the first GET
+        ABT_thread_yield();
+        auto& db = remoteDatabase();
+        unsigned j = 0;
+        for(unsigned i=0; i < m_num_entries; i++) {
+            auto& key = m_keys[i];
+            auto& val = m_vals_buffer[j];
+            hg_size_t vsize = m_val_size_range.second-1;
+            double t_start = ABT_get_wtime();
+            db.get((const void*)key.data(), key.size(), (void*)val.data(), &vsize);
+            m_latencies[i] = ABT_get_wtime() - t_start;
+            if(!m_reuse_buffer)
+                j += 1;
+        }
+        m_stop_scans = true;
+        ABT_thread_free(&scanner);
+    }
+
+    virtual void teardown() override {
+        // gather the GET latencies of all the clients and report their percentiles
+        int rank, num_clients;
+        MPI_Comm_rank(comm(), &rank);
+        MPI_Comm_size(comm(), &num_clients);
+        std::vector<double> latencies(m_latencies.size()*num_clients);
+        MPI_Gather(m_latencies.data(), m_latencies.size(), MPI_DOUBLE,
+                   latencies.data(), m_latencies.size(), MPI_DOUBLE, 0, comm());
+        if(rank == 0 && !latencies.empty()) {
+            std::sort(latencies.begin(), latencies.end());
+            size_t n = latencies.size();
+            std::cout << std::setprecision(9) << std::fixed;
+            std::cout << "GET p50(sec)    : " << latencies[n/2] << std::endl;
+            std::cout << "GET p99(sec)    : " << latencies[(99*n)/100] << std::endl;
+            std::cout << "GET p99.9(sec)  : " << latencies[(999*n)/1000] << std::endl;
+            std::cout << "GET max(sec)    : " << latencies[n-1] << std::endl;
+            std::cout << "Scans           : " << m_num_scans << std::endl;
+        }
+        if(m_erase_on_teardown) {
+            for(auto& key : m_scan_keys)
+                m_scan_db.erase(key);
+        }
+        m_scan_keys.resize(0); m_scan_keys.shrink_to_fit();
+        m_latencies.resize(0); m_latencies.shrink_to_fit();
+        GetBenchmark::teardown();
+    }
+};
+REGISTER_BENCHMARK("mixed-scan-get", MixedScanGetBenchmark);
+
 static void run_server(MPI_Comm comm, Json::Value& config);
 static void run_client(MPI_Comm comm, Json::Value& config);
 static void run_single_node(Json::Value& config);
 static sdskv_db_type_t database_type_from_string(const std::string& type);
+static sdskv_database_id_t attach_database_from_config(sdskv::provider* provider, const Json::Value& database_config);
+static void isolate_databases(margo_instance_id mid, sdskv::provider* provider, const std::vector<sdskv_database_id_t>& db_ids);
 static void parse_extra_cmd_arg(Json::Value& config, const char* arg);
 
 /**
@@ -863,19 +1019,21 @@ static void run_server(MPI_Comm comm, Json::Value& config) {
 
      fprintf(stderr, "Successfully set the SYMBIOMON provider\n");
 
-    // initialize database
-    auto& database_config = server_config["database"];
-    std::string db_name = database_config["name"].asString();
-    std::string db_path = database_config["path"].asString();
-    sdskv_db_type_t db_type = database_type_from_string(database_config["type"].asString());
-    sdskv_config_t db_config = {
-        .db_name = db_name.c_str(),
-        .db_path = db_path.c_str(),
-        .db_type = db_type,
-        .db_comp_fn_name = nullptr,
-        .db_no_overwrite = 0
-    };
-    provider->attach_database(db_config);
+    // initialize databases
+    std::vector<sdskv_database_id_t> db_ids;
+    sdskv_database_id_t db_id = attach_database_from_config(provider, server_config["database"]);
+    db_ids.push_back(db_id);
+    if(server_config.isMember("scan-database"))
+        db_ids.push_back(attach_database_from_config(provider, server_config["scan-database"]));
+    if(server_config.get("isolate-databases", false).asBool())
+        isolate_databases(mid, provider, db_ids);
+    auto& group_commit = server_config["group-commit"];
+    if(group_commit.get("enable", false).asBool())
+        provider->set_group_commit(db_id, true, group_commit.get("max-delay-us", 0).asUInt());
+    bool read_coalescing = server_config.get("read-coalescing", false).asBool();
+    if(read_coalescing)
+        provider->set_read_coalescing(db_id, true);
+    bool report_memory_usage = server_config["report-memory-usage"].asBool();
     // notify clients that the database is ready
     MPI_Barrier(MPI_COMM_WORLD);
     // wait for finalize
@@ -995,6 +1153,16 @@ static void run_client(MPI_Comm comm, Json::Value& config) {
                 std::cout << "Median(sec)     : " << median << std::endl;
                 std::cout << "Q3(sec)         : " << q3 << std::endl;
                 std::cout << "Maximum(sec)    : " << max << std::endl;
+            if(report_memory_usage) {
+                if(has_memory_usage) {
+                    std::cout << "Items           : " << memory_usage.num_items << std::endl;
+                    std::cout << "Data(bytes)     : " << memory_usage.data_bytes << std::endl;
+                    std::cout << "Storage(bytes)  : " << memory_usage.storage_bytes << std::endl;
+                    std::cout << "Index(bytes)    : " << memory_usage.index_bytes << std::endl;
+                } else {
+                    std::cout << "Memory usage not available for this database type" << std::endl;
+                }
+            }
             }
         }
         // wait for all the clients to be done with their tasks
@@ -1038,19 +1206,22 @@ static void run_single_node(Json::Value& config) {
      fprintf(stderr, "Successfully set the SYMBIOMON provider\n");
 
 //#endif
-    // initialize database
-    auto& database_config = server_config["database"];
-    std::string db_name = database_config["name"].asString();
-    std::string db_path = database_config["path"].asString();
-    sdskv_db_type_t db_type = database_type_from_string(database_config["type"].asString());
-    sdskv_config_t db_config = {
-        .db_name = db_name.c_str(),
-        .db_path = db_path.c_str(),
-        .db_type = db_type,
-        .db_comp_fn_name = nullptr,
-        .db_no_overwrite = 0
-    };
-    provider->attach_database(db_config);
+    // initialize databases
+    std::vector<sdskv_database_id_t> db_ids;
+    sdskv_database_id_t db_id = attach_database_from_config(provider, server_config["database"]);
+    db_ids.push_back(db_id);
+    if(server_config.isMember("scan-database"))
+        db_ids.push_back(attach_database_from_config(provider, server_config["scan-database"]));
+    if(server_config.get("isolate-databases", false).asBool())
+        isolate_databases(mid, provider, db_ids);
+    auto& group_commit = server_config["group-commit"];
+    bool group_commit_enabled = group_commit.get("enable", false).asBool();
+    if(group_commit_enabled)
+        provider->set_group_commit(db_id, true, group_commit.get("max-delay-us", 0).asUInt());
+    bool read_coalescing = server_config.get("read-coalescing", false).asBool();
+    if(read_coalescing)
+        provider->set_read_coalescing(db_id, true);
+    std::string db_name = server_config["database"]["name"].asString();
     // initialize and start client
     {
         // open remote database
@@ -1090,6 +1261,8 @@ static void run_single_node(Json::Value& config) {
             // reset the RNG
             srand(seed);
             std::vector<double> local_timings(rep);
+            sdskv_memory_usage_t memory_usage;
+            bool has_memory_usage = false;
             for(unsigned j = 0; j < rep; j++) {
                 // benchmark setup
                 bench->setup();
@@ -1098,6 +1271,13 @@ static void run_single_node(Json::Value& config) {
                 bench->execute();
                 double t_end = MPI_Wtime();
                 local_timings[j] = t_end - t_start;
+                // memory usage of the database before the last teardown
+                if(report_memory_usage && j == rep-1) {
+                    try {
+                        memory_usage = provider->get_database_memory_usage(db_id);
+                        has_memory_usage = true;
+                    } catch(const sdskv::exception& ex) {}
+                }
                 // teardown
                 bench->teardown();
             }
@@ -1134,15 +1314,86 @@ static void run_single_node(Json::Value& config) {
             std::cout << "Q3(sec)         : " << q3 << std::endl;
             std::cout << "Maximum(sec)    : " << max << std::endl;
         }
+        if(group_commit_enabled) {
+            sdskv_group_commit_stats_t stats = provider->get_group_commit_stats(db_id);
+            std::cout << "================ group commit ================" << std::endl;
+            std::cout << "Writes          : " << stats.num_writes << std::endl;
+            std::cout << "Batches         : " << stats.num_batches << std::endl;
+            if(stats.num_batches)
+                std::cout << "Writes/batch    : " << (double)stats.num_writes / stats.num_batches << std::endl;
+        }
+        if(read_coalescing) {
+            sdskv_read_coalescing_stats_t stats = provider->get_read_coalescing_stats(db_id);
+            std::cout << "================ read coalescing ================" << std::endl;
+            std::cout << "Gets            : " << stats.num_gets << std::endl;
+            std::cout << "Lookups         : " << stats.num_lookups << std::endl;
+            std::cout << "Merged          : " << stats.num_merged << std::endl;
+        }
     }
     margo_addr_free(mid, server_addr);
     margo_finalize(mid);
 }
+
+static sdskv_database_id_t attach_database_from_config(sdskv::provider* provider, const Json::Value& database_config) {
+    std::string db_name = database_config["name"].asString();
+    std::string db_path = database_config["path"].asString();
+    std::string db_options = database_config.get("options", "").asString();
+    sdskv_db_type_t db_type = database_type_from_string(database_config["type"].asString());
+    sdskv_config_t db_config = {
+        .db_name = db_name.c_str(),
+        .db_path = db_path.c_str(),
+        .db_type = db_type,
+        .db_comp_fn_name = nullptr,
+        .db_no_overwrite = 0,
+        .db_options = db_options.c_str()
+    };
+    return provider->attach_database(db_config);
+}
+
+/**
+ * Gives each database its own execution stream and pool, in which the
+ * provider runs the operations on that database once they are decoded.
+ * The execution streams are joined when margo finalizes.
+ */
+static void isolate_databases(margo_instance_id mid, sdskv::provider* provider,
+        const std::vector<sdskv_database_id_t>& db_ids) {
+    auto xstreams = new std::vector<ABT_xstream>();
+    for(auto db_id : db_ids) {
+        ABT_pool pool = ABT_POOL_NULL;
+        ABT_xstream xstream = ABT_XSTREAM_NULL;
+        int ret = ABT_pool_create_basic(ABT_POOL_FIFO_WAIT, ABT_POOL_ACCESS_MPMC, ABT_TRUE, &pool);
+        if(ret != ABT_SUCCESS) {
+            std::cerr << "Could not create a pool for database " << db_id << std::endl;
+            continue;
+        }
+        ret = ABT_xstream_create_basic(ABT_SCHED_BASIC_WAIT, 1, &pool, ABT_SCHED_CONFIG_NULL, &xstream);
+        if(ret != ABT_SUCCESS) {
+            std::cerr << "Could not create an execution stream for database " << db_id << std::endl;
+            ABT_pool_free(&pool);
+            continue;
+        }
+        xstreams->push_back(xstream);
+        provider->set_database_pool(db_id, SDSKV_OP_CLASS_ALL, pool);
+    }
+    margo_push_finalize_callback(mid, [](void* arg) {
+        auto xstreams = static_cast<std::vector<ABT_xstream>*>(arg);
+        for(auto& xstream : *xstreams) {
+            ABT_xstream_join(xstream);
+            ABT_xstream_free(&xstream);
+        }
+        delete xstreams;
+    }, xstreams);
+}
+
 static sdskv_db_type_t database_type_from_string(const std::string& type) {
     if(type == "null") {
         return KVDB_NULL;
     } else if(type == "map") {
         return KVDB_MAP;
+    } else if(type == "sharded-map" || type == "smap") {
+        return KVDB_SHARDED_MAP;
+    } else if(type == "hash") {
+        return KVDB_HASH;
     } else if(type == "leveldb" || type == "ldb") {
         return KVDB_LEVELDB;
     } else if(type == "berkeleydb" || type == "bdb") {
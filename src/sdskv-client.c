@@ -1,7 +1,9 @@
 #include "sdskv-client.h"
 #include "sdskv-rpc-types.h"
 
-#define MAX_RPC_MESSAGE_SIZE 4000 // in bytes
+#define SDSKV_DEFAULT_EAGER_SIZE 4000 // in bytes, if Mercury does not report an eager size
+#define SDSKV_RPC_HEADER_RESERVE 256  // room left in eager messages for the other RPC fields
+#define SDSKV_HANDLE_POOL_SIZE 16 // RPC handles kept per provider handle
 
 int32_t sdskv_remi_errno;
 
@@ -19,6 +21,9 @@ struct sdskv_client {
     hg_id_t sdskv_get_id;
     hg_id_t sdskv_get_multi_id;
     hg_id_t sdskv_get_packed_id;
+    hg_id_t sdskv_get_alloc_id;
+    hg_id_t sdskv_get_packed_alloc_id;
+    hg_id_t sdskv_release_bulk_id;
     hg_id_t sdskv_exists_id;
     hg_id_t sdskv_exists_multi_id;
     hg_id_t sdskv_erase_id;
@@ -29,6 +34,12 @@ struct sdskv_client {
     hg_id_t sdskv_bulk_get_id;
     hg_id_t sdskv_list_keys_id;
     hg_id_t sdskv_list_keyvals_id;
+    hg_id_t sdskv_list_keys_range_id;
+    hg_id_t sdskv_list_keyvals_range_id;
+    hg_id_t sdskv_list_packed_id;
+    hg_id_t sdskv_open_cursor_id;
+    hg_id_t sdskv_cursor_next_id;
+    hg_id_t sdskv_close_cursor_id;
     /* migration */
     hg_id_t sdskv_migrate_keys_id;
     hg_id_t sdskv_migrate_key_range_id;
@@ -37,6 +48,29 @@ struct sdskv_client {
     hg_id_t sdskv_migrate_database_id;
 
     uint64_t num_provider_handles;
+
+    /* largest payload sent inline with an RPC instead of through a bulk transfer */
+    hg_size_t eager_size;
+
+    /* cache of bulk registrations of user buffers (disabled if capacity is 0) */
+    ABT_mutex                      bulk_cache_mutex;
+    size_t                         bulk_cache_capacity;
+    size_t                         bulk_cache_count;
+    uint64_t                       bulk_cache_clock;
+    struct sdskv_bulk_cache_entry* bulk_cache;
+};
+
+struct sdskv_bulk_cache_entry {
+    void*      buffer;
+    hg_size_t  size;
+    uint8_t    flags;
+    hg_bulk_t  bulk;
+    uint64_t   last_use;
+};
+
+struct sdskv_pooled_handle {
+    hg_id_t     rpc_id;
+    hg_handle_t handle;
 };
 
 struct sdskv_provider_handle {
@@ -44,8 +78,258 @@ struct sdskv_provider_handle {
     hg_addr_t      addr;
     uint16_t       provider_id;
     uint64_t       refcount;
+    /* RPC handles kept for reuse by later requests */
+    ABT_mutex                  handle_pool_mutex;
+    size_t                     handle_pool_count;
+    struct sdskv_pooled_handle handle_pool[SDSKV_HANDLE_POOL_SIZE];
+};
+
+struct sdskv_cursor {
+    sdskv_provider_handle_t provider;
+    uint64_t                cursor_id;
+};
+
+/* An operation started by one of the sdskv_*_async functions. Once the
+ * RPC has completed, the complete callback decodes its output into the
+ * locations provided by the user. The bulk handles and buffers attached
+ * to the request must remain valid until then and are released along
+ * with the request. */
+struct sdskv_request {
+    sdskv_provider_handle_t provider;
+    hg_id_t         rpc_id;
+    hg_handle_t     handle;
+    int             reusable;
+    margo_request   req;
+    int           (*complete)(struct sdskv_request*);
+    hg_bulk_t       bulks[2];
+    void*           buffers[4];
+    /* user-provided locations receiving the results */
+    size_t          num;
+    void*           value;
+    void**          values;
+    hg_size_t*      vsizes;
+    int*            flag;
 };
 
+/* Takes an RPC handle for the given RPC from the pool of the provider
+ * handle, or creates a new one if the pool has none. */
+static hg_return_t sdskv_handle_acquire(sdskv_provider_handle_t provider,
+        hg_id_t rpc_id, hg_handle_t* handle)
+{
+    size_t i;
+    ABT_mutex_lock(provider->handle_pool_mutex);
+    for(i = provider->handle_pool_count; i > 0; i--) {
+        if(provider->handle_pool[i-1].rpc_id != rpc_id) continue;
+        *handle = provider->handle_pool[i-1].handle;
+        provider->handle_pool_count -= 1;
+        provider->handle_pool[i-1] = provider->handle_pool[provider->handle_pool_count];
+        ABT_mutex_unlock(provider->handle_pool_mutex);
+        return HG_SUCCESS;
+    }
+    ABT_mutex_unlock(provider->handle_pool_mutex);
+    return margo_create(provider->client->mid, provider->addr, rpc_id, handle);
+}
+
+/* Gives an RPC handle back to the pool of the provider handle. The
+ * handle is destroyed instead if it is not reusable or the pool is full. */
+static void sdskv_handle_release(sdskv_provider_handle_t provider,
+        hg_id_t rpc_id, hg_handle_t handle, int reusable)
+{
+    if(reusable) {
+        ABT_mutex_lock(provider->handle_pool_mutex);
+        if(provider->handle_pool_count < SDSKV_HANDLE_POOL_SIZE) {
+            provider->handle_pool[provider->handle_pool_count].rpc_id = rpc_id;
+            provider->handle_pool[provider->handle_pool_count].handle = handle;
+            provider->handle_pool_count += 1;
+            ABT_mutex_unlock(provider->handle_pool_mutex);
+            return;
+        }
+        ABT_mutex_unlock(provider->handle_pool_mutex);
+    }
+    margo_destroy(handle);
+}
+
+/* Frees the bulk cache entry at index i, which must be
+ * called with the bulk cache mutex locked. */
+static void sdskv_bulk_cache_remove_locked(sdskv_client_t client, size_t i)
+{
+    margo_bulk_free(client->bulk_cache[i].bulk);
+    client->bulk_cache_count -= 1;
+    client->bulk_cache[i] = client->bulk_cache[client->bulk_cache_count];
+}
+
+/* Creates a bulk handle exposing a single user buffer. If the bulk
+ * cache is enabled, the registration is looked up by address, size
+ * and access flags and shared with other requests using the same
+ * buffer; the least recently used registration is evicted when the
+ * cache is full. Either way the returned handle is released with
+ * margo_bulk_free. */
+static hg_return_t sdskv_bulk_create_cached(sdskv_client_t client,
+        void* buffer, hg_size_t size, uint8_t flags, hg_bulk_t* bulk)
+{
+    hg_return_t hret;
+    size_t i, lru;
+
+    if(client->bulk_cache_capacity == 0)
+        return margo_bulk_create(client->mid, 1, &buffer, &size, flags, bulk);
+
+    ABT_mutex_lock(client->bulk_cache_mutex);
+    client->bulk_cache_clock += 1;
+    for(i=0; i < client->bulk_cache_count; i++) {
+        struct sdskv_bulk_cache_entry* e = &client->bulk_cache[i];
+        if(e->buffer == buffer && e->size == size && e->flags == flags) {
+            e->last_use = client->bulk_cache_clock;
+            hret = HG_Bulk_ref_incr(e->bulk);
+            if(hret == HG_SUCCESS) *bulk = e->bulk;
+            ABT_mutex_unlock(client->bulk_cache_mutex);
+            return hret;
+        }
+    }
+    hret = margo_bulk_create(client->mid, 1, &buffer, &size, flags, bulk);
+    if(hret != HG_SUCCESS) {
+        ABT_mutex_unlock(client->bulk_cache_mutex);
+        return hret;
+    }
+    /* the cache holds its own reference to the registration */
+    if(HG_Bulk_ref_incr(*bulk) != HG_SUCCESS) {
+        ABT_mutex_unlock(client->bulk_cache_mutex);
+        return HG_SUCCESS;
+    }
+    if(client->bulk_cache_count == client->bulk_cache_capacity) {
+        lru = 0;
+        for(i=1; i < client->bulk_cache_count; i++)
+            if(client->bulk_cache[i].last_use < client->bulk_cache[lru].last_use)
+                lru = i;
+        sdskv_bulk_cache_remove_locked(client, lru);
+    }
+    i = client->bulk_cache_count;
+    client->bulk_cache[i].buffer   = buffer;
+    client->bulk_cache[i].size     = size;
+    client->bulk_cache[i].flags    = flags;
+    client->bulk_cache[i].bulk     = *bulk;
+    client->bulk_cache[i].last_use = client->bulk_cache_clock;
+    client->bulk_cache_count += 1;
+    ABT_mutex_unlock(client->bulk_cache_mutex);
+    return HG_SUCCESS;
+}
+
+static sdskv_request_t sdskv_request_create(int (*complete)(sdskv_request_t))
+{
+    sdskv_request_t r = (sdskv_request_t)calloc(1, sizeof(*r));
+    if(!r) return SDSKV_REQUEST_NULL;
+    r->handle   = HG_HANDLE_NULL;
+    r->req      = MARGO_REQUEST_NULL;
+    r->complete = complete;
+    r->bulks[0] = HG_BULK_NULL;
+    r->bulks[1] = HG_BULK_NULL;
+    return r;
+}
+
+static void sdskv_request_free(sdskv_request_t r)
+{
+    int i;
+    for(i=0; i < 2; i++)
+        if(r->bulks[i] != HG_BULK_NULL) margo_bulk_free(r->bulks[i]);
+    for(i=0; i < 4; i++)
+        free(r->buffers[i]);
+    if(r->handle != HG_HANDLE_NULL)
+        sdskv_handle_release(r->provider, r->rpc_id, r->handle, r->reusable);
+    free(r);
+}
+
+/* Creates the RPC handle of a request and forwards it without waiting
+ * for the response. On success the request is returned in *req,
+ * otherwise it is freed. */
+static int sdskv_request_forward(sdskv_provider_handle_t provider,
+        hg_id_t rpc_id, void* in, sdskv_request_t r, sdskv_request_t* req,
+        const char* caller)
+{
+    hg_return_t hret;
+
+    r->provider = provider;
+    r->rpc_id   = rpc_id;
+    hret = sdskv_handle_acquire(provider, rpc_id, &r->handle);
+    if(hret != HG_SUCCESS) {
+        fprintf(stderr,"[SDSKV] margo_create() failed in %s()\n", caller);
+        sdskv_request_free(r);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    hret = margo_provider_iforward(provider->provider_id, r->handle, in, &r->req);
+    if(hret != HG_SUCCESS) {
+        fprintf(stderr,"[SDSKV] margo_provider_iforward() failed in %s()\n", caller);
+        sdskv_request_free(r);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    *req = r;
+    return SDSKV_SUCCESS;
+}
+
+/* Completes a request whose margo request has already been waited
+ * on (hret being the result of this wait) and frees it. */
+static int sdskv_request_finish(sdskv_request_t r, hg_return_t hret)
+{
+    int ret;
+    if(hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+    } else {
+        ret = r->complete(r);
+        /* a handle that saw a Mercury error is not put back in the pool */
+        r->reusable = !SDSKV_ERROR_IS_HG(ret);
+    }
+    sdskv_request_free(r);
+    return ret;
+}
+
+static int sdskv_list_keys_internal(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id, const void *start_key, hg_size_t start_ksize,
+        const void *prefix, hg_size_t prefix_size,
+        uint8_t range, const void *upper_bound, hg_size_t upper_bound_size,
+        void **keys, hg_size_t* ksizes, hg_size_t* max_keys);
+
+static int sdskv_list_keyvals_internal(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id, const void *start_key, hg_size_t start_ksize,
+        const void *prefix, hg_size_t prefix_size,
+        uint8_t range, const void *upper_bound, hg_size_t upper_bound_size,
+        void **keys, hg_size_t* ksizes, void **values, hg_size_t* vsizes,
+        hg_size_t* max_keys);
+
+static int sdskv_list_packed_internal(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id, const void *start_key, hg_size_t start_ksize,
+        const void *prefix, hg_size_t prefix_size, uint8_t with_values,
+        void *packed_data, hg_size_t* packed_data_size,
+        const void **keys, hg_size_t* ksizes, const void **values, hg_size_t* vsizes,
+        hg_size_t* max_keys);
+
+/* Returns the largest payload that operations send inline with their RPC,
+ * derived from the eager message sizes of the Mercury class. */
+static hg_size_t sdskv_default_eager_size(margo_instance_id mid)
+{
+    hg_class_t* hg_class = margo_get_class(mid);
+    hg_size_t in_size  = HG_Class_get_input_eager_size(hg_class);
+    hg_size_t out_size = HG_Class_get_output_eager_size(hg_class);
+    hg_size_t size = in_size < out_size ? in_size : out_size;
+    if(size <= SDSKV_RPC_HEADER_RESERVE) return SDSKV_DEFAULT_EAGER_SIZE;
+    return size - SDSKV_RPC_HEADER_RESERVE;
+}
+
+/* Writes num sizes followed by the num corresponding segments
+ * back to back at dst and returns a pointer past the end. */
+static char* sdskv_pack_segments(char* dst, size_t num,
+        const void* const* ptrs, const hg_size_t* sizes)
+{
+    size_t i;
+    memcpy(dst, sizes, num*sizeof(hg_size_t));
+    dst += num*sizeof(hg_size_t);
+    for(i=0; i < num; i++) {
+        if(sizes[i] == 0) continue;
+        memcpy(dst, ptrs[i], sizes[i]);
+        dst += sizes[i];
+    }
+    return dst;
+}
+
 static int sdskv_client_register(sdskv_client_t client, margo_instance_id mid)
 {
     client->mid = mid;
@@ -68,6 +352,9 @@ static int sdskv_client_register(sdskv_client_t client, margo_instance_id mid)
         margo_registered_name(mid, "sdskv_get_rpc",                   &client->sdskv_get_id,                   &flag);
         margo_registered_name(mid, "sdskv_get_multi_rpc",             &client->sdskv_get_multi_id,             &flag);
         margo_registered_name(mid, "sdskv_get_packed_rpc",            &client->sdskv_get_packed_id,            &flag);
+        margo_registered_name(mid, "sdskv_get_alloc_rpc",             &client->sdskv_get_alloc_id,             &flag);
+        margo_registered_name(mid, "sdskv_get_packed_alloc_rpc",      &client->sdskv_get_packed_alloc_id,      &flag);
+        margo_registered_name(mid, "sdskv_release_bulk_rpc",          &client->sdskv_release_bulk_id,          &flag);
         margo_registered_name(mid, "sdskv_erase_rpc",                 &client->sdskv_erase_id,                 &flag);
         margo_registered_name(mid, "sdskv_erase_multi_rpc",           &client->sdskv_erase_multi_id,           &flag);
         margo_registered_name(mid, "sdskv_exists_rpc",                &client->sdskv_exists_id,                &flag);
@@ -78,6 +365,12 @@ static int sdskv_client_register(sdskv_client_t client, margo_instance_id mid)
         margo_registered_name(mid, "sdskv_bulk_get_rpc",              &client->sdskv_bulk_get_id,              &flag);
         margo_registered_name(mid, "sdskv_list_keys_rpc",             &client->sdskv_list_keys_id,             &flag);
         margo_registered_name(mid, "sdskv_list_keyvals_rpc",          &client->sdskv_list_keyvals_id,          &flag);
+        margo_registered_name(mid, "sdskv_list_keys_range_rpc",       &client->sdskv_list_keys_range_id,       &flag);
+        margo_registered_name(mid, "sdskv_list_keyvals_range_rpc",    &client->sdskv_list_keyvals_range_id,    &flag);
+        margo_registered_name(mid, "sdskv_list_packed_rpc",           &client->sdskv_list_packed_id,           &flag);
+        margo_registered_name(mid, "sdskv_open_cursor_rpc",           &client->sdskv_open_cursor_id,           &flag);
+        margo_registered_name(mid, "sdskv_cursor_next_rpc",           &client->sdskv_cursor_next_id,           &flag);
+        margo_registered_name(mid, "sdskv_close_cursor_rpc",          &client->sdskv_close_cursor_id,          &flag);
         margo_registered_name(mid, "sdskv_migrate_keys_rpc",          &client->sdskv_migrate_keys_id,          &flag);
         margo_registered_name(mid, "sdskv_migrate_key_range_rpc",     &client->sdskv_migrate_key_range_id,     &flag);
         margo_registered_name(mid, "sdskv_migrate_keys_prefixed_rpc", &client->sdskv_migrate_keys_prefixed_id, &flag);
@@ -106,6 +399,13 @@ static int sdskv_client_register(sdskv_client_t client, margo_instance_id mid)
             MARGO_REGISTER(mid, "sdskv_get_multi_rpc", get_multi_in_t, get_multi_out_t, NULL);
         client->sdskv_get_packed_id =
             MARGO_REGISTER(mid, "sdskv_get_packed_rpc", get_packed_in_t, get_packed_out_t, NULL);
+        client->sdskv_get_alloc_id =
+            MARGO_REGISTER(mid, "sdskv_get_alloc_rpc", get_alloc_in_t, get_alloc_out_t, NULL);
+        client->sdskv_get_packed_alloc_id =
+            MARGO_REGISTER(mid, "sdskv_get_packed_alloc_rpc", get_packed_alloc_in_t, get_alloc_out_t, NULL);
+        client->sdskv_release_bulk_id =
+            MARGO_REGISTER(mid, "sdskv_release_bulk_rpc", release_bulk_in_t, void, NULL);
+        margo_registered_disable_response(mid, client->sdskv_release_bulk_id, HG_TRUE);
         client->sdskv_erase_id =
             MARGO_REGISTER(mid, "sdskv_erase_rpc", erase_in_t, erase_out_t, NULL);
         client->sdskv_erase_multi_id =
@@ -126,6 +426,18 @@ static int sdskv_client_register(sdskv_client_t client, margo_instance_id mid)
             MARGO_REGISTER(mid, "sdskv_list_keys_rpc", list_keys_in_t, list_keys_out_t, NULL);
         client->sdskv_list_keyvals_id =
             MARGO_REGISTER(mid, "sdskv_list_keyvals_rpc", list_keyvals_in_t, list_keyvals_out_t, NULL);
+        client->sdskv_list_keys_range_id =
+            MARGO_REGISTER(mid, "sdskv_list_keys_range_rpc", list_keys_range_in_t, list_keys_out_t, NULL);
+        client->sdskv_list_keyvals_range_id =
+            MARGO_REGISTER(mid, "sdskv_list_keyvals_range_rpc", list_keyvals_range_in_t, list_keyvals_out_t, NULL);
+        client->sdskv_list_packed_id =
+            MARGO_REGISTER(mid, "sdskv_list_packed_rpc", list_packed_in_t, list_packed_out_t, NULL);
+        client->sdskv_open_cursor_id =
+            MARGO_REGISTER(mid, "sdskv_open_cursor_rpc", open_cursor_in_t, open_cursor_out_t, NULL);
+        client->sdskv_cursor_next_id =
+            MARGO_REGISTER(mid, "sdskv_cursor_next_rpc", cursor_next_in_t, cursor_next_out_t, NULL);
+        client->sdskv_close_cursor_id =
+            MARGO_REGISTER(mid, "sdskv_close_cursor_rpc", close_cursor_in_t, close_cursor_out_t, NULL);
         client->sdskv_migrate_keys_id =
             MARGO_REGISTER(mid, "sdskv_migrate_keys_rpc", migrate_keys_in_t, migrate_keys_out_t, NULL);
         client->sdskv_migrate_key_range_id = 
@@ -147,9 +459,15 @@ int sdskv_client_init(margo_instance_id mid, sdskv_client_t* client)
     if(!c) return SDSKV_ERR_ALLOCATION;
 
     c->num_provider_handles = 0;
+    c->bulk_cache = NULL;
+    c->eager_size = sdskv_default_eager_size(mid);
 
     int ret = sdskv_client_register(c, mid);
-    if(ret != 0) return ret;
+    if(ret != 0) {
+        free(c);
+        return ret;
+    }
+    ABT_mutex_create(&c->bulk_cache_mutex);
 
     *client = c;
     return SDSKV_SUCCESS;
@@ -162,6 +480,9 @@ int sdskv_client_finalize(sdskv_client_t client)
                 "[SDSKV] Warning: %d provider handles not released before sdskv_client_finalize was called\n",
                 client->num_provider_handles);
     }
+    sdskv_client_bulk_cache_invalidate(client, NULL, 0);
+    free(client->bulk_cache);
+    ABT_mutex_free(&client->bulk_cache_mutex);
     free(client);
     return SDSKV_SUCCESS;
 }
@@ -189,6 +510,8 @@ int sdskv_provider_handle_create(
     provider->client      = client;
     provider->provider_id = provider_id;
     provider->refcount    = 1;
+    provider->handle_pool_count = 0;
+    ABT_mutex_create(&provider->handle_pool_mutex);
 
     client->num_provider_handles += 1;
 
@@ -227,6 +550,10 @@ int sdskv_provider_handle_release(sdskv_provider_handle_t handle)
     if(handle == SDSKV_PROVIDER_HANDLE_NULL) return -1;
     handle->refcount -= 1;
     if(handle->refcount == 0) {
+        size_t i;
+        for(i=0; i < handle->handle_pool_count; i++)
+            margo_destroy(handle->handle_pool[i].handle);
+        ABT_mutex_free(&handle->handle_pool_mutex);
         margo_addr_free(handle->client->mid, handle->addr);
         handle->client->num_provider_handles -= 1;
         free(handle);
@@ -234,6 +561,76 @@ int sdskv_provider_handle_release(sdskv_provider_handle_t handle)
     return SDSKV_SUCCESS;
 }
 
+int sdskv_client_set_bulk_cache_size(sdskv_client_t client, size_t max_entries)
+{
+    struct sdskv_bulk_cache_entry* entries;
+    size_t i, lru;
+
+    if(client == SDSKV_CLIENT_NULL) return SDSKV_ERR_INVALID_ARG;
+
+    ABT_mutex_lock(client->bulk_cache_mutex);
+    while(client->bulk_cache_count > max_entries) {
+        lru = 0;
+        for(i=1; i < client->bulk_cache_count; i++)
+            if(client->bulk_cache[i].last_use < client->bulk_cache[lru].last_use)
+                lru = i;
+        sdskv_bulk_cache_remove_locked(client, lru);
+    }
+    if(max_entries == 0) {
+        free(client->bulk_cache);
+        client->bulk_cache = NULL;
+    } else {
+        entries = (struct sdskv_bulk_cache_entry*)realloc(client->bulk_cache,
+                max_entries*sizeof(*entries));
+        if(!entries) {
+            ABT_mutex_unlock(client->bulk_cache_mutex);
+            return SDSKV_ERR_ALLOCATION;
+        }
+        client->bulk_cache = entries;
+    }
+    client->bulk_cache_capacity = max_entries;
+    ABT_mutex_unlock(client->bulk_cache_mutex);
+    return SDSKV_SUCCESS;
+}
+
+int sdskv_client_set_eager_size(sdskv_client_t client, hg_size_t size)
+{
+    if(client == SDSKV_CLIENT_NULL) return SDSKV_ERR_INVALID_ARG;
+    client->eager_size = size != 0 ? size : sdskv_default_eager_size(client->mid);
+    return SDSKV_SUCCESS;
+}
+
+int sdskv_client_get_eager_size(sdskv_client_t client, hg_size_t* size)
+{
+    if(client == SDSKV_CLIENT_NULL) return SDSKV_ERR_INVALID_ARG;
+    *size = client->eager_size;
+    return SDSKV_SUCCESS;
+}
+
+int sdskv_client_bulk_cache_invalidate(sdskv_client_t client,
+        const void* buffer, hg_size_t size)
+{
+    size_t i;
+    const char* begin = (const char*)buffer;
+    const char* end   = begin + size;
+
+    if(client == SDSKV_CLIENT_NULL) return SDSKV_ERR_INVALID_ARG;
+
+    ABT_mutex_lock(client->bulk_cache_mutex);
+    i = 0;
+    while(i < client->bulk_cache_count) {
+        const char* b = (const char*)client->bulk_cache[i].buffer;
+        const char* e = b + client->bulk_cache[i].size;
+        if(buffer == NULL || (b < end && begin < e)) {
+            sdskv_bulk_cache_remove_locked(client, i);
+        } else {
+            i++;
+        }
+    }
+    ABT_mutex_unlock(client->bulk_cache_mutex);
+    return SDSKV_SUCCESS;
+}
+
 int sdskv_open(
         sdskv_provider_handle_t provider,
         const char* db_name,
@@ -365,21 +762,86 @@ int sdskv_list_databases(
     return ret;
 }
 
-int sdskv_put(sdskv_provider_handle_t provider, 
+int sdskv_wait(sdskv_request_t req)
+{
+    if(req == SDSKV_REQUEST_NULL) return SDSKV_ERR_INVALID_ARG;
+    hg_return_t hret = margo_wait(req->req);
+    return sdskv_request_finish(req, hret);
+}
+
+int sdskv_test(sdskv_request_t req, int* flag)
+{
+    if(req == SDSKV_REQUEST_NULL) return SDSKV_ERR_INVALID_ARG;
+    int ret = margo_test(req->req, flag);
+    if(ret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(ret);
+    return SDSKV_SUCCESS;
+}
+
+int sdskv_wait_any(size_t count, sdskv_request_t* reqs, size_t* index)
+{
+    hg_return_t hret;
+    size_t i;
+    int ret;
+
+    margo_request* mreqs = (margo_request*)malloc(count*sizeof(*mreqs));
+    if(count != 0 && !mreqs) return SDSKV_ERR_ALLOCATION;
+    for(i=0; i < count; i++) {
+        mreqs[i] = reqs[i] == SDSKV_REQUEST_NULL ? MARGO_REQUEST_NULL : reqs[i]->req;
+    }
+    /* margo_wait_any waits on the request that completed */
+    hret = margo_wait_any(count, mreqs, index);
+    free(mreqs);
+
+    if(*index >= count) {
+        /* no pending request */
+        *index = count;
+        return SDSKV_SUCCESS;
+    }
+    ret = sdskv_request_finish(reqs[*index], hret);
+    reqs[*index] = SDSKV_REQUEST_NULL;
+    return ret;
+}
+
+static int sdskv_put_complete(sdskv_request_t req)
+{
+    put_out_t out;
+    hg_return_t hret = margo_get_output(req->handle, &out);
+    if(hret != HG_SUCCESS) {
+        fprintf(stderr,"[SDSKV] margo_get_output() failed in sdskv_put()\n");
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+    int ret = out.ret;
+    margo_free_output(req->handle, &out);
+    return ret;
+}
+
+static int sdskv_bulk_put_complete(sdskv_request_t req)
+{
+    bulk_put_out_t out;
+    hg_return_t hret = margo_get_output(req->handle, &out);
+    if(hret != HG_SUCCESS) {
+        fprintf(stderr,"[SDSKV] margo_get_output() failed in sdskv_put()\n");
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+    int ret = out.ret;
+    margo_free_output(req->handle, &out);
+    return ret;
+}
+
+int sdskv_put_async(sdskv_provider_handle_t provider,
         sdskv_database_id_t db_id,
         const void *key, hg_size_t ksize,
-        const void *value, hg_size_t vsize)
+        const void *value, hg_size_t vsize,
+        sdskv_request_t* req)
 {
     hg_return_t hret;
-    int ret = SDSKV_SUCCESS;
-    hg_handle_t handle;
+    sdskv_request_t r;
 
     hg_size_t msize = ksize + vsize + 2*sizeof(hg_size_t);
 
-    if(msize <= MAX_RPC_MESSAGE_SIZE) {
+    if(msize <= provider->client->eager_size) {
 
         put_in_t in;
-        put_out_t out;
 
         in.db_id = db_id;
         in.key.data = (kv_ptr_t)key;
@@ -387,99 +849,71 @@ int sdskv_put(sdskv_provider_handle_t provider,
         in.value.data = (kv_ptr_t)value;
         in.value.size = vsize;
 
-        /* create handle */
-        hret = margo_create(
-                provider->client->mid,
-                provider->addr,
-                provider->client->sdskv_put_id,
-                &handle);
-        if(hret != HG_SUCCESS) {
-            fprintf(stderr,"[SDSKV] margo_create() failed in sdskv_put()\n");
-            return SDSKV_MAKE_HG_ERROR(hret);
-        }
-
-        hret = margo_provider_forward(provider->provider_id, handle, &in);
-        if(hret != HG_SUCCESS) {
-            fprintf(stderr,"[SDSKV] margo_forward() failed in sdskv_put()\n");
-            margo_destroy(handle);
-            return SDSKV_MAKE_HG_ERROR(hret);
-        }
-
-        hret = margo_get_output(handle, &out);
-        if(hret != HG_SUCCESS) {
-            fprintf(stderr,"[SDSKV] margo_get_output() failed in sdskv_put()\n");
-            margo_destroy(handle);
-            return SDSKV_MAKE_HG_ERROR(hret);
-        }
-
-        ret = out.ret;
+        r = sdskv_request_create(sdskv_put_complete);
+        if(!r) return SDSKV_ERR_ALLOCATION;
 
-        margo_free_output(handle, &out);
+        return sdskv_request_forward(provider, provider->client->sdskv_put_id,
+                &in, r, req, "sdskv_put");
 
     } else {
 
         bulk_put_in_t in;
-        bulk_put_out_t out;
 
         in.db_id = db_id;
         in.key.data = (kv_ptr_t)key;
         in.key.size = ksize;
         in.vsize = vsize;
 
-        hret = margo_bulk_create(provider->client->mid, 1, (void**)(&value), &in.vsize,
+        r = sdskv_request_create(sdskv_bulk_put_complete);
+        if(!r) return SDSKV_ERR_ALLOCATION;
+
+        hret = sdskv_bulk_create_cached(provider->client, (void*)value, in.vsize,
                                 HG_BULK_READ_ONLY, &in.handle);
         if(hret != HG_SUCCESS) {
             fprintf(stderr,"[SDSKV] margo_bulk_create() failed in sdskv_put()\n");
+            sdskv_request_free(r);
             return SDSKV_MAKE_HG_ERROR(hret);
         }
+        r->bulks[0] = in.handle;
 
-        /* create handle */
-        hret = margo_create(
-                provider->client->mid,
-                provider->addr,
-                provider->client->sdskv_bulk_put_id,
-                &handle);
-        if(hret != HG_SUCCESS) {
-            fprintf(stderr,"[SDSKV] margo_create() failed in sdskv_put()\n");
-            margo_bulk_free(in.handle);
-            return SDSKV_MAKE_HG_ERROR(hret);
-        }
-
-        hret = margo_provider_forward(provider->provider_id, handle, &in);
-        if(hret != HG_SUCCESS) {
-            fprintf(stderr,"[SDSKV] margo_forward() failed in sdskv_put()\n");
-            margo_bulk_free(in.handle);
-            margo_destroy(handle);
-            return SDSKV_MAKE_HG_ERROR(hret);
-        }
+        return sdskv_request_forward(provider, provider->client->sdskv_bulk_put_id,
+                &in, r, req, "sdskv_put");
+    }
+}
 
-        hret = margo_get_output(handle, &out);
-        if(hret != HG_SUCCESS) {
-            fprintf(stderr,"[SDSKV] margo_get_output() failed in sdskv_put()\n");
-            margo_bulk_free(in.handle);
-            margo_destroy(handle);
-            return SDSKV_MAKE_HG_ERROR(hret);
-        }
+int sdskv_put(sdskv_provider_handle_t provider, 
+        sdskv_database_id_t db_id,
+        const void *key, hg_size_t ksize,
+        const void *value, hg_size_t vsize)
+{
+    sdskv_request_t req;
+    int ret = sdskv_put_async(provider, db_id, key, ksize, value, vsize, &req);
+    if(ret != SDSKV_SUCCESS) return ret;
+    return sdskv_wait(req);
+}
 
-        ret = out.ret;
-        margo_free_output(handle, &out);
-        margo_bulk_free(in.handle);
+static int sdskv_put_multi_complete(sdskv_request_t req)
+{
+    put_multi_out_t out;
+    hg_return_t hret = margo_get_output(req->handle, &out);
+    if(hret != HG_SUCCESS) {
+        fprintf(stderr,"[SDSKV] margo_get_output() failed in sdskv_put_multi()\n");
+        return SDSKV_MAKE_HG_ERROR(hret);
     }
-
-    margo_destroy(handle);
+    int ret = out.ret;
+    margo_free_output(req->handle, &out);
     return ret;
 }
 
-int sdskv_put_multi(sdskv_provider_handle_t provider, 
+int sdskv_put_multi_async(sdskv_provider_handle_t provider,
         sdskv_database_id_t db_id,
         size_t num, const void* const* keys, const hg_size_t* ksizes,
-        const void* const* values, const hg_size_t *vsizes)
+        const void* const* values, const hg_size_t *vsizes,
+        sdskv_request_t* req)
 {
     hg_return_t     hret;
-    int             ret;
-    hg_handle_t     handle = HG_HANDLE_NULL;
+    sdskv_request_t r;
     put_multi_in_t  in;
-    put_multi_out_t out;
     void**          key_seg_ptrs  = NULL;
     hg_size_t*      key_seg_sizes = NULL;
     void**          val_seg_ptrs  = NULL;
@@ -488,14 +922,40 @@ int sdskv_put_multi(sdskv_provider_handle_t provider,
     in.db_id    = db_id;
     in.num_keys = num;
     in.keys_bulk_handle = HG_BULK_NULL;
-    in.keys_bulk_size   = 0;
+    in.keys_bulk_size   = num*sizeof(hg_size_t);
     in.vals_bulk_handle = HG_BULK_NULL;
-    in.vals_bulk_size   = 0;
+    in.vals_bulk_size   = num*sizeof(hg_size_t);
+    in.keys.data = NULL;
+    in.keys.size = 0;
+    in.vals.data = NULL;
+    in.vals.size = 0;
 
     /* check that none of the keys have a size of 0 */
     int i;
     for(i=0; i < num; i++) {
         if(ksizes[i] == 0) return SDSKV_ERR_INVALID_ARG;
+        in.keys_bulk_size += ksizes[i];
+        in.vals_bulk_size += vsizes[i];
+    }
+
+    r = sdskv_request_create(sdskv_put_multi_complete);
+    if(!r) return SDSKV_ERR_ALLOCATION;
+
+    if(in.keys_bulk_size + in.vals_bulk_size <= provider->client->eager_size) {
+        /* small enough to be sent inline with the RPC */
+        char* buffer = malloc(in.keys_bulk_size + in.vals_bulk_size);
+        if(!buffer) {
+            sdskv_request_free(r);
+            return SDSKV_ERR_ALLOCATION;
+        }
+        r->buffers[0] = buffer;
+        in.keys.data = buffer;
+        in.keys.size = in.keys_bulk_size;
+        in.vals.data = sdskv_pack_segments(buffer, num, keys, ksizes);
+        in.vals.size = in.vals_bulk_size;
+        sdskv_pack_segments(in.vals.data, num, values, vsizes);
+        return sdskv_request_forward(provider, provider->client->sdskv_put_multi_id,
+                &in, r, req, "sdskv_put_multi");
     }
 
     int non_empty_values = 0;
@@ -508,15 +968,15 @@ int sdskv_put_multi(sdskv_provider_handle_t provider,
 
     /* create an array of key sizes and key pointers */
     key_seg_sizes       = malloc(sizeof(hg_size_t)*(num+1));
+    r->buffers[0]       = key_seg_sizes;
     key_seg_sizes[0]    = num*sizeof(hg_size_t);
     memcpy(key_seg_sizes+1, ksizes, num*sizeof(hg_size_t));
     key_seg_ptrs        = malloc(sizeof(void*)*(num+1));
+    r->buffers[1]       = key_seg_ptrs;
     key_seg_ptrs[0]     = (void*)ksizes;
     memcpy(key_seg_ptrs+1, keys, num*sizeof(void*));
-    for(i=0; i < num+1; i++) {
-        in.keys_bulk_size += key_seg_sizes[i];
-    }
     val_seg_sizes = malloc(sizeof(hg_size_t)*(non_empty_values+1));
+    r->buffers[2] = val_seg_sizes;
     val_seg_sizes[0] = num*sizeof(hg_size_t);
     int j = 1;
     for(i=0; i < num; i++) {
@@ -526,6 +986,7 @@ int sdskv_put_multi(sdskv_provider_handle_t provider,
         }
     }
     val_seg_ptrs = malloc(sizeof(void*)*(non_empty_values+1));
+    r->buffers[3] = val_seg_ptrs;
     val_seg_ptrs[0] = (void*)vsizes;
     j = 1;
     for(i=0; i < num; i++) {
@@ -534,68 +995,40 @@ int sdskv_put_multi(sdskv_provider_handle_t provider,
             j++;
         }
     }
-    for(i=0; i < non_empty_values+1; i++) {
-        in.vals_bulk_size += val_seg_sizes[i];
-    }
 
     /* create the bulk handle to access the keys */
     hret = margo_bulk_create(provider->client->mid, num+1, key_seg_ptrs, key_seg_sizes,
             HG_BULK_READ_ONLY, &in.keys_bulk_handle);
     if(hret != HG_SUCCESS) {
         fprintf(stderr,"[SDSKV] margo_bulk_create() failed in sdskv_put_multi()\n");
-        out.ret = SDSKV_MAKE_HG_ERROR(hret);
-        goto finish;
+        sdskv_request_free(r);
+        return SDSKV_MAKE_HG_ERROR(hret);
     }
+    r->bulks[0] = in.keys_bulk_handle;
 
     /* create the bulk handle to access the values */
     hret = margo_bulk_create(provider->client->mid, non_empty_values+1, val_seg_ptrs, val_seg_sizes,
             HG_BULK_READ_ONLY, &in.vals_bulk_handle);
     if(hret != HG_SUCCESS) {
         fprintf(stderr,"[SDSKV] margo_bulk_create() failed in sdskv_put_multi()\n");
-        out.ret = SDSKV_MAKE_HG_ERROR(hret);
-        goto finish;
-    }
-
-    /* create a RPC handle */
-    hret = margo_create(
-            provider->client->mid,
-            provider->addr,
-            provider->client->sdskv_put_multi_id,
-            &handle);
-    if(hret != HG_SUCCESS) {
-        fprintf(stderr,"[SDSKV] margo_create() failed in sdskv_put_multi()\n");
-        out.ret = SDSKV_MAKE_HG_ERROR(hret);
-        goto finish;
-    }
-
-    /* forward the RPC */
-    hret = margo_provider_forward(provider->provider_id, handle, &in);
-    if(hret != HG_SUCCESS) {
-        fprintf(stderr,"[SDSKV] margo_forward() failed in sdskv_put_multi()\n");
-        out.ret = SDSKV_MAKE_HG_ERROR(hret);
-        goto finish;
-    }
-
-    /* get the output */
-    hret = margo_get_output(handle, &out);
-    if(hret != HG_SUCCESS) {
-        fprintf(stderr,"[SDSKV] margo_get_output() failed in sdskv_put_multi()\n");
-        out.ret = SDSKV_MAKE_HG_ERROR(hret);
-        goto finish;
+        sdskv_request_free(r);
+        return SDSKV_MAKE_HG_ERROR(hret);
     }
+    r->bulks[1] = in.vals_bulk_handle;
 
-    ret = out.ret;
+    return sdskv_request_forward(provider, provider->client->sdskv_put_multi_id,
+            &in, r, req, "sdskv_put_multi");
+}
 
-finish:
-    margo_free_output(handle, &out);
-    margo_bulk_free(in.keys_bulk_handle);
-    margo_bulk_free(in.vals_bulk_handle);
-    free(key_seg_sizes);
-    free(key_seg_ptrs);
-    free(val_seg_sizes);
-    free(val_seg_ptrs);
-    margo_destroy(handle);
-    return ret;
+int sdskv_put_multi(sdskv_provider_handle_t provider, 
+        sdskv_database_id_t db_id,
+        size_t num, const void* const* keys, const hg_size_t* ksizes,
+        const void* const* values, const hg_size_t *vsizes)
+{
+    sdskv_request_t req;
+    int ret = sdskv_put_multi_async(provider, db_id, num, keys, ksizes, values, vsizes, &req);
+    if(ret != SDSKV_SUCCESS) return ret;
+    return sdskv_wait(req);
 }
 
 int sdskv_put_packed(sdskv_provider_handle_t provider,
@@ -633,16 +1066,28 @@ int sdskv_put_packed(sdskv_provider_handle_t provider,
     return ret;
 }
 
-int sdskv_proxy_put_packed(sdskv_provider_handle_t provider,
-        sdskv_database_id_t db_id, const char* origin_addr,
-        size_t num, hg_bulk_t packed_data, hg_size_t bulk_data_size)
+static int sdskv_put_packed_complete(sdskv_request_t req)
 {
-    hg_return_t hret;
-    int ret = SDSKV_SUCCESS;
-    hg_handle_t handle;
+    put_packed_out_t out;
+    hg_return_t hret = margo_get_output(req->handle, &out);
+    if(hret != HG_SUCCESS) {
+        fprintf(stderr,"[SDSKV] margo_get_output() failed in sdskv_put_packed()\n");
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+    int ret = out.ret;
+    margo_free_output(req->handle, &out);
+    return ret;
+}
 
+/* Non-blocking version of sdskv_proxy_put_packed. The bulk handle
+ * remains owned by the caller and must stay valid until the request
+ * has completed. */
+static int sdskv_proxy_put_packed_async(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id, const char* origin_addr,
+        size_t num, hg_bulk_t packed_data, hg_size_t bulk_data_size,
+        sdskv_request_t* req)
+{
     put_packed_in_t in;
-    put_packed_out_t out;
 
     in.db_id = db_id;
     in.num_keys = num;
@@ -650,156 +1095,610 @@ int sdskv_proxy_put_packed(sdskv_provider_handle_t provider,
     in.bulk_handle = packed_data;
     in.bulk_size = bulk_data_size;
 
-    /* create handle */
-    hret = margo_create(
-            provider->client->mid,
-            provider->addr,
-            provider->client->sdskv_put_packed_id,
-            &handle);
-    if(hret != HG_SUCCESS) {
-        fprintf(stderr,"[SDSKV] margo_create() failed in sdskv_put_packed()\n");
-        margo_bulk_free(in.bulk_handle);
-        return SDSKV_MAKE_HG_ERROR(hret);
-    }
+    sdskv_request_t r = sdskv_request_create(sdskv_put_packed_complete);
+    if(!r) return SDSKV_ERR_ALLOCATION;
 
-    hret = margo_provider_forward(provider->provider_id, handle, &in);
-    if(hret != HG_SUCCESS) {
-        fprintf(stderr,"[SDSKV] margo_forward() failed in sdskv_put_packed()\n");
-        margo_bulk_free(in.bulk_handle);
-        margo_destroy(handle);
-        return SDSKV_MAKE_HG_ERROR(hret);
-    }
+    return sdskv_request_forward(provider, provider->client->sdskv_put_packed_id,
+            &in, r, req, "sdskv_put_packed");
+}
 
-    hret = margo_get_output(handle, &out);
-    if(hret != HG_SUCCESS) {
-        fprintf(stderr,"[SDSKV] margo_get_output() failed in sdskv_put_packed()\n");
-        margo_bulk_free(in.bulk_handle);
-        margo_destroy(handle);
-        return SDSKV_MAKE_HG_ERROR(hret);
+int sdskv_proxy_put_packed(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id, const char* origin_addr,
+        size_t num, hg_bulk_t packed_data, hg_size_t bulk_data_size)
+{
+    sdskv_request_t req;
+    int ret = sdskv_proxy_put_packed_async(provider, db_id, origin_addr,
+            num, packed_data, bulk_data_size, &req);
+    if(ret != SDSKV_SUCCESS) return ret;
+    return sdskv_wait(req);
+}
+
+/* Puts staged by a batcher: the key and value of each put are stored
+ * back to back in entries, their sizes in ksizes and vsizes. */
+struct sdskv_batch {
+    size_t     num;
+    size_t     capacity;
+    hg_size_t* ksizes;
+    hg_size_t* vsizes;
+    char*      entries;
+    hg_size_t  entries_size;
+};
+
+/* Result of a batch, kept until it is passed to the callback. */
+struct sdskv_batch_report {
+    size_t num;
+    int    ret;
+};
+
+/* A batcher accumulates puts into staging buffers and sends them in
+ * a single put_packed RPC, through a registered buffer holding them in
+ * the put_packed layout ([ksizes][vsizes][keys][values]). At most one
+ * batch is in flight at any time, so that batches are applied in the
+ * order of the puts. The thread sending a batch swaps the staging
+ * buffers with spare ones and waits for the batch in flight without
+ * holding the mutex, so new puts can be staged in the meantime.
+ * The results of the batches are queued and passed to the callback
+ * once the mutex is released, so that the callback may use the batcher. */
+struct sdskv_batcher {
+    sdskv_provider_handle_t provider;
+    sdskv_database_id_t     db_id;
+    size_t                  max_count;
+    hg_size_t               max_bytes;
+    sdskv_batch_callback_t  callback;
+    void*                   uargs;
+    ABT_mutex               mutex;
+    ABT_cond                cond;
+    /* puts being staged */
+    struct sdskv_batch      staged;
+    /* puts being packed by the thread sending them */
+    struct sdskv_batch      spare;
+    /* set while a thread sends a batch or waits for the one in flight,
+     * other threads wait on cond before doing either */
+    int                     busy;
+    /* registered buffer of the batch in flight */
+    char*                   send_buffer;
+    hg_bulk_t               send_bulk;
+    sdskv_request_t         send_req;
+    size_t                  send_num;
+    /* first error since the last sdskv_batcher_flush */
+    int                     error;
+    /* results not yet passed to the callback, in the order of the
+     * batches, and whether a thread is passing them */
+    struct sdskv_batch_report* reports;
+    size_t                  first_report;
+    size_t                  num_reports;
+    size_t                  reports_capacity;
+    int                     reporting;
+    /* periodic flush */
+    double                  flush_interval_ms;
+    double                  last_send;
+    ABT_thread              timer;
+    int                     stop;
+};
+
+/* size of the put_packed buffer for the staged puts */
+static hg_size_t sdskv_batcher_packed_size(size_t num, hg_size_t entries_size)
+{
+    return 2*num*sizeof(hg_size_t) + entries_size;
+}
+
+static int sdskv_batch_init(struct sdskv_batch* batch, size_t capacity, hg_size_t max_bytes)
+{
+    batch->num          = 0;
+    batch->capacity     = capacity;
+    batch->entries_size = 0;
+    batch->ksizes  = (hg_size_t*)malloc(capacity*sizeof(hg_size_t));
+    batch->vsizes  = (hg_size_t*)malloc(capacity*sizeof(hg_size_t));
+    batch->entries = (char*)malloc(max_bytes);
+    if(!batch->ksizes || !batch->vsizes || !batch->entries)
+        return SDSKV_ERR_ALLOCATION;
+    return SDSKV_SUCCESS;
+}
+
+static void sdskv_batch_finalize(struct sdskv_batch* batch)
+{
+    free(batch->ksizes);
+    free(batch->vsizes);
+    free(batch->entries);
+}
+
+/* Doubles the capacity of the size arrays. Both arrays are allocated
+ * before any of them is replaced, so the batch is left unchanged if
+ * an allocation fails. */
+static int sdskv_batch_grow(struct sdskv_batch* batch)
+{
+    size_t new_capacity = 2*batch->capacity;
+    hg_size_t* ksizes = (hg_size_t*)malloc(new_capacity*sizeof(hg_size_t));
+    hg_size_t* vsizes = (hg_size_t*)malloc(new_capacity*sizeof(hg_size_t));
+    if(!ksizes || !vsizes) {
+        free(ksizes);
+        free(vsizes);
+        return SDSKV_ERR_ALLOCATION;
+    }
+    memcpy(ksizes, batch->ksizes, batch->num*sizeof(hg_size_t));
+    memcpy(vsizes, batch->vsizes, batch->num*sizeof(hg_size_t));
+    free(batch->ksizes);
+    free(batch->vsizes);
+    batch->ksizes   = ksizes;
+    batch->vsizes   = vsizes;
+    batch->capacity = new_capacity;
+    return SDSKV_SUCCESS;
+}
+
+/* Records the result of a batch of num puts and queues it for the
+ * callback (see sdskv_batcher_deliver_locked). Must be called with
+ * the mutex held. */
+static void sdskv_batcher_report_locked(sdskv_batcher_t b, size_t num, int ret)
+{
+    if(ret != SDSKV_SUCCESS && b->error == SDSKV_SUCCESS)
+        b->error = ret;
+    if(!b->callback) return;
+    if(b->num_reports == b->reports_capacity) {
+        size_t new_capacity = b->reports_capacity ? 2*b->reports_capacity : 4;
+        struct sdskv_batch_report* reports = (struct sdskv_batch_report*)realloc(
+                b->reports, new_capacity*sizeof(*reports));
+        if(!reports) {
+            fprintf(stderr,"[SDSKV] could not queue the result of a batch for the callback\n");
+            return;
+        }
+        b->reports = reports;
+        b->reports_capacity = new_capacity;
     }
+    b->reports[b->num_reports].num = num;
+    b->reports[b->num_reports].ret = ret;
+    b->num_reports += 1;
+}
 
-    ret = out.ret;
-    margo_free_output(handle, &out);
+/* Passes the queued results to the callback, in the order of the batches.
+ * The mutex is released around each call, so the callback may put into or
+ * flush the batcher; results queued meanwhile, including by other threads,
+ * are passed by the thread already doing so. Must be called with the mutex
+ * held, and before each public function returns. */
+static void sdskv_batcher_deliver_locked(sdskv_batcher_t b)
+{
+    if(b->reporting) return;
+    b->reporting = 1;
+    while(b->first_report < b->num_reports) {
+        struct sdskv_batch_report r = b->reports[b->first_report];
+        b->first_report += 1;
+        if(b->first_report == b->num_reports)
+            b->first_report = b->num_reports = 0;
+        ABT_mutex_unlock(b->mutex);
+        b->callback(b->uargs, r.num, r.ret);
+        ABT_mutex_lock(b->mutex);
+    }
+    b->reporting = 0;
+}
 
-    margo_destroy(handle);
+/* Marks the calling thread as the one sending or waiting, after any
+ * other thread doing so is done. Must be called with the mutex held. */
+static void sdskv_batcher_acquire_locked(sdskv_batcher_t b)
+{
+    while(b->busy) ABT_cond_wait(b->cond, b->mutex);
+    b->busy = 1;
+}
+
+static void sdskv_batcher_release_locked(sdskv_batcher_t b)
+{
+    b->busy = 0;
+    ABT_cond_broadcast(b->cond);
+}
+
+/* Waits for the batch in flight, if any, and reports its result. Must be
+ * called with the mutex held, which is released during the wait. */
+static int sdskv_batcher_wait_locked(sdskv_batcher_t b)
+{
+    sdskv_batcher_acquire_locked(b);
+    sdskv_request_t req = b->send_req;
+    size_t num = b->send_num;
+    b->send_req = SDSKV_REQUEST_NULL;
+    int ret = SDSKV_SUCCESS;
+    if(req != SDSKV_REQUEST_NULL) {
+        ABT_mutex_unlock(b->mutex);
+        ret = sdskv_wait(req);
+        ABT_mutex_lock(b->mutex);
+        sdskv_batcher_report_locked(b, num, ret);
+    }
+    sdskv_batcher_release_locked(b);
     return ret;
 }
 
-int sdskv_get(sdskv_provider_handle_t provider,
-        sdskv_database_id_t db_id, 
+/* Sends the staged puts as a new batch, after the batch in flight has
+ * completed. Must be called with the mutex held, which is released
+ * while waiting for the batch in flight and packing the new one. */
+static int sdskv_batcher_send_locked(sdskv_batcher_t b)
+{
+    size_t i;
+    int ret;
+
+    sdskv_batcher_acquire_locked(b);
+    b->last_send = ABT_get_wtime();
+    if(b->staged.num == 0) {
+        sdskv_batcher_release_locked(b);
+        return SDSKV_SUCCESS;
+    }
+
+    /* take the staged puts, new puts are staged in the spare buffers */
+    struct sdskv_batch batch = b->staged;
+    b->staged = b->spare;
+    b->staged.num = 0;
+    b->staged.entries_size = 0;
+    sdskv_request_t prev_req = b->send_req;
+    size_t prev_num = b->send_num;
+    b->send_req = SDSKV_REQUEST_NULL;
+    ABT_mutex_unlock(b->mutex);
+
+    int prev_ret = SDSKV_SUCCESS;
+    if(prev_req != SDSKV_REQUEST_NULL)
+        prev_ret = sdskv_wait(prev_req);
+
+    /* pack the puts */
+    hg_size_t header_size = batch.num*sizeof(hg_size_t);
+    char* kptr = b->send_buffer + 2*header_size;
+    hg_size_t keys_size = 0;
+    for(i=0; i < batch.num; i++) keys_size += batch.ksizes[i];
+    char* vptr = kptr + keys_size;
+    const char* entry = batch.entries;
+    memcpy(b->send_buffer, batch.ksizes, header_size);
+    memcpy(b->send_buffer + header_size, batch.vsizes, header_size);
+    for(i=0; i < batch.num; i++) {
+        memcpy(kptr, entry, batch.ksizes[i]);
+        kptr  += batch.ksizes[i];
+        entry += batch.ksizes[i];
+        memcpy(vptr, entry, batch.vsizes[i]);
+        vptr  += batch.vsizes[i];
+        entry += batch.vsizes[i];
+    }
+
+    sdskv_request_t req = SDSKV_REQUEST_NULL;
+    ret = sdskv_proxy_put_packed_async(b->provider, b->db_id, NULL, batch.num,
+            b->send_bulk, sdskv_batcher_packed_size(batch.num, batch.entries_size),
+            &req);
+
+    ABT_mutex_lock(b->mutex);
+    b->spare = batch;
+    if(prev_req != SDSKV_REQUEST_NULL)
+        sdskv_batcher_report_locked(b, prev_num, prev_ret);
+    if(ret == SDSKV_SUCCESS) {
+        b->send_req = req;
+        b->send_num = batch.num;
+    } else {
+        sdskv_batcher_report_locked(b, batch.num, ret);
+    }
+    sdskv_batcher_release_locked(b);
+    return ret;
+}
+
+static void sdskv_batcher_timer_ult(void* arg)
+{
+    sdskv_batcher_t b = (sdskv_batcher_t)arg;
+    margo_instance_id mid = b->provider->client->mid;
+    while(1) {
+        margo_thread_sleep(mid, b->flush_interval_ms);
+        ABT_mutex_lock(b->mutex);
+        if(b->stop) {
+            ABT_mutex_unlock(b->mutex);
+            break;
+        }
+        if(b->staged.num != 0 && (ABT_get_wtime() - b->last_send)*1000.0 >= b->flush_interval_ms)
+            sdskv_batcher_send_locked(b);
+        sdskv_batcher_deliver_locked(b);
+        ABT_mutex_unlock(b->mutex);
+    }
+}
+
+int sdskv_batcher_create(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id,
+        size_t max_count, hg_size_t max_bytes,
+        double flush_interval_ms,
+        sdskv_batch_callback_t callback, void* uargs,
+        sdskv_batcher_t* batcher)
+{
+    hg_return_t hret;
+    int ret;
+
+    if(max_bytes < 2*sizeof(hg_size_t)) return SDSKV_ERR_INVALID_ARG;
+
+    sdskv_batcher_t b = (sdskv_batcher_t)calloc(1, sizeof(*b));
+    if(!b) return SDSKV_ERR_ALLOCATION;
+
+    b->provider          = provider;
+    b->db_id             = db_id;
+    b->max_count         = max_count;
+    b->max_bytes         = max_bytes;
+    b->callback          = callback;
+    b->uargs             = uargs;
+    b->send_bulk         = HG_BULK_NULL;
+    b->send_req          = SDSKV_REQUEST_NULL;
+    b->error             = SDSKV_SUCCESS;
+    b->flush_interval_ms = flush_interval_ms;
+    b->last_send         = ABT_get_wtime();
+    b->timer             = ABT_THREAD_NULL;
+
+    ret = sdskv_batch_init(&b->staged, 64, max_bytes);
+    if(ret != SDSKV_SUCCESS) goto error;
+    ret = sdskv_batch_init(&b->spare, 64, max_bytes);
+    if(ret != SDSKV_SUCCESS) goto error;
+    b->send_buffer = (char*)malloc(max_bytes);
+    if(!b->send_buffer) {
+        ret = SDSKV_ERR_ALLOCATION;
+        goto error;
+    }
+
+    /* the send buffer is registered once for all the batches */
+    hret = margo_bulk_create(provider->client->mid, 1, (void**)&b->send_buffer, &b->max_bytes,
+            HG_BULK_READ_ONLY, &b->send_bulk);
+    if(hret != HG_SUCCESS) {
+        fprintf(stderr,"[SDSKV] margo_bulk_create() failed in sdskv_batcher_create()\n");
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto error;
+    }
+
+    ABT_mutex_create(&b->mutex);
+    ABT_cond_create(&b->cond);
+
+    if(flush_interval_ms > 0) {
+        ABT_pool pool;
+        margo_get_handler_pool(provider->client->mid, &pool);
+        ret = ABT_thread_create(pool, sdskv_batcher_timer_ult, b, ABT_THREAD_ATTR_NULL, &b->timer);
+        if(ret != ABT_SUCCESS) {
+            ABT_cond_free(&b->cond);
+            ABT_mutex_free(&b->mutex);
+            ret = SDSKV_MAKE_ABT_ERROR(ret);
+            goto error;
+        }
+    }
+
+    sdskv_provider_handle_ref_incr(provider);
+    *batcher = b;
+    return SDSKV_SUCCESS;
+
+error:
+    if(b->send_bulk != HG_BULK_NULL) margo_bulk_free(b->send_bulk);
+    sdskv_batch_finalize(&b->staged);
+    sdskv_batch_finalize(&b->spare);
+    free(b->reports);
+    free(b->send_buffer);
+    free(b);
+    return ret;
+}
+
+int sdskv_batcher_put(sdskv_batcher_t batcher,
         const void *key, hg_size_t ksize,
-        void *value, hg_size_t* vsize)
+        const void *value, hg_size_t vsize)
+{
+    sdskv_batcher_t b = batcher;
+    int ret = SDSKV_SUCCESS;
+
+    if(ksize == 0) return SDSKV_ERR_INVALID_ARG;
+
+    ABT_mutex_lock(b->mutex);
+
+    /* a put that does not fit in an empty batch is sent on its own,
+     * after the puts staged before it */
+    if(sdskv_batcher_packed_size(1, ksize+vsize) > b->max_bytes) {
+        sdskv_batcher_send_locked(b);
+        sdskv_batcher_wait_locked(b);
+        sdskv_batcher_acquire_locked(b);
+        ABT_mutex_unlock(b->mutex);
+        ret = sdskv_put(b->provider, b->db_id, key, ksize, value, vsize);
+        ABT_mutex_lock(b->mutex);
+        sdskv_batcher_report_locked(b, 1, ret);
+        sdskv_batcher_release_locked(b);
+        sdskv_batcher_deliver_locked(b);
+        ABT_mutex_unlock(b->mutex);
+        return ret;
+    }
+
+    /* the mutex is released while sending, so other
+     * puts may have been staged when this returns */
+    while(sdskv_batcher_packed_size(b->staged.num+1, b->staged.entries_size+ksize+vsize) > b->max_bytes)
+        sdskv_batcher_send_locked(b);
+
+    if(b->staged.num == b->staged.capacity) {
+        ret = sdskv_batch_grow(&b->staged);
+        if(ret != SDSKV_SUCCESS) {
+            sdskv_batcher_deliver_locked(b);
+            ABT_mutex_unlock(b->mutex);
+            return ret;
+        }
+    }
+
+    struct sdskv_batch* batch = &b->staged;
+    batch->ksizes[batch->num] = ksize;
+    batch->vsizes[batch->num] = vsize;
+    memcpy(batch->entries + batch->entries_size, key, ksize);
+    memcpy(batch->entries + batch->entries_size + ksize, value, vsize);
+    batch->entries_size += ksize + vsize;
+    batch->num += 1;
+
+    if(b->max_count != 0 && batch->num >= b->max_count)
+        sdskv_batcher_send_locked(b);
+
+    sdskv_batcher_deliver_locked(b);
+    ABT_mutex_unlock(b->mutex);
+    return ret;
+}
+
+int sdskv_batcher_flush(sdskv_batcher_t batcher)
+{
+    sdskv_batcher_t b = batcher;
+    ABT_mutex_lock(b->mutex);
+    sdskv_batcher_send_locked(b);
+    sdskv_batcher_wait_locked(b);
+    sdskv_batcher_deliver_locked(b);
+    int ret = b->error;
+    b->error = SDSKV_SUCCESS;
+    ABT_mutex_unlock(b->mutex);
+    return ret;
+}
+
+int sdskv_batcher_destroy(sdskv_batcher_t batcher)
+{
+    sdskv_batcher_t b = batcher;
+    if(b->timer != ABT_THREAD_NULL) {
+        ABT_mutex_lock(b->mutex);
+        b->stop = 1;
+        ABT_mutex_unlock(b->mutex);
+        ABT_thread_join(b->timer);
+        ABT_thread_free(&b->timer);
+    }
+    int ret = sdskv_batcher_flush(b);
+    ABT_cond_free(&b->cond);
+    ABT_mutex_free(&b->mutex);
+    margo_bulk_free(b->send_bulk);
+    sdskv_provider_handle_release(b->provider);
+    sdskv_batch_finalize(&b->staged);
+    sdskv_batch_finalize(&b->spare);
+    free(b->reports);
+    free(b->send_buffer);
+    free(b);
+    return ret;
+}
+
+static int sdskv_get_complete(sdskv_request_t req)
+{
+    get_out_t out;
+    hg_return_t hret = margo_get_output(req->handle, &out);
+    if(hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
+
+    int ret = out.ret;
+    if(ret == SDSKV_SUCCESS) {
+        *(req->vsizes) = out.vsize;
+        if (out.value.size > 0) {
+            memcpy(req->value, out.value.data, out.value.size);
+        }
+    } else if(ret == SDSKV_ERR_SIZE) {
+        *(req->vsizes) = out.vsize;
+    }
+
+    margo_free_output(req->handle, &out);
+    return ret;
+}
+
+static int sdskv_bulk_get_complete(sdskv_request_t req)
+{
+    bulk_get_out_t out;
+    hg_return_t hret = margo_get_output(req->handle, &out);
+    if(hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
+
+    int ret = out.ret;
+    *(req->vsizes) = out.vsize;
+
+    margo_free_output(req->handle, &out);
+    return ret;
+}
+
+int sdskv_get_async(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id,
+        const void *key, hg_size_t ksize,
+        void *value, hg_size_t* vsize,
+        sdskv_request_t* req)
 {
     hg_return_t hret;
     hg_size_t size;
     hg_size_t msize;
-    int ret;
-    hg_handle_t handle;
+    sdskv_request_t r;
 
-    if(value == NULL) {
-        return sdskv_length(provider, db_id, key, ksize, vsize);
-    }
+    if(value == NULL) return SDSKV_ERR_INVALID_ARG;
 
     size = *(hg_size_t*)vsize;
     msize = size + sizeof(hg_size_t) + sizeof(hg_return_t);
 
-    if (msize <= MAX_RPC_MESSAGE_SIZE) {
+    if (msize <= provider->client->eager_size) {
 
         get_in_t in;
-        get_out_t out;
 
         in.db_id = db_id;
         in.key.data = (kv_ptr_t)key;
         in.key.size = ksize;
         in.vsize = size;
 
-        /* create handle */
-        hret = margo_create(
-                provider->client->mid,
-                provider->addr,
-                provider->client->sdskv_get_id,
-                &handle);
-        if(hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
+        r = sdskv_request_create(sdskv_get_complete);
+        if(!r) return SDSKV_ERR_ALLOCATION;
+        r->value  = value;
+        r->vsizes = vsize;
 
-        hret = margo_provider_forward(provider->provider_id, handle, &in);
-        if(hret != HG_SUCCESS) {
-            margo_destroy(handle);
-            return SDSKV_MAKE_HG_ERROR(hret);
-        }
-
-        hret = margo_get_output(handle, &out);
-        if(hret != HG_SUCCESS) {
-            margo_destroy(handle);
-            return SDSKV_MAKE_HG_ERROR(hret);
-        }
-
-        ret = out.ret;
-    
-        if(ret == SDSKV_SUCCESS) {
-            *vsize = out.vsize;
-            if (out.value.size > 0) {
-                memcpy(value, out.value.data, out.value.size);
-            }
-        } else if(ret == SDSKV_ERR_SIZE) {
-            *vsize = out.vsize;
-        }
-
-        margo_free_output(handle, &out);
+        return sdskv_request_forward(provider, provider->client->sdskv_get_id,
+                &in, r, req, "sdskv_get");
 
     } else {
 
         bulk_get_in_t in;
-        bulk_get_out_t out;
 
         in.db_id = db_id;
         in.key.data = (kv_ptr_t)key;
         in.key.size = ksize;
         in.vsize = size;
 
-        hret = margo_bulk_create(provider->client->mid, 1, &value, &in.vsize,
+        r = sdskv_request_create(sdskv_bulk_get_complete);
+        if(!r) return SDSKV_ERR_ALLOCATION;
+        r->value  = value;
+        r->vsizes = vsize;
+
+        hret = sdskv_bulk_create_cached(provider->client, value, in.vsize,
                                 HG_BULK_WRITE_ONLY, &in.handle);
-        if(hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
-
-        /* create handle */
-        hret = margo_create(
-                provider->client->mid,
-                provider->addr,
-                provider->client->sdskv_bulk_get_id,
-                &handle);
         if(hret != HG_SUCCESS) {
-            margo_bulk_free(in.handle);
+            sdskv_request_free(r);
             return SDSKV_MAKE_HG_ERROR(hret);
         }
+        r->bulks[0] = in.handle;
 
-        hret = margo_provider_forward(provider->provider_id, handle, &in);
-        if(hret != HG_SUCCESS) {
-            margo_bulk_free(in.handle);
-            margo_destroy(handle);
-            return SDSKV_MAKE_HG_ERROR(hret);
-        }
+        return sdskv_request_forward(provider, provider->client->sdskv_bulk_get_id,
+                &in, r, req, "sdskv_get");
+    }
+}
 
-        hret = margo_get_output(handle, &out);
-        if(hret != HG_SUCCESS) {
-            margo_bulk_free(in.handle);
-            margo_destroy(handle);
-            return SDSKV_MAKE_HG_ERROR(hret);
-        }
+int sdskv_get(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id, 
+        const void *key, hg_size_t ksize,
+        void *value, hg_size_t* vsize)
+{
+    if(value == NULL) {
+        return sdskv_length(provider, db_id, key, ksize, vsize);
+    }
 
-        ret = out.ret;
-        *vsize = out.vsize;
+    sdskv_request_t req;
+    int ret = sdskv_get_async(provider, db_id, key, ksize, value, vsize, &req);
+    if(ret != SDSKV_SUCCESS) return ret;
+    return sdskv_wait(req);
+}
 
-        margo_free_output(handle, &out);
-        margo_bulk_free(in.handle);
+static int sdskv_get_multi_complete(sdskv_request_t req)
+{
+    get_multi_out_t out;
+    hg_return_t hret = margo_get_output(req->handle, &out);
+    if(hret != HG_SUCCESS) {
+        fprintf(stderr,"[SDSKV] margo_get_output() failed in sdskv_get_multi()\n");
+        return SDSKV_MAKE_HG_ERROR(hret);
     }
 
-    margo_destroy(handle);
+    int ret = out.ret;
+    if(ret != SDSKV_SUCCESS) {
+        margo_free_output(req->handle, &out);
+        return ret;
+    }
+
+    /* copy the values from the response (if they were sent inline)
+     * or from the buffer they were pushed to into the user-provided buffers */
+    char* vals_buffer = out.values.size != 0 ? out.values.data : (char*)req->buffers[2];
+    hg_size_t* value_sizes = (hg_size_t*)vals_buffer;
+    char* value_ptr = vals_buffer + req->num*sizeof(hg_size_t);
+    size_t i;
+    for(i=0; i < req->num; i++) {
+        memcpy(req->values[i], value_ptr, value_sizes[i]);
+        req->vsizes[i] = value_sizes[i];
+        value_ptr += value_sizes[i];
+    }
+    margo_free_output(req->handle, &out);
     return ret;
 }
 
-int sdskv_get_multi(sdskv_provider_handle_t provider, 
+int sdskv_get_multi_async(sdskv_provider_handle_t provider,
         sdskv_database_id_t db_id,
         size_t num, const void* const* keys, const hg_size_t* ksizes,
-        void** values, hg_size_t *vsizes)
+        void** values, hg_size_t *vsizes,
+        sdskv_request_t* req)
 {
     /******* NOTE ********
      * This function works as follows:
@@ -816,53 +1715,81 @@ int sdskv_get_multi(sdskv_provider_handle_t provider,
      *   and will require unpacking to be put into the values input buffers.
      */
     hg_return_t     hret;
-    int             ret;
-    hg_handle_t     handle = HG_HANDLE_NULL;
+    sdskv_request_t r;
     get_multi_in_t  in;
-    get_multi_out_t out;
     void**          key_seg_ptrs  = NULL;
     hg_size_t*      key_seg_sizes = NULL;
     char*           vals_buffer   = NULL;
 
-    if(values == NULL) {
-        return sdskv_length_multi(provider, db_id, num, keys, ksizes, vsizes);
-    }
+    if(values == NULL) return SDSKV_ERR_INVALID_ARG;
 
     in.db_id    = db_id;
     in.num_keys = num;
     in.keys_bulk_handle = HG_BULK_NULL;
-    in.keys_bulk_size   = 0;
+    in.keys_bulk_size   = num*sizeof(hg_size_t);
     in.vals_bulk_handle = HG_BULK_NULL;
-    in.vals_bulk_size   = 0;
+    in.vals_bulk_size   = num*sizeof(hg_size_t);
+    in.keys.data = NULL;
+    in.keys.size = 0;
+    in.vals.data = NULL;
+    in.vals.size = 0;
+
+    r = sdskv_request_create(sdskv_get_multi_complete);
+    if(!r) return SDSKV_ERR_ALLOCATION;
+    r->num    = num;
+    r->values = values;
+    r->vsizes = vsizes;
+
+    int i;
+    for(i=0; i<num; i++) {
+        in.keys_bulk_size += ksizes[i];
+        in.vals_bulk_size += vsizes[i];
+    }
+
+    /* the server returns values inline only within the eager size of
+     * the transport, even if the client's eager size was raised above it */
+    if(in.keys_bulk_size + num*sizeof(hg_size_t) <= provider->client->eager_size
+    && in.vals_bulk_size <= provider->client->eager_size
+    && in.vals_bulk_size <= sdskv_default_eager_size(provider->client->mid)) {
+        /* keys, value sizes and values are small enough to be sent inline */
+        char* keys_buffer = malloc(in.keys_bulk_size);
+        if(!keys_buffer) {
+            sdskv_request_free(r);
+            return SDSKV_ERR_ALLOCATION;
+        }
+        r->buffers[0] = keys_buffer;
+        sdskv_pack_segments(keys_buffer, num, keys, ksizes);
+        in.keys.data = keys_buffer;
+        in.keys.size = in.keys_bulk_size;
+        in.vals.data = (kv_ptr_t)vsizes;
+        in.vals.size = num*sizeof(hg_size_t);
+        return sdskv_request_forward(provider, provider->client->sdskv_get_multi_id,
+                &in, r, req, "sdskv_get_multi");
+    }
 
     /* create an array of key sizes and key pointers */
     key_seg_sizes       = malloc(sizeof(hg_size_t)*(num+1));
+    r->buffers[0]       = key_seg_sizes;
     key_seg_sizes[0]    = num*sizeof(hg_size_t);
     memcpy(key_seg_sizes+1, ksizes, num*sizeof(hg_size_t));
     key_seg_ptrs        = malloc(sizeof(void*)*(num+1));
+    r->buffers[1]       = key_seg_ptrs;
     key_seg_ptrs[0]     = (void*)ksizes;
     memcpy(key_seg_ptrs+1, keys, num*sizeof(void*));
-    
-    int i;
-    for(i=0; i<num+1; i++) {
-        in.keys_bulk_size += key_seg_sizes[i];
-    }
 
     /* create the bulk handle to access the keys */
     hret = margo_bulk_create(provider->client->mid, num+1, key_seg_ptrs, key_seg_sizes,
             HG_BULK_READ_ONLY, &in.keys_bulk_handle);
     if(hret != HG_SUCCESS) {
         fprintf(stderr,"[SDSKV] margo_bulk_create() failed in sdskv_get_multi()\n");
-        out.ret = SDSKV_MAKE_HG_ERROR(hret);
-        goto finish;
+        sdskv_request_free(r);
+        return SDSKV_MAKE_HG_ERROR(hret);
     }
+    r->bulks[0] = in.keys_bulk_handle;
 
     /* allocate memory to send max value sizes and receive values */
-    for(i=0; i<num; i++) {
-        in.vals_bulk_size += vsizes[i];
-    }
-    in.vals_bulk_size += sizeof(hg_size_t)*num;
     vals_buffer = malloc(in.vals_bulk_size);
+    r->buffers[2] = vals_buffer;
     hg_size_t* value_sizes = (hg_size_t*)vals_buffer; // beginning of the buffer used to hold sizes
     for(i=0; i<num; i++) {
         value_sizes[i] = vsizes[i];
@@ -873,103 +1800,70 @@ int sdskv_get_multi(sdskv_provider_handle_t provider,
             HG_BULK_READWRITE, &in.vals_bulk_handle);
     if(hret != HG_SUCCESS) {
         fprintf(stderr,"[SDSKV] margo_bulk_create() failed in sdskv_get_multi()\n");
-        out.ret = SDSKV_MAKE_HG_ERROR(hret);
-        goto finish;
+        sdskv_request_free(r);
+        return SDSKV_MAKE_HG_ERROR(hret);
     }
+    r->bulks[1] = in.vals_bulk_handle;
 
-    /* create a RPC handle */
-    hret = margo_create(
-            provider->client->mid,
-            provider->addr,
-            provider->client->sdskv_get_multi_id,
-            &handle);
-    if(hret != HG_SUCCESS) {
-        fprintf(stderr,"[SDSKV] margo_create() failed in sdskv_get_multi()\n");
-        out.ret = SDSKV_MAKE_HG_ERROR(hret);
-        goto finish;
-    }
+    return sdskv_request_forward(provider, provider->client->sdskv_get_multi_id,
+            &in, r, req, "sdskv_get_multi");
+}
 
-    /* forward the RPC handle */
-    hret = margo_provider_forward(provider->provider_id, handle, &in);
-    if(hret != HG_SUCCESS) {
-        fprintf(stderr,"[SDSKV] margo_forward() failed in sdskv_get_multi()\n");
-        out.ret = SDSKV_MAKE_HG_ERROR(hret);
-        goto finish;
+int sdskv_get_multi(sdskv_provider_handle_t provider, 
+        sdskv_database_id_t db_id,
+        size_t num, const void* const* keys, const hg_size_t* ksizes,
+        void** values, hg_size_t *vsizes)
+{
+    if(values == NULL) {
+        return sdskv_length_multi(provider, db_id, num, keys, ksizes, vsizes);
     }
 
-    /* get the response */
-    hret = margo_get_output(handle, &out);
-    if(hret != HG_SUCCESS) {
-        fprintf(stderr,"[SDSKV] margo_get_output() failed in sdskv_put_multi()\n");
-        out.ret = SDSKV_MAKE_HG_ERROR(hret);
-        goto finish;
-    }
+    sdskv_request_t req;
+    int ret = sdskv_get_multi_async(provider, db_id, num, keys, ksizes, values, vsizes, &req);
+    if(ret != SDSKV_SUCCESS) return ret;
+    return sdskv_wait(req);
+}
 
-    ret = out.ret;
-    if(out.ret != SDSKV_SUCCESS) {
-        goto finish;
-    }
+static int sdskv_exists_complete(sdskv_request_t req)
+{
+    exists_out_t out;
+    hg_return_t hret = margo_get_output(req->handle, &out);
+    if(hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
 
-    /* copy the values from the buffer into the user-provided buffer */
-    char* value_ptr = vals_buffer + num*sizeof(hg_size_t);
-    for(i=0; i<num; i++) {
-        memcpy(values[i], value_ptr, value_sizes[i]);
-        vsizes[i] = value_sizes[i];
-        value_ptr += value_sizes[i];
-    }
+    int ret = out.ret;
+    if(ret == 0) *(req->flag) = out.flag;
 
-finish:
-    margo_free_output(handle, &out);
-    margo_bulk_free(in.keys_bulk_handle);
-    margo_bulk_free(in.vals_bulk_handle);
-    free(key_seg_sizes);
-    free(key_seg_ptrs);
-    free(vals_buffer);
-    margo_destroy(handle);
+    margo_free_output(req->handle, &out);
     return ret;
 }
 
-int sdskv_exists(sdskv_provider_handle_t provider,
+int sdskv_exists_async(sdskv_provider_handle_t provider,
         sdskv_database_id_t db_id, const void *key,
-        hg_size_t ksize, int* flag)
+        hg_size_t ksize, int* flag,
+        sdskv_request_t* req)
 {
-    hg_return_t hret;
-    int ret;
-    hg_handle_t handle;
-
     exists_in_t in;
-    exists_out_t out;
 
     in.db_id    = db_id;
     in.key.data = (kv_ptr_t)key;
     in.key.size = ksize;
 
-    /* create handle */
-    hret = margo_create(
-            provider->client->mid,
-            provider->addr,
-            provider->client->sdskv_exists_id,
-            &handle);
-    if(hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
-
-    hret = margo_provider_forward(provider->provider_id, handle, &in);
-    if(hret != HG_SUCCESS) {
-        margo_destroy(handle);
-        return SDSKV_MAKE_HG_ERROR(hret);
-    }
+    sdskv_request_t r = sdskv_request_create(sdskv_exists_complete);
+    if(!r) return SDSKV_ERR_ALLOCATION;
+    r->flag = flag;
 
-    hret = margo_get_output(handle, &out);
-    if(hret != HG_SUCCESS) {
-        margo_destroy(handle);
-        return SDSKV_MAKE_HG_ERROR(hret);
-    }
-
-    ret = out.ret;
-    if(ret == 0) *flag = out.flag;
+    return sdskv_request_forward(provider, provider->client->sdskv_exists_id,
+            &in, r, req, "sdskv_exists");
+}
 
-    margo_free_output(handle, &out);
-    margo_destroy(handle);
-    return ret;
+int sdskv_exists(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id, const void *key,
+        hg_size_t ksize, int* flag)
+{
+    sdskv_request_t req;
+    int ret = sdskv_exists_async(provider, db_id, key, ksize, flag, &req);
+    if(ret != SDSKV_SUCCESS) return ret;
+    return sdskv_wait(req);
 }
 
 int sdskv_exists_multi(sdskv_provider_handle_t provider, 
@@ -1078,47 +1972,46 @@ finish:
     return ret;
 }
 
-int sdskv_length(sdskv_provider_handle_t provider, 
-        sdskv_database_id_t db_id, const void *key, 
-        hg_size_t ksize, hg_size_t* vsize)
+static int sdskv_length_complete(sdskv_request_t req)
 {
-    hg_return_t hret;
-    int ret;
-    hg_handle_t handle;
+    length_out_t out;
+    hg_return_t hret = margo_get_output(req->handle, &out);
+    if(hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
+
+    int ret = out.ret;
+    if(ret == 0) *(req->vsizes) = out.size;
 
+    margo_free_output(req->handle, &out);
+    return ret;
+}
+
+int sdskv_length_async(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id, const void *key,
+        hg_size_t ksize, hg_size_t* vsize,
+        sdskv_request_t* req)
+{
     length_in_t in;
-    length_out_t out;
 
     in.db_id    = db_id;
     in.key.data = (kv_ptr_t)key;
     in.key.size = ksize;
 
-    /* create handle */
-    hret = margo_create(
-            provider->client->mid,
-            provider->addr,
-            provider->client->sdskv_length_id,
-            &handle);
-    if(hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
+    sdskv_request_t r = sdskv_request_create(sdskv_length_complete);
+    if(!r) return SDSKV_ERR_ALLOCATION;
+    r->vsizes = vsize;
 
-    hret = margo_provider_forward(provider->provider_id, handle, &in);
-    if(hret != HG_SUCCESS) {
-        margo_destroy(handle);
-        return SDSKV_MAKE_HG_ERROR(hret);
-    }
-
-    hret = margo_get_output(handle, &out);
-    if(hret != HG_SUCCESS) {
-        margo_destroy(handle);
-        return SDSKV_MAKE_HG_ERROR(hret);
-    }
-
-    ret = out.ret;
-    if(ret == 0) *vsize = out.size;
+    return sdskv_request_forward(provider, provider->client->sdskv_length_id,
+            &in, r, req, "sdskv_length");
+}
 
-    margo_free_output(handle, &out);
-    margo_destroy(handle);
-    return ret;
+int sdskv_length(sdskv_provider_handle_t provider, 
+        sdskv_database_id_t db_id, const void *key, 
+        hg_size_t ksize, hg_size_t* vsize)
+{
+    sdskv_request_t req;
+    int ret = sdskv_length_async(provider, db_id, key, ksize, vsize, &req);
+    if(ret != SDSKV_SUCCESS) return ret;
+    return sdskv_wait(req);
 }
 
 int sdskv_length_multi(sdskv_provider_handle_t provider, 
@@ -1345,10 +2238,206 @@ int sdskv_get_packed(sdskv_provider_handle_t provider,
     in.vals_bulk_size = (*num)*sizeof(hg_size_t) + vbufsize;
 
     hret = margo_bulk_create(provider->client->mid, 2, seg_ptrs, seg_sizes,
-            HG_BULK_WRITE_ONLY, &in.vals_bulk_handle);
+            HG_BULK_WRITE_ONLY, &in.vals_bulk_handle);
+    if(hret != HG_SUCCESS) {
+        fprintf(stderr,"[SDSKV] margo_bulk_create() for vals/vsizes failed in sdskv_get_packed()\n");
+        margo_bulk_free(in.keys_bulk_handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    /* create RPC handle */
+    hret = margo_create(
+            provider->client->mid,
+            provider->addr,
+            provider->client->sdskv_get_packed_id,
+            &handle);
+    if(hret != HG_SUCCESS) {
+        fprintf(stderr,"[SDSKV] margo_create() failed in sdskv_get_packed()\n");
+        margo_bulk_free(in.keys_bulk_handle);
+        margo_bulk_free(in.vals_bulk_handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    /* forward RPC */
+    hret = margo_provider_forward(provider->provider_id, handle, &in);
+    if(hret != HG_SUCCESS) {
+        fprintf(stderr,"[SDSKV] margo_provider_forward() failed in sdskv_get_packed()\n");
+        margo_bulk_free(in.keys_bulk_handle);
+        margo_bulk_free(in.vals_bulk_handle);
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    /* Get output */
+    hret = margo_get_output(handle, &out);
+    if(hret != HG_SUCCESS) {
+        fprintf(stderr,"[SDSKV] margo_get_output() failed in sdskv_get_packed()\n");
+        margo_bulk_free(in.keys_bulk_handle);
+        margo_bulk_free(in.vals_bulk_handle);
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    ret = out.ret;
+    *num = out.num_keys;
+
+    margo_bulk_free(in.keys_bulk_handle);
+    margo_bulk_free(in.vals_bulk_handle);
+    margo_free_output(handle, &out);
+    margo_destroy(handle);
+    return ret;
+}
+
+/* Retrieves the data described by the output of a get_alloc or
+ * get_packed_alloc RPC into a newly allocated buffer: the data is
+ * either taken from the output itself or pulled from the buffer
+ * that the provider exposed, in which case the provider is
+ * told that this buffer can be released. */
+static int sdskv_retrieve_alloc_result(sdskv_provider_handle_t provider,
+        get_alloc_out_t* out, void** data)
+{
+    hg_return_t hret;
+    hg_bulk_t local_bulk = HG_BULK_NULL;
+    hg_handle_t release_handle = HG_HANDLE_NULL;
+    release_bulk_in_t release_in;
+    void* buffer = NULL;
+    int ret = SDSKV_SUCCESS;
+
+    *data = NULL;
+
+    if(out->bulk_handle == HG_BULK_NULL) {
+        /* the data was sent inline, take ownership of it */
+        if(out->value.size > 0) {
+            *data = out->value.data;
+            out->value.data = NULL;
+            out->value.size = 0;
+        }
+        return SDSKV_SUCCESS;
+    }
+
+    buffer = malloc(out->vsize);
+    hret = margo_bulk_create(provider->client->mid, 1, &buffer, &out->vsize,
+            HG_BULK_WRITE_ONLY, &local_bulk);
+    if(hret != HG_SUCCESS) {
+        fprintf(stderr,"[SDSKV] margo_bulk_create() failed in sdskv_retrieve_alloc_result()\n");
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+
+    hret = margo_bulk_transfer(provider->client->mid, HG_BULK_PULL, provider->addr,
+            out->bulk_handle, 0, local_bulk, 0, out->vsize);
+    if(hret != HG_SUCCESS) {
+        fprintf(stderr,"[SDSKV] margo_bulk_transfer() failed in sdskv_retrieve_alloc_result()\n");
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+
+finish:
+    /* release the provider's buffer (no response is expected);
+     * if this fails the buffer will be freed when its lease expires */
+    release_in.bulk_id = out->bulk_id;
+    hret = margo_create(provider->client->mid, provider->addr,
+            provider->client->sdskv_release_bulk_id, &release_handle);
+    if(hret == HG_SUCCESS) {
+        margo_provider_forward(provider->provider_id, release_handle, &release_in);
+        margo_destroy(release_handle);
+    }
+    margo_bulk_free(local_bulk);
+    if(ret == SDSKV_SUCCESS) {
+        *data = buffer;
+    } else {
+        free(buffer);
+    }
+    return ret;
+}
+
+int sdskv_get_alloc(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id,
+        const void *key, hg_size_t ksize,
+        void **value, hg_size_t* vsize)
+{
+    hg_return_t hret;
+    int ret;
+    hg_handle_t handle;
+
+    get_alloc_in_t in;
+    get_alloc_out_t out;
+
+    *value = NULL;
+
+    in.db_id = db_id;
+    in.key.data = (kv_ptr_t)key;
+    in.key.size = ksize;
+    in.eager_size = provider->client->eager_size;
+
+    /* create handle */
+    hret = margo_create(
+            provider->client->mid,
+            provider->addr,
+            provider->client->sdskv_get_alloc_id,
+            &handle);
+    if(hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
+
+    hret = margo_provider_forward(provider->provider_id, handle, &in);
+    if(hret != HG_SUCCESS) {
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    hret = margo_get_output(handle, &out);
+    if(hret != HG_SUCCESS) {
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    ret = out.ret;
+    if(ret == SDSKV_SUCCESS) {
+        *vsize = out.vsize;
+        ret = sdskv_retrieve_alloc_result(provider, &out, value);
+    }
+
+    margo_free_output(handle, &out);
+    margo_destroy(handle);
+    return ret;
+}
+
+int sdskv_get_packed_alloc(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id,
+        size_t num, const void* packed_keys, const hg_size_t* ksizes,
+        void** packed_values, hg_size_t *vsizes)
+{
+    hg_return_t hret;
+    int ret;
+    hg_handle_t handle;
+    void* result = NULL;
+
+    get_packed_alloc_in_t in;
+    get_alloc_out_t out;
+
+    *packed_values = NULL;
+    if(num == 0) return SDSKV_SUCCESS;
+
+    in.db_id = db_id;
+    in.num_keys = num;
+    in.keys_bulk_size = 0;
+    in.keys_bulk_handle = HG_BULK_NULL;
+    in.eager_size = provider->client->eager_size;
+
+    hg_size_t total_ksize = 0;
+    unsigned i=0;
+    for(i = 0; i < num; i++) {
+        total_ksize += ksizes[i];
+    }
+
+    /* create bulk handle to expose the packed_keys and ksizes */
+    void* seg_ptrs[2] = { (void*)ksizes, (void*)packed_keys };
+    hg_size_t seg_sizes[2] = { num*sizeof(hg_size_t), total_ksize };
+    in.keys_bulk_size = total_ksize + num*sizeof(hg_size_t);
+
+    hret = margo_bulk_create(provider->client->mid, 2, seg_ptrs, seg_sizes,
+            HG_BULK_READ_ONLY, &in.keys_bulk_handle);
     if(hret != HG_SUCCESS) {
-        fprintf(stderr,"[SDSKV] margo_bulk_create() for vals/vsizes failed in sdskv_get_packed()\n");
-        margo_bulk_free(in.keys_bulk_handle);
+        fprintf(stderr,"[SDSKV] margo_bulk_create() for keys/ksizes failed in sdskv_get_packed_alloc()\n");
         return SDSKV_MAKE_HG_ERROR(hret);
     }
 
@@ -1356,21 +2445,19 @@ int sdskv_get_packed(sdskv_provider_handle_t provider,
     hret = margo_create(
             provider->client->mid,
             provider->addr,
-            provider->client->sdskv_get_packed_id,
+            provider->client->sdskv_get_packed_alloc_id,
             &handle);
     if(hret != HG_SUCCESS) {
-        fprintf(stderr,"[SDSKV] margo_create() failed in sdskv_get_packed()\n");
+        fprintf(stderr,"[SDSKV] margo_create() failed in sdskv_get_packed_alloc()\n");
         margo_bulk_free(in.keys_bulk_handle);
-        margo_bulk_free(in.vals_bulk_handle);
         return SDSKV_MAKE_HG_ERROR(hret);
     }
 
     /* forward RPC */
     hret = margo_provider_forward(provider->provider_id, handle, &in);
     if(hret != HG_SUCCESS) {
-        fprintf(stderr,"[SDSKV] margo_provider_forward() failed in sdskv_get_packed()\n");
+        fprintf(stderr,"[SDSKV] margo_provider_forward() failed in sdskv_get_packed_alloc()\n");
         margo_bulk_free(in.keys_bulk_handle);
-        margo_bulk_free(in.vals_bulk_handle);
         margo_destroy(handle);
         return SDSKV_MAKE_HG_ERROR(hret);
     }
@@ -1378,63 +2465,68 @@ int sdskv_get_packed(sdskv_provider_handle_t provider,
     /* Get output */
     hret = margo_get_output(handle, &out);
     if(hret != HG_SUCCESS) {
-        fprintf(stderr,"[SDSKV] margo_get_output() failed in sdskv_get_packed()\n");
+        fprintf(stderr,"[SDSKV] margo_get_output() failed in sdskv_get_packed_alloc()\n");
         margo_bulk_free(in.keys_bulk_handle);
-        margo_bulk_free(in.vals_bulk_handle);
         margo_destroy(handle);
         return SDSKV_MAKE_HG_ERROR(hret);
     }
 
     ret = out.ret;
-    *num = out.num_keys;
+    if(ret == SDSKV_SUCCESS)
+        ret = sdskv_retrieve_alloc_result(provider, &out, &result);
+
+    /* the result is [vsizes][values], move the values to the front */
+    if(ret == SDSKV_SUCCESS) {
+        hg_size_t header_size = num*sizeof(hg_size_t);
+        memcpy(vsizes, result, header_size);
+        memmove(result, (char*)result + header_size, out.vsize - header_size);
+        *packed_values = result;
+    }
 
     margo_bulk_free(in.keys_bulk_handle);
-    margo_bulk_free(in.vals_bulk_handle);
     margo_free_output(handle, &out);
     margo_destroy(handle);
     return ret;
 }
 
-int sdskv_erase(sdskv_provider_handle_t provider,
-        sdskv_database_id_t db_id, const void *key,
-        hg_size_t ksize)
+static int sdskv_erase_complete(sdskv_request_t req)
 {
-    hg_return_t hret;
-    int ret;
-    hg_handle_t handle;
+    erase_out_t out;
+    hg_return_t hret = margo_get_output(req->handle, &out);
+    if(hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
+
+    int ret = out.ret;
+
+    margo_free_output(req->handle, &out);
+    return ret;
+}
 
+int sdskv_erase_async(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id, const void *key,
+        hg_size_t ksize,
+        sdskv_request_t* req)
+{
     erase_in_t in;
-    erase_out_t out;
 
     in.db_id = db_id;
     in.key.data   = (kv_ptr_t)key;
     in.key.size = ksize;
 
-    /* create handle */
-    hret = margo_create(
-            provider->client->mid,
-            provider->addr,
-            provider->client->sdskv_erase_id,
-            &handle);
-    if(hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
-
-    hret = margo_provider_forward(provider->provider_id, handle, &in);
-    if(hret != HG_SUCCESS) {
-        margo_destroy(handle);
-        return SDSKV_MAKE_HG_ERROR(hret);
-    }
-
-    hret = margo_get_output(handle, &out);
-    if(hret != HG_SUCCESS) {
-        margo_destroy(handle);
-        return SDSKV_MAKE_HG_ERROR(hret);
-    }
+    sdskv_request_t r = sdskv_request_create(sdskv_erase_complete);
+    if(!r) return SDSKV_ERR_ALLOCATION;
 
-    ret = out.ret;
+    return sdskv_request_forward(provider, provider->client->sdskv_erase_id,
+            &in, r, req, "sdskv_erase");
+}
 
-    margo_free_output(handle, &out);
-    margo_destroy(handle);
-    return ret;
+int sdskv_erase(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id, const void *key,
+        hg_size_t ksize)
+{
+    sdskv_request_t req;
+    int ret = sdskv_erase_async(provider, db_id, key, ksize, &req);
+    if(ret != SDSKV_SUCCESS) return ret;
+    return sdskv_wait(req);
 }
 
 int sdskv_erase_multi(sdskv_provider_handle_t provider,
@@ -1453,28 +2545,43 @@ int sdskv_erase_multi(sdskv_provider_handle_t provider,
     in.db_id    = db_id;
     in.num_keys = num;
     in.keys_bulk_handle = HG_BULK_NULL;
-    in.keys_bulk_size   = 0;
-
-    /* create an array of key sizes and key pointers */
-    key_seg_sizes       = malloc(sizeof(hg_size_t)*(num+1));
-    key_seg_sizes[0]    = num*sizeof(hg_size_t);
-    memcpy(key_seg_sizes+1, ksizes, num*sizeof(hg_size_t));
-    key_seg_ptrs        = malloc(sizeof(void*)*(num+1));
-    key_seg_ptrs[0]     = (void*)ksizes;
-    memcpy(key_seg_ptrs+1, keys, num*sizeof(void*));
+    in.keys_bulk_size   = num*sizeof(hg_size_t);
+    in.keys.data = NULL;
+    in.keys.size = 0;
 
     int i;
-    for(i=0; i<num+1; i++) {
-        in.keys_bulk_size += key_seg_sizes[i];
+    for(i=0; i<num; i++) {
+        in.keys_bulk_size += ksizes[i];
     }
 
-    /* create the bulk handle to access the keys */
-    hret = margo_bulk_create(provider->client->mid, num+1, key_seg_ptrs, key_seg_sizes,
-            HG_BULK_READ_ONLY, &in.keys_bulk_handle);
-    if(hret != HG_SUCCESS) {
-        fprintf(stderr,"[SDSKV] margo_bulk_create() failed in sdskv_erase_multi()\n");
-        out.ret = SDSKV_MAKE_HG_ERROR(hret);
-        goto finish;
+    if(in.keys_bulk_size <= provider->client->eager_size) {
+        /* small enough to be sent inline with the RPC */
+        in.keys.data = malloc(in.keys_bulk_size);
+        if(!in.keys.data) return SDSKV_ERR_ALLOCATION;
+        in.keys.size = in.keys_bulk_size;
+        sdskv_pack_segments(in.keys.data, num, keys, ksizes);
+    } else {
+        /* create an array of key sizes and key pointers */
+        key_seg_sizes       = malloc(sizeof(hg_size_t)*(num+1));
+        key_seg_ptrs        = malloc(sizeof(void*)*(num+1));
+        if(!key_seg_sizes || !key_seg_ptrs) {
+            free(key_seg_sizes);
+            free(key_seg_ptrs);
+            return SDSKV_ERR_ALLOCATION;
+        }
+        key_seg_sizes[0]    = num*sizeof(hg_size_t);
+        memcpy(key_seg_sizes+1, ksizes, num*sizeof(hg_size_t));
+        key_seg_ptrs[0]     = (void*)ksizes;
+        memcpy(key_seg_ptrs+1, keys, num*sizeof(void*));
+
+        /* create the bulk handle to access the keys */
+        hret = margo_bulk_create(provider->client->mid, num+1, key_seg_ptrs, key_seg_sizes,
+                HG_BULK_READ_ONLY, &in.keys_bulk_handle);
+        if(hret != HG_SUCCESS) {
+            fprintf(stderr,"[SDSKV] margo_bulk_create() failed in sdskv_erase_multi()\n");
+            out.ret = SDSKV_MAKE_HG_ERROR(hret);
+            goto finish;
+        }
     }
 
     /* create a RPC handle */
@@ -1513,6 +2620,7 @@ int sdskv_erase_multi(sdskv_provider_handle_t provider,
 finish:
     margo_free_output(handle, &out);
     margo_bulk_free(in.keys_bulk_handle);
+    free(in.keys.data);
     free(key_seg_sizes);
     free(key_seg_ptrs);
     margo_destroy(handle);
@@ -1553,6 +2661,43 @@ int sdskv_list_keys_with_prefix(sdskv_provider_handle_t provider,
         //    representing sizes allocated in
         //     keys for each key
         hg_size_t* max_keys)   // maximum number of keys requested
+{
+    return sdskv_list_keys_internal(provider, db_id,
+            start_key, start_ksize, prefix, prefix_size,
+            0, NULL, 0, keys, ksizes, max_keys);
+}
+
+int sdskv_list_keys_range(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id,
+        const void *lower_bound,
+        hg_size_t lower_bound_size,
+        const void *upper_bound,
+        hg_size_t upper_bound_size,
+        void **keys,
+        hg_size_t* ksizes,
+        hg_size_t* max_keys)
+{
+    return sdskv_list_keys_internal(provider, db_id,
+            lower_bound, lower_bound_size, NULL, 0,
+            1, upper_bound, upper_bound_size, keys, ksizes, max_keys);
+}
+
+/* Common implementation of the list_keys functions. If range is 0, lists the
+ * keys strictly after start_key that start with prefix through the list_keys
+ * RPC; otherwise lists the keys in [start_key, upper_bound) through the
+ * list_keys_range RPC and prefix is ignored. */
+static int sdskv_list_keys_internal(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id,
+        const void *start_key,
+        hg_size_t start_ksize,
+        const void *prefix,
+        hg_size_t prefix_size,
+        uint8_t range,
+        const void *upper_bound,
+        hg_size_t upper_bound_size,
+        void **keys,
+        hg_size_t* ksizes,
+        hg_size_t* max_keys)
 {
     list_keys_in_t  in;
     list_keys_out_t out;
@@ -1573,13 +2718,255 @@ int sdskv_list_keys_with_prefix(sdskv_provider_handle_t provider,
     in.prefix.size = prefix_size;
     in.keys_bulk_handle   = HG_BULK_NULL;
     in.ksizes_bulk_handle = HG_BULK_NULL;
-    in.max_keys = *max_keys;
+    in.max_keys = *max_keys;
+
+    /* create bulk handle to expose the segments with key sizes */
+    hg_size_t ksize_bulk_size = (*max_keys)*sizeof(*ksizes);
+    void* buf_ptr[1] = { ksizes };
+    hret = margo_bulk_create(provider->client->mid,
+                             1, buf_ptr, &ksize_bulk_size,
+                             HG_BULK_READWRITE,
+                             &in.ksizes_bulk_handle);
+    if(hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+
+    /* make sure none of the buffers is NULL or 0-sized */
+    int requesting_sizes = 0;
+    if(keys == NULL) {
+        requesting_sizes = 1;
+    } else {
+        for(i=0; i < *max_keys; i++) {
+            if(keys[i] == NULL || ksizes[i] == 0) {
+                requesting_sizes = 1;
+                break;
+            }
+        }
+    }
+
+    /* create bulk handle to expose where the keys should be placed */
+    if(!requesting_sizes) {
+        hret = margo_bulk_create(provider->client->mid,
+                             *max_keys, keys, ksizes,
+                             HG_BULK_WRITE_ONLY,
+                             &in.keys_bulk_handle);
+        if(hret != HG_SUCCESS) {
+            ret = SDSKV_MAKE_HG_ERROR(hret);
+            goto finish;
+        }
+    }
+
+    /* create handle */
+    hret = margo_create(
+            provider->client->mid,
+            provider->addr,
+            range ? provider->client->sdskv_list_keys_range_id
+                  : provider->client->sdskv_list_keys_id,
+            &handle);
+    if(hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+
+    /* forward to provider */
+    if(range) {
+        list_keys_range_in_t range_in;
+        range_in.db_id = in.db_id;
+        range_in.lower_bound = in.start_key;
+        range_in.upper_bound.data = (kv_ptr_t) upper_bound;
+        range_in.upper_bound.size = upper_bound_size;
+        range_in.max_keys = in.max_keys;
+        range_in.ksizes_bulk_handle = in.ksizes_bulk_handle;
+        range_in.keys_bulk_handle   = in.keys_bulk_handle;
+        hret = margo_provider_forward(provider->provider_id, handle, &range_in);
+    } else {
+        hret = margo_provider_forward(provider->provider_id, handle, &in);
+    }
+    if(hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+
+    /* get the output from provider */
+    hret = margo_get_output(handle, &out);
+    if(hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+
+    /* set return values */
+    *max_keys = out.nkeys;
+    ret = out.ret;
+
+finish:
+    /* free everything we created */
+    margo_bulk_free(in.ksizes_bulk_handle);
+    margo_bulk_free(in.keys_bulk_handle);
+    margo_free_output(handle, &out);
+    margo_destroy(handle);
+
+    return ret;
+}
+
+int sdskv_list_keyvals(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id,  // db instance
+        const void *start_key,  // we want keys strictly after this start_key
+        hg_size_t start_ksize,  // size of the start_key
+        void **keys,            // pointer to an array of void* pointers,
+                                //     this array has size *max_keys
+        hg_size_t* ksizes,      // pointer to an array of hg_size_t sizes
+                                //    representing sizes allocated in
+                                //     keys for each key
+        void **values,          // pointer to an array of void* pointers,
+                                //     this array has size *max_keys
+        hg_size_t* vsizes,      // pointer to an array of hg_size_t sizes
+                                //    representing sizes allocated in
+                                //    values for each value
+        hg_size_t* max_keys)    // maximum number of keys requested
+{
+    return sdskv_list_keyvals_with_prefix(
+            provider,
+            db_id,
+            start_key,
+            start_ksize,
+            NULL,
+            0,
+            keys,
+            ksizes,
+            values,
+            vsizes,
+            max_keys);
+}
+
+int sdskv_list_keyvals_with_prefix(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id,  // db instance
+        const void *start_key,  // we want keys strictly after this start_key
+        hg_size_t start_ksize,  // size of the start_key
+        const void* prefix,     // prefix of returned keys
+        hg_size_t prefix_size,  // size of prefix
+        void **keys,            // pointer to an array of void* pointers,
+                                //     this array has size *max_keys
+        hg_size_t* ksizes,      // pointer to an array of hg_size_t sizes
+                                //    representing sizes allocated in
+                                //     keys for each key
+        void **values,          // pointer to an array of void* pointers,
+                                //     this array has size *max_keys
+        hg_size_t* vsizes,      // pointer to an array of hg_size_t sizes
+                                //    representing sizes allocated in
+                                //    values for each value
+        hg_size_t* max_keys)    // maximum number of keys requested
+{
+    return sdskv_list_keyvals_internal(provider, db_id,
+            start_key, start_ksize, prefix, prefix_size,
+            0, NULL, 0, keys, ksizes, values, vsizes, max_keys);
+}
+
+int sdskv_list_keyvals_range(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id,
+        const void *lower_bound,
+        hg_size_t lower_bound_size,
+        const void *upper_bound,
+        hg_size_t upper_bound_size,
+        void **keys,
+        hg_size_t* ksizes,
+        void **values,
+        hg_size_t* vsizes,
+        hg_size_t* max_items)
+{
+    return sdskv_list_keyvals_internal(provider, db_id,
+            lower_bound, lower_bound_size, NULL, 0,
+            1, upper_bound, upper_bound_size, keys, ksizes, values, vsizes, max_items);
+}
+
+int sdskv_list_keys_packed(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id,
+        const void *start_key,
+        hg_size_t start_ksize,
+        const void *prefix,
+        hg_size_t prefix_size,
+        void *packed_data,
+        hg_size_t* packed_data_size,
+        const void **keys,
+        hg_size_t* ksizes,
+        hg_size_t* max_keys)
+{
+    /* 0 would mean no limit in the RPC, but the tables hold *max_keys entries */
+    if(*max_keys == 0) {
+        *packed_data_size = 0;
+        return SDSKV_SUCCESS;
+    }
+    return sdskv_list_packed_internal(provider, db_id,
+            start_key, start_ksize, prefix, prefix_size, 0,
+            packed_data, packed_data_size,
+            keys, ksizes, NULL, NULL, max_keys);
+}
+
+int sdskv_list_keyvals_packed(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id,
+        const void *start_key,
+        hg_size_t start_ksize,
+        const void *prefix,
+        hg_size_t prefix_size,
+        void *packed_data,
+        hg_size_t* packed_data_size,
+        const void **keys,
+        hg_size_t* ksizes,
+        const void **values,
+        hg_size_t* vsizes,
+        hg_size_t* max_items)
+{
+    /* 0 would mean no limit in the RPC, but the tables hold *max_items entries */
+    if(*max_items == 0) {
+        *packed_data_size = 0;
+        return SDSKV_SUCCESS;
+    }
+    return sdskv_list_packed_internal(provider, db_id,
+            start_key, start_ksize, prefix, prefix_size, 1,
+            packed_data, packed_data_size,
+            keys, ksizes, values, vsizes, max_items);
+}
+
+/* Common implementation of the list_keyvals functions,
+ * see sdskv_list_keys_internal for the meaning of range. */
+static int sdskv_list_keyvals_internal(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id,
+        const void *start_key,
+        hg_size_t start_ksize,
+        const void* prefix,
+        hg_size_t prefix_size,
+        uint8_t range,
+        const void *upper_bound,
+        hg_size_t upper_bound_size,
+        void **keys,
+        hg_size_t* ksizes,
+        void **values,
+        hg_size_t* vsizes,
+        hg_size_t* max_keys)
+{
+    list_keyvals_in_t  in;
+    list_keyvals_out_t out;
+    hg_return_t hret      = HG_SUCCESS;
+    hg_handle_t handle    = HG_HANDLE_NULL;
+    int ret = SDSKV_SUCCESS;
+    int i;
+
+    in.db_id = db_id;
+    in.start_key.data = (kv_ptr_t) start_key;
+    in.start_key.size = start_ksize;
+    in.prefix.data = (char*)prefix;
+    in.prefix.size = prefix_size;
+    in.max_keys = *max_keys;
+    in.keys_bulk_handle   = HG_BULK_NULL;
+    in.ksizes_bulk_handle = HG_BULK_NULL;
+    in.vals_bulk_handle   = HG_BULK_NULL;
+    in.vsizes_bulk_handle = HG_BULK_NULL;
 
     /* create bulk handle to expose the segments with key sizes */
     hg_size_t ksize_bulk_size = (*max_keys)*sizeof(*ksizes);
-    void* buf_ptr[1] = { ksizes };
+    void* ksizes_buf_ptr[1] = { ksizes };
     hret = margo_bulk_create(provider->client->mid,
-                             1, buf_ptr, &ksize_bulk_size,
+                             1, ksizes_buf_ptr, &ksize_bulk_size,
                              HG_BULK_READWRITE,
                              &in.ksizes_bulk_handle);
     if(hret != HG_SUCCESS) {
@@ -1587,21 +2974,20 @@ int sdskv_list_keys_with_prefix(sdskv_provider_handle_t provider,
         goto finish;
     }
 
-    /* make sure none of the buffers is NULL or 0-sized */
-    int requesting_sizes = 0;
-    if(keys == NULL) {
-        requesting_sizes = 1;
-    } else {
-        for(i=0; i < *max_keys; i++) {
-            if(keys[i] == NULL || ksizes[i] == 0) {
-                requesting_sizes = 1;
-                break;
-            }
-        }
+    /* create bulk handle to expose the segments with value sizes */
+    hg_size_t vsize_bulk_size = (*max_keys)*sizeof(*vsizes);
+    void* vsizes_buf_ptr[1] = { vsizes };
+    hret = margo_bulk_create(provider->client->mid,
+                             1, vsizes_buf_ptr, &ksize_bulk_size,
+                             HG_BULK_READWRITE,
+                             &in.vsizes_bulk_handle);
+    if(hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
     }
 
     /* create bulk handle to expose where the keys should be placed */
-    if(!requesting_sizes) {
+    if(keys) {
         hret = margo_bulk_create(provider->client->mid,
                              *max_keys, keys, ksizes,
                              HG_BULK_WRITE_ONLY,
@@ -1612,11 +2998,24 @@ int sdskv_list_keys_with_prefix(sdskv_provider_handle_t provider,
         }
     }
 
+    /* create bulk handle to expose where the values should be placed */
+    if(values) {
+        hret = margo_bulk_create(provider->client->mid,
+                             *max_keys, values, vsizes,
+                             HG_BULK_WRITE_ONLY,
+                             &in.vals_bulk_handle);
+        if(hret != HG_SUCCESS) {
+            ret = SDSKV_MAKE_HG_ERROR(hret);
+            goto finish;
+        }
+    }
+
     /* create handle */
     hret = margo_create(
             provider->client->mid,
             provider->addr,
-            provider->client->sdskv_list_keys_id,
+            range ? provider->client->sdskv_list_keyvals_range_id
+                  : provider->client->sdskv_list_keyvals_id,
             &handle);
     if(hret != HG_SUCCESS) {
         ret = SDSKV_MAKE_HG_ERROR(hret);
@@ -1624,7 +3023,21 @@ int sdskv_list_keys_with_prefix(sdskv_provider_handle_t provider,
     }
 
     /* forward to provider */
-    hret = margo_provider_forward(provider->provider_id, handle, &in);
+    if(range) {
+        list_keyvals_range_in_t range_in;
+        range_in.db_id = in.db_id;
+        range_in.lower_bound = in.start_key;
+        range_in.upper_bound.data = (kv_ptr_t) upper_bound;
+        range_in.upper_bound.size = upper_bound_size;
+        range_in.max_keys = in.max_keys;
+        range_in.ksizes_bulk_handle = in.ksizes_bulk_handle;
+        range_in.keys_bulk_handle   = in.keys_bulk_handle;
+        range_in.vsizes_bulk_handle = in.vsizes_bulk_handle;
+        range_in.vals_bulk_handle   = in.vals_bulk_handle;
+        hret = margo_provider_forward(provider->provider_id, handle, &range_in);
+    } else {
+        hret = margo_provider_forward(provider->provider_id, handle, &in);
+    }
     if(hret != HG_SUCCESS) {
         ret = SDSKV_MAKE_HG_ERROR(hret);
         goto finish;
@@ -1645,80 +3058,264 @@ finish:
     /* free everything we created */
     margo_bulk_free(in.ksizes_bulk_handle);
     margo_bulk_free(in.keys_bulk_handle);
+    margo_bulk_free(in.vsizes_bulk_handle);
+    margo_bulk_free(in.vals_bulk_handle);
     margo_free_output(handle, &out);
     margo_destroy(handle);
 
     return ret;
 }
 
-int sdskv_list_keyvals(sdskv_provider_handle_t provider,
-        sdskv_database_id_t db_id,  // db instance
-        const void *start_key,  // we want keys strictly after this start_key
-        hg_size_t start_ksize,  // size of the start_key
-        void **keys,            // pointer to an array of void* pointers,
-                                //     this array has size *max_keys
-        hg_size_t* ksizes,      // pointer to an array of hg_size_t sizes
-                                //    representing sizes allocated in
-                                //     keys for each key
-        void **values,          // pointer to an array of void* pointers,
-                                //     this array has size *max_keys
-        hg_size_t* vsizes,      // pointer to an array of hg_size_t sizes
-                                //    representing sizes allocated in
-                                //    values for each value
-        hg_size_t* max_keys)    // maximum number of keys requested
+int sdskv_list_keys_budget(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id,
+        const void *start_key,
+        hg_size_t start_ksize,
+        const void *prefix,
+        hg_size_t prefix_size,
+        void *packed_data,
+        hg_size_t* packed_data_size,
+        hg_size_t* num_keys)
 {
-    return sdskv_list_keyvals_with_prefix(
-            provider,
-            db_id,
-            start_key,
-            start_ksize,
-            NULL,
-            0,
-            keys,
-            ksizes,
-            values,
-            vsizes,
-            max_keys);
+    *num_keys = 0;
+    return sdskv_list_packed_internal(provider, db_id,
+            start_key, start_ksize, prefix, prefix_size, 0,
+            packed_data, packed_data_size,
+            NULL, NULL, NULL, NULL, num_keys);
 }
 
-int sdskv_list_keyvals_with_prefix(sdskv_provider_handle_t provider,
-        sdskv_database_id_t db_id,  // db instance
-        const void *start_key,  // we want keys strictly after this start_key
-        hg_size_t start_ksize,  // size of the start_key
-        const void* prefix,     // prefix of returned keys
-        hg_size_t prefix_size,  // size of prefix
-        void **keys,            // pointer to an array of void* pointers,
-                                //     this array has size *max_keys
-        hg_size_t* ksizes,      // pointer to an array of hg_size_t sizes
-                                //    representing sizes allocated in
-                                //     keys for each key
-        void **values,          // pointer to an array of void* pointers,
-                                //     this array has size *max_keys
-        hg_size_t* vsizes,      // pointer to an array of hg_size_t sizes
-                                //    representing sizes allocated in
-                                //    values for each value
-        hg_size_t* max_keys)    // maximum number of keys requested
+int sdskv_list_keyvals_budget(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id,
+        const void *start_key,
+        hg_size_t start_ksize,
+        const void *prefix,
+        hg_size_t prefix_size,
+        void *packed_data,
+        hg_size_t* packed_data_size,
+        hg_size_t* num_items)
 {
-    list_keyvals_in_t  in;
-    list_keyvals_out_t out;
+    *num_items = 0;
+    return sdskv_list_packed_internal(provider, db_id,
+            start_key, start_ksize, prefix, prefix_size, 1,
+            packed_data, packed_data_size,
+            NULL, NULL, NULL, NULL, num_items);
+}
+
+void sdskv_unpack_keys(
+        const void *packed_data,
+        hg_size_t num_keys,
+        const void **keys,
+        hg_size_t* ksizes)
+{
+    const hg_size_t* packed_ksizes = (const hg_size_t*)packed_data;
+    const char* ptr = (const char*)packed_data + num_keys*sizeof(hg_size_t);
+    hg_size_t i;
+    for(i = 0; i < num_keys; i++) {
+        if(keys)   keys[i]   = ptr;
+        if(ksizes) ksizes[i] = packed_ksizes[i];
+        ptr += packed_ksizes[i];
+    }
+}
+
+void sdskv_unpack_keyvals(
+        const void *packed_data,
+        hg_size_t num_items,
+        const void **keys,
+        hg_size_t* ksizes,
+        const void **values,
+        hg_size_t* vsizes)
+{
+    const hg_size_t* packed_ksizes = (const hg_size_t*)packed_data;
+    const hg_size_t* packed_vsizes = packed_ksizes + num_items;
+    const char* ptr = (const char*)packed_data + 2*num_items*sizeof(hg_size_t);
+    hg_size_t i;
+    for(i = 0; i < num_items; i++) {
+        if(keys)   keys[i]   = ptr;
+        if(ksizes) ksizes[i] = packed_ksizes[i];
+        ptr += packed_ksizes[i];
+    }
+    for(i = 0; i < num_items; i++) {
+        if(values) values[i] = ptr;
+        if(vsizes) vsizes[i] = packed_vsizes[i];
+        ptr += packed_vsizes[i];
+    }
+}
+
+static int sdskv_list_packed_internal(sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id,
+        const void *start_key,
+        hg_size_t start_ksize,
+        const void* prefix,
+        hg_size_t prefix_size,
+        uint8_t with_values,
+        void *packed_data,
+        hg_size_t* packed_data_size,
+        const void **keys,
+        hg_size_t* ksizes,
+        const void **values,
+        hg_size_t* vsizes,
+        hg_size_t* max_keys)
+{
+    list_packed_in_t  in;
+    list_packed_out_t out;
     hg_return_t hret      = HG_SUCCESS;
     hg_handle_t handle    = HG_HANDLE_NULL;
     int ret = SDSKV_SUCCESS;
-    int i;
 
     in.db_id = db_id;
     in.start_key.data = (kv_ptr_t) start_key;
     in.start_key.size = start_ksize;
-    in.prefix.data = (char*)prefix;
+    in.prefix.data = (kv_ptr_t) prefix;
     in.prefix.size = prefix_size;
     in.max_keys = *max_keys;
+    in.with_values = with_values;
+    in.bulk_size = *packed_data_size;
+    in.bulk_handle = HG_BULK_NULL;
+
+    /* create bulk handle to expose the buffer receiving the packed data */
+    hret = sdskv_bulk_create_cached(provider->client,
+                             packed_data, *packed_data_size,
+                             HG_BULK_WRITE_ONLY,
+                             &in.bulk_handle);
+    if(hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+
+    /* create handle */
+    hret = margo_create(
+            provider->client->mid,
+            provider->addr,
+            provider->client->sdskv_list_packed_id,
+            &handle);
+    if(hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+
+    /* forward to provider */
+    hret = margo_provider_forward(provider->provider_id, handle, &in);
+    if(hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+
+    /* get the output from provider */
+    hret = margo_get_output(handle, &out);
+    if(hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+
+    /* set return values */
+    ret = out.ret;
+    *max_keys = out.nkeys;
+    *packed_data_size = out.size;
+    if(ret != SDSKV_SUCCESS) {
+        *max_keys = 0;
+        goto finish;
+    }
+
+    /* build the tables of pointers into the packed data */
+    if(with_values)
+        sdskv_unpack_keyvals(packed_data, out.nkeys, keys, ksizes, values, vsizes);
+    else
+        sdskv_unpack_keys(packed_data, out.nkeys, keys, ksizes);
+
+finish:
+    /* free everything we created */
+    margo_bulk_free(in.bulk_handle);
+    margo_free_output(handle, &out);
+    margo_destroy(handle);
+
+    return ret;
+}
+
+int sdskv_cursor_open(
+        sdskv_provider_handle_t provider,
+        sdskv_database_id_t db_id,
+        const void *start_key,
+        hg_size_t start_ksize,
+        const void *prefix,
+        hg_size_t prefix_size,
+        uint32_t lease_ms,
+        sdskv_cursor_t* cursor)
+{
+    open_cursor_in_t  in;
+    open_cursor_out_t out;
+    hg_return_t hret   = HG_SUCCESS;
+    hg_handle_t handle = HG_HANDLE_NULL;
+    int ret = SDSKV_SUCCESS;
+
+    in.db_id = db_id;
+    in.start_key.data = (kv_ptr_t) start_key;
+    in.start_key.size = start_ksize;
+    in.prefix.data = (kv_ptr_t) prefix;
+    in.prefix.size = prefix_size;
+    in.lease_ms = lease_ms;
+
+    hret = margo_create(
+            provider->client->mid,
+            provider->addr,
+            provider->client->sdskv_open_cursor_id,
+            &handle);
+    if(hret != HG_SUCCESS) return SDSKV_MAKE_HG_ERROR(hret);
+
+    hret = margo_provider_forward(provider->provider_id, handle, &in);
+    if(hret != HG_SUCCESS) {
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    hret = margo_get_output(handle, &out);
+    if(hret != HG_SUCCESS) {
+        margo_destroy(handle);
+        return SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    ret = out.ret;
+    if(ret == SDSKV_SUCCESS) {
+        sdskv_cursor_t c = (sdskv_cursor_t)calloc(1, sizeof(*c));
+        if(!c) {
+            ret = SDSKV_ERR_ALLOCATION;
+        } else {
+            c->provider  = provider;
+            c->cursor_id = out.cursor_id;
+            sdskv_provider_handle_ref_incr(provider);
+            *cursor = c;
+        }
+    }
+
+    margo_free_output(handle, &out);
+    margo_destroy(handle);
+    return ret;
+}
+
+int sdskv_cursor_next(
+        sdskv_cursor_t cursor,
+        void **keys,
+        hg_size_t* ksizes,
+        void **values,
+        hg_size_t* vsizes,
+        hg_size_t* max_items)
+{
+    cursor_next_in_t  in;
+    cursor_next_out_t out;
+    hg_return_t hret      = HG_SUCCESS;
+    hg_handle_t handle    = HG_HANDLE_NULL;
+    sdskv_provider_handle_t provider = cursor->provider;
+    int ret = SDSKV_SUCCESS;
+
+    if(*max_items == 0) return SDSKV_SUCCESS;
+
+    in.cursor_id = cursor->cursor_id;
+    in.max_keys  = *max_items;
     in.keys_bulk_handle   = HG_BULK_NULL;
     in.ksizes_bulk_handle = HG_BULK_NULL;
     in.vals_bulk_handle   = HG_BULK_NULL;
     in.vsizes_bulk_handle = HG_BULK_NULL;
 
     /* create bulk handle to expose the segments with key sizes */
-    hg_size_t ksize_bulk_size = (*max_keys)*sizeof(*ksizes);
+    hg_size_t ksize_bulk_size = (*max_items)*sizeof(*ksizes);
     void* ksizes_buf_ptr[1] = { ksizes };
     hret = margo_bulk_create(provider->client->mid,
                              1, ksizes_buf_ptr, &ksize_bulk_size,
@@ -1730,10 +3327,10 @@ int sdskv_list_keyvals_with_prefix(sdskv_provider_handle_t provider,
     }
 
     /* create bulk handle to expose the segments with value sizes */
-    hg_size_t vsize_bulk_size = (*max_keys)*sizeof(*vsizes);
+    hg_size_t vsize_bulk_size = (*max_items)*sizeof(*vsizes);
     void* vsizes_buf_ptr[1] = { vsizes };
     hret = margo_bulk_create(provider->client->mid,
-                             1, vsizes_buf_ptr, &ksize_bulk_size,
+                             1, vsizes_buf_ptr, &vsize_bulk_size,
                              HG_BULK_READWRITE,
                              &in.vsizes_bulk_handle);
     if(hret != HG_SUCCESS) {
@@ -1744,7 +3341,7 @@ int sdskv_list_keyvals_with_prefix(sdskv_provider_handle_t provider,
     /* create bulk handle to expose where the keys should be placed */
     if(keys) {
         hret = margo_bulk_create(provider->client->mid,
-                             *max_keys, keys, ksizes,
+                             *max_items, keys, ksizes,
                              HG_BULK_WRITE_ONLY,
                              &in.keys_bulk_handle);
         if(hret != HG_SUCCESS) {
@@ -1756,7 +3353,7 @@ int sdskv_list_keyvals_with_prefix(sdskv_provider_handle_t provider,
     /* create bulk handle to expose where the values should be placed */
     if(values) {
         hret = margo_bulk_create(provider->client->mid,
-                             *max_keys, values, vsizes,
+                             *max_items, values, vsizes,
                              HG_BULK_WRITE_ONLY,
                              &in.vals_bulk_handle);
         if(hret != HG_SUCCESS) {
@@ -1769,7 +3366,7 @@ int sdskv_list_keyvals_with_prefix(sdskv_provider_handle_t provider,
     hret = margo_create(
             provider->client->mid,
             provider->addr,
-            provider->client->sdskv_list_keyvals_id,
+            provider->client->sdskv_cursor_next_id,
             &handle);
     if(hret != HG_SUCCESS) {
         ret = SDSKV_MAKE_HG_ERROR(hret);
@@ -1791,21 +3388,65 @@ int sdskv_list_keyvals_with_prefix(sdskv_provider_handle_t provider,
     }
 
     /* set return values */
-    *max_keys = out.nkeys;
+    *max_items = out.nkeys;
     ret = out.ret;
 
+    margo_free_output(handle, &out);
+
 finish:
     /* free everything we created */
     margo_bulk_free(in.ksizes_bulk_handle);
     margo_bulk_free(in.keys_bulk_handle);
     margo_bulk_free(in.vsizes_bulk_handle);
     margo_bulk_free(in.vals_bulk_handle);
-    margo_free_output(handle, &out);
     margo_destroy(handle);
 
     return ret;
 }
 
+int sdskv_cursor_close(sdskv_cursor_t cursor)
+{
+    close_cursor_in_t  in;
+    close_cursor_out_t out;
+    hg_return_t hret   = HG_SUCCESS;
+    hg_handle_t handle = HG_HANDLE_NULL;
+    sdskv_provider_handle_t provider = cursor->provider;
+    int ret = SDSKV_SUCCESS;
+
+    in.cursor_id = cursor->cursor_id;
+
+    hret = margo_create(
+            provider->client->mid,
+            provider->addr,
+            provider->client->sdskv_close_cursor_id,
+            &handle);
+    if(hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+
+    hret = margo_provider_forward(provider->provider_id, handle, &in);
+    if(hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+
+    hret = margo_get_output(handle, &out);
+    if(hret != HG_SUCCESS) {
+        ret = SDSKV_MAKE_HG_ERROR(hret);
+        goto finish;
+    }
+
+    ret = out.ret;
+    margo_free_output(handle, &out);
+
+finish:
+    margo_destroy(handle);
+    sdskv_provider_handle_release(provider);
+    free(cursor);
+    return ret;
+}
+
 int sdskv_migrate_keys(
         sdskv_provider_handle_t source_provider,
         sdskv_database_id_t source_db_id,
@@ -47,6 +47,42 @@ static inline hg_return_t hg_proc_kv_data_t(hg_proc_t proc, void *arg)
   return HG_SUCCESS;
 }
 
+/* kv_view_t is encoded like kv_data_t, but decoding it does not allocate
+ * or copy: data points into the RPC's input buffer, hence it is only valid
+ * until margo_free_input is called and must not be freed or retained.
+ * It is used for the keys and values of requests that the provider only
+ * reads while handling them. */
+typedef kv_data_t kv_view_t;
+
+static inline hg_return_t hg_proc_kv_view_t(hg_proc_t proc, void *arg)
+{
+  hg_return_t ret;
+  kv_view_t *in = (kv_view_t*)arg;
+  ret = hg_proc_hg_size_t(proc, &in->size);
+  if(ret != HG_SUCCESS) return ret;
+  switch (hg_proc_get_op(proc)) {
+  case HG_ENCODE:
+    if(in->size) {
+      ret = hg_proc_raw(proc, in->data, in->size);
+      if(ret != HG_SUCCESS) return ret;
+    }
+    break;
+  case HG_DECODE:
+    if(in->size) {
+      in->data = (kv_ptr_t)hg_proc_save_ptr(proc, in->size);
+      if(!in->data) return HG_OVERFLOW;
+      ret = hg_proc_restore_ptr(proc, in->data, in->size);
+      if(ret != HG_SUCCESS) return ret;
+    } else {
+      in->data = NULL;
+    }
+    break;
+  default:
+    break;
+  }
+  return HG_SUCCESS;
+}
+
 // ------------- OPEN ------------- //
 MERCURY_GEN_PROC(open_in_t, 
         ((hg_string_t)(name)))
@@ -122,13 +158,13 @@ static hg_return_t hg_proc_list_db_out_t(hg_proc_t proc, void* arg)
 
 // ------------- PUT ------------- //
 MERCURY_GEN_PROC(put_in_t, ((uint64_t)(db_id))\
-        ((kv_data_t)(key))\
-        ((kv_data_t)(value)))
+        ((kv_view_t)(key))\
+        ((kv_view_t)(value)))
 MERCURY_GEN_PROC(put_out_t, ((int32_t)(ret)))
 
 // ------------- GET ------------- //
 MERCURY_GEN_PROC(get_in_t, ((uint64_t)(db_id))\
-        ((kv_data_t)(key))\
+        ((kv_view_t)(key))\
         ((hg_size_t)(vsize)))
 
 MERCURY_GEN_PROC(get_out_t, ((int32_t)(ret))\
@@ -136,16 +172,16 @@ MERCURY_GEN_PROC(get_out_t, ((int32_t)(ret))\
         ((hg_size_t)(vsize)))
 
 // ------------- LENGTH ------------- //
-MERCURY_GEN_PROC(length_in_t, ((uint64_t)(db_id))((kv_data_t)(key)))
+MERCURY_GEN_PROC(length_in_t, ((uint64_t)(db_id))((kv_view_t)(key)))
 MERCURY_GEN_PROC(length_out_t, ((hg_size_t)(size)) ((int32_t)(ret)))
 
 // ------------- EXISTS ------------- //
-MERCURY_GEN_PROC(exists_in_t, ((uint64_t)(db_id))((kv_data_t)(key)))
+MERCURY_GEN_PROC(exists_in_t, ((uint64_t)(db_id))((kv_view_t)(key)))
 MERCURY_GEN_PROC(exists_out_t, ((int32_t)(flag)) ((int32_t)(ret)))
 
 // ------------- ERASE ------------- //
 MERCURY_GEN_PROC(erase_out_t, ((int32_t)(ret)))
-MERCURY_GEN_PROC(erase_in_t, ((uint64_t)(db_id))((kv_data_t)(key)))
+MERCURY_GEN_PROC(erase_in_t, ((uint64_t)(db_id))((kv_view_t)(key)))
 
 // ------------- LIST KEYS ------------- //
 MERCURY_GEN_PROC(list_keys_in_t, ((uint64_t)(db_id))\
@@ -167,6 +203,54 @@ MERCURY_GEN_PROC(list_keyvals_in_t, ((uint64_t)(db_id))\
         ((hg_bulk_t)(vals_bulk_handle)))
 MERCURY_GEN_PROC(list_keyvals_out_t, ((hg_size_t)(nkeys)) ((int32_t)(ret)))
 
+// ------------- LIST KEYS RANGE ------------- //
+MERCURY_GEN_PROC(list_keys_range_in_t, ((uint64_t)(db_id))\
+        ((kv_data_t)(lower_bound))\
+        ((kv_data_t)(upper_bound))\
+        ((hg_size_t)(max_keys))\
+        ((hg_bulk_t)(ksizes_bulk_handle))\
+        ((hg_bulk_t)(keys_bulk_handle)))
+
+// ------------- LIST KEYVALS RANGE ------------- //
+MERCURY_GEN_PROC(list_keyvals_range_in_t, ((uint64_t)(db_id))\
+        ((kv_data_t)(lower_bound))\
+        ((kv_data_t)(upper_bound))\
+        ((hg_size_t)(max_keys))\
+        ((hg_bulk_t)(ksizes_bulk_handle))\
+        ((hg_bulk_t)(keys_bulk_handle))\
+        ((hg_bulk_t)(vsizes_bulk_handle))\
+        ((hg_bulk_t)(vals_bulk_handle)))
+
+// ------------- LIST PACKED ------------- //
+MERCURY_GEN_PROC(list_packed_in_t, ((uint64_t)(db_id))\
+        ((kv_data_t)(start_key))\
+        ((kv_data_t)(prefix))\
+        ((hg_size_t)(max_keys))\
+        ((uint8_t)(with_values))\
+        ((hg_size_t)(bulk_size))\
+        ((hg_bulk_t)(bulk_handle)))
+MERCURY_GEN_PROC(list_packed_out_t, ((hg_size_t)(nkeys))\
+        ((hg_size_t)(size))\
+        ((int32_t)(ret)))
+
+// ------------- CURSORS ------------- //
+MERCURY_GEN_PROC(open_cursor_in_t, ((uint64_t)(db_id))\
+        ((kv_data_t)(start_key))\
+        ((kv_data_t)(prefix))\
+        ((uint32_t)(lease_ms)))
+MERCURY_GEN_PROC(open_cursor_out_t, ((uint64_t)(cursor_id)) ((int32_t)(ret)))
+
+MERCURY_GEN_PROC(cursor_next_in_t, ((uint64_t)(cursor_id))\
+        ((hg_size_t)(max_keys))\
+        ((hg_bulk_t)(ksizes_bulk_handle))\
+        ((hg_bulk_t)(keys_bulk_handle))\
+        ((hg_bulk_t)(vsizes_bulk_handle))\
+        ((hg_bulk_t)(vals_bulk_handle)))
+MERCURY_GEN_PROC(cursor_next_out_t, ((hg_size_t)(nkeys)) ((int32_t)(ret)))
+
+MERCURY_GEN_PROC(close_cursor_in_t, ((uint64_t)(cursor_id)))
+MERCURY_GEN_PROC(close_cursor_out_t, ((int32_t)(ret)))
+
 // ------------- BULK PUT ------------- //
 MERCURY_GEN_PROC(bulk_put_in_t, ((uint64_t)(db_id))\
         ((kv_data_t)(key))\
@@ -182,13 +266,17 @@ MERCURY_GEN_PROC(bulk_get_in_t, ((uint64_t)(db_id))\
 MERCURY_GEN_PROC(bulk_get_out_t, ((hg_size_t)(vsize)) ((int32_t)(ret)))
 
 // ------------- PUT MULTI ------------- //
+// if keys_bulk_handle is null, [ksizes][keys] and [vsizes][values]
+// are sent inline in keys and vals
 MERCURY_GEN_PROC(put_multi_in_t, \
         ((uint64_t)(db_id))\
         ((hg_size_t)(num_keys))\
         ((hg_bulk_t)(keys_bulk_handle))\
         ((hg_size_t)(keys_bulk_size))\
         ((hg_bulk_t)(vals_bulk_handle))\
-        ((hg_size_t)(vals_bulk_size)))
+        ((hg_size_t)(vals_bulk_size))\
+        ((kv_view_t)(keys))\
+        ((kv_view_t)(vals)))
 MERCURY_GEN_PROC(put_multi_out_t, ((int32_t)(ret)))
 
 // ------------- PUT PACKED ------------- //
@@ -201,14 +289,20 @@ MERCURY_GEN_PROC(put_packed_in_t, \
 MERCURY_GEN_PROC(put_packed_out_t, ((int32_t)(ret)))
 
 // ------------- GET MULTI ------------- //
+// if keys_bulk_handle is null, [ksizes][keys] and the sizes allocated
+// for the values are sent inline in keys and vals, and [vsizes][values]
+// is sent back inline in the output's values
 MERCURY_GEN_PROC(get_multi_in_t, \
         ((uint64_t)(db_id))\
         ((hg_size_t)(num_keys))\
         ((hg_bulk_t)(keys_bulk_handle))\
         ((hg_size_t)(keys_bulk_size))\
         ((hg_bulk_t)(vals_bulk_handle))\
-        ((hg_size_t)(vals_bulk_size)))
-MERCURY_GEN_PROC(get_multi_out_t, ((int32_t)(ret)))
+        ((hg_size_t)(vals_bulk_size))\
+        ((kv_view_t)(keys))\
+        ((kv_view_t)(vals)))
+MERCURY_GEN_PROC(get_multi_out_t, ((int32_t)(ret))\
+        ((kv_data_t)(values)))
 
 // ------------- GET PACKED ------------- //
 MERCURY_GEN_PROC(get_packed_in_t, \
@@ -222,6 +316,28 @@ MERCURY_GEN_PROC(get_packed_out_t, \
         ((int32_t)(ret))\
         ((hg_size_t)(num_keys)))
 
+// ------------- GET ALLOC ------------- //
+MERCURY_GEN_PROC(get_alloc_in_t, ((uint64_t)(db_id))\
+        ((kv_data_t)(key))\
+        ((hg_size_t)(eager_size)))
+
+MERCURY_GEN_PROC(get_alloc_out_t, ((int32_t)(ret))\
+        ((hg_size_t)(vsize))\
+        ((kv_data_t)(value))\
+        ((uint64_t)(bulk_id))\
+        ((hg_bulk_t)(bulk_handle)))
+
+// ------------- GET PACKED ALLOC ------------- //
+MERCURY_GEN_PROC(get_packed_alloc_in_t, \
+        ((uint64_t)(db_id))\
+        ((hg_size_t)(num_keys))\
+        ((hg_size_t)(keys_bulk_size))\
+        ((hg_bulk_t)(keys_bulk_handle))\
+        ((hg_size_t)(eager_size)))
+
+// ------------- RELEASE BULK ------------- //
+MERCURY_GEN_PROC(release_bulk_in_t, ((uint64_t)(bulk_id)))
+
 // ------------- LENGTH MULTI ------------- //
 MERCURY_GEN_PROC(length_multi_in_t, \
         ((uint64_t)(db_id))\
@@ -250,11 +366,13 @@ MERCURY_GEN_PROC(exists_multi_in_t, \
 MERCURY_GEN_PROC(exists_multi_out_t, ((int32_t)(ret)))
 
 // ------------- ERASE MULTI ------------- //
+// if keys_bulk_handle is null, [ksizes][keys] is sent inline in keys
 MERCURY_GEN_PROC(erase_multi_in_t, \
         ((uint64_t)(db_id))\
         ((hg_size_t)(num_keys))\
         ((hg_bulk_t)(keys_bulk_handle))\
-        ((hg_size_t)(keys_bulk_size)))
+        ((hg_size_t)(keys_bulk_size))\
+        ((kv_view_t)(keys)))
 MERCURY_GEN_PROC(erase_multi_out_t, ((int32_t)(ret)))
 
 // ------------- MIGRATE KEYS ----------- //
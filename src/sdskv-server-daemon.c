@@ -24,32 +24,44 @@ struct options
     unsigned num_db;
     char **db_names;
     sdskv_db_type_t *db_types;
+    char **db_options;
     char *host_file;
     kv_mplex_mode_t mplex_mode;
 };
 
 static void usage(int argc, char **argv)
 {
-    fprintf(stderr, "Usage: sdskv-server-daemon [OPTIONS] <listen_addr> <db name 1>[:map|:bwt|:bdb|:ldb] <db name 2>[:map|:bwt|:bdb|:ldb] ...\n");
+    fprintf(stderr, "Usage: sdskv-server-daemon [OPTIONS] <listen_addr> <db name 1>[:map|:smap|:hash|:bwt|:bdb|:ldb[:options]] <db name 2>[:map|:smap|:hash|:bwt|:bdb|:ldb[:options]] ...\n");
     fprintf(stderr, "       listen_addr is the Mercury address to listen on\n");
     fprintf(stderr, "       db name X are the names of the databases\n");
+    fprintf(stderr, "       options are engine-specific key=value pairs separated by commas\n");
     fprintf(stderr, "       [-f filename] to write the server address to a file\n");
     fprintf(stderr, "       [-m mode] multiplexing mode (providers or databases) for managing multiple databases (default is databases)\n"); 
     fprintf(stderr, "Example: ./sdskv-server-daemon tcp://localhost:1234 foo:bdb bar\n");
+    fprintf(stderr, "Example: ./sdskv-server-daemon tcp://localhost:1234 foo:ldb:block_cache_size=256M,bloom_bits_per_key=10\n");
     return;
 }
 
-static sdskv_db_type_t parse_db_type(char* db_fullname) {
+static sdskv_db_type_t parse_db_type(char* db_fullname, char** db_options) {
     char* column = strstr(db_fullname, ":");
     if(column == NULL) {
         return KVDB_MAP;
     }
     *column = '\0';
     char* db_type = column + 1;
+    char* options = strstr(db_type, ":");
+    if(options != NULL) {
+        *options = '\0';
+        *db_options = options + 1;
+    }
     if(strcmp(db_type, "null") == 0) {
         return KVDB_NULL;
     } else if(strcmp(db_type, "map") == 0) {
         return KVDB_MAP;
+    } else if(strcmp(db_type, "smap") == 0) {
+        return KVDB_SHARDED_MAP;
+    } else if(strcmp(db_type, "hash") == 0) {
+        return KVDB_HASH;
     } else if(strcmp(db_type, "bwt") == 0) {
         return KVDB_BWTREE;
     } else if(strcmp(db_type, "bdb") == 0) {
@@ -101,10 +113,11 @@ static void parse_args(int argc, char **argv, struct options *opts)
     opts->listen_addr_str = argv[optind++];
     opts->db_names = calloc(opts->num_db, sizeof(char*));
     opts->db_types = calloc(opts->num_db, sizeof(sdskv_db_type_t));
+    opts->db_options = calloc(opts->num_db, sizeof(char*));
     int i;
     for(i=0; i < opts->num_db; i++) {
         opts->db_names[i] = argv[optind++];
-        opts->db_types[i] = parse_db_type(opts->db_names[i]);
+        opts->db_types[i] = parse_db_type(opts->db_names[i], &(opts->db_options[i]));
     }
 
     return;
@@ -213,7 +226,8 @@ int main(int argc, char **argv)
                 .db_path = (x == NULL ? "" : path),
                 .db_type = opts.db_types[i],
                 .db_comp_fn_name = SDSKV_COMPARE_DEFAULT,
-                .db_no_overwrite = 0
+                .db_no_overwrite = 0,
+                .db_options = opts.db_options[i]
             };
             ret = sdskv_provider_attach_database(provider, &db_config, &db_id);
 
@@ -272,7 +286,8 @@ int main(int argc, char **argv)
                 .db_path = (x == NULL ? "" : path),
                 .db_type = opts.db_types[i],
                 .db_comp_fn_name = SDSKV_COMPARE_DEFAULT,
-                .db_no_overwrite = 0
+                .db_no_overwrite = 0,
+                .db_options = opts.db_options[i]
             };
             ret = sdskv_provider_attach_database(provider, &db_config, &db_id);
 
@@ -21,30 +21,64 @@ struct options
     unsigned num_db;
     char **db_names;
     sdskv_db_type_t *db_types;
+    char **db_options;
     char *host_file;
     kv_mplex_mode_t mplex_mode;
+    int num_io_xstreams;
+    int group_commit_delay; /* in microseconds, -1 if disabled */
+    int read_coalescing;
+};
+
+struct io_xstreams
+{
+    int num;
+    ABT_xstream *xstreams;
+};
+
+struct db_stats_monitor
+{
+    sdskv::provider* provider;
+    sdskv_database_id_t db_id;
+    const char* db_name;
+    bool group_commit;
+    bool read_coalescing;
 };
 
 static void usage(int argc, char **argv)
 {
-    fprintf(stderr, "Usage: sdskv-server-daemon [OPTIONS] <listen_addr> <db name 1>[:map|:bwt|:bdb|:ldb] <db name 2>[:map|:bwt|:bdb|:ldb] ...\n");
+    fprintf(stderr, "Usage: sdskv-server-daemon [OPTIONS] <listen_addr> <db name 1>[:map|:smap|:hash|:bwt|:bdb|:ldb[:options]] <db name 2>[:map|:smap|:hash|:bwt|:bdb|:ldb[:options]] ...\n");
     fprintf(stderr, "       listen_addr is the Mercury address to listen on\n");
     fprintf(stderr, "       db name X are the names of the databases\n");
+    fprintf(stderr, "       options are engine-specific key=value pairs separated by commas\n");
     fprintf(stderr, "       [-f filename] to write the server address to a file\n");
     fprintf(stderr, "       [-m mode] multiplexing mode (providers or databases) for managing multiple databases (default is databases)\n"); 
+    fprintf(stderr, "       [-g delay] commit concurrent puts and erases in batches, waiting up to delay microseconds for a batch to fill\n");
+    fprintf(stderr, "       [-r] make concurrent gets of the same key share a single lookup\n");
+    fprintf(stderr, "       [-i num] number of execution streams running the operations on bdb and ldb databases (default is 0, i.e. the RPC execution streams)\n");
     fprintf(stderr, "Example: ./sdskv-server-daemon tcp://localhost:1234 foo:bdb bar\n");
+    fprintf(stderr, "Example: ./sdskv-server-daemon tcp://localhost:1234 foo:ldb:block_cache_size=256M,bloom_bits_per_key=10\n");
+    fprintf(stderr, "Example: ./sdskv-server-daemon tcp://localhost:1234 foo:smap:num_shards=64\n");
     return;
 }
 
-static sdskv_db_type_t parse_db_type(char* db_fullname) {
+static sdskv_db_type_t parse_db_type(char* db_fullname, char** db_options) {
     char* column = strstr(db_fullname, ":");
     if(column == NULL) {
         return KVDB_MAP;
     }
     *column = '\0';
     char* db_type = column + 1;
+    char* options = strstr(db_type, ":");
+    if(options != NULL) {
+        *options = '\0';
+        *db_options = options + 1;
+    }
     if(strcmp(db_type, "map") == 0) {
         return KVDB_MAP;
+    } else if(strcmp(db_type, "smap") == 0) {
+        return KVDB_SHARDED_MAP;
+    } else if(strcmp(db_type, "hash") == 0) {
+        return KVDB_HASH;
     } else if(strcmp(db_type, "bwt") == 0) {
         return KVDB_BWTREE;
     } else if(strcmp(db_type, "bdb") == 0) {
@@ -61,9 +95,10 @@ static void parse_args(int argc, char **argv, struct options *opts)
     int opt;
 
     memset(opts, 0, sizeof(*opts));
+    opts->group_commit_delay = -1;
 
     /* get options */
-    while((opt = getopt(argc, argv, "f:m:")) != -1)
+    while((opt = getopt(argc, argv, "f:m:i:g:r")) != -1)
     {
         switch(opt)
         {
@@ -80,6 +115,23 @@ static void parse_args(int argc, char **argv, struct options *opts)
                     exit(EXIT_FAILURE);
                 }
                 break;
+            case 'g':
+                opts->group_commit_delay = atoi(optarg);
+                if(opts->group_commit_delay < 0) {
+                    fprintf(stderr, "Invalid group commit delay \"%s\"\n", optarg);
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            case 'r':
+                opts->read_coalescing = 1;
+                break;
+            case 'i':
+                opts->num_io_xstreams = atoi(optarg);
+                if(opts->num_io_xstreams < 0) {
+                    fprintf(stderr, "Invalid number of I/O execution streams \"%s\"\n", optarg);
+                    exit(EXIT_FAILURE);
+                }
+                break;
             default:
                 usage(argc, argv);
                 exit(EXIT_FAILURE);
@@ -96,15 +148,89 @@ static void parse_args(int argc, char **argv, struct options *opts)
     opts->listen_addr_str = argv[optind++];
     opts->db_names = calloc(opts->num_db, sizeof(char*));
     opts->db_types = calloc(opts->num_db, sizeof(sdskv_db_type_t));
+    opts->db_options = calloc(opts->num_db, sizeof(char*));
     int i;
     for(i=0; i < opts->num_db; i++) {
         opts->db_names[i] = argv[optind++];
-        opts->db_types[i] = parse_db_type(opts->db_names[i]);
+        opts->db_types[i] = parse_db_type(opts->db_names[i], &(opts->db_options[i]));
     }
 
     return;
 }
 
+static void join_io_xstreams(void* arg)
+{
+    struct io_xstreams *io = (struct io_xstreams*)arg;
+    int i;
+    for(i=0; i < io->num; i++) {
+        ABT_xstream_join(io->xstreams[i]);
+        ABT_xstream_free(&io->xstreams[i]);
+    }
+    free(io->xstreams);
+    free(io);
+}
+
+/* prints the group commit and read coalescing counters of a database,
+ * pushed after its provider so it runs before the provider is destroyed */
+static void print_db_stats(void* arg)
+{
+    struct db_stats_monitor *m = (struct db_stats_monitor*)arg;
+    if(m->group_commit) {
+        sdskv_group_commit_stats_t stats = m->provider->get_group_commit_stats(m->db_id);
+        printf("Database \"%s\" group commit: %llu writes in %llu batches\n", m->db_name,
+                (unsigned long long)stats.num_writes, (unsigned long long)stats.num_batches);
+    }
+    if(m->read_coalescing) {
+        sdskv_read_coalescing_stats_t stats = m->provider->get_read_coalescing_stats(m->db_id);
+        printf("Database \"%s\" read coalescing: %llu gets, %llu lookups, %llu merged\n", m->db_name,
+                (unsigned long long)stats.num_gets, (unsigned long long)stats.num_lookups,
+                (unsigned long long)stats.num_merged);
+    }
+    fflush(stdout);
+    delete m;
+}
+
+static void monitor_db_stats(margo_instance_id mid, const struct options& opts,
+        sdskv::provider* provider, sdskv_database_id_t db_id, const char* db_name)
+{
+    if(opts.group_commit_delay < 0 && !opts.read_coalescing)
+        return;
+    struct db_stats_monitor *m = new db_stats_monitor;
+    m->provider        = provider;
+    m->db_id           = db_id;
+    m->db_name         = db_name;
+    m->group_commit    = opts.group_commit_delay >= 0;
+    m->read_coalescing = opts.read_coalescing;
+    margo_push_finalize_callback(mid, print_db_stats, m);
+}
+
+/* creates execution streams sharing a pool in which the
+ * providers run the operations on their bdb and ldb databases */
+static ABT_pool start_io_xstreams(margo_instance_id mid, int num)
+{
+    ABT_pool pool = ABT_POOL_NULL;
+    int ret = ABT_pool_create_basic(ABT_POOL_FIFO_WAIT, ABT_POOL_ACCESS_MPMC, ABT_TRUE, &pool);
+    if(ret != ABT_SUCCESS) {
+        fprintf(stderr, "Error: ABT_pool_create_basic()\n");
+        return ABT_POOL_NULL;
+    }
+    struct io_xstreams *io = (struct io_xstreams*)calloc(1, sizeof(*io));
+    io->xstreams = (ABT_xstream*)calloc(num, sizeof(ABT_xstream));
+    int i;
+    for(i=0; i < num; i++) {
+        ret = ABT_xstream_create_basic(ABT_SCHED_BASIC_WAIT, 1, &pool,
+                ABT_SCHED_CONFIG_NULL, &io->xstreams[io->num]);
+        if(ret != ABT_SUCCESS) {
+            fprintf(stderr, "Error: ABT_xstream_create_basic()\n");
+            break;
+        }
+        io->num += 1;
+    }
+    margo_push_finalize_callback(mid, join_io_xstreams, io);
+    if(io->num == 0) return ABT_POOL_NULL;
+    return pool;
+}
+
 int main(int argc, char **argv) 
 {
     struct options opts;
@@ -163,11 +289,16 @@ int main(int argc, char **argv)
         fclose(fp);
     }
 
+    ABT_pool io_pool = SDSKV_ABT_POOL_DEFAULT;
+    if(opts.num_io_xstreams > 0)
+        io_pool = start_io_xstreams(mid, opts.num_io_xstreams);
+
     /* initialize the SDSKV server */
     if(opts.mplex_mode == MODE_PROVIDERS) {
         int i;
         for(i=0; i< opts.num_db; i++) {
             sdskv::provider* provider = sdskv::provider::create(mid, i+1, SDSKV_ABT_POOL_DEFAULT);
+            provider->set_io_pool(io_pool);
 
             sdskv_database_id_t db_id;
             sdskv_config_t db_config = { 
@@ -175,9 +306,16 @@ int main(int argc, char **argv)
                 .db_path = "",
                 .db_type = opts.db_types[i],
                 .db_comp_fn_name = SDSKV_COMPARE_DEFAULT,
-                .db_no_overwrite = 0
+                .db_no_overwrite = 0,
+                .db_options = opts.db_options[i]
             };
             db_id = provider->attach_database(db_config);
+            if(opts.group_commit_delay >= 0)
+                provider->set_group_commit(db_id, true, opts.group_commit_delay);
+            if(opts.read_coalescing)
+                provider->set_read_coalescing(db_id, true);
+
+            monitor_db_stats(mid, opts, provider, db_id, opts.db_names[i]);
 
             printf("Provider %d managing database \"%s\" at multiplex id %d\n", i, opts.db_names[i], i+1);
         }
@@ -186,6 +324,7 @@ int main(int argc, char **argv)
 
         int i;
         sdskv::provider* provider = sdskv::provider::create(mid, 1, SDSKV_ABT_POOL_DEFAULT);
+        provider->set_io_pool(io_pool);
 
         for(i=0; i < opts.num_db; i++) {
             sdskv_database_id_t db_id;
@@ -194,9 +333,16 @@ int main(int argc, char **argv)
                 .db_path = "",
                 .db_type = opts.db_types[i],
                 .db_comp_fn_name = SDSKV_COMPARE_DEFAULT,
-                .db_no_overwrite = 0
+                .db_no_overwrite = 0,
+                .db_options = opts.db_options[i]
             };
             db_id = provider->attach_database(db_config);
+            if(opts.group_commit_delay >= 0)
+                provider->set_group_commit(db_id, true, opts.group_commit_delay);
+            if(opts.read_coalescing)
+                provider->set_read_coalescing(db_id, true);
+
+            monitor_db_stats(mid, opts, provider, db_id, opts.db_names[i]);
 
             printf("Provider 0 managing database \"%s\" at multiplex id %d\n", opts.db_names[i] , 1);
         }
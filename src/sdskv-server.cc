@@ -7,6 +7,10 @@
 #include <map>
 #include <iostream>
 #include <unordered_map>
+#include <memory>
+#include <algorithm>
+#include <iterator>
+#include <exception>
 #ifdef USE_REMI
 #include <remi/remi-client.h>
 #include <remi/remi-server.h>
@@ -22,15 +26,98 @@
 #include "datastore/datastore_factory.h"
 #include "sdskv-rpc-types.h"
 #include "sdskv-server.h"
+#include "bulk_pool.h"
+#include "database_table.h"
+
+/* lease of a cursor when the client does not specify one */
+#define SDSKV_DEFAULT_CURSOR_LEASE_MS 60000
+
+/* number of entries read from a database at a time when filling
+ * the buffer of a list_packed request */
+#define SDSKV_LIST_PACKED_BATCH_SIZE 128
+
+/* time after which a buffer exposed by get_alloc is freed
+ * if the client has not released it */
+#define SDSKV_EXPOSED_BUFFER_LEASE_MS 30000
+
+/* largest response payload accepted inline if Mercury
+ * does not report an eager size (same as the client's) */
+#define SDSKV_DEFAULT_EAGER_SIZE 4000
+
+/* A buffer exposed through a bulk handle in the response to a get_alloc
+ * or get_packed_alloc request, when the result was too large to be sent
+ * inline. The client pulls it, then sends a release_bulk message. */
+struct sdskv_exposed_buffer
+{
+    std::vector<char> data;
+    hg_bulk_t         bulk = HG_BULK_NULL;
+    double            expiration;
+
+    ~sdskv_exposed_buffer() {
+        if(bulk != HG_BULK_NULL)
+            margo_bulk_free(bulk);
+    }
+};
+
+/* A cursor opened by a client with sdskv_cursor_open. The session keeps
+ * the engine's cursor alive between sdskv_cursor_next calls, and after
+ * each call a ULT prefetches the next batch from the engine while the
+ * current one is being sent. A session that is not used for longer than
+ * its lease is destroyed. */
+struct sdskv_cursor_session
+{
+    sdskv_database_id_t db_id;
+    DatabaseTable::reference db; // keeps the database alive while the session exists
+    std::unique_ptr<AbstractDataStore::Cursor> cursor;
+    double     lease;          // in seconds
+    double     last_access;
+    ABT_mutex  mutex;          // serializes the next operations on the session
+    std::vector<std::pair<ds_bulk_t,ds_bulk_t>> pending; // fetched, not yet sent
+    bool       at_end       = false;
+    hg_size_t  prefetch_size = 0;
+    int        prefetch_ret = SDSKV_SUCCESS;
+    ABT_thread prefetch_ult = ABT_THREAD_NULL;
+
+    sdskv_cursor_session() {
+        ABT_mutex_create(&mutex);
+    }
+
+    ~sdskv_cursor_session() {
+        wait_prefetch();
+        ABT_mutex_free(&mutex);
+    }
+
+    /* appends up to n entries from the engine's cursor to pending */
+    void fill(hg_size_t n) {
+        if(at_end || n == 0) return;
+        if(cursor->next(n, pending) < n) at_end = true;
+    }
+
+    void wait_prefetch() {
+        if(prefetch_ult != ABT_THREAD_NULL)
+            ABT_thread_free(&prefetch_ult);
+    }
+};
 
 struct sdskv_server_context_t
 {
     margo_instance_id mid;
 
-    std::unordered_map<sdskv_database_id_t, AbstractDataStore*> databases;
+    DatabaseTable databases; // looked up without locking by the RPC handlers
     std::map<std::string, sdskv_database_id_t> name2id;
     std::map<sdskv_database_id_t, std::string> id2name;
     std::map<std::string, sdskv_compare_fn> compfunctions;
+    DataStoreResources shared_resources; // engine resources shared by the databases
+    std::unique_ptr<BulkBufferPool> bulk_pool; // registered buffers for the bulk handlers
+
+    ABT_pool pool; // pool in which the RPCs and the cursor prefetch ULTs run
+    std::map<uint64_t, std::shared_ptr<sdskv_cursor_session>> cursors;
+    uint64_t  next_cursor_id;
+    ABT_mutex cursors_mutex;
+
+    std::map<uint64_t, std::unique_ptr<sdskv_exposed_buffer>> exposed_buffers;
+    uint64_t  next_exposed_id;
+    ABT_mutex exposed_mutex;
 
 #ifdef USE_SYMBIOMON
     symbiomon_provider_t metric_provider;
@@ -57,9 +144,7 @@ struct sdskv_server_context_t
     void* migration_uargs;
 #endif
 
-    ABT_rwlock lock; // write-locked during migration, read-locked by all other
-    // operations. There should be something better to avoid locking everything
-    // but we are going with that for simplicity for now.
+    ABT_rwlock lock; // protects name2id and id2name
 
     hg_id_t sdskv_open_id;
     hg_id_t sdskv_count_databases_id;
@@ -71,6 +156,9 @@ struct sdskv_server_context_t
     hg_id_t sdskv_get_id;
     hg_id_t sdskv_get_multi_id;
     hg_id_t sdskv_get_packed_id;
+    hg_id_t sdskv_get_alloc_id;
+    hg_id_t sdskv_get_packed_alloc_id;
+    hg_id_t sdskv_release_bulk_id;
     hg_id_t sdskv_exists_id;
     hg_id_t sdskv_exists_multi_id;
     hg_id_t sdskv_erase_id;
@@ -81,6 +169,12 @@ struct sdskv_server_context_t
     hg_id_t sdskv_bulk_get_id;
     hg_id_t sdskv_list_keys_id;
     hg_id_t sdskv_list_keyvals_id;
+    hg_id_t sdskv_list_keys_range_id;
+    hg_id_t sdskv_list_keyvals_range_id;
+    hg_id_t sdskv_list_packed_id;
+    hg_id_t sdskv_open_cursor_id;
+    hg_id_t sdskv_cursor_next_id;
+    hg_id_t sdskv_close_cursor_id;
     /* migration */
     hg_id_t sdskv_migrate_keys_id;
     hg_id_t sdskv_migrate_key_range_id;
@@ -101,6 +195,122 @@ inline scoped_call<F> at_exit(F&& f) {
     return scoped_call<F>(std::forward<F>(f));
 }
 
+/* Bulk transfers issued with margo_bulk_itransfer so that they proceed
+ * concurrently. Transfers are waited for in the order they were started.
+ * The destructor waits for those still in flight, so the buffers they
+ * use must outlive this object. */
+class sdskv_bulk_transfers {
+
+    margo_instance_id          _mid;
+    std::vector<margo_request> _reqs;
+    size_t                     _completed = 0;
+    hg_return_t                _ret = HG_SUCCESS;
+
+    public:
+
+    sdskv_bulk_transfers(margo_instance_id mid)
+    : _mid(mid) {}
+
+    sdskv_bulk_transfers(const sdskv_bulk_transfers&) = delete;
+    sdskv_bulk_transfers& operator=(const sdskv_bulk_transfers&) = delete;
+
+    ~sdskv_bulk_transfers() {
+        wait();
+    }
+
+    /* starts a transfer; transfers of 0 bytes are skipped */
+    hg_return_t start(hg_bulk_op_t op, hg_addr_t origin_addr,
+            hg_bulk_t origin_handle, size_t origin_offset,
+            hg_bulk_t local_handle, size_t local_offset, size_t size) {
+        if(size == 0) return HG_SUCCESS;
+        margo_request req = MARGO_REQUEST_NULL;
+        hg_return_t hret = margo_bulk_itransfer(_mid, op, origin_addr,
+                origin_handle, origin_offset, local_handle, local_offset, size, &req);
+        if(hret != HG_SUCCESS) {
+            if(_ret == HG_SUCCESS) _ret = hret;
+            return hret;
+        }
+        _reqs.push_back(req);
+        return HG_SUCCESS;
+    }
+
+    /* waits for all the transfers started, returns the first error */
+    hg_return_t wait() {
+        for(; _completed < _reqs.size(); _completed++) {
+            hg_return_t hret = margo_wait(_reqs[_completed]);
+            if(hret != HG_SUCCESS && _ret == HG_SUCCESS) _ret = hret;
+        }
+        return _ret;
+    }
+};
+
+/* Runs f in the given pool and waits for it to complete, so that the
+ * calling ULT yields its execution stream in the meantime. f runs directly
+ * if pool is ABT_POOL_NULL or is the pool of the calling ULT. Exceptions
+ * thrown by f are rethrown in the calling ULT. */
+template<typename F>
+static void sdskv_run_in_pool(ABT_pool pool, F&& f)
+{
+    if(pool != ABT_POOL_NULL) {
+        ABT_thread self = ABT_THREAD_NULL;
+        ABT_pool current = ABT_POOL_NULL;
+        if(ABT_thread_self(&self) == ABT_SUCCESS)
+            ABT_thread_get_last_pool(self, &current);
+        if(current != pool) {
+            struct call_args {
+                F&                 f;
+                std::exception_ptr error;
+            } args{f, nullptr};
+            auto call = [](void* a) {
+                call_args* args = static_cast<call_args*>(a);
+                try {
+                    args->f();
+                } catch(...) {
+                    args->error = std::current_exception();
+                }
+            };
+            ABT_thread ult = ABT_THREAD_NULL;
+            if(ABT_thread_create(pool, call, &args, ABT_THREAD_ATTR_NULL, &ult) == ABT_SUCCESS) {
+                ABT_thread_free(&ult);
+                if(args.error) std::rethrow_exception(args.error);
+                return;
+            }
+        }
+    }
+    f();
+}
+
+/* Copies the count sizes at the beginning of a keys or values buffer.
+ * The buffer may point into the RPC input, where the sizes are not
+ * necessarily aligned to be read in place as an array of hg_size_t. */
+static std::vector<hg_size_t> sdskv_read_sizes(const char* data, size_t count)
+{
+    std::vector<hg_size_t> sizes(count);
+    if(count) memcpy(sizes.data(), data, count*sizeof(hg_size_t));
+    return sizes;
+}
+
+/* Checks that segments of the given sizes, packed back to back after
+ * the list of their sizes, fit in a buffer of buf_size bytes. The caller
+ * has checked that the list of sizes itself fits in the buffer. */
+static bool sdskv_segments_fit(const std::vector<hg_size_t>& sizes, hg_size_t buf_size)
+{
+    hg_size_t offset = sizes.size()*sizeof(hg_size_t);
+    for(hg_size_t size : sizes) {
+        if(size > buf_size - offset) return false;
+        offset += size;
+    }
+    return true;
+}
+
+/* Returns the largest payload a response of the provider's
+ * Margo instance carries inline, i.e. its output eager size. */
+static hg_size_t sdskv_max_inline_size(margo_instance_id mid)
+{
+    hg_size_t size = HG_Class_get_output_eager_size(margo_get_class(mid));
+    return size != 0 ? size : SDSKV_DEFAULT_EAGER_SIZE;
+}
+
 DECLARE_MARGO_RPC_HANDLER(sdskv_open_ult)
 DECLARE_MARGO_RPC_HANDLER(sdskv_count_db_ult)
 DECLARE_MARGO_RPC_HANDLER(sdskv_list_db_ult)
@@ -113,10 +323,19 @@ DECLARE_MARGO_RPC_HANDLER(sdskv_length_packed_ult)
 DECLARE_MARGO_RPC_HANDLER(sdskv_get_ult)
 DECLARE_MARGO_RPC_HANDLER(sdskv_get_multi_ult)
 DECLARE_MARGO_RPC_HANDLER(sdskv_get_packed_ult)
+DECLARE_MARGO_RPC_HANDLER(sdskv_get_alloc_ult)
+DECLARE_MARGO_RPC_HANDLER(sdskv_get_packed_alloc_ult)
+DECLARE_MARGO_RPC_HANDLER(sdskv_release_bulk_ult)
 DECLARE_MARGO_RPC_HANDLER(sdskv_bulk_put_ult)
 DECLARE_MARGO_RPC_HANDLER(sdskv_bulk_get_ult)
 DECLARE_MARGO_RPC_HANDLER(sdskv_list_keys_ult)
 DECLARE_MARGO_RPC_HANDLER(sdskv_list_keyvals_ult)
+DECLARE_MARGO_RPC_HANDLER(sdskv_list_keys_range_ult)
+DECLARE_MARGO_RPC_HANDLER(sdskv_list_keyvals_range_ult)
+DECLARE_MARGO_RPC_HANDLER(sdskv_list_packed_ult)
+DECLARE_MARGO_RPC_HANDLER(sdskv_open_cursor_ult)
+DECLARE_MARGO_RPC_HANDLER(sdskv_cursor_next_ult)
+DECLARE_MARGO_RPC_HANDLER(sdskv_close_cursor_ult)
 DECLARE_MARGO_RPC_HANDLER(sdskv_erase_ult)
 DECLARE_MARGO_RPC_HANDLER(sdskv_erase_multi_ult)
 DECLARE_MARGO_RPC_HANDLER(sdskv_exists_ult)
@@ -129,6 +348,8 @@ DECLARE_MARGO_RPC_HANDLER(sdskv_migrate_database_ult)
 
 static void sdskv_server_finalize_cb(void *data);
 
+static void sdskv_close_database_cursors(sdskv_provider_t provider, sdskv_database_id_t db_id);
+
 #ifdef USE_REMI
 
 static int sdskv_pre_migration_callback(remi_fileset_t fileset, void* uargs);
@@ -164,6 +385,7 @@ extern "C" int sdskv_provider_register(
         return SDSKV_ERR_ALLOCATION;
 
     tmp_svr_ctx->mid = mid;
+    tmp_svr_ctx->bulk_pool.reset(new BulkBufferPool(mid));
 
 #ifdef USE_REMI
     tmp_svr_ctx->owns_remi_provider = 0;
@@ -181,6 +403,14 @@ extern "C" int sdskv_provider_register(
         return SDSKV_MAKE_ABT_ERROR(ret);
     }
 
+    tmp_svr_ctx->next_cursor_id = 1;
+    ABT_mutex_create(&(tmp_svr_ctx->cursors_mutex));
+    tmp_svr_ctx->next_exposed_id = 1;
+    ABT_mutex_create(&(tmp_svr_ctx->exposed_mutex));
+    if(abt_pool == ABT_POOL_NULL)
+        margo_get_handler_pool(mid, &abt_pool);
+    tmp_svr_ctx->pool = abt_pool;
+
     /* register RPCs */
     hg_id_t rpc_id;
     rpc_id = MARGO_REGISTER_PROVIDER(mid, "sdskv_open_rpc",
@@ -243,6 +473,25 @@ extern "C" int sdskv_provider_register(
     tmp_svr_ctx->sdskv_get_packed_id = rpc_id;
     margo_register_data(mid, rpc_id, (void*)tmp_svr_ctx, NULL);
 
+    rpc_id = MARGO_REGISTER_PROVIDER(mid, "sdskv_get_alloc_rpc",
+            get_alloc_in_t, get_alloc_out_t,
+            sdskv_get_alloc_ult, provider_id, abt_pool);
+    tmp_svr_ctx->sdskv_get_alloc_id = rpc_id;
+    margo_register_data(mid, rpc_id, (void*)tmp_svr_ctx, NULL);
+
+    rpc_id = MARGO_REGISTER_PROVIDER(mid, "sdskv_get_packed_alloc_rpc",
+            get_packed_alloc_in_t, get_alloc_out_t,
+            sdskv_get_packed_alloc_ult, provider_id, abt_pool);
+    tmp_svr_ctx->sdskv_get_packed_alloc_id = rpc_id;
+    margo_register_data(mid, rpc_id, (void*)tmp_svr_ctx, NULL);
+
+    rpc_id = MARGO_REGISTER_PROVIDER(mid, "sdskv_release_bulk_rpc",
+            release_bulk_in_t, void,
+            sdskv_release_bulk_ult, provider_id, abt_pool);
+    tmp_svr_ctx->sdskv_release_bulk_id = rpc_id;
+    margo_register_data(mid, rpc_id, (void*)tmp_svr_ctx, NULL);
+    margo_registered_disable_response(mid, rpc_id, HG_TRUE);
+
     rpc_id = MARGO_REGISTER_PROVIDER(mid, "sdskv_length_rpc",
             length_in_t, length_out_t,
             sdskv_length_ult, provider_id, abt_pool);
@@ -291,6 +540,42 @@ extern "C" int sdskv_provider_register(
     tmp_svr_ctx->sdskv_list_keyvals_id = rpc_id;
     margo_register_data(mid, rpc_id, (void*)tmp_svr_ctx, NULL);
 
+    rpc_id = MARGO_REGISTER_PROVIDER(mid, "sdskv_list_keys_range_rpc",
+            list_keys_range_in_t, list_keys_out_t,
+            sdskv_list_keys_range_ult, provider_id, abt_pool);
+    tmp_svr_ctx->sdskv_list_keys_range_id = rpc_id;
+    margo_register_data(mid, rpc_id, (void*)tmp_svr_ctx, NULL);
+
+    rpc_id = MARGO_REGISTER_PROVIDER(mid, "sdskv_list_keyvals_range_rpc",
+            list_keyvals_range_in_t, list_keyvals_out_t,
+            sdskv_list_keyvals_range_ult, provider_id, abt_pool);
+    tmp_svr_ctx->sdskv_list_keyvals_range_id = rpc_id;
+    margo_register_data(mid, rpc_id, (void*)tmp_svr_ctx, NULL);
+
+    rpc_id = MARGO_REGISTER_PROVIDER(mid, "sdskv_list_packed_rpc",
+            list_packed_in_t, list_packed_out_t,
+            sdskv_list_packed_ult, provider_id, abt_pool);
+    tmp_svr_ctx->sdskv_list_packed_id = rpc_id;
+    margo_register_data(mid, rpc_id, (void*)tmp_svr_ctx, NULL);
+
+    rpc_id = MARGO_REGISTER_PROVIDER(mid, "sdskv_open_cursor_rpc",
+            open_cursor_in_t, open_cursor_out_t,
+            sdskv_open_cursor_ult, provider_id, abt_pool);
+    tmp_svr_ctx->sdskv_open_cursor_id = rpc_id;
+    margo_register_data(mid, rpc_id, (void*)tmp_svr_ctx, NULL);
+
+    rpc_id = MARGO_REGISTER_PROVIDER(mid, "sdskv_cursor_next_rpc",
+            cursor_next_in_t, cursor_next_out_t,
+            sdskv_cursor_next_ult, provider_id, abt_pool);
+    tmp_svr_ctx->sdskv_cursor_next_id = rpc_id;
+    margo_register_data(mid, rpc_id, (void*)tmp_svr_ctx, NULL);
+
+    rpc_id = MARGO_REGISTER_PROVIDER(mid, "sdskv_close_cursor_rpc",
+            close_cursor_in_t, close_cursor_out_t,
+            sdskv_close_cursor_ult, provider_id, abt_pool);
+    tmp_svr_ctx->sdskv_close_cursor_id = rpc_id;
+    margo_register_data(mid, rpc_id, (void*)tmp_svr_ctx, NULL);
+
     rpc_id = MARGO_REGISTER_PROVIDER(mid, "sdskv_erase_rpc",
             erase_in_t, erase_out_t,
             sdskv_erase_ult, provider_id, abt_pool);
@@ -445,13 +730,14 @@ extern "C" int sdskv_provider_attach_database(
         comp_fn = it->second;
     }
 
+    std::string options(config->db_options ? config->db_options : "");
     auto db = datastore_factory::open_datastore(config->db_type, 
-            std::string(config->db_name), std::string(config->db_path));
+            std::string(config->db_name), std::string(config->db_path),
+            options, &provider->shared_resources);
     if(db == nullptr) return SDSKV_ERR_DB_CREATE;
     if(comp_fn) {
         db->set_comparison_function(config->db_comp_fn_name, comp_fn);
     }
-    sdskv_database_id_t id = (sdskv_database_id_t)(db);
     if(config->db_no_overwrite) {
         db->set_no_overwrite();
     }
@@ -459,45 +745,112 @@ extern "C" int sdskv_provider_attach_database(
     ABT_rwlock_wrlock(provider->lock);
     auto r = at_exit([provider]() { ABT_rwlock_unlock(provider->lock); });
 
+    /* LevelDB and BerkeleyDB calls may block on the disk */
+    bool blocking = config->db_type == KVDB_LEVELDB
+                 || config->db_type == KVDB_BERKELEYDB;
+    sdskv_database_id_t id = provider->databases.insert(db, blocking);
+    if(id == SDSKV_DATABASE_ID_INVALID) {
+        delete db;
+        return SDSKV_ERR_DB_CREATE;
+    }
     provider->name2id[std::string(config->db_name)] = id;
     provider->id2name[id] = std::string(config->db_name);
-    provider->databases[id] = db;
 
     *db_id = id;
 
     return SDSKV_SUCCESS;
 }
 
+extern "C" int sdskv_provider_set_database_pool(
+        sdskv_provider_t provider,
+        sdskv_database_id_t db_id,
+        sdskv_op_class_t op_class,
+        ABT_pool pool)
+{
+    if(op_class < SDSKV_OP_CLASS_READ || op_class > SDSKV_OP_CLASS_ALL)
+        return SDSKV_ERR_INVALID_ARG;
+    if(!provider->databases.set_pool(db_id, op_class, pool))
+        return SDSKV_ERR_UNKNOWN_DB;
+    return SDSKV_SUCCESS;
+}
+
+extern "C" int sdskv_provider_set_group_commit(
+        sdskv_provider_t provider,
+        sdskv_database_id_t db_id,
+        int enable,
+        unsigned max_delay_us)
+{
+    if(!provider->databases.set_group_commit(db_id, enable != 0, max_delay_us*1e-6))
+        return SDSKV_ERR_UNKNOWN_DB;
+    return SDSKV_SUCCESS;
+}
+
+extern "C" int sdskv_provider_get_group_commit_stats(
+        sdskv_provider_t provider,
+        sdskv_database_id_t db_id,
+        sdskv_group_commit_stats_t* stats)
+{
+    if(!provider->databases.group_commit_stats(db_id, stats))
+        return SDSKV_ERR_UNKNOWN_DB;
+    return SDSKV_SUCCESS;
+}
+
+extern "C" int sdskv_provider_set_read_coalescing(
+        sdskv_provider_t provider,
+        sdskv_database_id_t db_id,
+        int enable)
+{
+    if(!provider->databases.set_read_coalescing(db_id, enable != 0))
+        return SDSKV_ERR_UNKNOWN_DB;
+    return SDSKV_SUCCESS;
+}
+
+extern "C" int sdskv_provider_get_read_coalescing_stats(
+        sdskv_provider_t provider,
+        sdskv_database_id_t db_id,
+        sdskv_read_coalescing_stats_t* stats)
+{
+    if(!provider->databases.read_coalescing_stats(db_id, stats))
+        return SDSKV_ERR_UNKNOWN_DB;
+    return SDSKV_SUCCESS;
+}
+
+extern "C" int sdskv_provider_set_io_pool(
+        sdskv_provider_t provider,
+        ABT_pool pool)
+{
+    provider->databases.set_io_pool(pool);
+    return SDSKV_SUCCESS;
+}
+
 extern "C" int sdskv_provider_remove_database(
         sdskv_provider_t provider,
         sdskv_database_id_t db_id)
 {
     ABT_rwlock_wrlock(provider->lock);
-    auto r = at_exit([provider]() { ABT_rwlock_unlock(provider->lock); });
-    if(provider->databases.count(db_id)) {
-        auto dbname = provider->id2name[db_id];
-        provider->id2name.erase(db_id);
-        provider->name2id.erase(dbname);
-        auto db = provider->databases[db_id];
-        delete db;
-        provider->databases.erase(db_id);
-        return SDSKV_SUCCESS;
-    } else {
+    auto db = provider->databases.detach(db_id);
+    if(!db) {
+        ABT_rwlock_unlock(provider->lock);
         return SDSKV_ERR_UNKNOWN_DB;
     }
+    auto dbname = provider->id2name[db_id];
+    provider->id2name.erase(db_id);
+    provider->name2id.erase(dbname);
+    ABT_rwlock_unlock(provider->lock);
+
+    sdskv_close_database_cursors(provider, db_id);
+    /* wait for the operations in progress on the database */
+    provider->databases.release(db_id);
+    delete db;
+    return SDSKV_SUCCESS;
 }
 
 extern "C" int sdskv_provider_remove_all_databases(
         sdskv_provider_t provider)
 {
-    ABT_rwlock_wrlock(provider->lock);
-    auto r = at_exit([provider]() { ABT_rwlock_unlock(provider->lock); });
-    for(auto db : provider->databases) {
-        delete db.second;
+    for(auto id : provider->databases.ids()) {
+        sdskv_provider_remove_database(provider, id);
     }
-    provider->databases.clear();
-    provider->name2id.clear();
-    provider->id2name.clear();
 
     return SDSKV_SUCCESS;
 }
@@ -506,8 +859,6 @@ extern "C" int sdskv_provider_count_databases(
         sdskv_provider_t provider,
         uint64_t* num_db)
 {
-    ABT_rwlock_rdlock(provider->lock);
-    auto r = at_exit([provider]() { ABT_rwlock_unlock(provider->lock); });
     *num_db = provider->databases.size();
     return SDSKV_SUCCESS;
 }
@@ -526,6 +877,20 @@ extern "C" int sdskv_provider_list_databases(
     return SDSKV_SUCCESS;
 }
 
+extern "C" int sdskv_provider_get_database_memory_usage(
+        sdskv_provider_t provider,
+        sdskv_database_id_t database_id,
+        sdskv_memory_usage_t* usage)
+{
+    // find the database
+    auto database = provider->databases.find(database_id);
+    if(!database) {
+        return SDSKV_ERR_UNKNOWN_DB;
+    }
+
+    return database->get_memory_usage(usage);
+}
+
 extern "C" int sdskv_provider_compute_database_size(
         sdskv_provider_t provider,
         sdskv_database_id_t database_id,
@@ -534,14 +899,10 @@ extern "C" int sdskv_provider_compute_database_size(
 #ifdef USE_REMI
     int ret;
     // find the database
-    ABT_rwlock_rdlock(provider->lock);
-    auto it = provider->databases.find(database_id);
-    if(it == provider->databases.end()) {
-        ABT_rwlock_unlock(provider->lock);
+    auto database = provider->databases.find(database_id);
+    if(!database) {
         return SDSKV_ERR_UNKNOWN_DB;
     }
-    auto database = it->second;
-    ABT_rwlock_unlock(provider->lock);
 
     database->sync();
 
@@ -748,10 +1109,8 @@ static void sdskv_put_ult(hg_handle_t handle)
         return;
     }
 
-    ABT_rwlock_rdlock(svr_ctx->lock);
-    auto it = svr_ctx->databases.find(in.db_id);
-    if(it == svr_ctx->databases.end()) {
-        ABT_rwlock_unlock(svr_ctx->lock);
+    auto db = svr_ctx->databases.find(in.db_id);
+    if(!db) {
         fprintf(stderr, "Error (sdskv_put_ult): could not find target database\n");
         out.ret = SDSKV_ERR_UNKNOWN_DB;
         margo_respond(handle, &out);
@@ -759,11 +1118,6 @@ static void sdskv_put_ult(hg_handle_t handle)
         margo_destroy(handle);
         return;
     }
-    auto db = it->second;
-    ABT_rwlock_unlock(svr_ctx->lock);
-
-    ds_bulk_t kdata(in.key.data, in.key.data+in.key.size);
-    ds_bulk_t vdata(in.value.data, in.value.data+in.value.size);
 
     double start = ABT_get_wtime();
 
@@ -771,7 +1125,14 @@ static void sdskv_put_ult(hg_handle_t handle)
     symbiomon_metric_update_gauge_by_fixed_amount(svr_ctx->put_num_entrants, 1);
 #endif
 
-    out.ret = db->put(kdata, vdata);
+    sdskv_run_in_pool(db.pool(SDSKV_OP_CLASS_WRITE), [&]() {
+        WriteCombiner* combiner = db.combiner();
+        if(combiner)
+            out.ret = combiner->put(db.get(), in.key.data, in.key.size, in.value.data, in.value.size);
+        else
+            out.ret = db->put(in.key.data, in.key.size, in.value.data, in.value.size);
+    });
+    db.written();
 
     double end = ABT_get_wtime();
 
@@ -792,8 +1153,8 @@ static void sdskv_put_multi_ult(hg_handle_t handle)
     put_multi_in_t in;
     put_multi_out_t out;
     out.ret = SDSKV_SUCCESS;
-    std::vector<char> local_keys_buffer;
-    std::vector<char> local_vals_buffer;
+    BulkBufferPool::buffer local_keys_buffer;
+    BulkBufferPool::buffer local_vals_buffer;
     hg_bulk_t local_keys_bulk_handle;
     hg_bulk_t local_vals_bulk_handle;
 
@@ -817,70 +1178,79 @@ static void sdskv_put_multi_ult(hg_handle_t handle)
     }
     auto r3 = at_exit([&handle,&in]() { margo_free_input(handle, &in); });
 
-    ABT_rwlock_rdlock(svr_ctx->lock);
-    auto it = svr_ctx->databases.find(in.db_id);
-    if(it == svr_ctx->databases.end()) {
-        ABT_rwlock_unlock(svr_ctx->lock); 
+    auto db = svr_ctx->databases.find(in.db_id);
+    if(!db) {
         out.ret = SDSKV_ERR_UNKNOWN_DB;
         return;
     }
-    auto db = it->second;
-    ABT_rwlock_unlock(svr_ctx->lock);
 
-    // allocate a buffer to receive the keys and a buffer to receive the values
-    local_keys_buffer.resize(in.keys_bulk_size);
-    local_vals_buffer.resize(in.vals_bulk_size);
-    std::vector<void*> keys_addr(1); keys_addr[0] = (void*)local_keys_buffer.data();
-    std::vector<void*> vals_addr(1); vals_addr[0] = (void*)local_vals_buffer.data();
-    
-    /* create bulk handle to receive keys */
-    hret = margo_bulk_create(mid, 1, keys_addr.data(), &in.keys_bulk_size,
-            HG_BULK_WRITE_ONLY, &local_keys_bulk_handle);
-    if(hret != HG_SUCCESS) {
-        out.ret = SDSKV_MAKE_HG_ERROR(hret);
+    /* keys and values sent inline must have the announced sizes */
+    if(in.keys_bulk_handle == HG_BULK_NULL
+    && (in.keys.size != in.keys_bulk_size || in.vals.size != in.vals_bulk_size)) {
+        out.ret = SDSKV_ERR_INVALID_ARG;
         return;
     }
-    auto r6 = at_exit([&local_keys_bulk_handle]() { margo_bulk_free(local_keys_bulk_handle); });
-
-    /* create bulk handle to receive values */
-    hret = margo_bulk_create(mid, 1, vals_addr.data(), &in.vals_bulk_size,
-            HG_BULK_WRITE_ONLY, &local_vals_bulk_handle);
-    if(hret != HG_SUCCESS) {
-        out.ret = SDSKV_MAKE_HG_ERROR(hret);
+    /* both buffers must be large enough to start with num_keys sizes */
+    if(in.num_keys > in.keys_bulk_size/sizeof(hg_size_t)
+    || in.num_keys > in.vals_bulk_size/sizeof(hg_size_t)) {
+        out.ret = SDSKV_ERR_INVALID_ARG;
         return;
     }
-    auto r7 = at_exit([&local_vals_bulk_handle]() { margo_bulk_free(local_vals_bulk_handle); });
 
-    /* transfer keys */
-    hret = margo_bulk_transfer(mid, HG_BULK_PULL, info->addr, in.keys_bulk_handle, 0,
-            local_keys_bulk_handle, 0, in.keys_bulk_size);
-    if(hret != HG_SUCCESS) {
-        out.ret = SDSKV_MAKE_HG_ERROR(hret);
-        return;
-    }
+    char* keys_data = in.keys.data;
+    char* vals_data = in.vals.data;
+    if(in.keys_bulk_handle != HG_BULK_NULL) {
+        // get a registered buffer to receive the keys and one to receive the values
+        hret = svr_ctx->bulk_pool->get(in.keys_bulk_size, local_keys_buffer);
+        if(hret != HG_SUCCESS) {
+            out.ret = SDSKV_MAKE_HG_ERROR(hret);
+            return;
+        }
+        local_keys_bulk_handle = local_keys_buffer.bulk();
 
-    /* transfer values */
-    hret = margo_bulk_transfer(mid, HG_BULK_PULL, info->addr, in.vals_bulk_handle, 0,
-            local_vals_bulk_handle, 0, in.vals_bulk_size);
-    if(hret != HG_SUCCESS) {
-        out.ret = SDSKV_MAKE_HG_ERROR(hret);
-        return;
+        hret = svr_ctx->bulk_pool->get(in.vals_bulk_size, local_vals_buffer);
+        if(hret != HG_SUCCESS) {
+            out.ret = SDSKV_MAKE_HG_ERROR(hret);
+            return;
+        }
+        local_vals_bulk_handle = local_vals_buffer.bulk();
+
+        /* transfer keys and values concurrently */
+        sdskv_bulk_transfers pull(mid);
+        hret = pull.start(HG_BULK_PULL, info->addr, in.keys_bulk_handle, 0,
+                local_keys_bulk_handle, 0, in.keys_bulk_size);
+        if(hret == HG_SUCCESS)
+            hret = pull.start(HG_BULK_PULL, info->addr, in.vals_bulk_handle, 0,
+                    local_vals_bulk_handle, 0, in.vals_bulk_size);
+        if(hret == HG_SUCCESS)
+            hret = pull.wait();
+        if(hret != HG_SUCCESS) {
+            out.ret = SDSKV_MAKE_HG_ERROR(hret);
+            return;
+        }
+        keys_data = local_keys_buffer.data();
+        vals_data = local_vals_buffer.data();
     }
 
-    /* interpret beginning of the key buffer as a list of key sizes */
-    hg_size_t* key_sizes = (hg_size_t*)local_keys_buffer.data();
-    /* interpret beginning of the value buffer as a list of value sizes */
-    hg_size_t* val_sizes = (hg_size_t*)local_vals_buffer.data();
+    /* read the list of key sizes at the beginning of the key buffer */
+    std::vector<hg_size_t> key_sizes = sdskv_read_sizes(keys_data, in.num_keys);
+    /* read the list of value sizes at the beginning of the value buffer */
+    std::vector<hg_size_t> val_sizes = sdskv_read_sizes(vals_data, in.num_keys);
 
-    size_t tot_key_size, tot_val_size = 0;
-    /* go through the key/value pairs and insert them */
+    size_t tot_key_size = 0, tot_val_size = 0;
+    /* find where each key and value starts in the buffers */
     uint64_t keys_offset = sizeof(hg_size_t)*in.num_keys;
     uint64_t vals_offset = sizeof(hg_size_t)*in.num_keys;
     std::vector<const void*> kptrs(in.num_keys);
     std::vector<const void*> vptrs(in.num_keys);
     for(unsigned i=0; i < in.num_keys; i++) {
-        kptrs[i] = local_keys_buffer.data()+keys_offset;
-        vptrs[i] = val_sizes[i] == 0 ? nullptr : local_vals_buffer.data()+vals_offset;
+        if(key_sizes[i] > in.keys_bulk_size - keys_offset
+        || val_sizes[i] > in.vals_bulk_size - vals_offset) {
+            out.ret = SDSKV_ERR_INVALID_ARG;
+            return;
+        }
+        kptrs[i] = keys_data+keys_offset;
+        vptrs[i] = val_sizes[i] == 0 ? nullptr : vals_data+vals_offset;
         keys_offset += key_sizes[i];
         vals_offset += val_sizes[i];
 	tot_key_size += key_sizes[i];
@@ -893,7 +1263,13 @@ static void sdskv_put_multi_ult(hg_handle_t handle)
 #ifdef USE_SYMBIOMON
     symbiomon_metric_update_gauge_by_fixed_amount(svr_ctx->putpacked_num_entrants, 1);
 #endif
-    out.ret = db->put_multi(in.num_keys, kptrs.data(), key_sizes, vptrs.data(), val_sizes);
+    /* insert all the entries with a single engine call, so that
+     * engines applying put_multi atomically do so for the whole RPC */
+    sdskv_run_in_pool(db.pool(SDSKV_OP_CLASS_WRITE), [&]() {
+        out.ret = db->put_multi(in.num_keys, kptrs.data(), key_sizes.data(),
+                vptrs.data(), val_sizes.data());
+    });
+    db.written();
     end = ABT_get_wtime();
 #ifdef USE_SYMBIOMON
     symbiomon_metric_update_gauge_by_fixed_amount(svr_ctx->putpacked_num_entrants, -1);
@@ -912,7 +1288,7 @@ static void sdskv_put_packed_ult(hg_handle_t handle)
     put_packed_in_t in;
     put_packed_out_t out;
     out.ret = SDSKV_SUCCESS;
-    std::vector<char> local_buffer;
+    BulkBufferPool::buffer local_buffer;
     hg_bulk_t local_bulk_handle;
     hg_addr_t origin_addr = HG_ADDR_NULL;
     double start, end;
@@ -936,15 +1312,11 @@ static void sdskv_put_packed_ult(hg_handle_t handle)
     }
     auto r3 = at_exit([&handle,&in]() { margo_free_input(handle, &in); });
 
-    ABT_rwlock_rdlock(svr_ctx->lock);
-    auto it = svr_ctx->databases.find(in.db_id);
-    if(it == svr_ctx->databases.end()) {
-        ABT_rwlock_unlock(svr_ctx->lock); 
+    auto db = svr_ctx->databases.find(in.db_id);
+    if(!db) {
         out.ret = SDSKV_ERR_UNKNOWN_DB;
         return;
     }
-    auto db = it->second;
-    ABT_rwlock_unlock(svr_ctx->lock);
 
     // find out the address of the origin
     if(in.origin_addr != NULL) {
@@ -958,19 +1330,13 @@ static void sdskv_put_packed_ult(hg_handle_t handle)
     }
     auto r4 = at_exit([&origin_addr,&mid]() { margo_addr_free(mid, origin_addr); });
 
-    // allocate a buffer to receive the keys and a buffer to receive the values
-    local_buffer.resize(in.bulk_size);
-    void* buf_ptr = local_buffer.data();
-    hg_size_t buf_size = in.bulk_size;
-
-    /* create bulk handle to receive keys */
-    hret = margo_bulk_create(mid, 1, &buf_ptr, &buf_size,
-            HG_BULK_WRITE_ONLY, &local_bulk_handle);
+    // get a registered buffer to receive the keys and values
+    hret = svr_ctx->bulk_pool->get(in.bulk_size, local_buffer);
     if(hret != HG_SUCCESS) {
         out.ret = SDSKV_MAKE_HG_ERROR(hret);
         return;
     }
-    auto r5 = at_exit([&local_bulk_handle]() { margo_bulk_free(local_bulk_handle); });
+    local_bulk_handle = local_buffer.bulk();
 
     /* transfer data */
     hret = margo_bulk_transfer(mid, HG_BULK_PULL, origin_addr, in.bulk_handle, 0,
@@ -999,7 +1365,10 @@ static void sdskv_put_packed_ult(hg_handle_t handle)
 #ifdef USE_SYMBIOMON
     symbiomon_metric_update_gauge_by_fixed_amount(svr_ctx->putpacked_num_entrants, 1);
 #endif
-    out.ret = db->put_packed(in.num_keys, packed_keys, key_sizes, packed_vals, val_sizes);
+    sdskv_run_in_pool(db.pool(SDSKV_OP_CLASS_WRITE), [&]() {
+        out.ret = db->put_packed(in.num_keys, packed_keys, key_sizes, packed_vals, val_sizes);
+    });
+    db.written();
     end = ABT_get_wtime();
 #ifdef USE_SYMBIOMON
     symbiomon_metric_update_gauge_by_fixed_amount(svr_ctx->putpacked_num_entrants, -1);
@@ -1042,24 +1411,22 @@ static void sdskv_length_ult(hg_handle_t handle)
         return;
     }
 
-    ABT_rwlock_rdlock(svr_ctx->lock);
-    auto it = svr_ctx->databases.find(in.db_id);
-    if(it == svr_ctx->databases.end()) {
-        ABT_rwlock_unlock(svr_ctx->lock);
+    auto db = svr_ctx->databases.find(in.db_id);
+    if(!db) {
         out.ret = SDSKV_ERR_UNKNOWN_DB;
         margo_respond(handle, &out);
         margo_free_input(handle, &in);
         margo_destroy(handle);
         return;
     }
-    auto db = it->second;
-    ABT_rwlock_unlock(svr_ctx->lock);
     
-    ds_bulk_t kdata(in.key.data, in.key.data+in.key.size);
-
-    ds_bulk_t vdata;
-    if(db->get(kdata, vdata)) {
-        out.size = vdata.size();
+    hg_size_t vsize;
+    bool found = false;
+    sdskv_run_in_pool(db.pool(SDSKV_OP_CLASS_READ), [&]() {
+        found = db->length(in.key.data, in.key.size, &vsize);
+    });
+    if(found) {
+        out.size = vsize;
         out.ret  = SDSKV_SUCCESS;
     } else {
         out.size = 0;
@@ -1105,10 +1472,8 @@ static void sdskv_get_ult(hg_handle_t handle)
         return;
     }
 
-    ABT_rwlock_rdlock(svr_ctx->lock);
-    auto it = svr_ctx->databases.find(in.db_id);
-    if(it == svr_ctx->databases.end()) {
-        ABT_rwlock_unlock(svr_ctx->lock);
+    auto db = svr_ctx->databases.find(in.db_id);
+    if(!db) {
         out.ret = SDSKV_ERR_UNKNOWN_DB;
         out.value.data = nullptr;
         out.value.size = 0;
@@ -1118,17 +1483,28 @@ static void sdskv_get_ult(hg_handle_t handle)
         margo_destroy(handle);
         return;
     }
-    auto db = it->second;
-    ABT_rwlock_unlock(svr_ctx->lock);
     
-    ds_bulk_t kdata(in.key.data, in.key.data+in.key.size);
-
-    ds_bulk_t vdata;
-    if(db->get(kdata, vdata)) {
+    /* with read coalescing, the value may be shared with concurrent
+     * gets of the same key and must be kept alive until we respond */
+    ReadCoalescer::result_ptr res;
+    sdskv_run_in_pool(db.pool(SDSKV_OP_CLASS_READ), [&]() {
+        ReadCoalescer* coalescer = db.read_coalescer();
+        if(coalescer) {
+            res = coalescer->get(in.key.data, in.key.size, [&](ReadCoalescer::result& r) {
+                r.found = db->get(in.key.data, in.key.size, r.value);
+            });
+        } else {
+            auto r = std::make_shared<ReadCoalescer::result>();
+            r->found = db->get(in.key.data, in.key.size, r->value);
+            res = std::move(r);
+        }
+    });
+    const ds_bulk_t& vdata = res->value;
+    if(res->found) {
         if(vdata.size() <= in.vsize) {
             out.vsize = vdata.size();
             out.value.size = vdata.size();
-            out.value.data = vdata.data();
+            out.value.data = const_cast<char*>(vdata.data());
             out.ret = SDSKV_SUCCESS;
         } else {
             out.vsize = vdata.size();
@@ -1158,10 +1534,13 @@ static void sdskv_get_multi_ult(hg_handle_t handle)
     get_multi_in_t in;
     get_multi_out_t out;
     out.ret = SDSKV_SUCCESS;
-    std::vector<char> local_keys_buffer;
-    std::vector<char> local_vals_buffer;
+    BulkBufferPool::buffer local_keys_buffer;
+    BulkBufferPool::buffer local_vals_buffer;
     hg_bulk_t local_keys_bulk_handle;
     hg_bulk_t local_vals_bulk_handle;
+    std::vector<char> inline_values; // [vsizes][values] sent back in the response
+    out.values.size = 0;
+    out.values.data = nullptr;
 
     auto r1 = at_exit([&handle]() { margo_destroy(handle); });
     auto r2 = at_exit([&handle,&out]() { margo_respond(handle, &out); });
@@ -1185,92 +1564,120 @@ static void sdskv_get_multi_ult(hg_handle_t handle)
     auto r3 = at_exit([&handle,&in]() { margo_free_input(handle, &in); });
 
     /* find the target database */
-    ABT_rwlock_rdlock(svr_ctx->lock);
-    auto it = svr_ctx->databases.find(in.db_id);
-    if(it == svr_ctx->databases.end()) {
-        ABT_rwlock_unlock(svr_ctx->lock);
+    auto db = svr_ctx->databases.find(in.db_id);
+    if(!db) {
         out.ret = SDSKV_ERR_UNKNOWN_DB;
         return;
     }
-    auto db = it->second;
-    ABT_rwlock_unlock(svr_ctx->lock);
 
-    /* allocate buffers to receive the keys */
-    local_keys_buffer.resize(in.keys_bulk_size);
-    std::vector<void*> keys_addr(1);
-    keys_addr[0] = (void*)local_keys_buffer.data();
-    
-    /* create bulk handle to receive key sizes and packed keys */
-    hret = margo_bulk_create(mid, 1, keys_addr.data(), &in.keys_bulk_size,
-            HG_BULK_WRITE_ONLY, &local_keys_bulk_handle);
-    if(hret != HG_SUCCESS) {
-        out.ret = SDSKV_MAKE_HG_ERROR(hret);
+    /* both buffers must be large enough to start with num_keys sizes */
+    if(in.num_keys > in.keys_bulk_size/sizeof(hg_size_t)
+    || in.num_keys > in.vals_bulk_size/sizeof(hg_size_t)) {
+        out.ret = SDSKV_ERR_INVALID_ARG;
         return;
     }
-    auto r6 = at_exit([&local_keys_bulk_handle]() { margo_bulk_free(local_keys_bulk_handle); });
-
-    /* allocate buffer to send/receive the values */
-    local_vals_buffer.resize(in.vals_bulk_size);
-    std::vector<void*> vals_addr(1);
-    vals_addr[0] = (void*)local_vals_buffer.data();
-
-    /* create bulk handle to receive max value sizes and to send values */
-    hret = margo_bulk_create(mid, 1, vals_addr.data(), &in.vals_bulk_size,
-            HG_BULK_READWRITE, &local_vals_bulk_handle);
-    if(hret != HG_SUCCESS) {
-        out.ret = SDSKV_MAKE_HG_ERROR(hret);
+    /* keys sent inline must have the announced size, only the value sizes
+     * are sent inline, and the values must fit in the response */
+    if(in.keys_bulk_handle == HG_BULK_NULL
+    && (in.keys.size != in.keys_bulk_size
+        || in.vals.size != in.num_keys*sizeof(hg_size_t)
+        || in.vals_bulk_size > sdskv_max_inline_size(mid))) {
+        out.ret = SDSKV_ERR_INVALID_ARG;
         return;
     }
-    auto r7 = at_exit([&local_vals_bulk_handle]() { margo_bulk_free(local_vals_bulk_handle); });
 
-    /* transfer keys */
-    hret = margo_bulk_transfer(mid, HG_BULK_PULL, info->addr, in.keys_bulk_handle, 0,
-            local_keys_bulk_handle, 0, in.keys_bulk_size);
-    if(hret != HG_SUCCESS) {
-        out.ret = SDSKV_MAKE_HG_ERROR(hret);
-        return;
+    char* keys_data;
+    char* vals_data;
+    if(in.keys_bulk_handle == HG_BULK_NULL) {
+        /* the keys and the sizes allocated for the values were sent
+         * inline, and the values will be sent back in the response */
+        keys_data = in.keys.data;
+        inline_values.resize(in.vals_bulk_size);
+        memcpy(inline_values.data(), in.vals.data, in.vals.size);
+        vals_data = inline_values.data();
+    } else {
+        /* get a registered buffer to receive the key sizes and packed keys */
+        hret = svr_ctx->bulk_pool->get(in.keys_bulk_size, local_keys_buffer);
+        if(hret != HG_SUCCESS) {
+            out.ret = SDSKV_MAKE_HG_ERROR(hret);
+            return;
+        }
+        local_keys_bulk_handle = local_keys_buffer.bulk();
+
+        /* get a registered buffer to send/receive the values */
+        hret = svr_ctx->bulk_pool->get(in.vals_bulk_size, local_vals_buffer);
+        if(hret != HG_SUCCESS) {
+            out.ret = SDSKV_MAKE_HG_ERROR(hret);
+            return;
+        }
+        local_vals_bulk_handle = local_vals_buffer.bulk();
+
+        /* transfer keys and sizes allocated by user for the values
+         * (beginning of value segment) concurrently */
+        sdskv_bulk_transfers pull(mid);
+        hret = pull.start(HG_BULK_PULL, info->addr, in.keys_bulk_handle, 0,
+                local_keys_bulk_handle, 0, in.keys_bulk_size);
+        if(hret == HG_SUCCESS)
+            hret = pull.start(HG_BULK_PULL, info->addr, in.vals_bulk_handle, 0,
+                    local_vals_bulk_handle, 0, in.num_keys*sizeof(hg_size_t));
+        if(hret == HG_SUCCESS)
+            hret = pull.wait();
+        if(hret != HG_SUCCESS) {
+            out.ret = SDSKV_MAKE_HG_ERROR(hret);
+            return;
+        }
+        keys_data = local_keys_buffer.data();
+        vals_data = local_vals_buffer.data();
     }
 
-    /* transfer sizes allocated by user for the values (beginning of value segment) */
-    hret = margo_bulk_transfer(mid, HG_BULK_PULL, info->addr, in.vals_bulk_handle, 0,
-            local_vals_bulk_handle, 0, in.num_keys*sizeof(hg_size_t));
-    if(hret != HG_SUCCESS) {
-        out.ret = SDSKV_MAKE_HG_ERROR(hret);
+    /* read the list of key sizes at the beginning of the key buffer */
+    std::vector<hg_size_t> key_sizes = sdskv_read_sizes(keys_data, in.num_keys);
+    /* the keys, and the values in the sizes allocated for them,
+     * must fit in their buffers */
+    if(!sdskv_segments_fit(key_sizes, in.keys_bulk_size)
+    || !sdskv_segments_fit(sdskv_read_sizes(vals_data, in.num_keys), in.vals_bulk_size)) {
+        out.ret = SDSKV_ERR_INVALID_ARG;
         return;
     }
-
-    /* interpret beginning of the key buffer as a list of key sizes */
-    hg_size_t* key_sizes = (hg_size_t*)local_keys_buffer.data();
     /* find beginning of packed keys */
-    char* packed_keys = local_keys_buffer.data() + in.num_keys*sizeof(hg_size_t);
-    /* interpret beginning of the value buffer as a list of value sizes */
-    hg_size_t* val_sizes = (hg_size_t*)local_vals_buffer.data();
+    char* packed_keys = keys_data + in.num_keys*sizeof(hg_size_t);
+    /* interpret beginning of the value buffer as a list of value sizes,
+     * updated in place (it is an allocated copy or a pool buffer, so aligned) */
+    hg_size_t* val_sizes = (hg_size_t*)vals_data;
     /* find beginning of region where to pack values */
-    char* packed_values = local_vals_buffer.data() + in.num_keys*sizeof(hg_size_t);
+    char* packed_values = vals_data + in.num_keys*sizeof(hg_size_t);
 
     /* go through the key/value pairs and get the values from the database */
-    for(unsigned i=0; i < in.num_keys; i++) {
-        ds_bulk_t kdata(packed_keys, packed_keys+key_sizes[i]);
-        ds_bulk_t vdata;
-        size_t client_allocated_value_size = val_sizes[i];
-        if(db->get(kdata, vdata)) {
-            size_t old_vsize = val_sizes[i];
-            if(vdata.size() > val_sizes[i]) {
-                val_sizes[i] = 0;
+    sdskv_run_in_pool(db.pool(SDSKV_OP_CLASS_READ), [&]() {
+        for(unsigned i=0; i < in.num_keys; i++) {
+            ds_bulk_t vdata;
+            size_t client_allocated_value_size = val_sizes[i];
+            if(db->get(packed_keys, key_sizes[i], vdata)) {
+                size_t old_vsize = val_sizes[i];
+                if(vdata.size() > val_sizes[i]) {
+                    val_sizes[i] = 0;
+                } else {
+                    val_sizes[i] = vdata.size();
+                    memcpy(packed_values, vdata.data(), val_sizes[i]);
+                }
             } else {
-                val_sizes[i] = vdata.size();
-                memcpy(packed_values, vdata.data(), val_sizes[i]);
+                val_sizes[i] = 0;
             }
-        } else {
-            val_sizes[i] = 0;
+            packed_keys += key_sizes[i];
+            packed_values += val_sizes[i];
         }
-        packed_keys += key_sizes[i];
-        packed_values += val_sizes[i];
+    });
+
+    if(in.keys_bulk_handle == HG_BULK_NULL) {
+        out.values.data = inline_values.data();
+        out.values.size = inline_values.size();
+        return;
     }
 
-    /* do a PUSH operation to push back the values to the client */
+    /* push back the sizes and the values written; the rest of the
+     * pool buffer holds data left over from other requests */
     hret = margo_bulk_transfer(mid, HG_BULK_PUSH, info->addr, in.vals_bulk_handle, 0,
-            local_vals_bulk_handle, 0, in.vals_bulk_size);
+            local_vals_bulk_handle, 0, packed_values - local_vals_buffer.data());
     if(hret != HG_SUCCESS) {
         out.ret = SDSKV_MAKE_HG_ERROR(hret);
         return;
@@ -1288,8 +1695,8 @@ static void sdskv_get_packed_ult(hg_handle_t handle)
     get_packed_out_t out;
     out.ret = SDSKV_SUCCESS;
     out.num_keys = 0;
-    std::vector<char> local_keys_buffer;
-    std::vector<char> local_vals_buffer;
+    BulkBufferPool::buffer local_keys_buffer;
+    BulkBufferPool::buffer local_vals_buffer;
     hg_bulk_t local_keys_bulk_handle;
     hg_bulk_t local_vals_bulk_handle;
 
@@ -1315,43 +1722,27 @@ static void sdskv_get_packed_ult(hg_handle_t handle)
     auto r3 = at_exit([&handle,&in]() { margo_free_input(handle, &in); });
 
     /* find the target database */
-    ABT_rwlock_rdlock(svr_ctx->lock);
-    auto it = svr_ctx->databases.find(in.db_id);
-    if(it == svr_ctx->databases.end()) {
-        ABT_rwlock_unlock(svr_ctx->lock);
+    auto db = svr_ctx->databases.find(in.db_id);
+    if(!db) {
         out.ret = SDSKV_ERR_UNKNOWN_DB;
         return;
     }
-    auto db = it->second;
-    ABT_rwlock_unlock(svr_ctx->lock);
 
-    /* allocate buffers to receive the keys */
-    local_keys_buffer.resize(in.keys_bulk_size);
-    std::vector<void*> keys_addr(1);
-    keys_addr[0] = (void*)local_keys_buffer.data();
-    
-    /* create bulk handle to receive key sizes and packed keys */
-    hret = margo_bulk_create(mid, 1, keys_addr.data(), &in.keys_bulk_size,
-            HG_BULK_WRITE_ONLY, &local_keys_bulk_handle);
+    /* get a registered buffer to receive the key sizes and packed keys */
+    hret = svr_ctx->bulk_pool->get(in.keys_bulk_size, local_keys_buffer);
     if(hret != HG_SUCCESS) {
         out.ret = SDSKV_MAKE_HG_ERROR(hret);
         return;
     }
-    auto r6 = at_exit([&local_keys_bulk_handle]() { margo_bulk_free(local_keys_bulk_handle); });
+    local_keys_bulk_handle = local_keys_buffer.bulk();
 
-    /* allocate buffer to send the values */
-    local_vals_buffer.resize(in.vals_bulk_size);
-    std::vector<void*> vals_addr(1);
-    vals_addr[0] = (void*)local_vals_buffer.data();
-
-    /* create bulk handle to receive max value sizes and to send values */
-    hret = margo_bulk_create(mid, 1, vals_addr.data(), &in.vals_bulk_size,
-            HG_BULK_READ_ONLY, &local_vals_bulk_handle);
+    /* get a registered buffer to send the values */
+    hret = svr_ctx->bulk_pool->get(in.vals_bulk_size, local_vals_buffer);
     if(hret != HG_SUCCESS) {
         out.ret = SDSKV_MAKE_HG_ERROR(hret);
         return;
     }
-    auto r7 = at_exit([&local_vals_bulk_handle]() { margo_bulk_free(local_vals_bulk_handle); });
+    local_vals_bulk_handle = local_vals_buffer.bulk();
 
     /* transfer keys and key sizes */
     hret = margo_bulk_transfer(mid, HG_BULK_PULL, info->addr, in.keys_bulk_handle, 0,
@@ -1373,34 +1764,36 @@ static void sdskv_get_packed_ult(hg_handle_t handle)
     /* go through the key/value pairs and get the values from the database */
     size_t available_client_memory = in.vals_bulk_size - in.num_keys*sizeof(hg_size_t);
     unsigned i = 0;
-    for(unsigned i=0; i < in.num_keys; i++) {
-        ds_bulk_t kdata(packed_keys, packed_keys+key_sizes[i]);
-        ds_bulk_t vdata;
-        if(available_client_memory == 0) {
-            val_sizes[i] = 0;
-            out.ret = SDSKV_ERR_SIZE;
-            continue;
-        }
-        if(db->get(kdata, vdata)) {
-            if(vdata.size() > available_client_memory) {
-                available_client_memory = 0;
-                out.ret = SDSKV_ERR_SIZE;
+    sdskv_run_in_pool(db.pool(SDSKV_OP_CLASS_READ), [&]() {
+        for(unsigned i=0; i < in.num_keys; i++) {
+            ds_bulk_t vdata;
+            if(available_client_memory == 0) {
                 val_sizes[i] = 0;
+                out.ret = SDSKV_ERR_SIZE;
+                continue;
+            }
+            if(db->get(packed_keys, key_sizes[i], vdata)) {
+                if(vdata.size() > available_client_memory) {
+                    available_client_memory = 0;
+                    out.ret = SDSKV_ERR_SIZE;
+                    val_sizes[i] = 0;
+                } else {
+                    out.num_keys += 1;
+                    val_sizes[i] = vdata.size();
+                    memcpy(packed_values, vdata.data(), val_sizes[i]);
+                    packed_values += val_sizes[i];
+                }
             } else {
-                out.num_keys += 1;
-                val_sizes[i] = vdata.size();
-                memcpy(packed_values, vdata.data(), val_sizes[i]);
-                packed_values += val_sizes[i];
+                val_sizes[i] = (hg_size_t)(-1);
             }
-        } else {
-            val_sizes[i] = (hg_size_t)(-1);
+            packed_keys += key_sizes[i];
         }
-        packed_keys += key_sizes[i];
-    }
+    });
 
-    /* do a PUSH operation to push back the values to the client */
+    /* push back the sizes and the values written; the rest of the
+     * pool buffer holds data left over from other requests */
     hret = margo_bulk_transfer(mid, HG_BULK_PUSH, info->addr, in.vals_bulk_handle, 0,
-            local_vals_bulk_handle, 0, in.vals_bulk_size);
+            local_vals_bulk_handle, 0, packed_values - local_vals_buffer.data());
     if(hret != HG_SUCCESS) {
         out.ret = SDSKV_MAKE_HG_ERROR(hret);
         return;
@@ -1410,6 +1803,223 @@ static void sdskv_get_packed_ult(hg_handle_t handle)
 }
 DEFINE_MARGO_RPC_HANDLER(sdskv_get_packed_ult)
 
+/* Fills the output of a get_alloc or get_packed_alloc request. The data
+ * is sent inline if it is not larger than eager_size, otherwise it is
+ * moved into a buffer exposed for the client to pull, which is kept until
+ * the client releases it (or until its lease expires). Throws a Mercury
+ * error if the buffer cannot be exposed. data must remain valid until
+ * the response has been sent. */
+static void sdskv_set_alloc_output(sdskv_provider_t provider, margo_instance_id mid,
+        ds_bulk_t& data, hg_size_t eager_size, get_alloc_out_t& out)
+{
+    out.vsize = data.size();
+    if(data.size() <= eager_size) {
+        out.value.data = data.data();
+        out.value.size = data.size();
+        return;
+    }
+
+    std::unique_ptr<sdskv_exposed_buffer> buffer(new sdskv_exposed_buffer);
+    buffer->data = std::move(data);
+    void* buf_ptrs[1] = { (void*)buffer->data.data() };
+    hg_size_t buf_size = buffer->data.size();
+    hg_return_t hret = margo_bulk_create(mid, 1, buf_ptrs, &buf_size,
+            HG_BULK_READ_ONLY, &buffer->bulk);
+    if(hret != HG_SUCCESS) {
+        std::cerr << "Error: SDSKV get_alloc could not create bulk handle" << std::endl;
+        throw (int)SDSKV_MAKE_HG_ERROR(hret);
+    }
+    double now = ABT_get_wtime();
+    buffer->expiration = now + SDSKV_EXPOSED_BUFFER_LEASE_MS/1000.0;
+    out.bulk_handle = buffer->bulk;
+
+    std::vector<std::unique_ptr<sdskv_exposed_buffer>> expired;
+    ABT_mutex_lock(provider->exposed_mutex);
+    for(auto it = provider->exposed_buffers.begin(); it != provider->exposed_buffers.end();) {
+        if(it->second->expiration < now) {
+            expired.push_back(std::move(it->second));
+            it = provider->exposed_buffers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    out.bulk_id = provider->next_exposed_id++;
+    provider->exposed_buffers[out.bulk_id] = std::move(buffer);
+    ABT_mutex_unlock(provider->exposed_mutex);
+}
+
+static void sdskv_get_alloc_ult(hg_handle_t handle)
+{
+    hg_return_t hret;
+    get_alloc_in_t in;
+    get_alloc_out_t out;
+    out.ret = SDSKV_SUCCESS;
+    out.vsize = 0;
+    out.value.size = 0;
+    out.value.data = nullptr;
+    out.bulk_id = 0;
+    out.bulk_handle = HG_BULK_NULL;
+    ds_bulk_t vdata; // may be referenced by out until the response is sent
+
+    auto r0 = at_exit([&handle]() { margo_destroy(handle); });
+    auto r1 = at_exit([&handle,&out]() { margo_respond(handle, &out); });
+
+    margo_instance_id mid = margo_hg_handle_get_instance(handle);
+    assert(mid);
+    const struct hg_info* info = margo_get_info(handle);
+    sdskv_provider_t svr_ctx = 
+        (sdskv_provider_t)margo_registered_data(mid, info->id);
+    if(!svr_ctx) {
+        std::cerr << "Error (sdskv_get_alloc_ult): SDSKV get_alloc could not find provider" << std::endl;
+        out.ret = SDSKV_ERR_UNKNOWN_PR;
+        return;
+    }
+
+    hret = margo_get_input(handle, &in);
+    if(hret != HG_SUCCESS) {
+        out.ret = SDSKV_MAKE_HG_ERROR(hret);
+        return;
+    }
+    auto r2 = at_exit([&handle,&in]() { margo_free_input(handle, &in); });
+
+    auto db = svr_ctx->databases.find(in.db_id);
+    if(!db) {
+        out.ret = SDSKV_ERR_UNKNOWN_DB;
+        return;
+    }
+
+    bool found = false;
+    sdskv_run_in_pool(db.pool(SDSKV_OP_CLASS_READ), [&]() {
+        found = db->get(in.key.data, in.key.size, vdata);
+    });
+    if(!found) {
+        out.ret = SDSKV_ERR_UNKNOWN_KEY;
+        return;
+    }
+
+    try {
+        sdskv_set_alloc_output(svr_ctx, mid, vdata, in.eager_size, out);
+    } catch(int exc_no) {
+        out.ret = exc_no;
+    }
+}
+DEFINE_MARGO_RPC_HANDLER(sdskv_get_alloc_ult)
+
+static void sdskv_get_packed_alloc_ult(hg_handle_t handle)
+{
+    hg_return_t hret;
+    get_packed_alloc_in_t in;
+    get_alloc_out_t out;
+    out.ret = SDSKV_SUCCESS;
+    out.vsize = 0;
+    out.value.size = 0;
+    out.value.data = nullptr;
+    out.bulk_id = 0;
+    out.bulk_handle = HG_BULK_NULL;
+    ds_bulk_t result; // may be referenced by out until the response is sent
+
+    auto r0 = at_exit([&handle]() { margo_destroy(handle); });
+    auto r1 = at_exit([&handle,&out]() { margo_respond(handle, &out); });
+
+    margo_instance_id mid = margo_hg_handle_get_instance(handle);
+    assert(mid);
+    const struct hg_info* info = margo_get_info(handle);
+    sdskv_provider_t svr_ctx = 
+        (sdskv_provider_t)margo_registered_data(mid, info->id);
+    if(!svr_ctx) {
+        std::cerr << "Error (sdskv_get_packed_alloc_ult): SDSKV get_packed_alloc could not find provider" << std::endl;
+        out.ret = SDSKV_ERR_UNKNOWN_PR;
+        return;
+    }
+
+    hret = margo_get_input(handle, &in);
+    if(hret != HG_SUCCESS) {
+        out.ret = SDSKV_MAKE_HG_ERROR(hret);
+        return;
+    }
+    auto r2 = at_exit([&handle,&in]() { margo_free_input(handle, &in); });
+
+    auto db = svr_ctx->databases.find(in.db_id);
+    if(!db) {
+        out.ret = SDSKV_ERR_UNKNOWN_DB;
+        return;
+    }
+
+    /* pull the key sizes and packed keys */
+    BulkBufferPool::buffer local_keys_buffer;
+    hret = svr_ctx->bulk_pool->get(in.keys_bulk_size, local_keys_buffer);
+    if(hret != HG_SUCCESS) {
+        out.ret = SDSKV_MAKE_HG_ERROR(hret);
+        return;
+    }
+    hg_bulk_t local_keys_bulk_handle = local_keys_buffer.bulk();
+
+    hret = margo_bulk_transfer(mid, HG_BULK_PULL, info->addr, in.keys_bulk_handle, 0,
+            local_keys_bulk_handle, 0, in.keys_bulk_size);
+    if(hret != HG_SUCCESS) {
+        out.ret = SDSKV_MAKE_HG_ERROR(hret);
+        return;
+    }
+
+    /* build [vsizes][values], with a size of (hg_size_t)-1 for missing keys */
+    const hg_size_t* key_sizes = (const hg_size_t*)local_keys_buffer.data();
+    const char* packed_keys = local_keys_buffer.data() + in.num_keys*sizeof(hg_size_t);
+    result.resize(in.num_keys*sizeof(hg_size_t));
+    ds_bulk_t vdata;
+    sdskv_run_in_pool(db.pool(SDSKV_OP_CLASS_READ), [&]() {
+        for(unsigned i = 0; i < in.num_keys; i++) {
+            hg_size_t vsize = (hg_size_t)(-1);
+            if(db->get(packed_keys, key_sizes[i], vdata)) {
+                vsize = vdata.size();
+                result.insert(result.end(), vdata.begin(), vdata.end());
+            }
+            memcpy(result.data() + i*sizeof(hg_size_t), &vsize, sizeof(vsize));
+            packed_keys += key_sizes[i];
+        }
+    });
+
+    try {
+        sdskv_set_alloc_output(svr_ctx, mid, result, in.eager_size, out);
+    } catch(int exc_no) {
+        out.ret = exc_no;
+    }
+}
+DEFINE_MARGO_RPC_HANDLER(sdskv_get_packed_alloc_ult)
+
+static void sdskv_release_bulk_ult(hg_handle_t handle)
+{
+    hg_return_t hret;
+    release_bulk_in_t in;
+
+    /* this RPC does not send a response */
+    auto r0 = at_exit([&handle]() { margo_destroy(handle); });
+
+    margo_instance_id mid = margo_hg_handle_get_instance(handle);
+    assert(mid);
+    const struct hg_info* info = margo_get_info(handle);
+    sdskv_provider_t svr_ctx = 
+        (sdskv_provider_t)margo_registered_data(mid, info->id);
+    if(!svr_ctx) {
+        std::cerr << "Error (sdskv_release_bulk_ult): SDSKV release_bulk could not find provider" << std::endl;
+        return;
+    }
+
+    hret = margo_get_input(handle, &in);
+    if(hret != HG_SUCCESS) return;
+
+    std::unique_ptr<sdskv_exposed_buffer> buffer;
+    ABT_mutex_lock(svr_ctx->exposed_mutex);
+    auto it = svr_ctx->exposed_buffers.find(in.bulk_id);
+    if(it != svr_ctx->exposed_buffers.end()) {
+        buffer = std::move(it->second);
+        svr_ctx->exposed_buffers.erase(it);
+    }
+    ABT_mutex_unlock(svr_ctx->exposed_mutex);
+
+    margo_free_input(handle, &in);
+}
+DEFINE_MARGO_RPC_HANDLER(sdskv_release_bulk_ult)
+
 static void sdskv_length_multi_ult(hg_handle_t handle)
 {
 
@@ -1417,7 +2027,7 @@ static void sdskv_length_multi_ult(hg_handle_t handle)
     length_multi_in_t in;
     length_multi_out_t out;
     out.ret = SDSKV_SUCCESS;
-    std::vector<char> local_keys_buffer;
+    BulkBufferPool::buffer local_keys_buffer;
     std::vector<hg_size_t> local_vals_size_buffer;
     hg_bulk_t local_keys_bulk_handle;
     hg_bulk_t local_vals_size_bulk_handle;
@@ -1444,29 +2054,19 @@ static void sdskv_length_multi_ult(hg_handle_t handle)
     auto r3 = at_exit([&handle,&in]() { margo_free_input(handle, &in); });
 
     /* find the target database */
-    ABT_rwlock_rdlock(svr_ctx->lock);
-    auto it = svr_ctx->databases.find(in.db_id);
-    if(it == svr_ctx->databases.end()) {
-        ABT_rwlock_unlock(svr_ctx->lock);
+    auto db = svr_ctx->databases.find(in.db_id);
+    if(!db) {
         out.ret = SDSKV_ERR_UNKNOWN_DB;
         return;
     }
-    auto db = it->second;
-    ABT_rwlock_unlock(svr_ctx->lock);
 
-    /* allocate buffers to receive the keys */
-    local_keys_buffer.resize(in.keys_bulk_size);
-    std::vector<void*> keys_addr(1);
-    keys_addr[0] = (void*)local_keys_buffer.data();
-    
-    /* create bulk handle to receive key sizes and packed keys */
-    hret = margo_bulk_create(mid, 1, keys_addr.data(), &in.keys_bulk_size,
-            HG_BULK_WRITE_ONLY, &local_keys_bulk_handle);
+    /* get a registered buffer to receive the key sizes and packed keys */
+    hret = svr_ctx->bulk_pool->get(in.keys_bulk_size, local_keys_buffer);
     if(hret != HG_SUCCESS) {
         out.ret = SDSKV_MAKE_HG_ERROR(hret);
         return;
     }
-    auto r6 = at_exit([&local_keys_bulk_handle]() { margo_bulk_free(local_keys_bulk_handle); });
+    local_keys_bulk_handle = local_keys_buffer.bulk();
 
     /* allocate buffer to send the values */
     local_vals_size_buffer.resize(in.num_keys);
@@ -1497,16 +2097,14 @@ static void sdskv_length_multi_ult(hg_handle_t handle)
     char* packed_keys = local_keys_buffer.data() + in.num_keys*sizeof(hg_size_t);
 
     /* go through the key/value pairs and get the values from the database */
-    for(unsigned i=0; i < in.num_keys; i++) {
-        ds_bulk_t kdata(packed_keys, packed_keys+key_sizes[i]);
-        ds_bulk_t vdata;
-        if(db->get(kdata, vdata)) {
-            local_vals_size_buffer[i] = vdata.size();
-        } else {
-            local_vals_size_buffer[i] = 0;
+    sdskv_run_in_pool(db.pool(SDSKV_OP_CLASS_READ), [&]() {
+        for(unsigned i=0; i < in.num_keys; i++) {
+            if(!db->length(packed_keys, key_sizes[i], &local_vals_size_buffer[i])) {
+                local_vals_size_buffer[i] = 0;
+            }
+            packed_keys += key_sizes[i];
         }
-        packed_keys += key_sizes[i];
-    }
+    });
 
     /* do a PUSH operation to push back the value sizes to the client */
     hret = margo_bulk_transfer(mid, HG_BULK_PUSH, info->addr, in.vals_size_bulk_handle, 0,
@@ -1527,7 +2125,7 @@ static void sdskv_exists_multi_ult(hg_handle_t handle)
     exists_multi_in_t in;
     exists_multi_out_t out;
     out.ret = SDSKV_SUCCESS;
-    std::vector<char> local_keys_buffer;
+    BulkBufferPool::buffer local_keys_buffer;
     std::vector<uint8_t> local_flags_buffer;
     hg_bulk_t local_keys_bulk_handle;
     hg_bulk_t local_flags_bulk_handle;
@@ -1554,29 +2152,19 @@ static void sdskv_exists_multi_ult(hg_handle_t handle)
     auto r3 = at_exit([&handle,&in]() { margo_free_input(handle, &in); });
 
     /* find the target database */
-    ABT_rwlock_rdlock(svr_ctx->lock);
-    auto it = svr_ctx->databases.find(in.db_id);
-    if(it == svr_ctx->databases.end()) {
-        ABT_rwlock_unlock(svr_ctx->lock);
+    auto db = svr_ctx->databases.find(in.db_id);
+    if(!db) {
         out.ret = SDSKV_ERR_UNKNOWN_DB;
         return;
     }
-    auto db = it->second;
-    ABT_rwlock_unlock(svr_ctx->lock);
 
-    /* allocate buffers to receive the keys */
-    local_keys_buffer.resize(in.keys_bulk_size);
-    std::vector<void*> keys_addr(1);
-    keys_addr[0] = (void*)local_keys_buffer.data();
-    
-    /* create bulk handle to receive key sizes and packed keys */
-    hret = margo_bulk_create(mid, 1, keys_addr.data(), &in.keys_bulk_size,
-            HG_BULK_WRITE_ONLY, &local_keys_bulk_handle);
+    /* get a registered buffer to receive the key sizes and packed keys */
+    hret = svr_ctx->bulk_pool->get(in.keys_bulk_size, local_keys_buffer);
     if(hret != HG_SUCCESS) {
         out.ret = SDSKV_MAKE_HG_ERROR(hret);
         return;
     }
-    auto r6 = at_exit([&local_keys_bulk_handle]() { margo_bulk_free(local_keys_bulk_handle); });
+    local_keys_bulk_handle = local_keys_buffer.bulk();
 
     /* allocate buffer to send the flags */
     hg_size_t local_flags_buffer_size = in.num_keys/8 + (in.num_keys % 8 == 0 ? 0 : 1);
@@ -1606,19 +2194,10 @@ static void sdskv_exists_multi_ult(hg_handle_t handle)
     /* find beginning of packed keys */
     char* packed_keys = local_keys_buffer.data() + in.num_keys*sizeof(hg_size_t);
 
-    /* go through the key/value pairs and get the values from the database */
-    uint8_t mask = 1;
-    for(unsigned i=0; i < in.num_keys; i++) {
-        ds_bulk_t kdata(packed_keys, packed_keys+key_sizes[i]);
-        ds_bulk_t vdata;
-        if(db->get(kdata, vdata)) {
-            local_flags_buffer[i/8] |= mask;
-        }
-        mask = mask << 1;
-        if(i % 8 == 7)
-            mask = 1;
-        packed_keys += key_sizes[i];
-    }
+    /* check which keys exist in the database */
+    sdskv_run_in_pool(db.pool(SDSKV_OP_CLASS_READ), [&]() {
+        db->exists_multi(in.num_keys, packed_keys, key_sizes, local_flags_buffer.data());
+    });
 
     /* do a PUSH operation to push back the value sizes to the client */
     hret = margo_bulk_transfer(mid, HG_BULK_PUSH, info->addr, in.flags_bulk_handle, 0,
@@ -1639,7 +2218,7 @@ static void sdskv_length_packed_ult(hg_handle_t handle)
     length_packed_in_t in;
     length_packed_out_t out;
     out.ret = SDSKV_SUCCESS;
-    std::vector<char> local_keys_buffer;
+    BulkBufferPool::buffer local_keys_buffer;
     std::vector<hg_size_t> local_vals_size_buffer;
     hg_bulk_t local_keys_bulk_handle;
     hg_bulk_t local_vals_size_bulk_handle;
@@ -1666,29 +2245,19 @@ static void sdskv_length_packed_ult(hg_handle_t handle)
     auto r3 = at_exit([&handle,&in]() { margo_free_input(handle, &in); });
 
     /* find the target database */
-    ABT_rwlock_rdlock(svr_ctx->lock);
-    auto it = svr_ctx->databases.find(in.db_id);
-    if(it == svr_ctx->databases.end()) {
-        ABT_rwlock_unlock(svr_ctx->lock);
+    auto db = svr_ctx->databases.find(in.db_id);
+    if(!db) {
         out.ret = SDSKV_ERR_UNKNOWN_DB;
         return;
     }
-    auto db = it->second;
-    ABT_rwlock_unlock(svr_ctx->lock);
 
-    /* allocate buffers to receive the keys and key sizes*/
-    local_keys_buffer.resize(in.in_bulk_size);
-    std::vector<void*> keys_addr(1);
-    keys_addr[0] = (void*)local_keys_buffer.data();
-    
-    /* create bulk handle to receive key sizes and packed keys */
-    hret = margo_bulk_create(mid, 1, keys_addr.data(), &in.in_bulk_size,
-            HG_BULK_WRITE_ONLY, &local_keys_bulk_handle);
+    /* get a registered buffer to receive the key sizes and packed keys */
+    hret = svr_ctx->bulk_pool->get(in.in_bulk_size, local_keys_buffer);
     if(hret != HG_SUCCESS) {
         out.ret = SDSKV_MAKE_HG_ERROR(hret);
         return;
     }
-    auto r6 = at_exit([&local_keys_bulk_handle]() { margo_bulk_free(local_keys_bulk_handle); });
+    local_keys_bulk_handle = local_keys_buffer.bulk();
 
     /* allocate buffer to send the value sizes */
     local_vals_size_buffer.resize(in.num_keys);
@@ -1719,16 +2288,14 @@ static void sdskv_length_packed_ult(hg_handle_t handle)
     char* packed_keys = local_keys_buffer.data() + in.num_keys*sizeof(hg_size_t);
 
     /* go through the key/value pairs and get the values from the database */
-    for(unsigned i=0; i < in.num_keys; i++) {
-        ds_bulk_t kdata(packed_keys, packed_keys+key_sizes[i]);
-        ds_bulk_t vdata;
-        if(db->get(kdata, vdata)) {
-            local_vals_size_buffer[i] = vdata.size();
-        } else {
-            local_vals_size_buffer[i] = 0;
+    sdskv_run_in_pool(db.pool(SDSKV_OP_CLASS_READ), [&]() {
+        for(unsigned i=0; i < in.num_keys; i++) {
+            if(!db->length(packed_keys, key_sizes[i], &local_vals_size_buffer[i])) {
+                local_vals_size_buffer[i] = 0;
+            }
+            packed_keys += key_sizes[i];
         }
-        packed_keys += key_sizes[i];
-    }
+    });
 
     /* do a PUSH operation to push back the value sizes to the client */
     hret = margo_bulk_transfer(mid, HG_BULK_PUSH, info->addr, in.out_bulk_handle, 0,
@@ -1771,18 +2338,14 @@ static void sdskv_bulk_put_ult(hg_handle_t handle)
         return;
     }
 
-    ABT_rwlock_rdlock(svr_ctx->lock);
-    auto it = svr_ctx->databases.find(in.db_id);
-    if(it == svr_ctx->databases.end()) {
-        ABT_rwlock_unlock(svr_ctx->lock);
+    auto db = svr_ctx->databases.find(in.db_id);
+    if(!db) {
         out.ret = SDSKV_ERR_UNKNOWN_DB;
         margo_respond(handle, &out);
         margo_free_input(handle, &in);
         margo_destroy(handle);
         return;
     }
-    auto db = it->second;
-    ABT_rwlock_unlock(svr_ctx->lock);
 
     ds_bulk_t vdata(in.vsize);
 
@@ -1815,15 +2378,20 @@ static void sdskv_bulk_put_ult(hg_handle_t handle)
 
     }
 
-    ds_bulk_t kdata(in.key.data, in.key.data+in.key.size);
-
     double start = ABT_get_wtime();
 
 #ifdef USE_SYMBIOMON
     symbiomon_metric_update_gauge_by_fixed_amount(svr_ctx->put_num_entrants, 1);
 #endif
 
-    out.ret = db->put(kdata, vdata);
+    sdskv_run_in_pool(db.pool(SDSKV_OP_CLASS_WRITE), [&]() {
+        WriteCombiner* combiner = db.combiner();
+        if(combiner)
+            out.ret = combiner->put(db.get(), in.key.data, in.key.size, vdata.data(), vdata.size());
+        else
+            out.ret = db->put(in.key.data, in.key.size, vdata.data(), vdata.size());
+    });
+    db.written();
 
     double end = ABT_get_wtime();
 
@@ -1870,23 +2438,20 @@ static void sdskv_bulk_get_ult(hg_handle_t handle)
         return;
     }
 
-    ABT_rwlock_rdlock(svr_ctx->lock);
-    auto it = svr_ctx->databases.find(in.db_id);
-    if(it == svr_ctx->databases.end()) {
-        ABT_rwlock_unlock(svr_ctx->lock);
+    auto db = svr_ctx->databases.find(in.db_id);
+    if(!db) {
         out.ret = SDSKV_ERR_UNKNOWN_DB;
         margo_respond(handle, &out);
         margo_free_input(handle, &in);
         margo_destroy(handle);
         return;
     }
-    auto db = it->second;
-    ABT_rwlock_unlock(svr_ctx->lock);
     
-    ds_bulk_t kdata(in.key.data, in.key.data+in.key.size);
-
     ds_bulk_t vdata;
-    auto b = db->get(kdata, vdata);
+    bool b = false;
+    sdskv_run_in_pool(db.pool(SDSKV_OP_CLASS_READ), [&]() {
+        b = db->get(in.key.data, in.key.size, vdata);
+    });
 
     if(!b) {
         out.vsize = 0;
@@ -1974,26 +2539,25 @@ static void sdskv_erase_ult(hg_handle_t handle)
         return;
     }
 
-    ABT_rwlock_rdlock(svr_ctx->lock);
-    auto it = svr_ctx->databases.find(in.db_id);
-    if(it == svr_ctx->databases.end()) {
-        ABT_rwlock_unlock(svr_ctx->lock);
+    auto db = svr_ctx->databases.find(in.db_id);
+    if(!db) {
         out.ret = SDSKV_ERR_UNKNOWN_DB;
         margo_respond(handle, &out);
         margo_free_input(handle, &in);
         margo_destroy(handle);
         return;
     }
-    auto db = it->second;
-    ABT_rwlock_unlock(svr_ctx->lock);
     
-    ds_bulk_t kdata(in.key.data, in.key.data+in.key.size);
-
-    if(db->erase(kdata)) {
-        out.ret   = SDSKV_SUCCESS;
-    } else {
-        out.ret   = SDSKV_ERR_ERASE;
-    }
+    sdskv_run_in_pool(db.pool(SDSKV_OP_CLASS_WRITE), [&]() {
+        WriteCombiner* combiner = db.combiner();
+        if(combiner)
+            out.ret = combiner->erase(db.get(), in.key.data, in.key.size);
+        else if(db->erase(in.key.data, in.key.size))
+            out.ret = SDSKV_SUCCESS;
+        else
+            out.ret = SDSKV_ERR_ERASE;
+    });
+    db.written();
 
     margo_respond(handle, &out);
     margo_free_input(handle, &in);
@@ -2010,7 +2574,7 @@ static void sdskv_erase_multi_ult(hg_handle_t handle)
     erase_multi_in_t in;
     erase_multi_out_t out;
     out.ret = SDSKV_SUCCESS;
-    std::vector<char> local_keys_buffer;
+    BulkBufferPool::buffer local_keys_buffer;
     hg_bulk_t local_keys_bulk_handle;
 
     auto r1 = at_exit([&handle]() { margo_destroy(handle); });
@@ -2035,49 +2599,55 @@ static void sdskv_erase_multi_ult(hg_handle_t handle)
     auto r3 = at_exit([&handle,&in]() { margo_free_input(handle, &in); });
 
     /* find the target database */
-    ABT_rwlock_rdlock(svr_ctx->lock);
-    auto it = svr_ctx->databases.find(in.db_id);
-    if(it == svr_ctx->databases.end()) {
-        ABT_rwlock_unlock(svr_ctx->lock);
+    auto db = svr_ctx->databases.find(in.db_id);
+    if(!db) {
         out.ret = SDSKV_ERR_UNKNOWN_DB;
         return;
     }
-    auto db = it->second;
-    ABT_rwlock_unlock(svr_ctx->lock);
 
-    /* allocate buffers to receive the keys */
-    local_keys_buffer.resize(in.keys_bulk_size);
-    std::vector<void*> keys_addr(1);
-    keys_addr[0] = (void*)local_keys_buffer.data();
-    
-    /* create bulk handle to receive key sizes and packed keys */
-    hret = margo_bulk_create(mid, 1, keys_addr.data(), &in.keys_bulk_size,
-            HG_BULK_WRITE_ONLY, &local_keys_bulk_handle);
-    if(hret != HG_SUCCESS) {
-        out.ret = SDSKV_MAKE_HG_ERROR(hret);
+    /* keys sent inline must have the announced size, and the
+     * buffer must be large enough to start with num_keys sizes */
+    if((in.keys_bulk_handle == HG_BULK_NULL && in.keys.size != in.keys_bulk_size)
+    || in.num_keys > in.keys_bulk_size/sizeof(hg_size_t)) {
+        out.ret = SDSKV_ERR_INVALID_ARG;
         return;
     }
-    auto r6 = at_exit([&local_keys_bulk_handle]() { margo_bulk_free(local_keys_bulk_handle); });
 
-    /* transfer keys */
-    hret = margo_bulk_transfer(mid, HG_BULK_PULL, info->addr, in.keys_bulk_handle, 0,
-            local_keys_bulk_handle, 0, in.keys_bulk_size);
-    if(hret != HG_SUCCESS) {
-        out.ret = SDSKV_MAKE_HG_ERROR(hret);
-        return;
+    char* keys_data = in.keys.data;
+    if(in.keys_bulk_handle != HG_BULK_NULL) {
+        /* get a registered buffer to receive the key sizes and packed keys */
+        hret = svr_ctx->bulk_pool->get(in.keys_bulk_size, local_keys_buffer);
+        if(hret != HG_SUCCESS) {
+            out.ret = SDSKV_MAKE_HG_ERROR(hret);
+            return;
+        }
+        local_keys_bulk_handle = local_keys_buffer.bulk();
+
+        /* transfer keys */
+        hret = margo_bulk_transfer(mid, HG_BULK_PULL, info->addr, in.keys_bulk_handle, 0,
+                local_keys_bulk_handle, 0, in.keys_bulk_size);
+        if(hret != HG_SUCCESS) {
+            out.ret = SDSKV_MAKE_HG_ERROR(hret);
+            return;
+        }
+        keys_data = local_keys_buffer.data();
     }
 
-    /* interpret beginning of the key buffer as a list of key sizes */
-    hg_size_t* key_sizes = (hg_size_t*)local_keys_buffer.data();
+    /* read the list of key sizes at the beginning of the key buffer */
+    std::vector<hg_size_t> key_sizes = sdskv_read_sizes(keys_data, in.num_keys);
+    /* the keys must fit in the buffer */
+    if(!sdskv_segments_fit(key_sizes, in.keys_bulk_size)) {
+        out.ret = SDSKV_ERR_INVALID_ARG;
+        return;
+    }
     /* find beginning of packed keys */
-    char* packed_keys = local_keys_buffer.data() + in.num_keys*sizeof(hg_size_t);
+    char* packed_keys = keys_data + in.num_keys*sizeof(hg_size_t);
 
-    /* go through the key/value pairs and erase them */
-    for(unsigned i=0; i < in.num_keys; i++) {
-        ds_bulk_t kdata(packed_keys, packed_keys+key_sizes[i]);
-        db->erase(kdata);
-        packed_keys += key_sizes[i];
-    }
+    /* erase the keys */
+    sdskv_run_in_pool(db.pool(SDSKV_OP_CLASS_WRITE), [&]() {
+        out.ret = db->erase_multi(in.num_keys, packed_keys, key_sizes.data());
+    });
+    db.written();
 
     return;
 }
@@ -2111,22 +2681,18 @@ static void sdskv_exists_ult(hg_handle_t handle)
         return;
     }
 
-    ABT_rwlock_rdlock(svr_ctx->lock);
-    auto it = svr_ctx->databases.find(in.db_id);
-    if(it == svr_ctx->databases.end()) {
-        ABT_rwlock_unlock(svr_ctx->lock);
+    auto db = svr_ctx->databases.find(in.db_id);
+    if(!db) {
         out.ret = SDSKV_ERR_UNKNOWN_DB;
         margo_respond(handle, &out);
         margo_free_input(handle, &in);
         margo_destroy(handle);
         return;
     }
-    auto db = it->second;
-    ABT_rwlock_unlock(svr_ctx->lock);
     
-    ds_bulk_t kdata(in.key.data, in.key.data+in.key.size);
-
-    out.flag = db->exists(kdata) ? 1 : 0;
+    sdskv_run_in_pool(db.pool(SDSKV_OP_CLASS_READ), [&]() {
+        out.flag = db->exists(in.key.data, in.key.size) ? 1 : 0;
+    });
     out.ret  = SDSKV_SUCCESS;
 
     margo_respond(handle, &out);
@@ -2136,14 +2702,546 @@ static void sdskv_exists_ult(hg_handle_t handle)
 }
 DEFINE_MARGO_RPC_HANDLER(sdskv_exists_ult)
 
+/* Sends keys to the client of a list_keys-like request. The client's
+ * ksizes array (max_keys entries) holds the sizes of its buffers; it is
+ * pulled, replaced with the actual sizes and pushed back, then the keys
+ * are pushed into the client's buffers. Throws SDSKV_ERR_SIZE (after
+ * pushing the sizes) if a buffer is too small, or a Mercury error. */
+static void sdskv_push_keys(margo_instance_id mid, hg_addr_t origin_addr,
+        const std::vector<ds_bulk_t>& keys, hg_size_t max_keys,
+        hg_bulk_t ksizes_bulk_handle, hg_bulk_t keys_bulk_handle)
+{
+    hg_return_t hret;
+    hg_bulk_t ksizes_local_bulk = HG_BULK_NULL;
+    hg_bulk_t keys_local_bulk   = HG_BULK_NULL;
+    auto r = at_exit([&]() {
+        margo_bulk_free(ksizes_local_bulk);
+        margo_bulk_free(keys_local_bulk);
+    });
+
+    hg_size_t num_keys = keys.size();
+    if(num_keys == 0) return;
+
+    /* create a bulk handle to receive and send key sizes from client */
+    std::vector<hg_size_t> ksizes(max_keys);
+    std::vector<void*> ksizes_addr(1);
+    ksizes_addr[0] = (void*)ksizes.data();
+    hg_size_t ksizes_bulk_size = ksizes.size()*sizeof(hg_size_t);
+    hret = margo_bulk_create(mid, 1, ksizes_addr.data(), 
+            &ksizes_bulk_size, HG_BULK_READWRITE, &ksizes_local_bulk);
+    if(hret != HG_SUCCESS) {
+        std::cerr << "Error: SDSKV list_keys could not create bulk handle (ksizes_local_bulk)" << std::endl;
+        throw (int)SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    /* receive the key sizes from the client */
+    hret = margo_bulk_transfer(mid, HG_BULK_PULL, origin_addr,
+            ksizes_bulk_handle, 0, ksizes_local_bulk, 0, ksizes_bulk_size);
+    if(hret != HG_SUCCESS) {
+        std::cerr << "Error: SDSKV list_keys could not issue bulk transfer " 
+            << "(pull from in.ksizes_bulk_handle to ksizes_local_bulk)" << std::endl;
+        throw (int)SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    /* make a copy of the remote key sizes */
+    std::vector<hg_size_t> remote_ksizes(ksizes.begin(), ksizes.end());
+
+    /* create the array of actual sizes */
+    std::vector<hg_size_t> true_ksizes(num_keys);
+    bool size_error = false;
+    for(unsigned i = 0; i < num_keys; i++) {
+        true_ksizes[i] = keys[i].size();
+        if(true_ksizes[i] > ksizes[i]) {
+            // this key has a size that exceeds the allocated size on client
+            size_error = true;
+        }
+        ksizes[i] = true_ksizes[i];
+    }
+    for(unsigned i = num_keys; i < max_keys; i++) {
+        ksizes[i] = 0;
+    }
+
+    /* transfer the ksizes back to the client */
+    hret = margo_bulk_transfer(mid, HG_BULK_PUSH, origin_addr, 
+            ksizes_bulk_handle, 0, ksizes_local_bulk, 0, ksizes_bulk_size);
+    if(hret != HG_SUCCESS) {
+        std::cerr << "Error: SDSKV list_keys could not issue bulk transfer "
+            << "(push from ksizes_local_bulk to in.ksizes_bulk_handle)" << std::endl;
+        throw (int)SDSKV_MAKE_HG_ERROR(hret);
+    }
+        
+    /* if user provided a size too small for some key, return error (we already set the right key sizes) */    
+    if(size_error)
+        throw (int)SDSKV_ERR_SIZE;
+
+    /* create an array of addresses pointing to keys */
+    std::vector<void*> keys_addr(num_keys);
+    for(unsigned i=0; i < num_keys; i++) {
+        keys_addr[i] = (void*)(keys[i].data());
+    }
+
+    /* expose the keys for bulk transfer */
+    hret = margo_bulk_create(mid, num_keys, keys_addr.data(),
+            true_ksizes.data(), HG_BULK_READ_ONLY, &keys_local_bulk);
+    if(hret != HG_SUCCESS) {
+        std::cerr << "Error: SDSKV list_keys could not create bulk handle (keys_local_bulk)" << std::endl;
+        throw (int)SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    /* transfer the keys to the client, all transfers running concurrently */
+    sdskv_bulk_transfers keys_push(mid);
+    uint64_t remote_offset = 0;
+    uint64_t local_offset  = 0;
+    for(unsigned i = 0; i < num_keys; i++) {
+
+        if(true_ksizes[i] > 0) {
+            hret = keys_push.start(HG_BULK_PUSH, origin_addr,
+                    keys_bulk_handle, remote_offset, keys_local_bulk, local_offset, true_ksizes[i]);
+            if(hret != HG_SUCCESS) {
+                std::cerr << "Error: SDSKV list_keys could not issue bulk transfer (keys_local_bulk)" << std::endl;
+                throw (int)SDSKV_MAKE_HG_ERROR(hret);
+            }
+        }
+
+        remote_offset += remote_ksizes[i];
+        local_offset  += true_ksizes[i];
+    }
+    hret = keys_push.wait();
+    if(hret != HG_SUCCESS) {
+        std::cerr << "Error: SDSKV list_keys bulk transfer failed (keys_local_bulk)" << std::endl;
+        throw (int)SDSKV_MAKE_HG_ERROR(hret);
+    }
+}
+
 static void sdskv_list_keys_ult(hg_handle_t handle)
 {
 
     hg_return_t hret;
-    list_keys_in_t in;
-    list_keys_out_t out;
-    hg_bulk_t ksizes_local_bulk = HG_BULK_NULL;
-    hg_bulk_t keys_local_bulk   = HG_BULK_NULL;
+    list_keys_in_t in;
+    list_keys_out_t out;
+
+    out.ret     = SDSKV_SUCCESS;
+    out.nkeys   = 0;
+
+    /* get the provider handling this request */
+    margo_instance_id mid = margo_hg_handle_get_instance(handle);
+    assert(mid);
+    const struct hg_info* info = margo_get_info(handle);
+    sdskv_provider_t svr_ctx = 
+        (sdskv_provider_t)margo_registered_data(mid, info->id);
+    if(!svr_ctx) {
+        std::cerr << "Error (sdskv_list_keys_ult): SDSKV list_keys could not find provider" << std::endl;
+        out.ret = SDSKV_ERR_UNKNOWN_PR;
+        margo_respond(handle, &out);
+        margo_destroy(handle);
+        return;
+    }
+
+    /* get the input */
+    hret = margo_get_input(handle, &in);
+    if(hret != HG_SUCCESS) {
+        std::cerr << "Error: SDSKV list_keys could not get RPC input" << std::endl;
+        out.ret = SDSKV_MAKE_HG_ERROR(hret);
+        margo_respond(handle, &out);
+        margo_destroy(handle);
+        return;
+    }
+
+    try {
+
+        /* find the database targeted */
+        auto db = svr_ctx->databases.find(in.db_id);
+        if(!db) {
+            std::cerr << "Error: SDSKV list_keys could not get database with id " << in.db_id << std::endl;
+            throw (int)SDSKV_ERR_UNKNOWN_DB;
+        }
+
+        /* get the keys from the underlying database */    
+        ds_bulk_t start_kdata(in.start_key.data, in.start_key.data+in.start_key.size);
+        ds_bulk_t prefix(in.prefix.data, in.prefix.data+in.prefix.size);
+        std::vector<ds_bulk_t> keys;
+        sdskv_run_in_pool(db.pool(SDSKV_OP_CLASS_SCAN), [&]() {
+            keys = db->list_keys(start_kdata, in.max_keys, prefix);
+        });
+        if(keys.size() > in.max_keys) keys.resize(in.max_keys);
+        out.nkeys = keys.size();
+
+        /* send the keys to the client */
+        sdskv_push_keys(mid, info->addr, keys, in.max_keys,
+                in.ksizes_bulk_handle, in.keys_bulk_handle);
+
+        out.ret = SDSKV_SUCCESS;
+
+    } catch(int exc_no) {
+        out.ret = exc_no;
+    }
+
+    margo_respond(handle, &out);
+    margo_free_input(handle, &in);
+    margo_destroy(handle); 
+
+    return;
+}
+DEFINE_MARGO_RPC_HANDLER(sdskv_list_keys_ult)
+
+static void sdskv_list_keys_range_ult(hg_handle_t handle)
+{
+
+    hg_return_t hret;
+    list_keys_range_in_t in;
+    list_keys_out_t out;
+
+    out.ret     = SDSKV_SUCCESS;
+    out.nkeys   = 0;
+
+    /* get the provider handling this request */
+    margo_instance_id mid = margo_hg_handle_get_instance(handle);
+    assert(mid);
+    const struct hg_info* info = margo_get_info(handle);
+    sdskv_provider_t svr_ctx = 
+        (sdskv_provider_t)margo_registered_data(mid, info->id);
+    if(!svr_ctx) {
+        std::cerr << "Error (sdskv_list_keys_range_ult): SDSKV list_keys_range could not find provider" << std::endl;
+        out.ret = SDSKV_ERR_UNKNOWN_PR;
+        margo_respond(handle, &out);
+        margo_destroy(handle);
+        return;
+    }
+
+    /* get the input */
+    hret = margo_get_input(handle, &in);
+    if(hret != HG_SUCCESS) {
+        std::cerr << "Error: SDSKV list_keys_range could not get RPC input" << std::endl;
+        out.ret = SDSKV_MAKE_HG_ERROR(hret);
+        margo_respond(handle, &out);
+        margo_destroy(handle);
+        return;
+    }
+
+    try {
+
+        /* find the database targeted */
+        auto db = svr_ctx->databases.find(in.db_id);
+        if(!db) {
+            std::cerr << "Error: SDSKV list_keys_range could not get database with id " << in.db_id << std::endl;
+            throw (int)SDSKV_ERR_UNKNOWN_DB;
+        }
+
+        /* get the keys in [lower_bound, upper_bound) from the underlying database */
+        ds_bulk_t lower_bound(in.lower_bound.data, in.lower_bound.data+in.lower_bound.size);
+        ds_bulk_t upper_bound(in.upper_bound.data, in.upper_bound.data+in.upper_bound.size);
+        std::vector<ds_bulk_t> keys;
+        sdskv_run_in_pool(db.pool(SDSKV_OP_CLASS_SCAN), [&]() {
+            keys = db->list_key_range(lower_bound, upper_bound, in.max_keys);
+        });
+        if(keys.size() > in.max_keys) keys.resize(in.max_keys);
+        out.nkeys = keys.size();
+
+        /* send the keys to the client */
+        sdskv_push_keys(mid, info->addr, keys, in.max_keys,
+                in.ksizes_bulk_handle, in.keys_bulk_handle);
+
+        out.ret = SDSKV_SUCCESS;
+
+    } catch(int exc_no) {
+        out.ret = exc_no;
+    }
+
+    margo_respond(handle, &out);
+    margo_free_input(handle, &in);
+    margo_destroy(handle); 
+
+    return;
+}
+DEFINE_MARGO_RPC_HANDLER(sdskv_list_keys_range_ult)
+
+/* Sends keyvals to the client of a list_keyvals-like request. The client's
+ * ksizes and vsizes arrays (max_keys entries each) hold the sizes of its
+ * buffers; they are pulled, replaced with the actual sizes and pushed back,
+ * then the keys and values are pushed into the client's buffers. Throws
+ * SDSKV_ERR_SIZE (after pushing the sizes) if a buffer is too small, or
+ * a Mercury error. Returns the number of bytes of keys and values sent. */
+static size_t sdskv_push_keyvals(margo_instance_id mid, hg_addr_t origin_addr,
+        const std::vector<std::pair<ds_bulk_t,ds_bulk_t>>& keyvals, hg_size_t max_keys,
+        hg_bulk_t ksizes_bulk_handle, hg_bulk_t keys_bulk_handle,
+        hg_bulk_t vsizes_bulk_handle, hg_bulk_t vals_bulk_handle)
+{
+    hg_return_t hret;
+    hg_bulk_t ksizes_local_bulk = HG_BULK_NULL;
+    hg_bulk_t keys_local_bulk   = HG_BULK_NULL;
+    hg_bulk_t vsizes_local_bulk = HG_BULK_NULL;
+    hg_bulk_t vals_local_bulk   = HG_BULK_NULL;
+    auto r = at_exit([&]() {
+        margo_bulk_free(ksizes_local_bulk);
+        margo_bulk_free(keys_local_bulk);
+        margo_bulk_free(vsizes_local_bulk);
+        margo_bulk_free(vals_local_bulk);
+    });
+
+    hg_size_t num_keys = keyvals.size();
+    if(num_keys == 0) return 0;
+
+    /* create a bulk handle to receive and send key sizes from client */
+    std::vector<hg_size_t> ksizes(max_keys);
+    std::vector<void*> ksizes_addr(1);
+    ksizes_addr[0] = (void*)ksizes.data();
+    hg_size_t ksizes_bulk_size = ksizes.size()*sizeof(hg_size_t);
+    hret = margo_bulk_create(mid, 1, ksizes_addr.data(), 
+            &ksizes_bulk_size, HG_BULK_READWRITE, &ksizes_local_bulk);
+    if(hret != HG_SUCCESS) {
+        std::cerr << "Error: SDSKV list_keyvals could not create bulk handle (ksizes_local_bulk)" << std::endl;
+        throw (int)SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    /* create a bulk handle to receive and send value sizes from client */
+    std::vector<hg_size_t> vsizes(max_keys);
+    std::vector<void*> vsizes_addr(1);
+    vsizes_addr[0] = (void*)vsizes.data();
+    hg_size_t vsizes_bulk_size = vsizes.size()*sizeof(hg_size_t);
+    hret = margo_bulk_create(mid, 1, vsizes_addr.data(), 
+            &vsizes_bulk_size, HG_BULK_READWRITE, &vsizes_local_bulk);
+    if(hret != HG_SUCCESS) {
+        std::cerr << "Error: SDSKV list_keyvals could not create bulk handle (vsizes_local_bulk)" << std::endl;
+        throw (int)SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    /* receive the key sizes and value sizes from the client concurrently */
+    sdskv_bulk_transfers sizes_pull(mid);
+    hret = sizes_pull.start(HG_BULK_PULL, origin_addr,
+            ksizes_bulk_handle, 0, ksizes_local_bulk, 0, ksizes_bulk_size);
+    if(hret == HG_SUCCESS)
+        hret = sizes_pull.start(HG_BULK_PULL, origin_addr,
+                vsizes_bulk_handle, 0, vsizes_local_bulk, 0, vsizes_bulk_size);
+    if(hret == HG_SUCCESS)
+        hret = sizes_pull.wait();
+    if(hret != HG_SUCCESS) {
+        std::cerr << "Error: SDSKV list_keyvals could not issue bulk transfer " 
+            << "(pull from in.ksizes_bulk_handle and in.vsizes_bulk_handle)" << std::endl;
+        throw (int)SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    /* make a copy of the remote key sizes and value sizes */
+    std::vector<hg_size_t> remote_ksizes(ksizes.begin(), ksizes.end());
+    std::vector<hg_size_t> remote_vsizes(vsizes.begin(), vsizes.end());
+
+    bool size_error = false;
+
+    /* create the array of actual key sizes */
+    std::vector<hg_size_t> true_ksizes(num_keys);
+    hg_size_t keys_bulk_size = 0;
+    for(unsigned i = 0; i < num_keys; i++) {
+        true_ksizes[i] = keyvals[i].first.size();
+        if(true_ksizes[i] > ksizes[i]) {
+            // this key has a size that exceeds the allocated size on client
+            size_error = true;
+        } 
+        ksizes[i] = true_ksizes[i];
+        keys_bulk_size += ksizes[i];
+    }
+    for(unsigned i = num_keys; i < ksizes.size(); i++) ksizes[i] = 0;
+
+    /* create the array of actual value sizes */
+    std::vector<hg_size_t> true_vsizes(num_keys);
+    hg_size_t vals_bulk_size = 0;
+    for(unsigned i = 0; i < num_keys; i++) {
+        true_vsizes[i] = keyvals[i].second.size();
+        if(true_vsizes[i] > vsizes[i]) {
+            // this value has a size that exceeds the allocated size on client
+            size_error = true;
+        }
+        vsizes[i] = true_vsizes[i];
+        vals_bulk_size += vsizes[i];
+    }
+    for(unsigned i = num_keys; i < vsizes.size(); i++) vsizes[i] = 0;
+
+    /* transfer the ksizes and vsizes back to the client concurrently */
+    sdskv_bulk_transfers sizes_push(mid);
+    hret = sizes_push.start(HG_BULK_PUSH, origin_addr,
+            ksizes_bulk_handle, 0, ksizes_local_bulk, 0, ksizes_bulk_size);
+    if(hret == HG_SUCCESS)
+        hret = sizes_push.start(HG_BULK_PUSH, origin_addr,
+                vsizes_bulk_handle, 0, vsizes_local_bulk, 0, vsizes_bulk_size);
+    if(hret == HG_SUCCESS)
+        hret = sizes_push.wait();
+    if(hret != HG_SUCCESS) {
+        std::cerr << "Error: SDSKV list_keyvals could not issue bulk transfer "
+            << "(push to in.ksizes_bulk_handle and in.vsizes_bulk_handle)" << std::endl;
+        throw (int)SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    if(size_error)
+        throw (int)SDSKV_ERR_SIZE;
+
+    /* create an array of addresses pointing to keys */
+    std::vector<void*> keys_addr(num_keys);
+    for(unsigned i=0; i < num_keys; i++) {
+        keys_addr[i] = (void*)(keyvals[i].first.data());
+    }
+
+    /* create an array of addresses pointing to values */
+    std::vector<void*> vals_addr(num_keys);
+    for(unsigned i=0; i < num_keys; i++) {
+        vals_addr[i] = (void*)(keyvals[i].second.data());
+    }
+
+    /* expose the keys for bulk transfer */
+    hret = margo_bulk_create(mid, num_keys, keys_addr.data(),
+            true_ksizes.data(), HG_BULK_READ_ONLY, &keys_local_bulk);
+    if(hret != HG_SUCCESS) {
+        std::cerr << "Error: SDSKV list_keyvals could not create bulk handle (keys_local_bulk)" << std::endl;
+        throw (int)SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    /* expose the values for bulk transfer */
+    hret = margo_bulk_create(mid, num_keys, vals_addr.data(),
+            true_vsizes.data(), HG_BULK_READ_ONLY, &vals_local_bulk);
+    if(hret != HG_SUCCESS) {
+        std::cerr << "Error: SDSKV list_keyvals could not create bulk handle (vals_local_bulk)" << std::endl;
+        throw (int)SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    uint64_t remote_offset = 0;
+    uint64_t local_offset  = 0;
+
+    /* start transferring the keys and values to the client, then wait for all of them */
+    sdskv_bulk_transfers data_push(mid);
+
+    /* transfer the keys to the client */
+    for(unsigned i=0; i < num_keys; i++) {
+        if(true_ksizes[i] > 0) {
+            hret = data_push.start(HG_BULK_PUSH, origin_addr,
+                    keys_bulk_handle, remote_offset, keys_local_bulk, local_offset, true_ksizes[i]);
+            if(hret != HG_SUCCESS) {
+                std::cerr << "Error: SDSKV list_keyvals could not issue bulk transfer (keys_local_bulk)" << std::endl;
+                throw (int)SDSKV_MAKE_HG_ERROR(hret);
+            }
+        }
+        remote_offset += remote_ksizes[i];
+        local_offset  += true_ksizes[i];
+    }
+
+    remote_offset = 0;
+    local_offset  = 0;
+
+    /* transfer the values to the client */
+    for(unsigned i=0; i < num_keys; i++) {
+        if(true_vsizes[i] > 0) {
+            hret = data_push.start(HG_BULK_PUSH, origin_addr,
+                    vals_bulk_handle, remote_offset, vals_local_bulk, local_offset, true_vsizes[i]);
+            if(hret != HG_SUCCESS) {
+                std::cerr << "Error: SDSKV list_keyvals could not issue bulk transfer (vals_local_bulk)" << std::endl;
+                throw (int)SDSKV_MAKE_HG_ERROR(hret);
+            }
+        }
+        remote_offset += remote_vsizes[i];
+        local_offset  += true_vsizes[i];
+    }
+
+    hret = data_push.wait();
+    if(hret != HG_SUCCESS) {
+        std::cerr << "Error: SDSKV list_keyvals bulk transfer failed" << std::endl;
+        throw (int)SDSKV_MAKE_HG_ERROR(hret);
+    }
+
+    return keys_bulk_size + vals_bulk_size;
+}
+
+static void sdskv_list_keyvals_ult(hg_handle_t handle)
+{
+
+    hg_return_t hret;
+    list_keyvals_in_t in;
+    list_keyvals_out_t out;
+    double start, end;
+    size_t true_data_size = 0;
+    size_t true_num_keys = 0;
+
+    out.ret     = SDSKV_SUCCESS;
+    out.nkeys   = 0;
+
+    start = ABT_get_wtime();
+    /* get the provider handling this request */
+    margo_instance_id mid = margo_hg_handle_get_instance(handle);
+    assert(mid);
+    const struct hg_info* info = margo_get_info(handle);
+    sdskv_provider_t svr_ctx = 
+        (sdskv_provider_t)margo_registered_data(mid, info->id);
+    if(!svr_ctx) {
+        std::cerr << "Error (sdskv_list_keyvals_ult): SDSKV list_keyvals could not find provider" << std::endl;
+        out.ret = SDSKV_ERR_UNKNOWN_PR;
+        margo_respond(handle, &out);
+        margo_destroy(handle);
+        return;
+    }
+
+    /* get the input */
+    hret = margo_get_input(handle, &in);
+    if(hret != HG_SUCCESS) {
+        std::cerr << "Error: SDSKV list_keyvals could not get RPC input" << std::endl;
+        out.ret = SDSKV_MAKE_HG_ERROR(hret);
+        margo_respond(handle, &out);
+        margo_destroy(handle);
+        return;
+    }
+
+    try {
+
+        /* find the database targeted */
+        auto db = svr_ctx->databases.find(in.db_id);
+        if(!db) {
+            std::cerr << "Error: SDSKV list_keyvals could not get database with id " << in.db_id << std::endl;
+            throw (int)SDSKV_ERR_UNKNOWN_DB;
+        }
+
+        /* get the keys and values from the underlying database */    
+        ds_bulk_t start_kdata(in.start_key.data, in.start_key.data+in.start_key.size);
+#ifdef USE_SYMBIOMON
+    symbiomon_metric_update_gauge_by_fixed_amount(svr_ctx->listkeyvals_num_entrants, 1);
+#endif
+        std::vector<std::pair<ds_bulk_t,ds_bulk_t>> keyvals;
+        ds_bulk_t prefix(in.prefix.data, in.prefix.data+in.prefix.size);
+        sdskv_run_in_pool(db.pool(SDSKV_OP_CLASS_SCAN), [&]() {
+            keyvals = db->list_keyvals(start_kdata, in.max_keys, prefix);
+        });
+#ifdef USE_SYMBIOMON
+    symbiomon_metric_update_gauge_by_fixed_amount(svr_ctx->listkeyvals_num_entrants, -1);
+#endif
+        if(keyvals.size() > in.max_keys) keyvals.resize(in.max_keys);
+        out.nkeys = keyvals.size();
+
+        /* send the keys and values to the client */
+        true_data_size = sdskv_push_keyvals(mid, info->addr, keyvals, in.max_keys,
+                in.ksizes_bulk_handle, in.keys_bulk_handle,
+                in.vsizes_bulk_handle, in.vals_bulk_handle);
+
+        out.ret = SDSKV_SUCCESS;
+        true_num_keys = keyvals.size();
+
+    } catch(int exc_no) {
+        out.ret = exc_no;
+    }
+
+    margo_respond(handle, &out);
+    margo_free_input(handle, &in);
+    margo_destroy(handle); 
+
+    end = ABT_get_wtime();
+#ifdef USE_SYMBIOMON
+    symbiomon_metric_update(svr_ctx->listkeyvals_latency, (end-start));
+    symbiomon_metric_update(svr_ctx->listkeyvals_data_size, (double)true_data_size);
+    symbiomon_metric_update(svr_ctx->listkeyvals_batch_size, (double)true_num_keys);
+#endif 
+
+    return;
+}
+DEFINE_MARGO_RPC_HANDLER(sdskv_list_keyvals_ult)
+
+static void sdskv_list_keyvals_range_ult(hg_handle_t handle)
+{
+
+    hg_return_t hret;
+    list_keyvals_range_in_t in;
+    list_keyvals_out_t out;
 
     out.ret     = SDSKV_SUCCESS;
     out.nkeys   = 0;
@@ -2155,7 +3253,7 @@ static void sdskv_list_keys_ult(hg_handle_t handle)
     sdskv_provider_t svr_ctx = 
         (sdskv_provider_t)margo_registered_data(mid, info->id);
     if(!svr_ctx) {
-        std::cerr << "Error (sdskv_list_keys_ult): SDSKV list_keys could not find provider" << std::endl;
+        std::cerr << "Error (sdskv_list_keyvals_range_ult): SDSKV list_keyvals_range could not find provider" << std::endl;
         out.ret = SDSKV_ERR_UNKNOWN_PR;
         margo_respond(handle, &out);
         margo_destroy(handle);
@@ -2165,7 +3263,7 @@ static void sdskv_list_keys_ult(hg_handle_t handle)
     /* get the input */
     hret = margo_get_input(handle, &in);
     if(hret != HG_SUCCESS) {
-        std::cerr << "Error: SDSKV list_keys could not get RPC input" << std::endl;
+        std::cerr << "Error: SDSKV list_keyvals_range could not get RPC input" << std::endl;
         out.ret = SDSKV_MAKE_HG_ERROR(hret);
         margo_respond(handle, &out);
         margo_destroy(handle);
@@ -2175,112 +3273,26 @@ static void sdskv_list_keys_ult(hg_handle_t handle)
     try {
 
         /* find the database targeted */
-        ABT_rwlock_rdlock(svr_ctx->lock);
-        auto it = svr_ctx->databases.find(in.db_id);
-        if(it == svr_ctx->databases.end()) {
-            std::cerr << "Error: SDSKV list_keys could not get database with id " << in.db_id << std::endl;
-            ABT_rwlock_unlock(svr_ctx->lock);
+        auto db = svr_ctx->databases.find(in.db_id);
+        if(!db) {
+            std::cerr << "Error: SDSKV list_keyvals_range could not get database with id " << in.db_id << std::endl;
             throw (int)SDSKV_ERR_UNKNOWN_DB;
         }
-        auto db = it->second;
-        ABT_rwlock_unlock(svr_ctx->lock);
-
-        /* create a bulk handle to receive and send key sizes from client */
-        std::vector<hg_size_t> ksizes(in.max_keys);
-        std::vector<void*> ksizes_addr(1);
-        ksizes_addr[0] = (void*)ksizes.data();
-        hg_size_t ksizes_bulk_size = ksizes.size()*sizeof(hg_size_t);
-        hret = margo_bulk_create(mid, 1, ksizes_addr.data(), 
-                &ksizes_bulk_size, HG_BULK_READWRITE, &ksizes_local_bulk);
-        if(hret != HG_SUCCESS) {
-            std::cerr << "Error: SDSKV list_keys could not create bulk handle (ksizes_local_bulk)" << std::endl;
-            throw (int)SDSKV_MAKE_HG_ERROR(hret);
-        }
-
-
-        /* receive the key sizes from the client */
-        hg_addr_t origin_addr = info->addr;
-        hret = margo_bulk_transfer(mid, HG_BULK_PULL, origin_addr,
-                in.ksizes_bulk_handle, 0, ksizes_local_bulk, 0, ksizes_bulk_size);
-        if(hret != HG_SUCCESS) {
-            std::cerr << "Error: SDSKV list_keys could not issue bulk transfer " 
-                << "(pull from in.ksizes_bulk_handle to ksizes_local_bulk)" << std::endl;
-            throw (int)SDSKV_MAKE_HG_ERROR(hret);
-        }
-
-        /* make a copy of the remote key sizes */
-        std::vector<hg_size_t> remote_ksizes(ksizes.begin(), ksizes.end());
-
-        /* get the keys from the underlying database */    
-        ds_bulk_t start_kdata(in.start_key.data, in.start_key.data+in.start_key.size);
-        ds_bulk_t prefix(in.prefix.data, in.prefix.data+in.prefix.size);
-        auto keys = db->list_keys(start_kdata, in.max_keys, prefix);
-        hg_size_t num_keys = std::min((size_t)keys.size(), (size_t)in.max_keys);
-
-        if(num_keys == 0) throw (int)SDSKV_SUCCESS;
-
-        /* create the array of actual sizes */
-        std::vector<hg_size_t> true_ksizes(num_keys);
-        hg_size_t keys_bulk_size = 0;
-        bool size_error = false;
-        for(unsigned i = 0; i < num_keys; i++) {
-            true_ksizes[i] = keys[i].size();
-            if(true_ksizes[i] > ksizes[i]) {
-                // this key has a size that exceeds the allocated size on client
-                size_error = true;
-            }
-            ksizes[i] = true_ksizes[i];
-            keys_bulk_size += ksizes[i];
-        }
-        for(unsigned i = num_keys; i < in.max_keys; i++) {
-            ksizes[i] = 0;
-        }
-        out.nkeys = num_keys;
-
-        /* transfer the ksizes back to the client */
-        hret = margo_bulk_transfer(mid, HG_BULK_PUSH, origin_addr, 
-                in.ksizes_bulk_handle, 0, ksizes_local_bulk, 0, ksizes_bulk_size);
-        if(hret != HG_SUCCESS) {
-            std::cerr << "Error: SDSKV list_keys could not issue bulk transfer "
-                << "(push from ksizes_local_bulk to in.ksizes_bulk_handle)" << std::endl;
-            throw (int)SDSKV_MAKE_HG_ERROR(hret);
-        }
-            
-        /* if user provided a size too small for some key, return error (we already set the right key sizes) */    
-        if(size_error)
-            throw (int)SDSKV_ERR_SIZE;
-
-        /* create an array of addresses pointing to keys */
-        std::vector<void*> keys_addr(num_keys);
-        for(unsigned i=0; i < num_keys; i++) {
-            keys_addr[i] = (void*)(keys[i].data());
-        }
-
-        /* expose the keys for bulk transfer */
-        hret = margo_bulk_create(mid, num_keys, keys_addr.data(),
-                true_ksizes.data(), HG_BULK_READ_ONLY, &keys_local_bulk);
-        if(hret != HG_SUCCESS) {
-            std::cerr << "Error: SDSKV list_keys could not create bulk handle (keys_local_bulk)" << std::endl;
-            throw (int)SDSKV_MAKE_HG_ERROR(hret);
-        }
-
-        /* transfer the keys to the client */
-        uint64_t remote_offset = 0;
-        uint64_t local_offset  = 0;
-        for(unsigned i = 0; i < num_keys; i++) {
 
-            if(true_ksizes[i] > 0) {
-                hret = margo_bulk_transfer(mid, HG_BULK_PUSH, origin_addr,
-                        in.keys_bulk_handle, remote_offset, keys_local_bulk, local_offset, true_ksizes[i]);
-                if(hret != HG_SUCCESS) {
-                    std::cerr << "Error: SDSKV list_keys could not issue bulk transfer (keys_local_bulk)" << std::endl;
-                    throw (int)SDSKV_MAKE_HG_ERROR(hret);
-                }
-            }
-
-            remote_offset += remote_ksizes[i];
-            local_offset  += true_ksizes[i];
-        }
+        /* get the keys and values in [lower_bound, upper_bound) from the underlying database */
+        ds_bulk_t lower_bound(in.lower_bound.data, in.lower_bound.data+in.lower_bound.size);
+        ds_bulk_t upper_bound(in.upper_bound.data, in.upper_bound.data+in.upper_bound.size);
+        std::vector<std::pair<ds_bulk_t,ds_bulk_t>> keyvals;
+        sdskv_run_in_pool(db.pool(SDSKV_OP_CLASS_SCAN), [&]() {
+            keyvals = db->list_keyval_range(lower_bound, upper_bound, in.max_keys);
+        });
+        if(keyvals.size() > in.max_keys) keyvals.resize(in.max_keys);
+        out.nkeys = keyvals.size();
+
+        /* send the keys and values to the client */
+        sdskv_push_keyvals(mid, info->addr, keyvals, in.max_keys,
+                in.ksizes_bulk_handle, in.keys_bulk_handle,
+                in.vsizes_bulk_handle, in.vals_bulk_handle);
 
         out.ret = SDSKV_SUCCESS;
 
@@ -2288,34 +3300,26 @@ static void sdskv_list_keys_ult(hg_handle_t handle)
         out.ret = exc_no;
     }
 
-    margo_bulk_free(ksizes_local_bulk);
-    margo_bulk_free(keys_local_bulk);
     margo_respond(handle, &out);
     margo_free_input(handle, &in);
     margo_destroy(handle); 
 
     return;
 }
-DEFINE_MARGO_RPC_HANDLER(sdskv_list_keys_ult)
+DEFINE_MARGO_RPC_HANDLER(sdskv_list_keyvals_range_ult)
 
-static void sdskv_list_keyvals_ult(hg_handle_t handle)
+static void sdskv_list_packed_ult(hg_handle_t handle)
 {
-
     hg_return_t hret;
-    list_keyvals_in_t in;
-    list_keyvals_out_t out;
-    hg_bulk_t ksizes_local_bulk = HG_BULK_NULL;
-    hg_bulk_t keys_local_bulk   = HG_BULK_NULL;
-    hg_bulk_t vsizes_local_bulk = HG_BULK_NULL;
-    hg_bulk_t vals_local_bulk   = HG_BULK_NULL;
-    double start, end;
-    size_t true_data_size;
-    size_t true_num_keys;
+    list_packed_in_t in;
+    list_packed_out_t out;
+    out.ret   = SDSKV_SUCCESS;
+    out.nkeys = 0;
+    out.size  = 0;
 
-    out.ret     = SDSKV_SUCCESS;
-    out.nkeys   = 0;
+    auto r0 = at_exit([&handle]() { margo_destroy(handle); });
+    auto r1 = at_exit([&handle,&out]() { margo_respond(handle, &out); });
 
-    start = ABT_get_wtime();
     /* get the provider handling this request */
     margo_instance_id mid = margo_hg_handle_get_instance(handle);
     assert(mid);
@@ -2323,243 +3327,379 @@ static void sdskv_list_keyvals_ult(hg_handle_t handle)
     sdskv_provider_t svr_ctx = 
         (sdskv_provider_t)margo_registered_data(mid, info->id);
     if(!svr_ctx) {
-        std::cerr << "Error (sdskv_list_keyvals_ult): SDSKV list_keyvals could not find provider" << std::endl;
+        std::cerr << "Error (sdskv_list_packed_ult): SDSKV list_packed could not find provider" << std::endl;
         out.ret = SDSKV_ERR_UNKNOWN_PR;
-        margo_respond(handle, &out);
-        margo_destroy(handle);
         return;
     }
 
     /* get the input */
     hret = margo_get_input(handle, &in);
     if(hret != HG_SUCCESS) {
-        std::cerr << "Error: SDSKV list_keyvals could not get RPC input" << std::endl;
+        std::cerr << "Error: SDSKV list_packed could not get RPC input" << std::endl;
         out.ret = SDSKV_MAKE_HG_ERROR(hret);
-        margo_respond(handle, &out);
-        margo_destroy(handle);
         return;
     }
+    auto r2 = at_exit([&handle,&in]() { margo_free_input(handle, &in); });
 
-    try {
+    /* find the database targeted */
+    auto db = svr_ctx->databases.find(in.db_id);
+    if(!db) {
+        std::cerr << "Error: SDSKV list_packed could not get database with id " << in.db_id << std::endl;
+        out.ret = SDSKV_ERR_UNKNOWN_DB;
+        return;
+    }
 
-        /* find the database targeted */
-        ABT_rwlock_rdlock(svr_ctx->lock);
-        auto it = svr_ctx->databases.find(in.db_id);
-        if(it == svr_ctx->databases.end()) {
-            std::cerr << "Error: SDSKV list_keyvals could not get database with id " << in.db_id << std::endl;
-            ABT_rwlock_unlock(svr_ctx->lock);
-            throw (int)SDSKV_ERR_UNKNOWN_DB;
-        }
-        auto db = it->second;
-        ABT_rwlock_unlock(svr_ctx->lock);
+    ds_bulk_t start_kdata(in.start_key.data, in.start_key.data+in.start_key.size);
+    ds_bulk_t prefix(in.prefix.data, in.prefix.data+in.prefix.size);
 
-        /* create a bulk handle to receive and send key sizes from client */
-        std::vector<hg_size_t> ksizes(in.max_keys);
-        std::vector<void*> ksizes_addr(1);
-        ksizes_addr[0] = (void*)ksizes.data();
-        hg_size_t ksizes_bulk_size = ksizes.size()*sizeof(hg_size_t);
-        hret = margo_bulk_create(mid, 1, ksizes_addr.data(), 
-                &ksizes_bulk_size, HG_BULK_READWRITE, &ksizes_local_bulk);
-        if(hret != HG_SUCCESS) {
-            std::cerr << "Error: SDSKV list_keyvals could not create bulk handle (ksizes_local_bulk)" << std::endl;
-            throw (int)SDSKV_MAKE_HG_ERROR(hret);
+    /* read entries from the database by batches until the client's buffer
+     * (or max_keys, if not 0) is full; the first entry that does not fit
+     * and the rest of its batch are discarded */
+    std::vector<std::pair<ds_bulk_t,ds_bulk_t>> keyvals;
+    hg_size_t num_sizes   = in.with_values ? 2 : 1;
+    hg_size_t num_keys    = 0;
+    hg_size_t packed_size = 0;
+    bool full = false;
+    try {
+        while(!full) {
+            hg_size_t batch_size = SDSKV_LIST_PACKED_BATCH_SIZE;
+            if(in.max_keys != 0)
+                batch_size = std::min<hg_size_t>(batch_size, in.max_keys - num_keys);
+            const ds_bulk_t& last_key = keyvals.empty() ? start_kdata : keyvals.back().first;
+            std::vector<std::pair<ds_bulk_t,ds_bulk_t>> batch;
+            sdskv_run_in_pool(db.pool(SDSKV_OP_CLASS_SCAN), [&]() {
+                if(in.with_values) {
+                    batch = db->list_keyvals(last_key, batch_size, prefix);
+                } else {
+                    auto keys = db->list_keys(last_key, batch_size, prefix);
+                    batch.resize(keys.size());
+                    for(unsigned i = 0; i < keys.size(); i++)
+                        batch[i].first = std::move(keys[i]);
+                }
+            });
+            if(batch.size() > batch_size) batch.resize(batch_size);
+            for(auto& kv : batch) {
+                hg_size_t entry_size = num_sizes*sizeof(hg_size_t) + kv.first.size() + kv.second.size();
+                if(packed_size + entry_size > in.bulk_size) {
+                    if(num_keys == 0) {
+                        /* tell the client how large the buffer must be for the first entry */
+                        out.size = entry_size;
+                        out.ret  = SDSKV_ERR_SIZE;
+                        return;
+                    }
+                    full = true;
+                    break;
+                }
+                packed_size += entry_size;
+                num_keys += 1;
+                keyvals.push_back(std::move(kv));
+            }
+            if(batch.size() < batch_size
+            || (in.max_keys != 0 && num_keys == in.max_keys))
+                full = true;
         }
+    } catch(int exc_no) {
+        out.ret = exc_no;
+        return;
+    }
+    if(num_keys == 0) return;
 
-        /* create a bulk handle to receive and send value sizes from client */
-        std::vector<hg_size_t> vsizes(in.max_keys);
-        std::vector<void*> vsizes_addr(1);
-        vsizes_addr[0] = (void*)vsizes.data();
-        hg_size_t vsizes_bulk_size = vsizes.size()*sizeof(hg_size_t);
-        hret = margo_bulk_create(mid, 1, vsizes_addr.data(), 
-                &vsizes_bulk_size, HG_BULK_READWRITE, &vsizes_local_bulk);
-        if(hret != HG_SUCCESS) {
-            std::cerr << "Error: SDSKV list_keyvals could not create bulk handle (vsizes_local_bulk)" << std::endl;
-            throw (int)SDSKV_MAKE_HG_ERROR(hret);
+    /* pack [ksizes][vsizes][keys][values] in a contiguous buffer */
+    std::vector<char> packed(packed_size);
+    hg_size_t* ksizes = (hg_size_t*)packed.data();
+    hg_size_t* vsizes = ksizes + num_keys;
+    char* data = packed.data() + num_sizes*num_keys*sizeof(hg_size_t);
+    for(unsigned i = 0; i < num_keys; i++) {
+        ksizes[i] = keyvals[i].first.size();
+        memcpy(data, keyvals[i].first.data(), ksizes[i]);
+        data += ksizes[i];
+    }
+    if(in.with_values) {
+        for(unsigned i = 0; i < num_keys; i++) {
+            vsizes[i] = keyvals[i].second.size();
+            memcpy(data, keyvals[i].second.data(), vsizes[i]);
+            data += vsizes[i];
         }
+    }
 
-        /* receive the key sizes from the client */
-        hg_addr_t origin_addr = info->addr;
-        hret = margo_bulk_transfer(mid, HG_BULK_PULL, origin_addr,
-                in.ksizes_bulk_handle, 0, ksizes_local_bulk, 0, ksizes_bulk_size);
-        if(hret != HG_SUCCESS) {
-            std::cerr << "Error: SDSKV list_keyvals could not issue bulk transfer " 
-                << "(pull from in.ksizes_bulk_handle to ksizes_local_bulk)" << std::endl;
-            throw (int)SDSKV_MAKE_HG_ERROR(hret);
-        }
+    /* send everything with a single transfer */
+    hg_bulk_t local_bulk = HG_BULK_NULL;
+    void* buf_ptrs[1] = { (void*)packed.data() };
+    hret = margo_bulk_create(mid, 1, buf_ptrs, &packed_size, HG_BULK_READ_ONLY, &local_bulk);
+    if(hret != HG_SUCCESS) {
+        std::cerr << "Error: SDSKV list_packed could not create bulk handle" << std::endl;
+        out.ret = SDSKV_MAKE_HG_ERROR(hret);
+        return;
+    }
+    auto r3 = at_exit([&local_bulk]() { margo_bulk_free(local_bulk); });
 
-        /* receive the values sizes from the client */
-        hret = margo_bulk_transfer(mid, HG_BULK_PULL, origin_addr,
-                in.vsizes_bulk_handle, 0, vsizes_local_bulk, 0, vsizes_bulk_size);
-        if(hret != HG_SUCCESS) {
-            std::cerr << "Error: SDSKV list_keyvals could not issue bulk transfer " 
-                << "(pull from in.vsizes_bulk_handle to vsizes_local_bulk)" << std::endl;
-            throw (int)SDSKV_MAKE_HG_ERROR(hret);
-        }
+    hret = margo_bulk_transfer(mid, HG_BULK_PUSH, info->addr,
+            in.bulk_handle, 0, local_bulk, 0, packed_size);
+    if(hret != HG_SUCCESS) {
+        std::cerr << "Error: SDSKV list_packed could not issue bulk transfer" << std::endl;
+        out.ret = SDSKV_MAKE_HG_ERROR(hret);
+        return;
+    }
 
-        /* make a copy of the remote key sizes and value sizes */
-        std::vector<hg_size_t> remote_ksizes(ksizes.begin(), ksizes.end());
-        std::vector<hg_size_t> remote_vsizes(vsizes.begin(), vsizes.end());
+    out.nkeys = num_keys;
+    out.size  = packed_size;
+}
+DEFINE_MARGO_RPC_HANDLER(sdskv_list_packed_ult)
 
-        /* get the keys and values from the underlying database */    
-        ds_bulk_t start_kdata(in.start_key.data, in.start_key.data+in.start_key.size);
-        ds_bulk_t prefix(in.prefix.data, in.prefix.data+in.prefix.size);
-#ifdef USE_SYMBIOMON
-    symbiomon_metric_update_gauge_by_fixed_amount(svr_ctx->listkeyvals_num_entrants, 1);
-#endif
-        auto keyvals = db->list_keyvals(start_kdata, in.max_keys, prefix);
-#ifdef USE_SYMBIOMON
-    symbiomon_metric_update_gauge_by_fixed_amount(svr_ctx->listkeyvals_num_entrants, -1);
-#endif
-        hg_size_t num_keys = std::min((size_t)keyvals.size(), (size_t)in.max_keys);
+/* Destroys the sessions that have not been used during their lease.
+ * Must be called with provider->cursors_mutex locked. */
+static void sdskv_expire_cursors(sdskv_provider_t provider)
+{
+    double now = ABT_get_wtime();
+    for(auto it = provider->cursors.begin(); it != provider->cursors.end(); ) {
+        if(now - it->second->last_access > it->second->lease)
+            it = provider->cursors.erase(it);
+        else
+            it++;
+    }
+}
 
-        out.nkeys = num_keys;
+/* Destroys the sessions opened on a database that is being removed.
+ * In-flight operations keep their session alive until they complete. */
+static void sdskv_close_database_cursors(sdskv_provider_t provider, sdskv_database_id_t db_id)
+{
+    ABT_mutex_lock(provider->cursors_mutex);
+    for(auto it = provider->cursors.begin(); it != provider->cursors.end(); ) {
+        if(it->second->db_id == db_id)
+            it = provider->cursors.erase(it);
+        else
+            it++;
+    }
+    ABT_mutex_unlock(provider->cursors_mutex);
+}
 
-        if(num_keys == 0) throw (int)SDSKV_SUCCESS;
+static void sdskv_cursor_prefetch_ult(void* arg)
+{
+    sdskv_cursor_session* session = (sdskv_cursor_session*)arg;
+    try {
+        session->fill(session->prefetch_size);
+    } catch(int exc_no) {
+        session->prefetch_ret = exc_no;
+    }
+}
 
-        bool size_error = false;
+static void sdskv_open_cursor_ult(hg_handle_t handle)
+{
+    hg_return_t hret;
+    open_cursor_in_t in;
+    open_cursor_out_t out;
+    out.ret = SDSKV_SUCCESS;
+    out.cursor_id = 0;
 
-        /* create the array of actual key sizes */
-        std::vector<hg_size_t> true_ksizes(num_keys);
-        hg_size_t keys_bulk_size = 0;
-        for(unsigned i = 0; i < num_keys; i++) {
-            true_ksizes[i] = keyvals[i].first.size();
-            if(true_ksizes[i] > ksizes[i]) {
-                // this key has a size that exceeds the allocated size on client
-                size_error = true;
-            } 
-            ksizes[i] = true_ksizes[i];
-            keys_bulk_size += ksizes[i];
-        }
-        for(unsigned i = num_keys; i < ksizes.size(); i++) ksizes[i] = 0;
+    auto r0 = at_exit([&handle]() { margo_destroy(handle); });
+    auto r1 = at_exit([&handle,&out]() { margo_respond(handle, &out); });
 
-        /* create the array of actual value sizes */
-        std::vector<hg_size_t> true_vsizes(num_keys);
-        hg_size_t vals_bulk_size = 0;
-        for(unsigned i = 0; i < num_keys; i++) {
-            true_vsizes[i] = keyvals[i].second.size();
-            if(true_vsizes[i] > vsizes[i]) {
-                // this value has a size that exceeds the allocated size on client
-                size_error = true;
-            }
-            vsizes[i] = true_vsizes[i];
-            vals_bulk_size += vsizes[i];
-        }
-        for(unsigned i = num_keys; i < vsizes.size(); i++) vsizes[i] = 0;
+    /* get the provider handling this request */
+    margo_instance_id mid = margo_hg_handle_get_instance(handle);
+    assert(mid);
+    const struct hg_info* info = margo_get_info(handle);
+    sdskv_provider_t svr_ctx = 
+        (sdskv_provider_t)margo_registered_data(mid, info->id);
+    if(!svr_ctx) {
+        std::cerr << "Error (sdskv_open_cursor_ult): SDSKV open_cursor could not find provider" << std::endl;
+        out.ret = SDSKV_ERR_UNKNOWN_PR;
+        return;
+    }
 
-        /* transfer the ksizes back to the client */
-        if(ksizes_bulk_size) {
-            hret = margo_bulk_transfer(mid, HG_BULK_PUSH, origin_addr, 
-                in.ksizes_bulk_handle, 0, ksizes_local_bulk, 0, ksizes_bulk_size);
-            if(hret != HG_SUCCESS) {
-                std::cerr << "Error: SDSKV list_keyvals could not issue bulk transfer "
-                    << "(push from ksizes_local_bulk to in.ksizes_bulk_handle)" << std::endl;
-                throw (int)SDSKV_MAKE_HG_ERROR(hret);
-            }
-        }
+    /* get the input */
+    hret = margo_get_input(handle, &in);
+    if(hret != HG_SUCCESS) {
+        std::cerr << "Error: SDSKV open_cursor could not get RPC input" << std::endl;
+        out.ret = SDSKV_MAKE_HG_ERROR(hret);
+        return;
+    }
+    auto r2 = at_exit([&handle,&in]() { margo_free_input(handle, &in); });
 
-        /* transfer the vsizes back to the client */
-        if(vsizes_bulk_size) {
-            hret = margo_bulk_transfer(mid, HG_BULK_PUSH, origin_addr, 
-                in.vsizes_bulk_handle, 0, vsizes_local_bulk, 0, vsizes_bulk_size);
-            if(hret != HG_SUCCESS) {
-                std::cerr << "Error: SDSKV list_keyvals could not issue bulk transfer "
-                    << "(push from vsizes_local_bulk to in.vsizes_bulk_handle)" << std::endl;
-                throw (int)SDSKV_MAKE_HG_ERROR(hret);
-            }
-        }
+    /* find the database targeted */
+    auto db = svr_ctx->databases.find(in.db_id);
+    if(!db) {
+        std::cerr << "Error: SDSKV open_cursor could not get database with id " << in.db_id << std::endl;
+        out.ret = SDSKV_ERR_UNKNOWN_DB;
+        return;
+    }
 
-        if(size_error)
-            throw (int)SDSKV_ERR_SIZE;
+    ds_bulk_t start_kdata(in.start_key.data, in.start_key.data+in.start_key.size);
+    ds_bulk_t prefix(in.prefix.data, in.prefix.data+in.prefix.size);
 
-        /* create an array of addresses pointing to keys */
-        std::vector<void*> keys_addr(num_keys);
-        for(unsigned i=0; i < num_keys; i++) {
-            keys_addr[i] = (void*)(keyvals[i].first.data());
-        }
+    auto session = std::make_shared<sdskv_cursor_session>();
+    session->db_id = in.db_id;
+    session->lease = (in.lease_ms ? in.lease_ms : SDSKV_DEFAULT_CURSOR_LEASE_MS) / 1000.0;
+    session->last_access = ABT_get_wtime();
+    try {
+        sdskv_run_in_pool(db.pool(SDSKV_OP_CLASS_SCAN), [&]() {
+            session->cursor = db->open_cursor(start_kdata, prefix);
+        });
+    } catch(int exc_no) {
+        out.ret = exc_no;
+        return;
+    }
+    session->db = std::move(db);
 
-        /* create an array of addresses pointing to values */
-        std::vector<void*> vals_addr(num_keys);
-        for(unsigned i=0; i < num_keys; i++) {
-            vals_addr[i] = (void*)(keyvals[i].second.data());
-        }
+    ABT_mutex_lock(svr_ctx->cursors_mutex);
+    sdskv_expire_cursors(svr_ctx);
+    /* the database may have been removed, after its sessions were closed */
+    if(!svr_ctx->databases.find(in.db_id)) {
+        ABT_mutex_unlock(svr_ctx->cursors_mutex);
+        out.ret = SDSKV_ERR_UNKNOWN_DB;
+        return;
+    }
+    out.cursor_id = svr_ctx->next_cursor_id++;
+    svr_ctx->cursors[out.cursor_id] = session;
+    ABT_mutex_unlock(svr_ctx->cursors_mutex);
+}
+DEFINE_MARGO_RPC_HANDLER(sdskv_open_cursor_ult)
 
-        /* expose the keys for bulk transfer */
-        hret = margo_bulk_create(mid, num_keys, keys_addr.data(),
-                true_ksizes.data(), HG_BULK_READ_ONLY, &keys_local_bulk);
-        if(hret != HG_SUCCESS) {
-            std::cerr << "Error: SDSKV list_keyvals could not create bulk handle (keys_local_bulk)" << std::endl;
-            throw (int)SDSKV_MAKE_HG_ERROR(hret);
-        }
+static void sdskv_cursor_next_ult(hg_handle_t handle)
+{
+    hg_return_t hret;
+    cursor_next_in_t in;
+    cursor_next_out_t out;
+    out.ret   = SDSKV_SUCCESS;
+    out.nkeys = 0;
 
-        /* expose the values for bulk transfer */
-        hret = margo_bulk_create(mid, num_keys, vals_addr.data(),
-                true_vsizes.data(), HG_BULK_READ_ONLY, &vals_local_bulk);
-        if(hret != HG_SUCCESS) {
-            std::cerr << "Error: SDSKV list_keyvals could not create bulk handle (vals_local_bulk)" << std::endl;
-            throw (int)SDSKV_MAKE_HG_ERROR(hret);
-        }
+    auto r0 = at_exit([&handle]() { margo_destroy(handle); });
+    auto r1 = at_exit([&handle,&out]() { margo_respond(handle, &out); });
+
+    /* get the provider handling this request */
+    margo_instance_id mid = margo_hg_handle_get_instance(handle);
+    assert(mid);
+    const struct hg_info* info = margo_get_info(handle);
+    sdskv_provider_t svr_ctx = 
+        (sdskv_provider_t)margo_registered_data(mid, info->id);
+    if(!svr_ctx) {
+        std::cerr << "Error (sdskv_cursor_next_ult): SDSKV cursor_next could not find provider" << std::endl;
+        out.ret = SDSKV_ERR_UNKNOWN_PR;
+        return;
+    }
+
+    /* get the input */
+    hret = margo_get_input(handle, &in);
+    if(hret != HG_SUCCESS) {
+        std::cerr << "Error: SDSKV cursor_next could not get RPC input" << std::endl;
+        out.ret = SDSKV_MAKE_HG_ERROR(hret);
+        return;
+    }
+    auto r2 = at_exit([&handle,&in]() { margo_free_input(handle, &in); });
 
+    /* find the session */
+    std::shared_ptr<sdskv_cursor_session> session;
+    ABT_mutex_lock(svr_ctx->cursors_mutex);
+    sdskv_expire_cursors(svr_ctx);
+    auto it = svr_ctx->cursors.find(in.cursor_id);
+    if(it != svr_ctx->cursors.end()) {
+        session = it->second;
+        session->last_access = ABT_get_wtime();
+    }
+    ABT_mutex_unlock(svr_ctx->cursors_mutex);
+    if(!session) {
+        out.ret = SDSKV_ERR_UNKNOWN_CURSOR;
+        return;
+    }
 
-        uint64_t remote_offset = 0;
-        uint64_t local_offset  = 0;
+    ABT_mutex_lock(session->mutex);
+    auto r3 = at_exit([&session]() { ABT_mutex_unlock(session->mutex); });
 
-        /* transfer the keys to the client */
-        for(unsigned i=0; i < num_keys; i++) {
-            if(true_ksizes[i] > 0) {
-                hret = margo_bulk_transfer(mid, HG_BULK_PUSH, origin_addr,
-                        in.keys_bulk_handle, remote_offset, keys_local_bulk, local_offset, true_ksizes[i]);
-                if(hret != HG_SUCCESS) {
-                    std::cerr << "Error: SDSKV list_keyvals could not issue bulk transfer (keys_local_bulk)" << std::endl;
-                    throw (int)SDSKV_MAKE_HG_ERROR(hret);
-                }
-            }
-            remote_offset += remote_ksizes[i];
-            local_offset  += true_ksizes[i];
+    std::vector<std::pair<ds_bulk_t,ds_bulk_t>> batch;
+    try {
+        /* complete the batch prefetched after the previous call, if any */
+        session->wait_prefetch();
+        if(session->prefetch_ret != SDSKV_SUCCESS) {
+            int ret = session->prefetch_ret;
+            session->prefetch_ret = SDSKV_SUCCESS;
+            throw ret;
+        }
+        if(session->pending.size() < in.max_keys) {
+            sdskv_run_in_pool(session->db.pool(SDSKV_OP_CLASS_SCAN), [&]() {
+                session->fill(in.max_keys - session->pending.size());
+            });
         }
 
-        remote_offset = 0;
-        local_offset  = 0;
-
-        /* transfer the values to the client */
-        for(unsigned i=0; i < num_keys; i++) {
-            if(true_vsizes[i] > 0) {
-                hret = margo_bulk_transfer(mid, HG_BULK_PUSH, origin_addr,
-                        in.vals_bulk_handle, remote_offset, vals_local_bulk, local_offset, true_vsizes[i]);
-                if(hret != HG_SUCCESS) {
-                    std::cerr << "Error: SDSKV list_keyvals could not issue bulk transfer (vals_local_bulk)" << std::endl;
-                    throw (int)SDSKV_MAKE_HG_ERROR(hret);
-                }
-            }
-            remote_offset += remote_vsizes[i];
-            local_offset  += true_vsizes[i];
+        hg_size_t n = std::min((size_t)in.max_keys, session->pending.size());
+        batch.reserve(n);
+        std::move(session->pending.begin(), session->pending.begin()+n, std::back_inserter(batch));
+        session->pending.erase(session->pending.begin(), session->pending.begin()+n);
+        out.nkeys = n;
+
+        /* fetch the next batch while this one is sent to the client */
+        if(!session->at_end) {
+            session->prefetch_size = in.max_keys;
+            ABT_pool prefetch_pool = session->db.pool(SDSKV_OP_CLASS_SCAN);
+            if(prefetch_pool == ABT_POOL_NULL)
+                prefetch_pool = svr_ctx->pool;
+            int ret = ABT_thread_create(prefetch_pool, sdskv_cursor_prefetch_ult,
+                    session.get(), ABT_THREAD_ATTR_NULL, &session->prefetch_ult);
+            if(ret != ABT_SUCCESS)
+                session->prefetch_ult = ABT_THREAD_NULL; // next call will fetch it
         }
 
-        out.ret = SDSKV_SUCCESS;
-        true_data_size = keys_bulk_size + vals_bulk_size;
-        true_num_keys = num_keys;
+        sdskv_push_keyvals(mid, info->addr, batch, in.max_keys,
+                in.ksizes_bulk_handle, in.keys_bulk_handle,
+                in.vsizes_bulk_handle, in.vals_bulk_handle);
 
     } catch(int exc_no) {
         out.ret = exc_no;
+        /* put the entries back so that the client can retry, e.g.
+         * with larger buffers if the error is SDSKV_ERR_SIZE */
+        if(!batch.empty()) {
+            session->wait_prefetch();
+            session->pending.insert(session->pending.begin(),
+                    std::make_move_iterator(batch.begin()),
+                    std::make_move_iterator(batch.end()));
+        }
     }
+}
+DEFINE_MARGO_RPC_HANDLER(sdskv_cursor_next_ult)
 
-    margo_bulk_free(ksizes_local_bulk);
-    margo_bulk_free(keys_local_bulk);
-    margo_bulk_free(vsizes_local_bulk);
-    margo_bulk_free(vals_local_bulk);
-    margo_respond(handle, &out);
-    margo_free_input(handle, &in);
-    margo_destroy(handle); 
+static void sdskv_close_cursor_ult(hg_handle_t handle)
+{
+    hg_return_t hret;
+    close_cursor_in_t in;
+    close_cursor_out_t out;
+    out.ret = SDSKV_SUCCESS;
 
-    end = ABT_get_wtime();
-#ifdef USE_SYMBIOMON
-    symbiomon_metric_update(svr_ctx->listkeyvals_latency, (end-start));
-    symbiomon_metric_update(svr_ctx->listkeyvals_data_size, (double)true_data_size);
-    symbiomon_metric_update(svr_ctx->listkeyvals_batch_size, (double)true_num_keys);
-#endif 
+    auto r0 = at_exit([&handle]() { margo_destroy(handle); });
+    auto r1 = at_exit([&handle,&out]() { margo_respond(handle, &out); });
 
-    return;
+    /* get the provider handling this request */
+    margo_instance_id mid = margo_hg_handle_get_instance(handle);
+    assert(mid);
+    const struct hg_info* info = margo_get_info(handle);
+    sdskv_provider_t svr_ctx = 
+        (sdskv_provider_t)margo_registered_data(mid, info->id);
+    if(!svr_ctx) {
+        std::cerr << "Error (sdskv_close_cursor_ult): SDSKV close_cursor could not find provider" << std::endl;
+        out.ret = SDSKV_ERR_UNKNOWN_PR;
+        return;
+    }
+
+    /* get the input */
+    hret = margo_get_input(handle, &in);
+    if(hret != HG_SUCCESS) {
+        std::cerr << "Error: SDSKV close_cursor could not get RPC input" << std::endl;
+        out.ret = SDSKV_MAKE_HG_ERROR(hret);
+        return;
+    }
+    auto r2 = at_exit([&handle,&in]() { margo_free_input(handle, &in); });
+
+    /* the session is destroyed (waiting for its prefetch ULT) once
+     * any operation still using it has completed */
+    std::shared_ptr<sdskv_cursor_session> session;
+    ABT_mutex_lock(svr_ctx->cursors_mutex);
+    auto it = svr_ctx->cursors.find(in.cursor_id);
+    if(it == svr_ctx->cursors.end()) {
+        out.ret = SDSKV_ERR_UNKNOWN_CURSOR;
+    } else {
+        session = std::move(it->second);
+        svr_ctx->cursors.erase(it);
+    }
+    ABT_mutex_unlock(svr_ctx->cursors_mutex);
 }
-DEFINE_MARGO_RPC_HANDLER(sdskv_list_keyvals_ult)
+DEFINE_MARGO_RPC_HANDLER(sdskv_close_cursor_ult)
 
 static void sdskv_migrate_keys_ult(hg_handle_t handle)
 {
@@ -2589,15 +3729,11 @@ static void sdskv_migrate_keys_ult(hg_handle_t handle)
     }
     auto r2 = at_exit([&handle,&in]() { margo_free_input(handle, &in); });
     /* find the source database */
-    ABT_rwlock_rdlock(provider->lock);
-    auto it = provider->databases.find(in.source_db_id);
-    if(it == provider->databases.end()) {
-        ABT_rwlock_unlock(provider->lock);
+    auto database = provider->databases.find(in.source_db_id);
+    if(!database) {
         out.ret = SDSKV_ERR_UNKNOWN_DB;
         return;
     }
-    auto database = it->second;
-    ABT_rwlock_unlock(provider->lock);
     /* lookup the address of the target provider */
     hg_addr_t target_addr = HG_ADDR_NULL;
     hret = margo_addr_lookup(mid, in.target_addr, &target_addr);
@@ -2606,18 +3742,15 @@ static void sdskv_migrate_keys_ult(hg_handle_t handle)
         return;
     }
 
-    /* create the bulk buffer to receive the keys */
-    char *buffer = (char*)malloc(in.bulk_size);
-    auto r4 = at_exit([&buffer]() { free(buffer); });
-    hg_size_t bulk_size = in.bulk_size;
-    hg_bulk_t bulk_handle = HG_BULK_NULL;
-    hret = margo_bulk_create(mid, 1, (void**)&buffer, &bulk_size,
-            HG_BULK_WRITE_ONLY, &bulk_handle);
+    /* get a registered buffer to receive the keys */
+    BulkBufferPool::buffer local_buffer;
+    hret = provider->bulk_pool->get(in.bulk_size, local_buffer);
     if(hret != HG_SUCCESS) {
         out.ret = SDSKV_MAKE_HG_ERROR(hret);
         return;
     }
-    auto r5 = at_exit([&bulk_handle]() { margo_bulk_free(bulk_handle); });
+    char* buffer = local_buffer.data();
+    hg_bulk_t bulk_handle = local_buffer.bulk();
 
     /* issue a bulk pull */
     hret = margo_bulk_transfer(mid, HG_BULK_PULL, info->addr, in.keys_bulk, 0,
@@ -2649,15 +3782,17 @@ static void sdskv_migrate_keys_ult(hg_handle_t handle)
         size_t size = seg_sizes[i]; 
         offset += size;
 
-        ds_bulk_t kdata(key, key+size);
         ds_bulk_t vdata;
-        auto b = database->get(kdata, vdata);
+        bool b = false;
+        sdskv_run_in_pool(database.pool(SDSKV_OP_CLASS_MIGRATION), [&]() {
+            b = database->get(key, size, vdata);
+        });
         if(!b) continue;
 
         /* issue a "put" for that key */
         put_in.db_id      = in.target_db_id;
-        put_in.key.data   = (kv_ptr_t)kdata.data();
-        put_in.key.size   = kdata.size();
+        put_in.key.data   = (kv_ptr_t)key;
+        put_in.key.size   = size;
         put_in.value.data = (kv_ptr_t)vdata.data();
         put_in.value.size = vdata.size();
         /* forward put call */
@@ -2675,7 +3810,10 @@ static void sdskv_migrate_keys_ult(hg_handle_t handle)
         margo_free_output(put_handle, &out);
         /* remove the key if needed */
         if(in.flag == SDSKV_REMOVE_ORIGINAL) {
-            database->erase(kdata);
+            sdskv_run_in_pool(database.pool(SDSKV_OP_CLASS_MIGRATION), [&]() {
+                database->erase(key, size);
+            });
+            database.written();
         }
     }
 }
@@ -2754,15 +3892,11 @@ static void sdskv_migrate_keys_prefixed_ult(hg_handle_t handle)
     /* need to destroy the input at exit */
     auto r2 = at_exit([&handle,&in]() { margo_free_input(handle, &in); });
     /* find the source database */
-    ABT_rwlock_rdlock(provider->lock);
-    auto it = provider->databases.find(in.source_db_id);
-    if(it == provider->databases.end()) {
-        ABT_rwlock_unlock(provider->lock);
+    auto database = provider->databases.find(in.source_db_id);
+    if(!database) {
         out.ret = SDSKV_ERR_UNKNOWN_DB;
         return;
     }
-    auto database = it->second;
-    ABT_rwlock_unlock(provider->lock);
     /* lookup the address of the target provider */
     hg_addr_t target_addr = HG_ADDR_NULL;
     hret = margo_addr_lookup(mid, in.target_addr, &target_addr);
@@ -2788,7 +3922,9 @@ static void sdskv_migrate_keys_prefixed_ult(hg_handle_t handle)
     ds_bulk_t prefix(in.key_prefix.data, in.key_prefix.data + in.key_prefix.size);
     do {
         try {
-            batch = database->list_keyvals(start_key, 64, prefix);
+            sdskv_run_in_pool(database.pool(SDSKV_OP_CLASS_MIGRATION), [&]() {
+                batch = database->list_keyvals(start_key, 64, prefix);
+            });
         } catch(int err) {
             out.ret = err;
             return;
@@ -2819,7 +3955,10 @@ static void sdskv_migrate_keys_prefixed_ult(hg_handle_t handle)
             margo_free_output(put_handle, &out);
             /* remove the key if needed */
             if(in.flag == SDSKV_REMOVE_ORIGINAL) {
-                database->erase(kv.first);
+                sdskv_run_in_pool(database.pool(SDSKV_OP_CLASS_MIGRATION), [&]() {
+                    database->erase(kv.first);
+                });
+                database.written();
             }
         }
         /* if original is removed, start_key can stay empty since we
@@ -2863,15 +4002,11 @@ static void sdskv_migrate_all_keys_ult(hg_handle_t handle)
     /* need to destroy the input at exit */
     auto r2 = at_exit([&handle,&in]() { margo_free_input(handle, &in); });
     /* find the source database */
-    ABT_rwlock_rdlock(provider->lock);
-    auto it = provider->databases.find(in.source_db_id);
-    if(it == provider->databases.end()) {
-        ABT_rwlock_unlock(provider->lock);
+    auto database = provider->databases.find(in.source_db_id);
+    if(!database) {
         out.ret = SDSKV_ERR_UNKNOWN_DB;
         return;
     }
-    auto database = it->second;
-    ABT_rwlock_unlock(provider->lock);
     /* lookup the address of the target provider */
     hg_addr_t target_addr = HG_ADDR_NULL;
     hret = margo_addr_lookup(mid, in.target_addr, &target_addr);
@@ -2896,7 +4031,9 @@ static void sdskv_migrate_all_keys_ult(hg_handle_t handle)
     ds_bulk_t start_key;
     do {
         try {
-            batch = database->list_keyvals(start_key, 64);
+            sdskv_run_in_pool(database.pool(SDSKV_OP_CLASS_MIGRATION), [&]() {
+                batch = database->list_keyvals(start_key, 64);
+            });
         } catch(int err) {
             out.ret = err;
             return;
@@ -2927,7 +4064,10 @@ static void sdskv_migrate_all_keys_ult(hg_handle_t handle)
             margo_free_output(put_handle, &out);
             /* remove the key if needed */
             if(in.flag == SDSKV_REMOVE_ORIGINAL) {
-                database->erase(kv.first);
+                sdskv_run_in_pool(database.pool(SDSKV_OP_CLASS_MIGRATION), [&]() {
+                    database->erase(kv.first);
+                });
+                database.written();
             }
         }
         /* if original is removed, start_key can stay empty since we
@@ -2977,19 +4117,16 @@ static void sdskv_migrate_database_ult(hg_handle_t handle)
         }
 
 #ifdef USE_REMI
-        ABT_rwlock_rdlock(svr_ctx->lock);
         // find the database that needs to be migrated
-        auto it = svr_ctx->databases.find(in.source_db_id);
-        if(it == svr_ctx->databases.end()) {
-            ABT_rwlock_unlock(svr_ctx->lock);
+        auto database = svr_ctx->databases.find(in.source_db_id);
+        if(!database) {
             out.ret = SDSKV_ERR_UNKNOWN_DB;
             break;
         }
-        auto database = it->second;
-        /* release the lock on the database */
-        ABT_rwlock_unlock(svr_ctx->lock);
         /* sync the database */
-        database->sync();
+        sdskv_run_in_pool(database.pool(SDSKV_OP_CLASS_MIGRATION), [&]() {
+            database->sync();
+        });
 
         /* lookup the address of the destination REMI provider */
         hret = margo_addr_lookup(mid, in.dest_remi_addr, &dest_addr);
@@ -3026,6 +4163,7 @@ static void sdskv_migrate_database_ult(hg_handle_t handle)
         }
 
         if(in.remove_src) {
+            database.reset();
             ret = sdskv_provider_remove_database(svr_ctx, in.source_db_id);
             out.ret = ret;
         }
@@ -3107,17 +4245,30 @@ static void sdskv_server_finalize_cb(void *data)
     margo_deregister(mid, provider->sdskv_list_databases_id);
     margo_deregister(mid, provider->sdskv_put_id);
     margo_deregister(mid, provider->sdskv_put_multi_id);
+    margo_deregister(mid, provider->sdskv_put_packed_id);
     margo_deregister(mid, provider->sdskv_bulk_put_id);
     margo_deregister(mid, provider->sdskv_get_id);
     margo_deregister(mid, provider->sdskv_get_multi_id);
+    margo_deregister(mid, provider->sdskv_get_packed_id);
+    margo_deregister(mid, provider->sdskv_get_alloc_id);
+    margo_deregister(mid, provider->sdskv_get_packed_alloc_id);
+    margo_deregister(mid, provider->sdskv_release_bulk_id);
     margo_deregister(mid, provider->sdskv_exists_id);
+    margo_deregister(mid, provider->sdskv_exists_multi_id);
     margo_deregister(mid, provider->sdskv_erase_id);
     margo_deregister(mid, provider->sdskv_erase_multi_id);
     margo_deregister(mid, provider->sdskv_length_id);
     margo_deregister(mid, provider->sdskv_length_multi_id);
+    margo_deregister(mid, provider->sdskv_length_packed_id);
     margo_deregister(mid, provider->sdskv_bulk_get_id);
     margo_deregister(mid, provider->sdskv_list_keys_id);
     margo_deregister(mid, provider->sdskv_list_keyvals_id);
+    margo_deregister(mid, provider->sdskv_list_keys_range_id);
+    margo_deregister(mid, provider->sdskv_list_keyvals_range_id);
+    margo_deregister(mid, provider->sdskv_list_packed_id);
+    margo_deregister(mid, provider->sdskv_open_cursor_id);
+    margo_deregister(mid, provider->sdskv_cursor_next_id);
+    margo_deregister(mid, provider->sdskv_close_cursor_id);
     margo_deregister(mid, provider->sdskv_migrate_keys_id);
     margo_deregister(mid, provider->sdskv_migrate_key_range_id);
     margo_deregister(mid, provider->sdskv_migrate_keys_prefixed_id);
@@ -3125,6 +4276,8 @@ static void sdskv_server_finalize_cb(void *data)
     margo_deregister(mid, provider->sdskv_migrate_database_id);
 
     ABT_rwlock_free(&(provider->lock));
+    ABT_mutex_free(&(provider->cursors_mutex));
+    ABT_mutex_free(&(provider->exposed_mutex));
 
     delete provider;
 
@@ -3197,6 +4350,10 @@ static int sdskv_pre_migration_callback(remi_fileset_t fileset, void* uargs)
             config.db_no_overwrite = 1;
         else
             config.db_no_overwrite = 0;
+        if(md._metadata.find("database_options") != md._metadata.end())
+            config.db_options = md._metadata["database_options"].c_str();
+        else
+            config.db_options = NULL;
         (provider->pre_migration_callback)(provider, &config, provider->migration_uargs);
     }
     // all is fine
@@ -3234,6 +4391,10 @@ static int sdskv_post_migration_callback(remi_fileset_t fileset, void* uargs)
         config.db_no_overwrite = 1;
     else
         config.db_no_overwrite = 0;
+    if(md._metadata.find("database_options") != md._metadata.end())
+        config.db_options = md._metadata["database_options"].c_str();
+    else
+        config.db_options = NULL;
     
     sdskv_database_id_t db_id;
     int ret = sdskv_provider_attach_database(provider, &config, &db_id);
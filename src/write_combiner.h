@@ -0,0 +1,166 @@
+// Copyright (c) 2017, Los Alamos National Security, LLC.
+// All rights reserved.
+#ifndef write_combiner_h
+#define write_combiner_h
+
+#include <atomic>
+#include <algorithm>
+#include <deque>
+#include <new>
+#include <vector>
+#include <time.h>
+#include <margo.h>
+#include "sdskv-common.h"
+#include "datastore/datastore.h"
+
+/**
+ * WriteCombiner commits the puts and erases issued concurrently on a
+ * database as batches (group commit). Each ULT calling submit() enqueues
+ * its mutation and waits. The ULT whose mutation is at the head of the
+ * queue is the leader: it optionally waits up to max_delay seconds for
+ * more mutations to arrive (the mutation that fills the batch wakes it up
+ * early), applies up to max_batch_size queued mutations
+ * with a single AbstractDataStore::write_batch call, hands each of their
+ * ULTs its own result and wakes them up. The mutation that is then at the
+ * head of the queue makes its ULT the next leader.
+ *
+ * The mutations are applied in the order in which they were enqueued.
+ */
+class WriteCombiner {
+
+    struct request {
+        AbstractDataStore::write_op op;
+        int                         result;
+        bool                        done;
+    };
+
+    public:
+
+        static const size_t default_max_batch_size = 256;
+
+        WriteCombiner(double max_delay = 0.0, size_t max_batch_size = default_max_batch_size)
+        : _max_delay(max_delay), _max_batch_size(max_batch_size ? max_batch_size : 1) {
+            ABT_mutex_create(&_mutex);
+            ABT_cond_create(&_cond);
+            ABT_cond_create(&_batch_full);
+        }
+
+        WriteCombiner(const WriteCombiner&) = delete;
+        WriteCombiner& operator=(const WriteCombiner&) = delete;
+
+        ~WriteCombiner() {
+            ABT_cond_free(&_batch_full);
+            ABT_cond_free(&_cond);
+            ABT_mutex_free(&_mutex);
+        }
+
+        /* maximum time (in seconds) a leader waits for more mutations */
+        void set_max_delay(double max_delay) {
+            _max_delay.store(max_delay, std::memory_order_relaxed);
+        }
+
+        int put(AbstractDataStore* db, const void* key, hg_size_t ksize,
+                const void* value, hg_size_t vsize) {
+            return submit(db, { false, key, ksize, value, vsize });
+        }
+
+        int erase(AbstractDataStore* db, const void* key, hg_size_t ksize) {
+            return submit(db, { true, key, ksize, nullptr, 0 });
+        }
+
+        /* number of mutations processed, and number of batches processing them */
+        uint64_t num_writes() const { return _num_writes.load(std::memory_order_relaxed); }
+
+        uint64_t num_batches() const { return _num_batches.load(std::memory_order_relaxed); }
+
+    private:
+
+        int submit(AbstractDataStore* db, const AbstractDataStore::write_op& op) {
+            request r = { op, SDSKV_SUCCESS, false };
+            ABT_mutex_lock(_mutex);
+            _queue.push_back(&r);
+            // wake up the leader if it is waiting for this batch to fill
+            if(_queue.size() == _max_batch_size)
+                ABT_cond_signal(_batch_full);
+            while(!r.done && _queue.front() != &r)
+                ABT_cond_wait(_cond, _mutex);
+            if(r.done) {
+                ABT_mutex_unlock(_mutex);
+                return r.result;
+            }
+            // this ULT is the leader, give other mutations a chance to join
+            double max_delay = _max_delay.load(std::memory_order_relaxed);
+            if(max_delay > 0.0 && _queue.size() < _max_batch_size) {
+                struct timespec deadline = deadline_after(max_delay);
+                while(_queue.size() < _max_batch_size) {
+                    if(ABT_cond_timedwait(_batch_full, _mutex, &deadline) != ABT_SUCCESS)
+                        break;
+                }
+            }
+            // requests behind the leader are not removed from the queue until
+            // they are done, so none of them can become a leader in the meantime
+            size_t n = std::min(_queue.size(), _max_batch_size);
+            std::vector<AbstractDataStore::write_op> ops;
+            std::vector<int> results;
+            // if the batch cannot be committed, its mutations fail but the
+            // leader still completes them and hands off leadership, otherwise
+            // their ULTs and every later writer would wait forever
+            int error = SDSKV_SUCCESS;
+            try {
+                ops.reserve(n);
+                for(size_t i = 0; i < n; i++)
+                    ops.push_back(_queue[i]->op);
+                results.resize(n);
+            } catch(const std::bad_alloc&) {
+                error = SDSKV_ERR_ALLOCATION;
+            }
+            ABT_mutex_unlock(_mutex);
+            if(error == SDSKV_SUCCESS) {
+                try {
+                    db->write_batch(n, ops.data(), results.data());
+                } catch(const std::bad_alloc&) {
+                    error = SDSKV_ERR_ALLOCATION;
+                } catch(...) {
+                    error = SDSKV_ERR_PUT;
+                }
+            }
+            ABT_mutex_lock(_mutex);
+            for(size_t i = 0; i < n; i++) {
+                request* q = _queue.front();
+                if(error == SDSKV_SUCCESS)
+                    q->result = results[i];
+                else if(error == SDSKV_ERR_PUT && q->op.erase)
+                    q->result = SDSKV_ERR_ERASE;
+                else
+                    q->result = error;
+                q->done = true;
+                _queue.pop_front();
+            }
+            _num_writes.fetch_add(n, std::memory_order_relaxed);
+            _num_batches.fetch_add(1, std::memory_order_relaxed);
+            ABT_cond_broadcast(_cond);
+            ABT_mutex_unlock(_mutex);
+            return r.result;
+        }
+
+        /* absolute time delay seconds from now, as expected by ABT_cond_timedwait */
+        static struct timespec deadline_after(double delay) {
+            struct timespec ts;
+            clock_gettime(CLOCK_REALTIME, &ts);
+            long long ns = ts.tv_nsec + (long long)(delay*1e9);
+            ts.tv_sec  += ns / 1000000000LL;
+            ts.tv_nsec  = ns % 1000000000LL;
+            return ts;
+        }
+
+        std::atomic<double>   _max_delay;
+        size_t                _max_batch_size;
+        std::atomic<uint64_t> _num_writes = { 0 };
+        std::atomic<uint64_t> _num_batches = { 0 };
+        ABT_mutex             _mutex;
+        ABT_cond              _cond;
+        ABT_cond              _batch_full;
+        std::deque<request*>  _queue;
+};
+
+#endif
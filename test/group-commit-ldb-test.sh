@@ -0,0 +1,11 @@
+#!/bin/bash -x
+
+if [ -z $srcdir ]; then
+    echo srcdir variable not set.
+    exit 1
+fi
+
+# run the group commit test against a leveldb database
+export SDSKV_TEST_DB_TYPE="ldb"
+
+$srcdir/test/group-commit-test.sh
@@ -0,0 +1,41 @@
+#!/bin/bash -x
+
+if [ -z $srcdir ]; then
+    echo srcdir variable not set.
+    exit 1
+fi
+source $srcdir/test/test-util.sh
+
+find_db_name
+
+# start a server with 2 second wait, 20s timeout,
+# my_test_db as database and group commit enabled
+test_start_server 2 20 -g 100 $test_db_full
+
+sleep 1
+
+#####################
+
+# concurrent puts are committed in batches
+run_to 20 test/sdskv-async-test $svr_addr 1 $test_db_name 200
+if [ $? -ne 0 ]; then
+    wait
+    exit 1
+fi
+
+wait
+
+# the server reports "<writes> writes in <batches> batches" when it shuts
+# down; windows of 16 concurrent puts must have shared some batches
+stats=$(grep -o "[0-9]* writes in [0-9]* batches" $TMPBASE/sdskv.out)
+read num_writes _ _ num_batches _ <<< "$stats"
+if [ -z "$num_writes" ] || [ "$num_batches" -ge "$num_writes" ]; then
+    echo "expected fewer batches than writes, got: $stats"
+    rm -rf $TMPBASE
+    exit 1
+fi
+
+echo cleaning up $TMPBASE
+rm -rf $TMPBASE
+
+exit 0
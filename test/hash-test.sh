@@ -0,0 +1,19 @@
+#!/bin/bash -x
+
+if [ -z $srcdir ]; then
+    echo srcdir variable not set.
+    exit 1
+fi
+
+# run the tests that only use point operations against a hash
+# database, which does not support listing
+export SDSKV_TEST_DB_TYPE="hash"
+
+for t in put-test get-test length-test erase-test get-alloc-test multi-test packed-test; do
+    $srcdir/test/$t.sh
+    if [ $? -ne 0 ]; then
+        exit 1
+    fi
+done
+
+exit 0
@@ -0,0 +1,20 @@
+#!/bin/bash -x
+
+if [ -z $srcdir ]; then
+    echo srcdir variable not set.
+    exit 1
+fi
+
+# run the point operation tests against a leveldb database whose
+# operations run in the I/O pool of 2 dedicated execution streams
+export SDSKV_TEST_DB_TYPE="ldb"
+export SDSKV_TEST_SERVER_OPTS="-i 2"
+
+for t in put-test get-test length-test erase-test multi-test; do
+    $srcdir/test/$t.sh
+    if [ $? -ne 0 ]; then
+        exit 1
+    fi
+done
+
+exit 0
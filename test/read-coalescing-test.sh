@@ -0,0 +1,52 @@
+#!/bin/bash -x
+
+if [ -z $srcdir ]; then
+    echo srcdir variable not set.
+    exit 1
+fi
+source $srcdir/test/test-util.sh
+
+find_db_name
+
+# start a server with 2 second wait, 20s timeout,
+# my_test_db as database and read coalescing enabled
+test_start_server 2 20 -r $test_db_full
+
+sleep 1
+
+#####################
+
+# concurrent gets share lookups and see the values put before them
+run_to 20 test/sdskv-async-test $svr_addr 1 $test_db_name 20
+if [ $? -ne 0 ]; then
+    wait
+    exit 1
+fi
+
+wait
+
+# concurrent gets of the same key must have joined in-flight lookups;
+# the server reports "<merged> merged" when it shuts down
+test_start_server 2 20 -r $test_db_full
+
+sleep 1
+
+run_to 20 test/sdskv-read-coalescing-test $svr_addr 1 $test_db_name 256
+if [ $? -ne 0 ]; then
+    wait
+    exit 1
+fi
+
+wait
+
+num_merged=$(grep -o "[0-9]* merged" $TMPBASE/sdskv.out | cut -d' ' -f1)
+if [ -z "$num_merged" ] || [ "$num_merged" -eq 0 ]; then
+    echo "expected concurrent gets of the same key to be merged"
+    rm -rf $TMPBASE
+    exit 1
+fi
+
+echo cleaning up $TMPBASE
+rm -rf $TMPBASE
+
+exit 0
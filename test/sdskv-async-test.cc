@@ -0,0 +1,240 @@
+/*
+ * (C) 2015 The University of Chicago
+ * 
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <assert.h>
+#include <unistd.h>
+#include <margo.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+#include "sdskv-client.h"
+
+static std::string gen_random_string(size_t len);
+
+int main(int argc, char *argv[])
+{
+    char cli_addr_prefix[64] = {0};
+    char *sdskv_svr_addr_str;
+    char *db_name;
+    margo_instance_id mid;
+    hg_addr_t svr_addr;
+    uint8_t mplex_id;
+    uint32_t num_keys;
+    sdskv_client_t kvcl;
+    sdskv_provider_handle_t kvph;
+    hg_return_t hret;
+    int ret;
+
+    if(argc != 5)
+    {
+        fprintf(stderr, "Usage: %s <sdskv_server_addr> <mplex_id> <db_name> <num_keys>\n", argv[0]);
+        fprintf(stderr, "  Example: %s tcp://localhost:1234 1 foo 1000\n", argv[0]);
+        return(-1);
+    }
+    sdskv_svr_addr_str = argv[1];
+    mplex_id           = atoi(argv[2]);
+    db_name            = argv[3];
+    num_keys           = atoi(argv[4]);
+
+    /* initialize Margo using the transport portion of the server
+     * address (i.e., the part before the first : character if present)
+     */
+    for(unsigned i=0; (i<63 && sdskv_svr_addr_str[i] != '\0' && sdskv_svr_addr_str[i] != ':'); i++)
+        cli_addr_prefix[i] = sdskv_svr_addr_str[i];
+
+    /* start margo */
+    mid = margo_init(cli_addr_prefix, MARGO_SERVER_MODE, 0, 0);
+    if(mid == MARGO_INSTANCE_NULL)
+    {
+        fprintf(stderr, "Error: margo_init()\n");
+        return(-1);
+    }
+
+    ret = sdskv_client_init(mid, &kvcl);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_client_init()\n");
+        margo_finalize(mid);
+        return -1;
+    }
+
+    /* look up the SDSKV server address */
+    hret = margo_addr_lookup(mid, sdskv_svr_addr_str, &svr_addr);
+    if(hret != HG_SUCCESS)
+    {
+        fprintf(stderr, "Error: margo_addr_lookup()\n");
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* create a SDSKV provider handle */
+    ret = sdskv_provider_handle_create(kvcl, svr_addr, mplex_id, &kvph);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_provider_handle_create()\n");
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* open the database */
+    sdskv_database_id_t db_id;
+    ret = sdskv_open(kvph, db_name, &db_id);
+    if(ret == 0) {
+        printf("Successfuly open database %s, id is %ld\n", db_name, db_id);
+    } else {
+        fprintf(stderr, "Error: could not open database %s\n", db_name);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* **** put keys, keeping many operations in flight ***** */
+    std::vector<std::string> keys(num_keys);
+    std::vector<std::string> values(num_keys);
+    std::map<std::string, std::string> reference;
+    /* larger than the RPC message size, so that both the inline
+     * and the bulk paths are exercised */
+    size_t max_value_size = 8000;
+    const size_t window = 16;
+    std::vector<sdskv_request_t> reqs(window, SDSKV_REQUEST_NULL);
+
+    for(unsigned i=0; i < num_keys && ret == 0; i++) {
+        keys[i] = gen_random_string(16);
+        values[i] = gen_random_string(1+i*max_value_size/num_keys);
+        reference[keys[i]] = values[i];
+        /* find a free slot, waiting for a request to complete if needed */
+        size_t slot = std::find(reqs.begin(), reqs.end(), SDSKV_REQUEST_NULL) - reqs.begin();
+        if(slot == window) {
+            ret = sdskv_wait_any(window, reqs.data(), &slot);
+            if(ret != 0) {
+                fprintf(stderr, "Error: sdskv_put_async() failed (completed by sdskv_wait_any)\n");
+                break;
+            }
+        }
+        ret = sdskv_put_async(kvph, db_id,
+                (const void *)keys[i].data(), keys[i].size(),
+                (const void *)values[i].data(), values[i].size(), &reqs[slot]);
+        if(ret != 0) {
+            fprintf(stderr, "Error: sdskv_put_async() failed (iteration %d)\n", i);
+        }
+    }
+    for(auto& r : reqs) {
+        if(r == SDSKV_REQUEST_NULL) continue;
+        int r_ret = sdskv_wait(r);
+        if(ret == 0) ret = r_ret;
+    }
+    if(ret != 0) {
+        fprintf(stderr, "Error: could not put all the keys\n");
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    printf("Successfuly inserted %d keys\n", num_keys);
+
+    /* **** get all the values with all the requests in flight **** */
+    std::vector<sdskv_request_t> get_reqs(num_keys, SDSKV_REQUEST_NULL);
+    std::vector<std::vector<char>> got(num_keys, std::vector<char>(max_value_size+1));
+    std::vector<hg_size_t> got_sizes(num_keys, max_value_size+1);
+    for(unsigned i=0; i < num_keys && ret == 0; i++) {
+        ret = sdskv_get_async(kvph, db_id,
+                (const void *)keys[i].data(), keys[i].size(),
+                (void*)got[i].data(), &got_sizes[i], &get_reqs[i]);
+        if(ret != 0) {
+            fprintf(stderr, "Error: sdskv_get_async() failed (key was %s)\n", keys[i].c_str());
+        }
+    }
+    for(unsigned i=0; i < num_keys; i++) {
+        if(get_reqs[i] == SDSKV_REQUEST_NULL) continue;
+        int r_ret = sdskv_wait(get_reqs[i]);
+        if(ret != 0) continue;
+        ret = r_ret;
+        if(ret != 0) {
+            fprintf(stderr, "Error: sdskv_get_async() completed with an error (key was %s)\n", keys[i].c_str());
+            continue;
+        }
+        std::string v(got[i].data(), got_sizes[i]);
+        if(v != reference[keys[i]]) {
+            fprintf(stderr, "Error: sdskv_get_async() returned a value different from the reference\n");
+            ret = -1;
+        }
+    }
+    if(ret != 0) {
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    printf("Successfuly got %d values asynchronously\n", num_keys);
+
+    /* **** erase the first key and check existence and length **** */
+    sdskv_request_t erase_req, exists_req, length_req;
+    int flag = 1;
+    hg_size_t vsize = 0;
+    ret = sdskv_erase_async(kvph, db_id,
+            (const void *)keys[0].data(), keys[0].size(), &erase_req);
+    if(ret == 0) ret = sdskv_wait(erase_req);
+    if(ret == 0) ret = sdskv_exists_async(kvph, db_id,
+            (const void *)keys[0].data(), keys[0].size(), &flag, &exists_req);
+    if(ret == 0) ret = sdskv_length_async(kvph, db_id,
+            (const void *)keys[num_keys-1].data(), keys[num_keys-1].size(), &vsize, &length_req);
+    if(ret == 0) {
+        int done = 0;
+        while(!done && ret == 0) ret = sdskv_test(exists_req, &done);
+        int r1 = sdskv_wait(exists_req);
+        int r2 = sdskv_wait(length_req);
+        if(ret == 0) ret = r1 != 0 ? r1 : r2;
+    }
+    if(ret == 0 && (flag != 0 || vsize != values[num_keys-1].size())) {
+        fprintf(stderr, "Error: unexpected result of sdskv_exists_async() or sdskv_length_async()\n");
+        ret = -1;
+    }
+    if(ret != 0) {
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    printf("Successfuly checked sdskv_erase_async, sdskv_exists_async and sdskv_length_async\n");
+
+    /* shutdown the server */
+    ret = sdskv_shutdown_service(kvcl, svr_addr);
+
+    /**** cleanup ****/
+    sdskv_provider_handle_release(kvph);
+    margo_addr_free(mid, svr_addr);
+    sdskv_client_finalize(kvcl);
+    margo_finalize(mid);
+    return(ret);
+}
+
+static std::string gen_random_string(size_t len) {
+    static const char alphanum[] =
+                "0123456789"
+                "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                "abcdefghijklmnopqrstuvwxyz";
+    std::string s(len, ' ');
+    for (unsigned i = 0; i < len; ++i) {
+        s[i] = alphanum[rand() % (sizeof(alphanum) - 1)];
+    }
+    return s;
+}
@@ -0,0 +1,224 @@
+/*
+ * (C) 2015 The University of Chicago
+ * 
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <assert.h>
+#include <unistd.h>
+#include <margo.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+#include "sdskv-client.h"
+
+static std::string gen_random_string(size_t len);
+
+int main(int argc, char *argv[])
+{
+    char cli_addr_prefix[64] = {0};
+    char *sdskv_svr_addr_str;
+    char *db_name;
+    margo_instance_id mid;
+    hg_addr_t svr_addr;
+    uint8_t mplex_id;
+    uint32_t num_keys;
+    sdskv_client_t kvcl;
+    sdskv_provider_handle_t kvph;
+    hg_return_t hret;
+    int ret;
+
+    if(argc != 5)
+    {
+        fprintf(stderr, "Usage: %s <sdskv_server_addr> <mplex_id> <db_name> <num_keys>\n", argv[0]);
+        fprintf(stderr, "  Example: %s tcp://localhost:1234 1 foo 1000\n", argv[0]);
+        return(-1);
+    }
+    sdskv_svr_addr_str = argv[1];
+    mplex_id           = atoi(argv[2]);
+    db_name            = argv[3];
+    num_keys           = atoi(argv[4]);
+
+    /* initialize Margo using the transport portion of the server
+     * address (i.e., the part before the first : character if present)
+     */
+    for(unsigned i=0; (i<63 && sdskv_svr_addr_str[i] != '\0' && sdskv_svr_addr_str[i] != ':'); i++)
+        cli_addr_prefix[i] = sdskv_svr_addr_str[i];
+
+    /* start margo */
+    mid = margo_init(cli_addr_prefix, MARGO_SERVER_MODE, 0, 0);
+    if(mid == MARGO_INSTANCE_NULL)
+    {
+        fprintf(stderr, "Error: margo_init()\n");
+        return(-1);
+    }
+
+    ret = sdskv_client_init(mid, &kvcl);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_client_init()\n");
+        margo_finalize(mid);
+        return -1;
+    }
+
+    /* look up the SDSKV server address */
+    hret = margo_addr_lookup(mid, sdskv_svr_addr_str, &svr_addr);
+    if(hret != HG_SUCCESS)
+    {
+        fprintf(stderr, "Error: margo_addr_lookup()\n");
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* create a SDSKV provider handle */
+    ret = sdskv_provider_handle_create(kvcl, svr_addr, mplex_id, &kvph);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_provider_handle_create()\n");
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* open the database */
+    sdskv_database_id_t db_id;
+    ret = sdskv_open(kvph, db_name, &db_id);
+    if(ret == 0) {
+        printf("Successfuly open database %s, id is %ld\n", db_name, db_id);
+    } else {
+        fprintf(stderr, "Error: could not open database %s\n", db_name);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* **** put keys through a batcher ***** */
+    std::vector<std::string> keys;
+    std::map<std::string, std::string> reference;
+    size_t max_value_size = 64;
+    hg_size_t max_bytes = 512;
+    size_t completed = 0;
+    auto count_completed = [](void* uargs, size_t num, int r) {
+        if(r == 0) *(size_t*)uargs += num;
+    };
+
+    sdskv_batcher_t batcher;
+    ret = sdskv_batcher_create(kvph, db_id, 7, max_bytes, 0,
+            count_completed, &completed, &batcher);
+    if(ret != 0) {
+        fprintf(stderr, "Error: sdskv_batcher_create() failed\n");
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+
+    for(unsigned i=0; i < num_keys && ret == 0; i++) {
+        auto k = gen_random_string(16);
+        /* one of the values does not fit in a batch */
+        auto v = gen_random_string(i == num_keys/2 ? 2*max_bytes : i*max_value_size/num_keys);
+        ret = sdskv_batcher_put(batcher,
+                (const void *)k.data(), k.size(),
+                (const void *)v.data(), v.size());
+        if(ret != 0) {
+            fprintf(stderr, "Error: sdskv_batcher_put() failed (iteration %d)\n", i);
+        }
+        reference[k] = v;
+        keys.push_back(k);
+    }
+    if(ret == 0) {
+        ret = sdskv_batcher_flush(batcher);
+        if(ret != 0) fprintf(stderr, "Error: sdskv_batcher_flush() failed\n");
+    }
+    if(ret == 0 && completed != num_keys) {
+        fprintf(stderr, "Error: %ld puts reported as completed instead of %d\n",
+                (long)completed, num_keys);
+        ret = -1;
+    }
+    sdskv_batcher_destroy(batcher);
+
+    /* **** check that all the keys were written **** */
+    for(unsigned i=0; i < num_keys && ret == 0; i++) {
+        auto& k = keys[i];
+        std::vector<char> v(2*max_bytes);
+        hg_size_t vsize = v.size();
+        ret = sdskv_get(kvph, db_id,
+                (const void *)k.data(), k.size(),
+                (void *)v.data(), &vsize);
+        if(ret != 0) {
+            fprintf(stderr, "Error: sdskv_get() failed (key was %s)\n", k.c_str());
+        } else if(std::string(v.data(), vsize) != reference[k]) {
+            fprintf(stderr, "Error: sdskv_get() returned a value different from the reference\n");
+            ret = -1;
+        }
+    }
+    if(ret != 0) {
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    printf("Successfuly put %d keys through a batcher\n", num_keys);
+
+    /* **** check that a batcher with a flush interval sends by itself **** */
+    completed = 0;
+    ret = sdskv_batcher_create(kvph, db_id, 0, max_bytes, 50,
+            count_completed, &completed, &batcher);
+    if(ret == 0) {
+        std::string k = "timed-key", v = "timed-value";
+        ret = sdskv_batcher_put(batcher,
+                (const void *)k.data(), k.size(),
+                (const void *)v.data(), v.size());
+        for(unsigned i=0; i < 20 && completed == 0; i++)
+            margo_thread_sleep(mid, 50);
+        if(ret == 0 && completed != 1) {
+            fprintf(stderr, "Error: the batcher did not send its batch after its flush interval\n");
+            ret = -1;
+        }
+        sdskv_batcher_destroy(batcher);
+    }
+    if(ret != 0) {
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    printf("Successfuly checked the flush interval of a batcher\n");
+
+    /* shutdown the server */
+    ret = sdskv_shutdown_service(kvcl, svr_addr);
+
+    /**** cleanup ****/
+    sdskv_provider_handle_release(kvph);
+    margo_addr_free(mid, svr_addr);
+    sdskv_client_finalize(kvcl);
+    margo_finalize(mid);
+    return(ret);
+}
+
+static std::string gen_random_string(size_t len) {
+    static const char alphanum[] =
+                "0123456789"
+                "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                "abcdefghijklmnopqrstuvwxyz";
+    std::string s(len, ' ');
+    for (unsigned i = 0; i < len; ++i) {
+        s[i] = alphanum[rand() % (sizeof(alphanum) - 1)];
+    }
+    return s;
+}
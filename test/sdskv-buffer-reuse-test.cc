@@ -0,0 +1,212 @@
+/*
+ * (C) 2015 The University of Chicago
+ * 
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <assert.h>
+#include <unistd.h>
+#include <margo.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+#include "sdskv-client.h"
+
+static std::string gen_random_string(size_t len);
+
+int main(int argc, char *argv[])
+{
+    char cli_addr_prefix[64] = {0};
+    char *sdskv_svr_addr_str;
+    char *db_name;
+    margo_instance_id mid;
+    hg_addr_t svr_addr;
+    uint8_t mplex_id;
+    uint32_t num_keys;
+    sdskv_client_t kvcl;
+    sdskv_provider_handle_t kvph;
+    hg_return_t hret;
+    int ret;
+
+    if(argc != 5)
+    {
+        fprintf(stderr, "Usage: %s <sdskv_server_addr> <mplex_id> <db_name> <num_keys>\n", argv[0]);
+        fprintf(stderr, "  Example: %s tcp://localhost:1234 1 foo 1000\n", argv[0]);
+        return(-1);
+    }
+    sdskv_svr_addr_str = argv[1];
+    mplex_id           = atoi(argv[2]);
+    db_name            = argv[3];
+    num_keys           = atoi(argv[4]);
+
+    /* initialize Margo using the transport portion of the server
+     * address (i.e., the part before the first : character if present)
+     */
+    for(unsigned i=0; (i<63 && sdskv_svr_addr_str[i] != '\0' && sdskv_svr_addr_str[i] != ':'); i++)
+        cli_addr_prefix[i] = sdskv_svr_addr_str[i];
+
+    /* start margo */
+    mid = margo_init(cli_addr_prefix, MARGO_SERVER_MODE, 0, 0);
+    if(mid == MARGO_INSTANCE_NULL)
+    {
+        fprintf(stderr, "Error: margo_init()\n");
+        return(-1);
+    }
+
+    ret = sdskv_client_init(mid, &kvcl);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_client_init()\n");
+        margo_finalize(mid);
+        return -1;
+    }
+
+    /* look up the SDSKV server address */
+    hret = margo_addr_lookup(mid, sdskv_svr_addr_str, &svr_addr);
+    if(hret != HG_SUCCESS)
+    {
+        fprintf(stderr, "Error: margo_addr_lookup()\n");
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* create a SDSKV provider handle */
+    ret = sdskv_provider_handle_create(kvcl, svr_addr, mplex_id, &kvph);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_provider_handle_create()\n");
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* open the database */
+    sdskv_database_id_t db_id;
+    ret = sdskv_open(kvph, db_name, &db_id);
+    if(ret == 0) {
+        printf("Successfuly open database %s, id is %ld\n", db_name, db_id);
+    } else {
+        fprintf(stderr, "Error: could not open database %s\n", db_name);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+
+    /* **** put keys, reusing the same buffer for all the values ***** */
+    /* values are larger than the RPC message size so that they are
+     * sent through bulk transfers using the cached registrations */
+    const size_t value_size = 8000;
+    std::vector<std::string> keys(num_keys);
+    std::map<std::string, std::string> reference;
+    std::vector<char> send_buffer(value_size);
+    std::vector<char> recv_buffer(value_size);
+
+    ret = sdskv_client_set_bulk_cache_size(kvcl, 4);
+    if(ret != 0) {
+        fprintf(stderr, "Error: sdskv_client_set_bulk_cache_size() failed\n");
+    }
+
+    for(unsigned i=0; i < num_keys && ret == 0; i++) {
+        keys[i] = gen_random_string(16);
+        std::string v = gen_random_string(value_size);
+        std::memcpy(send_buffer.data(), v.data(), value_size);
+        reference[keys[i]] = v;
+        ret = sdskv_put(kvph, db_id,
+                (const void *)keys[i].data(), keys[i].size(),
+                (const void *)send_buffer.data(), value_size);
+        if(ret != 0) {
+            fprintf(stderr, "Error: sdskv_put() failed (iteration %d)\n", i);
+        }
+    }
+
+    /* **** get the keys back, reusing the same receive buffer ***** */
+    for(unsigned i=0; i < num_keys && ret == 0; i++) {
+        hg_size_t vsize = value_size;
+        std::memset(recv_buffer.data(), 0, value_size);
+        ret = sdskv_get(kvph, db_id,
+                (const void *)keys[i].data(), keys[i].size(),
+                (void *)recv_buffer.data(), &vsize);
+        if(ret != 0) {
+            fprintf(stderr, "Error: sdskv_get() failed (iteration %d)\n", i);
+            break;
+        }
+        if(vsize != value_size
+        || std::string(recv_buffer.data(), vsize) != reference[keys[i]]) {
+            fprintf(stderr, "Error: value of key %d does not match\n", i);
+            ret = -1;
+        }
+    }
+
+    /* **** invalidate the receive buffer and replace it ***** */
+    if(ret == 0) {
+        ret = sdskv_client_bulk_cache_invalidate(kvcl, recv_buffer.data(), value_size);
+        if(ret != 0) {
+            fprintf(stderr, "Error: sdskv_client_bulk_cache_invalidate() failed\n");
+        }
+        std::vector<char>().swap(recv_buffer);
+        recv_buffer.resize(value_size);
+    }
+    for(unsigned i=0; i < num_keys && ret == 0; i++) {
+        hg_size_t vsize = value_size;
+        ret = sdskv_get(kvph, db_id,
+                (const void *)keys[i].data(), keys[i].size(),
+                (void *)recv_buffer.data(), &vsize);
+        if(ret != 0) {
+            fprintf(stderr, "Error: sdskv_get() failed after invalidation (iteration %d)\n", i);
+            break;
+        }
+        if(std::string(recv_buffer.data(), vsize) != reference[keys[i]]) {
+            fprintf(stderr, "Error: value of key %d does not match after invalidation\n", i);
+            ret = -1;
+        }
+    }
+
+    /* **** disable the cache, which drops all the registrations ***** */
+    if(ret == 0) {
+        ret = sdskv_client_set_bulk_cache_size(kvcl, 0);
+        if(ret != 0) {
+            fprintf(stderr, "Error: sdskv_client_set_bulk_cache_size(0) failed\n");
+        }
+    }
+    if(ret != 0) {
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    printf("Successfuly put and got %d keys reusing registered buffers\n", num_keys);
+
+    /* shutdown the server */
+    ret = sdskv_shutdown_service(kvcl, svr_addr);
+
+    /**** cleanup ****/
+    sdskv_provider_handle_release(kvph);
+    margo_addr_free(mid, svr_addr);
+    sdskv_client_finalize(kvcl);
+    margo_finalize(mid);
+    return(ret);
+}
+
+static std::string gen_random_string(size_t len) {
+    static const char alphanum[] =
+                "0123456789"
+                "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                "abcdefghijklmnopqrstuvwxyz";
+    std::string s(len, ' ');
+    for (unsigned i = 0; i < len; ++i) {
+        s[i] = alphanum[rand() % (sizeof(alphanum) - 1)];
+    }
+    return s;
+}
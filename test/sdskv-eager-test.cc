@@ -0,0 +1,222 @@
+/*
+ * (C) 2015 The University of Chicago
+ * 
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <assert.h>
+#include <unistd.h>
+#include <margo.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+#include "sdskv-client.h"
+
+static std::string gen_random_string(size_t len);
+
+int main(int argc, char *argv[])
+{
+    char cli_addr_prefix[64] = {0};
+    char *sdskv_svr_addr_str;
+    char *db_name;
+    margo_instance_id mid;
+    hg_addr_t svr_addr;
+    uint8_t mplex_id;
+    uint32_t num_keys;
+    sdskv_client_t kvcl;
+    sdskv_provider_handle_t kvph;
+    hg_return_t hret;
+    int ret;
+
+    if(argc != 5)
+    {
+        fprintf(stderr, "Usage: %s <sdskv_server_addr> <mplex_id> <db_name> <num_keys>\n", argv[0]);
+        fprintf(stderr, "  Example: %s tcp://localhost:1234 1 foo 1000\n", argv[0]);
+        return(-1);
+    }
+    sdskv_svr_addr_str = argv[1];
+    mplex_id           = atoi(argv[2]);
+    db_name            = argv[3];
+    num_keys           = atoi(argv[4]);
+
+    /* initialize Margo using the transport portion of the server
+     * address (i.e., the part before the first : character if present)
+     */
+    for(unsigned i=0; (i<63 && sdskv_svr_addr_str[i] != '\0' && sdskv_svr_addr_str[i] != ':'); i++)
+        cli_addr_prefix[i] = sdskv_svr_addr_str[i];
+
+    /* start margo */
+    mid = margo_init(cli_addr_prefix, MARGO_SERVER_MODE, 0, 0);
+    if(mid == MARGO_INSTANCE_NULL)
+    {
+        fprintf(stderr, "Error: margo_init()\n");
+        return(-1);
+    }
+
+    ret = sdskv_client_init(mid, &kvcl);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_client_init()\n");
+        margo_finalize(mid);
+        return -1;
+    }
+
+    /* look up the SDSKV server address */
+    hret = margo_addr_lookup(mid, sdskv_svr_addr_str, &svr_addr);
+    if(hret != HG_SUCCESS)
+    {
+        fprintf(stderr, "Error: margo_addr_lookup()\n");
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* create a SDSKV provider handle */
+    ret = sdskv_provider_handle_create(kvcl, svr_addr, mplex_id, &kvph);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_provider_handle_create()\n");
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* open the database */
+    sdskv_database_id_t db_id;
+    ret = sdskv_open(kvph, db_name, &db_id);
+    if(ret == 0) {
+        printf("Successfuly open database %s, id is %ld\n", db_name, db_id);
+    } else {
+        fprintf(stderr, "Error: could not open database %s\n", db_name);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+
+    hg_size_t default_eager_size = 0;
+    ret = sdskv_client_get_eager_size(kvcl, &default_eager_size);
+    if(ret != 0 || default_eager_size == 0) {
+        fprintf(stderr, "Error: sdskv_client_get_eager_size() failed\n");
+        ret = -1;
+    }
+    printf("Default eager size is %lu bytes\n", (unsigned long)default_eager_size);
+
+    /* run the same operations with the default eager size, with which
+     * they are sent inline, and with a tiny one forcing bulk transfers */
+    hg_size_t eager_sizes[2] = { 0, 16 };
+
+    for(unsigned round = 0; round < 2 && ret == 0; round++) {
+
+        ret = sdskv_client_set_eager_size(kvcl, eager_sizes[round]);
+        if(ret != 0) {
+            fprintf(stderr, "Error: sdskv_client_set_eager_size() failed\n");
+            break;
+        }
+
+        /* **** generate a few small key/vals ***** */
+        std::vector<std::string> keys(num_keys);
+        std::vector<std::string> vals(num_keys);
+        std::vector<const void*> keys_ptr(num_keys);
+        std::vector<const void*> vals_ptr(num_keys);
+        std::vector<hg_size_t> keys_size(num_keys);
+        std::vector<hg_size_t> vals_size(num_keys);
+        for(unsigned i=0; i < num_keys; i++) {
+            keys[i] = gen_random_string(8+i%8);
+            vals[i] = gen_random_string(i%4 == 0 ? 0 : 1+i%24);
+            keys_ptr[i]  = keys[i].data();
+            vals_ptr[i]  = vals[i].data();
+            keys_size[i] = keys[i].size();
+            vals_size[i] = vals[i].size();
+        }
+
+        /* **** put them ***** */
+        ret = sdskv_put_multi(kvph, db_id, num_keys, keys_ptr.data(), keys_size.data(),
+                vals_ptr.data(), vals_size.data());
+        if(ret != 0) {
+            fprintf(stderr, "Error: sdskv_put_multi() failed (round %d)\n", round);
+            break;
+        }
+
+        /* **** get them back, with one buffer too small ***** */
+        std::vector<std::vector<char>> read_values(num_keys);
+        std::vector<void*> read_ptr(num_keys);
+        std::vector<hg_size_t> read_size(num_keys);
+        for(unsigned i=0; i < num_keys; i++) {
+            read_values[i].resize(32);
+            read_ptr[i]  = read_values[i].data();
+            read_size[i] = read_values[i].size();
+        }
+        read_size[0] = 0;
+        ret = sdskv_get_multi(kvph, db_id, num_keys, keys_ptr.data(), keys_size.data(),
+                read_ptr.data(), read_size.data());
+        if(ret != 0) {
+            fprintf(stderr, "Error: sdskv_get_multi() failed (round %d)\n", round);
+            break;
+        }
+        for(unsigned i=1; i < num_keys && ret == 0; i++) {
+            if(std::string(read_values[i].data(), read_size[i]) != vals[i]) {
+                fprintf(stderr, "Error: value %d does not match (round %d)\n", i, round);
+                ret = -1;
+            }
+        }
+        if(ret != 0) break;
+
+        /* **** erase them ***** */
+        ret = sdskv_erase_multi(kvph, db_id, num_keys, keys_ptr.data(), keys_size.data());
+        if(ret != 0) {
+            fprintf(stderr, "Error: sdskv_erase_multi() failed (round %d)\n", round);
+            break;
+        }
+        std::vector<int> exist(num_keys);
+        ret = sdskv_exists_multi(kvph, db_id, num_keys, keys_ptr.data(), keys_size.data(),
+                exist.data());
+        if(ret != 0) {
+            fprintf(stderr, "Error: sdskv_exists_multi() failed (round %d)\n", round);
+            break;
+        }
+        if(std::find(exist.begin(), exist.end(), 1) != exist.end()) {
+            fprintf(stderr, "Error: some keys were not erased (round %d)\n", round);
+            ret = -1;
+        }
+    }
+    if(ret != 0) {
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    printf("Successfuly checked put_multi, get_multi and erase_multi with inline and bulk payloads\n");
+
+    /* shutdown the server */
+    ret = sdskv_shutdown_service(kvcl, svr_addr);
+
+    /**** cleanup ****/
+    sdskv_provider_handle_release(kvph);
+    margo_addr_free(mid, svr_addr);
+    sdskv_client_finalize(kvcl);
+    margo_finalize(mid);
+    return(ret);
+}
+
+static std::string gen_random_string(size_t len) {
+    static const char alphanum[] =
+                "0123456789"
+                "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                "abcdefghijklmnopqrstuvwxyz";
+    std::string s(len, ' ');
+    for (unsigned i = 0; i < len; ++i) {
+        s[i] = alphanum[rand() % (sizeof(alphanum) - 1)];
+    }
+    return s;
+}
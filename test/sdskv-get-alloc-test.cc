@@ -0,0 +1,237 @@
+/*
+ * (C) 2015 The University of Chicago
+ * 
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <assert.h>
+#include <unistd.h>
+#include <margo.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+#include "sdskv-client.h"
+
+static std::string gen_random_string(size_t len);
+
+int main(int argc, char *argv[])
+{
+    char cli_addr_prefix[64] = {0};
+    char *sdskv_svr_addr_str;
+    char *db_name;
+    margo_instance_id mid;
+    hg_addr_t svr_addr;
+    uint8_t mplex_id;
+    uint32_t num_keys;
+    sdskv_client_t kvcl;
+    sdskv_provider_handle_t kvph;
+    hg_return_t hret;
+    int ret;
+
+    if(argc != 5)
+    {
+        fprintf(stderr, "Usage: %s <sdskv_server_addr> <mplex_id> <db_name> <num_keys>\n", argv[0]);
+        fprintf(stderr, "  Example: %s tcp://localhost:1234 1 foo 1000\n", argv[0]);
+        return(-1);
+    }
+    sdskv_svr_addr_str = argv[1];
+    mplex_id           = atoi(argv[2]);
+    db_name            = argv[3];
+    num_keys           = atoi(argv[4]);
+
+    /* initialize Margo using the transport portion of the server
+     * address (i.e., the part before the first : character if present)
+     */
+    for(unsigned i=0; (i<63 && sdskv_svr_addr_str[i] != '\0' && sdskv_svr_addr_str[i] != ':'); i++)
+        cli_addr_prefix[i] = sdskv_svr_addr_str[i];
+
+    /* start margo */
+    mid = margo_init(cli_addr_prefix, MARGO_SERVER_MODE, 0, 0);
+    if(mid == MARGO_INSTANCE_NULL)
+    {
+        fprintf(stderr, "Error: margo_init()\n");
+        return(-1);
+    }
+
+    ret = sdskv_client_init(mid, &kvcl);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_client_init()\n");
+        margo_finalize(mid);
+        return -1;
+    }
+
+    /* look up the SDSKV server address */
+    hret = margo_addr_lookup(mid, sdskv_svr_addr_str, &svr_addr);
+    if(hret != HG_SUCCESS)
+    {
+        fprintf(stderr, "Error: margo_addr_lookup()\n");
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* create a SDSKV provider handle */
+    ret = sdskv_provider_handle_create(kvcl, svr_addr, mplex_id, &kvph);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_provider_handle_create()\n");
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* open the database */
+    sdskv_database_id_t db_id;
+    ret = sdskv_open(kvph, db_name, &db_id);
+    if(ret == 0) {
+        printf("Successfuly open database %s, id is %ld\n", db_name, db_id);
+    } else {
+        fprintf(stderr, "Error: could not open database %s\n", db_name);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* **** put keys ***** */
+    std::vector<std::string> keys;
+    std::map<std::string, std::string> reference;
+    /* larger than the RPC message size, so that both the inline
+     * and the bulk path of sdskv_get_alloc are exercised */
+    size_t max_value_size = 10000;
+
+    for(unsigned i=0; i < num_keys; i++) {
+        auto k = gen_random_string(16);
+        auto v = gen_random_string(i*max_value_size/num_keys);
+        ret = sdskv_put(kvph, db_id,
+                (const void *)k.data(), k.size(),
+                (const void *)v.data(), v.size());
+        if(ret != 0) {
+            fprintf(stderr, "Error: sdskv_put() failed (iteration %d)\n", i);
+            sdskv_shutdown_service(kvcl, svr_addr);
+            sdskv_provider_handle_release(kvph);
+            margo_addr_free(mid, svr_addr);
+            sdskv_client_finalize(kvcl);
+            margo_finalize(mid);
+            return -1;
+        }
+        reference[k] = v;
+        keys.push_back(k);
+    }
+    printf("Successfuly inserted %d keys\n", num_keys);
+
+    /* **** get values without knowing their size **** */
+    for(unsigned i=0; i < num_keys && ret == 0; i++) {
+        auto& k = keys[i];
+        void* value = NULL;
+        hg_size_t vsize = 0;
+        ret = sdskv_get_alloc(kvph, db_id,
+                (const void *)k.data(), k.size(), &value, &vsize);
+        if(ret != 0) {
+            fprintf(stderr, "Error: sdskv_get_alloc() failed (key was %s)\n", k.c_str());
+            break;
+        }
+        std::string v((const char*)value, vsize);
+        free(value);
+        if(v != reference[k]) {
+            fprintf(stderr, "Error: sdskv_get_alloc() returned a value different from the reference\n");
+            ret = -1;
+        }
+    }
+    if(ret == 0) {
+        std::string k = "this-key-does-not-exist";
+        void* value = NULL;
+        hg_size_t vsize = 0;
+        ret = sdskv_get_alloc(kvph, db_id,
+                (const void *)k.data(), k.size(), &value, &vsize);
+        if(ret != SDSKV_ERR_UNKNOWN_KEY) {
+            fprintf(stderr, "Error: sdskv_get_alloc() did not fail on a missing key\n");
+            ret = -1;
+        } else {
+            ret = 0;
+        }
+    }
+    if(ret != 0) {
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    printf("Successfuly got %d values with sdskv_get_alloc\n", num_keys);
+
+    /* **** get all the values at once, with one missing key **** */
+    keys.push_back("this-key-does-not-exist");
+    std::string packed_keys;
+    std::vector<hg_size_t> ksizes;
+    for(auto& k : keys) {
+        packed_keys += k;
+        ksizes.push_back(k.size());
+    }
+    std::vector<hg_size_t> vsizes(keys.size());
+    void* packed_values = NULL;
+    ret = sdskv_get_packed_alloc(kvph, db_id, keys.size(),
+            (const void*)packed_keys.data(), ksizes.data(),
+            &packed_values, vsizes.data());
+    if(ret != 0) {
+        fprintf(stderr, "Error: sdskv_get_packed_alloc() failed\n");
+    } else {
+        const char* v = (const char*)packed_values;
+        for(unsigned i=0; i < keys.size(); i++) {
+            if(i == keys.size()-1) {
+                if(vsizes[i] != (hg_size_t)(-1)) {
+                    fprintf(stderr, "Error: sdskv_get_packed_alloc() returned a value for a missing key\n");
+                    ret = -1;
+                }
+                break;
+            }
+            if(std::string(v, vsizes[i]) != reference[keys[i]]) {
+                fprintf(stderr, "Error: sdskv_get_packed_alloc() returned a value different from the reference\n");
+                ret = -1;
+                break;
+            }
+            v += vsizes[i];
+        }
+        free(packed_values);
+    }
+    if(ret != 0) {
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    printf("Successfuly got %d values with sdskv_get_packed_alloc\n", num_keys);
+
+    /* shutdown the server */
+    ret = sdskv_shutdown_service(kvcl, svr_addr);
+
+    /**** cleanup ****/
+    sdskv_provider_handle_release(kvph);
+    margo_addr_free(mid, svr_addr);
+    sdskv_client_finalize(kvcl);
+    margo_finalize(mid);
+    return(ret);
+}
+
+static std::string gen_random_string(size_t len) {
+    static const char alphanum[] =
+                "0123456789"
+                "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                "abcdefghijklmnopqrstuvwxyz";
+    std::string s(len, ' ');
+    for (unsigned i = 0; i < len; ++i) {
+        s[i] = alphanum[rand() % (sizeof(alphanum) - 1)];
+    }
+    return s;
+}
@@ -0,0 +1,248 @@
+/*
+ * (C) 2015 The University of Chicago
+ * 
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <assert.h>
+#include <unistd.h>
+#include <margo.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <map>
+
+#include "sdskv-client.h"
+
+static std::string gen_random_string(size_t len);
+
+int main(int argc, char *argv[])
+{
+    char cli_addr_prefix[64] = {0};
+    char *sdskv_svr_addr_str;
+    char *db_name;
+    margo_instance_id mid;
+    hg_addr_t svr_addr;
+    uint8_t mplex_id;
+    uint32_t num_keys;
+    sdskv_client_t kvcl;
+    sdskv_provider_handle_t kvph;
+    hg_return_t hret;
+    int ret;
+
+    if(argc != 5)
+    {
+        fprintf(stderr, "Usage: %s <sdskv_server_addr> <mplex_id> <db_name> <num_keys>\n", argv[0]);
+        fprintf(stderr, "  Example: %s tcp://localhost:1234 1 foo 1000\n", argv[0]);
+        return(-1);
+    }
+    sdskv_svr_addr_str = argv[1];
+    mplex_id           = atoi(argv[2]);
+    db_name            = argv[3];
+    num_keys           = atoi(argv[4]);
+
+    /* initialize Margo using the transport portion of the server
+     * address (i.e., the part before the first : character if present)
+     */
+    for(unsigned i=0; (i<63 && sdskv_svr_addr_str[i] != '\0' && sdskv_svr_addr_str[i] != ':'); i++)
+        cli_addr_prefix[i] = sdskv_svr_addr_str[i];
+
+    /* start margo */
+    mid = margo_init(cli_addr_prefix, MARGO_SERVER_MODE, 0, 0);
+    if(mid == MARGO_INSTANCE_NULL)
+    {
+        fprintf(stderr, "Error: margo_init()\n");
+        return(-1);
+    }
+
+    ret = sdskv_client_init(mid, &kvcl);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_client_init()\n");
+        margo_finalize(mid);
+        return -1;
+    }
+
+    /* look up the SDSKV server address */
+    hret = margo_addr_lookup(mid, sdskv_svr_addr_str, &svr_addr);
+    if(hret != HG_SUCCESS)
+    {
+        fprintf(stderr, "Error: margo_addr_lookup()\n");
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* create a SDSKV provider handle */
+    ret = sdskv_provider_handle_create(kvcl, svr_addr, mplex_id, &kvph);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_provider_handle_create()\n");
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* open the database */
+    sdskv_database_id_t db_id;
+    ret = sdskv_open(kvph, db_name, &db_id);
+    if(ret == 0) {
+        printf("Successfuly open database %s, id is %ld\n", db_name, db_id);
+    } else {
+        fprintf(stderr, "Error: could not open database %s\n", db_name);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* **** put keys ***** */
+    std::map<std::string, std::string> reference;
+    size_t max_key_size   = 16;
+    size_t max_value_size = 16;
+
+    for(unsigned i=0; i < num_keys; i++) {
+        auto k = gen_random_string((max_key_size+(rand()%max_key_size))/2);
+        auto v = gen_random_string(i*max_value_size/num_keys);
+        ret = sdskv_put(kvph, db_id,
+                (const void *)k.data(), k.size(),
+                (const void *)v.data(), v.size());
+        if(ret != 0) {
+            fprintf(stderr, "Error: sdskv_put() failed (iteration %d)\n", i);
+            sdskv_shutdown_service(kvcl, svr_addr);
+            sdskv_provider_handle_release(kvph);
+            margo_addr_free(mid, svr_addr);
+            sdskv_client_finalize(kvcl);
+            margo_finalize(mid);
+            return -1;
+        }
+        reference[k] = v;
+    }
+    printf("Successfuly inserted %d keys\n", num_keys);
+
+    /* **** list the database in pages received as single packed buffers **** */
+    const hg_size_t page_size = 4;
+    /* small enough that some pages are cut by the buffer size */
+    hg_size_t buffer_size = page_size*(2*sizeof(hg_size_t)+max_key_size+max_value_size)/2;
+    std::vector<char> buffer(buffer_size);
+    std::vector<const void*> keys(page_size);
+    std::vector<const void*> vals(page_size);
+    std::vector<hg_size_t> ksizes(page_size);
+    std::vector<hg_size_t> vsizes(page_size);
+
+    auto expected = reference.begin();
+    std::string last_key;
+    while(ret == 0) {
+        hg_size_t count = page_size;
+        hg_size_t size  = buffer_size;
+        ret = sdskv_list_keyvals_packed(kvph, db_id,
+                (const void*)last_key.data(), last_key.size(), NULL, 0,
+                buffer.data(), &size,
+                keys.data(), ksizes.data(),
+                vals.data(), vsizes.data(), &count);
+        if(ret != 0) {
+            fprintf(stderr, "Error: sdskv_list_keyvals_packed() failed\n");
+            break;
+        }
+        if(count == 0) break;
+        if(size > buffer_size) {
+            fprintf(stderr, "Error: sdskv_list_keyvals_packed() used more than the buffer size\n");
+            ret = -1;
+            break;
+        }
+        for(unsigned i=0; i < count; i++, expected++) {
+            std::string k((const char*)keys[i], ksizes[i]);
+            std::string v((const char*)vals[i], vsizes[i]);
+            if(expected == reference.end() || k != expected->first || v != expected->second) {
+                fprintf(stderr, "Error: unexpected key/value pair (%s, %s)\n",
+                        k.c_str(), v.c_str());
+                ret = -1;
+                break;
+            }
+            last_key = k;
+        }
+    }
+    if(ret == 0 && expected != reference.end()) {
+        fprintf(stderr, "Error: listing stopped before the end of the database\n");
+        ret = -1;
+    }
+    if(ret != 0) {
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    printf("Successfuly listed %ld keys with packed transfers\n", (long)reference.size());
+
+    /* **** list the database again, limited only by a byte budget **** */
+    expected = reference.begin();
+    last_key.clear();
+    while(ret == 0) {
+        hg_size_t count = 0;
+        hg_size_t size  = buffer_size;
+        ret = sdskv_list_keyvals_budget(kvph, db_id,
+                (const void*)last_key.data(), last_key.size(), NULL, 0,
+                buffer.data(), &size, &count);
+        if(ret != 0) {
+            fprintf(stderr, "Error: sdskv_list_keyvals_budget() failed\n");
+            break;
+        }
+        if(count == 0) break;
+        keys.resize(count); ksizes.resize(count);
+        vals.resize(count); vsizes.resize(count);
+        sdskv_unpack_keyvals(buffer.data(), count,
+                keys.data(), ksizes.data(), vals.data(), vsizes.data());
+        for(unsigned i=0; i < count; i++, expected++) {
+            std::string k((const char*)keys[i], ksizes[i]);
+            std::string v((const char*)vals[i], vsizes[i]);
+            if(expected == reference.end() || k != expected->first || v != expected->second) {
+                fprintf(stderr, "Error: unexpected key/value pair (%s, %s)\n",
+                        k.c_str(), v.c_str());
+                ret = -1;
+                break;
+            }
+            last_key = k;
+        }
+    }
+    if(ret == 0 && expected != reference.end()) {
+        fprintf(stderr, "Error: budget listing stopped before the end of the database\n");
+        ret = -1;
+    }
+    if(ret != 0) {
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    printf("Successfuly listed %ld keys within a byte budget\n", (long)reference.size());
+
+    /* shutdown the server */
+    ret = sdskv_shutdown_service(kvcl, svr_addr);
+
+    /**** cleanup ****/
+    sdskv_provider_handle_release(kvph);
+    margo_addr_free(mid, svr_addr);
+    sdskv_client_finalize(kvcl);
+    margo_finalize(mid);
+    return(ret);
+}
+
+static std::string gen_random_string(size_t len) {
+    static const char alphanum[] =
+                "0123456789"
+                "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                "abcdefghijklmnopqrstuvwxyz";
+    std::string s(len, ' ');
+    for (unsigned i = 0; i < len; ++i) {
+        s[i] = alphanum[rand() % (sizeof(alphanum) - 1)];
+    }
+    return s;
+}
@@ -0,0 +1,183 @@
+/*
+ * (C) 2015 The University of Chicago
+ * 
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <assert.h>
+#include <unistd.h>
+#include <margo.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstring>
+
+#include "sdskv-client.h"
+
+static std::string gen_random_string(size_t len);
+
+int main(int argc, char *argv[])
+{
+    char cli_addr_prefix[64] = {0};
+    char *sdskv_svr_addr_str;
+    char *db_name;
+    margo_instance_id mid;
+    hg_addr_t svr_addr;
+    uint8_t mplex_id;
+    uint32_t num_gets;
+    sdskv_client_t kvcl;
+    sdskv_provider_handle_t kvph;
+    hg_return_t hret;
+    int ret;
+
+    if(argc != 5)
+    {
+        fprintf(stderr, "Usage: %s <sdskv_server_addr> <mplex_id> <db_name> <num_gets>\n", argv[0]);
+        fprintf(stderr, "  Example: %s tcp://localhost:1234 1 foo 256\n", argv[0]);
+        return(-1);
+    }
+    sdskv_svr_addr_str = argv[1];
+    mplex_id           = atoi(argv[2]);
+    db_name            = argv[3];
+    num_gets           = atoi(argv[4]);
+
+    /* initialize Margo using the transport portion of the server
+     * address (i.e., the part before the first : character if present)
+     */
+    for(unsigned i=0; (i<63 && sdskv_svr_addr_str[i] != '\0' && sdskv_svr_addr_str[i] != ':'); i++)
+        cli_addr_prefix[i] = sdskv_svr_addr_str[i];
+
+    /* start margo */
+    mid = margo_init(cli_addr_prefix, MARGO_SERVER_MODE, 0, 0);
+    if(mid == MARGO_INSTANCE_NULL)
+    {
+        fprintf(stderr, "Error: margo_init()\n");
+        return(-1);
+    }
+
+    ret = sdskv_client_init(mid, &kvcl);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_client_init()\n");
+        margo_finalize(mid);
+        return -1;
+    }
+
+    /* look up the SDSKV server address */
+    hret = margo_addr_lookup(mid, sdskv_svr_addr_str, &svr_addr);
+    if(hret != HG_SUCCESS)
+    {
+        fprintf(stderr, "Error: margo_addr_lookup()\n");
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* create a SDSKV provider handle */
+    ret = sdskv_provider_handle_create(kvcl, svr_addr, mplex_id, &kvph);
+    if(ret != 0)
+    {
+        fprintf(stderr, "Error: sdskv_provider_handle_create()\n");
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* open the database */
+    sdskv_database_id_t db_id;
+    ret = sdskv_open(kvph, db_name, &db_id);
+    if(ret == 0) {
+        printf("Successfuly open database %s, id is %ld\n", db_name, db_id);
+    } else {
+        fprintf(stderr, "Error: could not open database %s\n", db_name);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return(-1);
+    }
+
+    /* **** put a single key, small enough for its value to be
+     * returned inline, which is the path that coalesces gets ***** */
+    std::string key = gen_random_string(16);
+    std::string value = gen_random_string(2000);
+    ret = sdskv_put(kvph, db_id,
+            (const void *)key.data(), key.size(),
+            (const void *)value.data(), value.size());
+    if(ret != 0) {
+        fprintf(stderr, "Error: sdskv_put() failed\n");
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    printf("Successfuly inserted key %s\n", key.c_str());
+
+    /* **** get that key concurrently, round after round, so that gets
+     * arrive while a lookup of the key is in flight on the server **** */
+    const unsigned num_rounds = 20;
+    std::vector<sdskv_request_t> reqs(num_gets, SDSKV_REQUEST_NULL);
+    std::vector<std::vector<char>> got(num_gets, std::vector<char>(value.size()));
+    std::vector<hg_size_t> got_sizes(num_gets);
+    for(unsigned round=0; round < num_rounds && ret == 0; round++) {
+        for(unsigned i=0; i < num_gets && ret == 0; i++) {
+            got_sizes[i] = value.size();
+            ret = sdskv_get_async(kvph, db_id,
+                    (const void *)key.data(), key.size(),
+                    (void*)got[i].data(), &got_sizes[i], &reqs[i]);
+            if(ret != 0) {
+                fprintf(stderr, "Error: sdskv_get_async() failed (round %d, get %d)\n", round, i);
+            }
+        }
+        for(unsigned i=0; i < num_gets; i++) {
+            if(reqs[i] == SDSKV_REQUEST_NULL) continue;
+            int r_ret = sdskv_wait(reqs[i]);
+            reqs[i] = SDSKV_REQUEST_NULL;
+            if(ret != 0) continue;
+            ret = r_ret;
+            if(ret != 0) {
+                fprintf(stderr, "Error: sdskv_get_async() completed with an error (round %d, get %d)\n", round, i);
+                continue;
+            }
+            if(std::string(got[i].data(), got_sizes[i]) != value) {
+                fprintf(stderr, "Error: sdskv_get_async() returned a value different from the reference\n");
+                ret = -1;
+            }
+        }
+    }
+    if(ret != 0) {
+        sdskv_shutdown_service(kvcl, svr_addr);
+        sdskv_provider_handle_release(kvph);
+        margo_addr_free(mid, svr_addr);
+        sdskv_client_finalize(kvcl);
+        margo_finalize(mid);
+        return -1;
+    }
+    printf("Successfuly got the key %d times in %d rounds\n", num_gets*num_rounds, num_rounds);
+
+    /* shutdown the server */
+    ret = sdskv_shutdown_service(kvcl, svr_addr);
+
+    /**** cleanup ****/
+    sdskv_provider_handle_release(kvph);
+    margo_addr_free(mid, svr_addr);
+    sdskv_client_finalize(kvcl);
+    margo_finalize(mid);
+    return(ret);
+}
+
+static std::string gen_random_string(size_t len) {
+    static const char alphanum[] =
+                "0123456789"
+                "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                "abcdefghijklmnopqrstuvwxyz";
+    std::string s(len, ' ');
+    for (unsigned i = 0; i < len; ++i) {
+        s[i] = alphanum[rand() % (sizeof(alphanum) - 1)];
+    }
+    return s;
+}
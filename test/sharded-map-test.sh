@@ -0,0 +1,19 @@
+#!/bin/bash -x
+
+if [ -z $srcdir ]; then
+    echo srcdir variable not set.
+    exit 1
+fi
+
+# run the point and listing tests against a sharded map
+# with fewer shards than keys, so that listings merge shards
+export SDSKV_TEST_DB_TYPE="smap:num_shards=4"
+
+for t in put-test get-test erase-test list-keys-test list-keyvals-test list-keys-prefix-test list-keys-range-test; do
+    $srcdir/test/$t.sh
+    if [ $? -ne 0 ]; then
+        exit 1
+    fi
+done
+
+exit 0
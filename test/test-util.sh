@@ -35,7 +35,8 @@ function test_start_server ()
     startwait=${1:-15}
     maxtime=${2:-120}
 
-    run_to ${maxtime} bin/sdskv-server-daemon -f $TMPBASE/sdskv.addr ${SDSKV_TEST_TRANSPORT:-"na+sm"} ${@:3} &
+    # keep a copy of the server output for the tests that check its statistics
+    run_to ${maxtime} bin/sdskv-server-daemon -f $TMPBASE/sdskv.addr ${SDSKV_TEST_SERVER_OPTS} ${SDSKV_TEST_TRANSPORT:-"na+sm"} ${@:3} | tee $TMPBASE/sdskv.out &
     # wait for server to start
     sleep ${startwait}
 